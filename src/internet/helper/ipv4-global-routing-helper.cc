@@ -71,5 +71,11 @@ Ipv4GlobalRoutingHelper::RecomputeRoutingTables (void)
   GlobalRouteManager::InitializeRoutes ();
 }
 
+void
+Ipv4GlobalRoutingHelper::UpdateRoutingTables (void)
+{
+  GlobalRouteManager::UpdateRoutes ();
+}
+
 
 } // namespace ns3
@@ -84,6 +84,17 @@ public:
    *
    */
   static void RecomputeRoutingTables (void);
+  /**
+   * \brief Update the routes after changes of the topology.
+   *
+   * This method gives the same routes as RecomputeRoutingTables(), but
+   * only recomputes the routes of the nodes which may be affected by the
+   * changes since the previous call to PopulateRoutingTables(),
+   * RecomputeRoutingTables() or UpdateRoutingTables().  The routes of the
+   * other nodes, including the ones added outside of global routing, are
+   * kept.
+   */
+  static void UpdateRoutingTables (void);
 private:
   /**
    * \brief Assignment operator declared private and not implemented to disallow
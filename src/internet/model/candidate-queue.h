@@ -22,7 +22,8 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
+#include <unordered_map>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -47,6 +48,11 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
  * enhanced priority queue.
+ *
+ * The vertices are kept in a binary heap, and indexed by their vertex ID
+ * for Find ().  Vertices at the same distance from the root (and of the
+ * same type) are popped in the order they were pushed, or, if their
+ * distance decreased, in the order of the Reorder (SPFVertex*) calls.
  */
 class CandidateQueue
 {
@@ -154,6 +160,18 @@ public:
  */
   void Reorder (void);
 
+/**
+ * @brief Restores the order of the Candidate Queue after the distance of
+ * one vertex decreased.
+ *
+ * This is cheaper than Reorder (void).  The vertex is ordered after the
+ * other vertices at the same distance, as if it had just been pushed.
+ *
+ * @see SPFVertex
+ * @param v The vertex whose m_distanceFromRoot decreased.
+ */
+  void Reorder (SPFVertex *v);
+
 private:
 /**
  * Candidate Queue copy construction is disallowed (not implemented) to 
@@ -184,8 +202,46 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-  CandidateList_t m_candidates;  //!< SPFVertex candidates
+  /// A vertex in the heap, with its rank among the vertices at the same distance
+  struct Candidate
+  {
+    SPFVertex *vertex; //!< the vertex
+    uint64_t order;    //!< the order of the vertex among the equal ones
+  };
+
+  /**
+   * \brief return true if c1 should be popped before c2
+   * \param c1 first operand
+   * \param c2 second operand
+   * \return True if c1 should be popped before c2; false otherwise
+   */
+  static bool IsBefore (const Candidate &c1, const Candidate &c2);
+
+  /**
+   * \brief Move a candidate towards the top of the heap.
+   * \param index the index of the candidate in the heap
+   */
+  void SiftUp (uint32_t index);
+
+  /**
+   * \brief Store a candidate at a position of the heap and record that
+   * position in the vertex, so that Reorder (SPFVertex*) finds it directly.
+   * \param index the index of the candidate in the heap
+   * \param c the candidate
+   */
+  void Place (uint32_t index, const Candidate &c);
+
+  /**
+   * \brief Move a candidate towards the bottom of the heap.
+   * \param index the index of the candidate in the heap
+   */
+  void SiftDown (uint32_t index);
+
+  typedef std::vector<Candidate> CandidateList_t; //!< container of SPFVertex pointers
+  CandidateList_t m_candidates;  //!< SPFVertex candidates, as a binary heap
+  /// the candidates, by vertex ID
+  std::unordered_map<Ipv4Address, SPFVertex*, Ipv4AddressHash> m_candidatesById;
+  uint64_t m_nextOrder; //!< the order of the next pushed vertex
 
   /**
    * \brief Stream insertion operator.
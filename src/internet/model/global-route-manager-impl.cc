@@ -94,7 +94,8 @@ SPFVertex::SPFVertex () :
   m_nextHop ("0.0.0.0"),
   m_parents (),
   m_children (),
-  m_vertexProcessed (false)
+  m_vertexProcessed (false),
+  m_candidateIndex (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -107,7 +108,8 @@ SPFVertex::SPFVertex (GlobalRoutingLSA* lsa) :
   m_nextHop ("0.0.0.0"),
   m_parents (),
   m_children (),
-  m_vertexProcessed (false)
+  m_vertexProcessed (false),
+  m_candidateIndex (0)
 {
   NS_LOG_FUNCTION (this << lsa);
 
@@ -470,7 +472,28 @@ GlobalRouteManagerLSDB::Insert (Ipv4Address addr, GlobalRoutingLSA* lsa)
     } 
   else
     {
-      m_database.insert (LSDBPair_t (addr, lsa));
+      if (!m_database.insert (LSDBPair_t (addr, lsa)).second)
+        {
+          return;
+        }
+//
+// Index the TransitNetwork link records for GetLSAByLinkData, which returns
+// the LSA with the lowest address when several of them match.
+//
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+          if (lr->GetLinkType () != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              continue;
+            }
+          std::pair<std::unordered_map<Ipv4Address, LSDBPair_t, Ipv4AddressHash>::iterator, bool> ret =
+            m_linkDataIndex.insert (std::make_pair (lr->GetLinkData (), LSDBPair_t (addr, lsa)));
+          if (!ret.second && addr < ret.first->second.first)
+            {
+              ret.first->second = LSDBPair_t (addr, lsa);
+            }
+        }
     }
 }
 
@@ -495,13 +518,10 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i != m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return i->second;
     }
   return 0;
 }
@@ -511,24 +531,102 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this << addr);
 //
-// Look up an LSA by its address.
+// Look up an LSA by the link data of one of its TransitNetwork link records.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  std::unordered_map<Ipv4Address, LSDBPair_t, Ipv4AddressHash>::const_iterator i =
+    m_linkDataIndex.find (addr);
+  if (i != m_linkDataIndex.end ())
     {
-      GlobalRoutingLSA* temp = i->second;
-// Iterate among temp's Link Records
-      for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
+      return i->second.second;
+    }
+  return 0;
+}
+
+void
+GlobalRouteManagerLSDB::GetChangedLSAs (const GlobalRouteManagerLSDB &lsdb,
+                                        std::set<Ipv4Address> &changed) const
+{
+  NS_LOG_FUNCTION (this << &lsdb);
+//
+// Both maps are sorted by address: walk them together.
+//
+  LSDBMap_t::const_iterator i = m_database.begin ();
+  LSDBMap_t::const_iterator j = lsdb.m_database.begin ();
+  while (i != m_database.end () || j != lsdb.m_database.end ())
+    {
+      if (j == lsdb.m_database.end () || (i != m_database.end () && i->first < j->first))
+        {
+          changed.insert (i->first);
+          i++;
+        }
+      else if (i == m_database.end () || j->first < i->first)
+        {
+          changed.insert (j->first);
+          j++;
+        }
+      else
         {
-          GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
-          if ( lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork &&
-               lr->GetLinkData () == addr)
+          if (!IsSameLSA (i->second, j->second))
             {
-              return temp;
+              changed.insert (i->first);
             }
+          i++;
+          j++;
         }
     }
-  return 0;
+}
+
+bool
+GlobalRouteManagerLSDB::HasSameExtLSAs (const GlobalRouteManagerLSDB &lsdb) const
+{
+  NS_LOG_FUNCTION (this << &lsdb);
+  if (m_extdatabase.size () != lsdb.m_extdatabase.size ())
+    {
+      return false;
+    }
+  for (uint32_t j = 0; j < m_extdatabase.size (); j++)
+    {
+      if (!IsSameLSA (m_extdatabase[j], lsdb.m_extdatabase[j]))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+GlobalRouteManagerLSDB::IsSameLSA (GlobalRoutingLSA* lsa1, GlobalRoutingLSA* lsa2)
+{
+  if (lsa1->GetLSType () != lsa2->GetLSType ()
+      || lsa1->GetLinkStateId () != lsa2->GetLinkStateId ()
+      || lsa1->GetAdvertisingRouter () != lsa2->GetAdvertisingRouter ()
+      || lsa1->GetNetworkLSANetworkMask () != lsa2->GetNetworkLSANetworkMask ()
+      || lsa1->GetNode () != lsa2->GetNode ()
+      || lsa1->GetNLinkRecords () != lsa2->GetNLinkRecords ()
+      || lsa1->GetNAttachedRouters () != lsa2->GetNAttachedRouters ())
+    {
+      return false;
+    }
+  for (uint32_t j = 0; j < lsa1->GetNLinkRecords (); j++)
+    {
+      GlobalRoutingLinkRecord *lr1 = lsa1->GetLinkRecord (j);
+      GlobalRoutingLinkRecord *lr2 = lsa2->GetLinkRecord (j);
+      if (lr1->GetLinkType () != lr2->GetLinkType ()
+          || lr1->GetLinkId () != lr2->GetLinkId ()
+          || lr1->GetLinkData () != lr2->GetLinkData ()
+          || lr1->GetMetric () != lr2->GetMetric ())
+        {
+          return false;
+        }
+    }
+  for (uint32_t j = 0; j < lsa1->GetNAttachedRouters (); j++)
+    {
+      if (lsa1->GetAttachedRouter (j) != lsa2->GetAttachedRouter (j))
+        {
+          return false;
+        }
+    }
+  return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -539,7 +637,9 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_spfrootNodeIndex (0),
+    m_spfrootLookups (0)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -700,6 +800,7 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 // Walk the list of nodes in the system.
 //
   NS_LOG_INFO ("About to start SPF calculation");
+  m_spfLookups.clear ();
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -724,12 +825,149 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 //
       if (rtr && rtr->GetNumLSAs () )
         {
-          SPFCalculate (rtr->GetRouterId ());
+          SPFCalculate (rtr->GetRouterId (), i - NodeList::Begin ());
         }
     }
   NS_LOG_INFO ("Finished SPF calculation");
 }
 
+//
+// Rebuild the link state database and compare it with the previous one.
+// Only the routers whose routes depend on a Link State Advertisement which
+// changed get their routes deleted and recomputed (see IsRootAffected).
+//
+void
+GlobalRouteManagerImpl::UpdateRoutes ()
+{
+  NS_LOG_FUNCTION (this);
+  GlobalRouteManagerLSDB *oldLsdb = m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+  std::set<Ipv4Address> changed;
+  m_lsdb->GetChangedLSAs (*oldLsdb, changed);
+  bool extChanged = !m_lsdb->HasSameExtLSAs (*oldLsdb);
+//
+// The SPF calculations also look up LSAs by the link data of their
+// TransitNetwork link records, in the old and in the new database.
+//
+  std::set<Ipv4Address> changedLinkData;
+  for (std::set<Ipv4Address>::const_iterator it = changed.begin (); it != changed.end (); it++)
+    {
+      GlobalRoutingLSA *lsas[] = { oldLsdb->GetLSA (*it), m_lsdb->GetLSA (*it) };
+      for (GlobalRoutingLSA *lsa : lsas)
+        {
+          for (uint32_t j = 0; lsa != 0 && j < lsa->GetNLinkRecords (); j++)
+            {
+              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+              if (lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+                {
+                  changedLinkData.insert (lr->GetLinkData ());
+                }
+            }
+        }
+    }
+  delete oldLsdb;
+  NS_LOG_LOGIC (changed.size () << " LSAs changed, external LSAs changed: " << extChanged);
+
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+      if (rtr == 0 || node->GetSystemId () != systemId)
+        {
+          continue;
+        }
+      if (!IsRootAffected (rtr->GetRouterId (), changed, changedLinkData, extChanged))
+        {
+          NS_LOG_LOGIC ("Keeping the routes of node " << node->GetId ());
+          continue;
+        }
+      Ptr<Ipv4GlobalRouting> gr = rtr->GetRoutingProtocol ();
+      uint32_t nRoutes = gr->GetNRoutes ();
+      NS_LOG_LOGIC ("Deleting " << nRoutes << " routes from node " << node->GetId ());
+      for (uint32_t j = 0; j < nRoutes; j++)
+        {
+          gr->RemoveRoute (0);
+        }
+      if (rtr->GetNumLSAs ())
+        {
+          SPFCalculate (rtr->GetRouterId (), i - NodeList::Begin ());
+        }
+    }
+}
+
+bool
+GlobalRouteManagerImpl::IsRootAffected (Ipv4Address root, const std::set<Ipv4Address> &changed,
+                                        const std::set<Ipv4Address> &changedLinkData,
+                                        bool extChanged) const
+{
+  NS_LOG_FUNCTION (this << root << extChanged);
+  if (changed.empty () && !extChanged)
+    {
+      return false;
+    }
+  if (changed.find (root) != changed.end ())
+    {
+      return true;
+    }
+  if (m_lsdb->GetLSA (root) == 0)
+    {
+      // no LSA, now and before: no route
+      return false;
+    }
+  std::map<Ipv4Address, SPFLookups>::const_iterator lookups = m_spfLookups.find (root);
+  if (lookups == m_spfLookups.end ())
+    {
+      // the routes were not computed by SPFCalculate
+      return true;
+    }
+  if (extChanged && lookups->second.externals)
+    {
+      return true;
+    }
+  const std::vector<Ipv4Address> &lsas = lookups->second.lsas;
+  for (std::set<Ipv4Address>::const_iterator it = changed.begin (); it != changed.end (); it++)
+    {
+      if (std::binary_search (lsas.begin (), lsas.end (), *it))
+        {
+          return true;
+        }
+    }
+  const std::vector<Ipv4Address> &linkData = lookups->second.linkData;
+  for (std::set<Ipv4Address>::const_iterator it = changedLinkData.begin (); it != changedLinkData.end (); it++)
+    {
+      if (std::binary_search (linkData.begin (), linkData.end (), *it))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+GlobalRoutingLSA*
+GlobalRouteManagerImpl::SPFGetLSA (Ipv4Address addr)
+{
+  NS_LOG_FUNCTION (this << addr);
+  if (m_spfrootLookups != 0)
+    {
+      m_spfrootLookups->lsas.push_back (addr);
+    }
+  return m_lsdb->GetLSA (addr);
+}
+
+GlobalRoutingLSA*
+GlobalRouteManagerImpl::SPFGetLSAByLinkData (Ipv4Address addr)
+{
+  NS_LOG_FUNCTION (this << addr);
+  if (m_spfrootLookups != 0)
+    {
+      m_spfrootLookups->linkData.push_back (addr);
+    }
+  return m_lsdb->GetLSAByLinkData (addr);
+}
+
 //
 // This method is derived from quagga ospf_spf_next ().  See RFC2328 Section 
 // 16.1 (2) for further details.
@@ -797,7 +1035,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // Lookup the link state advertisement of the new link -- we call it <w> in
 // the link state database.
 //
-              w_lsa = m_lsdb->GetLSA (l->GetLinkId ());
+              w_lsa = SPFGetLSA (l->GetLinkId ());
               NS_ASSERT (w_lsa);
               NS_LOG_LOGIC ("Found a P2P record from " << 
                             v->GetVertexId () << " to " << w_lsa->GetLinkStateId ());
@@ -805,7 +1043,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
           else if (l->GetLinkType () == 
                    GlobalRoutingLinkRecord::TransitNetwork)
             {
-              w_lsa = m_lsdb->GetLSA (l->GetLinkId ());
+              w_lsa = SPFGetLSA (l->GetLinkId ());
               NS_ASSERT (w_lsa);
               NS_LOG_LOGIC ("Found a Transit record from " << 
                             v->GetVertexId () << " to " << w_lsa->GetLinkStateId ());
@@ -818,7 +1056,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // Get w_lsa:  In case of V is Network-LSA
       if (v->GetVertexType () == SPFVertex::VertexNetwork) 
         {
-          w_lsa = m_lsdb->GetLSAByLinkData 
+          w_lsa = SPFGetLSAByLinkData 
               (v->GetLSA ()->GetAttachedRouter (i));
           if (!w_lsa)
             {
@@ -960,7 +1198,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // If we've changed the cost to get to the vertex represented by <w>, we 
 // must reorder the priority queue keyed to that cost.
 //
-                  candidate.Reorder ();
+                  candidate.Reorder (cw);
                 }
             } // new lower cost path found
         } // end W is already on the candidate list
@@ -1250,6 +1488,23 @@ GlobalRouteManagerImpl::DebugSPFCalculate (Ipv4Address root)
   SPFCalculate (root);
 }
 
+void
+GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
+{
+  NS_LOG_FUNCTION (this << root);
+  uint32_t rootNodeIndex = 0;
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++, rootNodeIndex++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      if (rtr != 0 && rtr->GetRouterId () == root)
+        {
+          break;
+        }
+    }
+  SPFCalculate (root, rootNodeIndex);
+}
+
 //
 // Used to test if a node is a stub, from an OSPF sense.
 // If there is only one link of type 1 or 2, then a default route
@@ -1260,7 +1515,7 @@ bool
 GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
 {
   NS_LOG_FUNCTION (this << root);
-  GlobalRoutingLSA *rlsa = m_lsdb->GetLSA (root);
+  GlobalRoutingLSA *rlsa = SPFGetLSA (root);
   Ipv4Address myRouterId = rlsa->GetLinkStateId ();
   int transits = 0;
   GlobalRoutingLinkRecord *transitLink = 0;
@@ -1304,7 +1559,7 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
           // Install default route to next hop
           // The link record LinkID is the router ID of the peer.
           // The Link Data is the local IP interface address
-          GlobalRoutingLSA *w_lsa = m_lsdb->GetLSA (transitLink->GetLinkId ());
+          GlobalRoutingLSA *w_lsa = SPFGetLSA (transitLink->GetLinkId ());
           uint32_t nLinkRecords = w_lsa->GetNLinkRecords ();
           for (uint32_t j = 0; j < nLinkRecords; ++j)
             {
@@ -1339,9 +1594,9 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
 
 // quagga ospf_spf_calculate
 void
-GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
+GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root, uint32_t rootNodeIndex)
 {
-  NS_LOG_FUNCTION (this << root);
+  NS_LOG_FUNCTION (this << root << rootNodeIndex);
 
   SPFVertex *v;
 //
@@ -1349,6 +1604,13 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
   m_lsdb->Initialize ();
 //
+// Record the LSAs this calculation depends on, for UpdateRoutes.
+//
+  m_spfrootLookups = &m_spfLookups[root];
+  m_spfrootLookups->lsas.clear ();
+  m_spfrootLookups->linkData.clear ();
+  m_spfrootLookups->externals = false;
+//
 // The candidate queue is a priority queue of SPFVertex objects, with the top
 // of the queue being the closest vertex in terms of distance from the root
 // of the tree.  Initially, this queue is empty.
@@ -1366,6 +1628,7 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // We also mark this vertex as being in the SPF tree.
 //
   m_spfroot= v;
+  m_spfrootNodeIndex = rootNodeIndex;
   v->SetDistanceFromRoot (0);
   v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
   NS_LOG_LOGIC ("Starting SPFCalculate for node " << root);
@@ -1381,6 +1644,7 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
       delete m_spfroot;
+      SPFFinishLookups ();
       return;
     }
 
@@ -1487,6 +1751,7 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 
 // Second stage of SPF calculation procedure
   SPFProcessStubs (m_spfroot);
+  m_spfrootLookups->externals = true;
   for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs (); i++)
     {
       m_spfroot->ClearVertexProcessed ();
@@ -1502,6 +1767,24 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
   delete m_spfroot;
   m_spfroot = 0;
+  SPFFinishLookups ();
+}
+
+void
+GlobalRouteManagerImpl::SPFFinishLookups ()
+{
+  NS_LOG_FUNCTION (this);
+//
+// Sort the lookups for IsRootAffected, and drop the duplicates of the
+// LSAs reached through several links.
+//
+  std::vector<Ipv4Address> &lsas = m_spfrootLookups->lsas;
+  std::sort (lsas.begin (), lsas.end ());
+  lsas.erase (std::unique (lsas.begin (), lsas.end ()), lsas.end ());
+  std::vector<Ipv4Address> &linkData = m_spfrootLookups->linkData;
+  std::sort (linkData.begin (), linkData.end ());
+  linkData.erase (std::unique (linkData.begin (), linkData.end ()), linkData.end ());
+  m_spfrootLookups = 0;
 }
 
 void
@@ -1562,9 +1845,10 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
 //
 // We need to walk the list of nodes looking for the one that has the router
 // ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// the routing information to.  SPFCalculate has found its index, so the walk
+// starts there.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
+  NodeList::Iterator i = NodeList::Begin () + m_spfrootNodeIndex;
   NodeList::Iterator listEnd = NodeList::End ();
   for (; i != listEnd; i++)
     {
@@ -1731,9 +2015,10 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
 //
 // We need to walk the list of nodes looking for the one that has the router
 // ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// the routing information to.  SPFCalculate has found its index, so the walk
+// starts there.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
+  NodeList::Iterator i = NodeList::Begin () + m_spfrootNodeIndex;
   NodeList::Iterator listEnd = NodeList::End ();
   for (; i != listEnd; i++)
     {
@@ -1855,9 +2140,10 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 //
 // Walk the list of nodes in the system looking for the one corresponding to
 // the node at the root of the SPF tree.  This is the node for which we are
-// building the routing table.
+// building the routing table.  SPFCalculate has found its index, so the walk
+// starts there.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
+  NodeList::Iterator i = NodeList::Begin () + m_spfrootNodeIndex;
   NodeList::Iterator listEnd = NodeList::End ();
   for (; i != listEnd; i++)
     {
@@ -1946,9 +2232,10 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 //
 // We need to walk the list of nodes looking for the one that has the router
 // ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// the routing information to.  SPFCalculate has found its index, so the walk
+// starts there.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
+  NodeList::Iterator i = NodeList::Begin () + m_spfrootNodeIndex;
   NodeList::Iterator listEnd = NodeList::End ();
   for (; i != listEnd; i++)
     {
@@ -2091,9 +2378,10 @@ GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
 //
 // We need to walk the list of nodes looking for the one that has the router
 // ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// the routing information to.  SPFCalculate has found its index, so the walk
+// starts there.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
+  NodeList::Iterator i = NodeList::Begin () + m_spfrootNodeIndex;
   NodeList::Iterator listEnd = NodeList::End ();
   for (; i != listEnd; i++)
     {
@@ -26,7 +26,9 @@
 #include <list>
 #include <queue>
 #include <map>
+#include <set>
 #include <vector>
+#include <unordered_map>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4-address.h"
@@ -538,6 +540,7 @@ private:
   ListOfSPFVertex_t m_parents; //!< parent list
   ListOfSPFVertex_t m_children; //!< Children list
   bool m_vertexProcessed; //!< Flag to note whether vertex has been processed in stage two of SPF computation
+  uint32_t m_candidateIndex; //!< index of the vertex in the CandidateQueue heap, maintained by the queue
 
 /**
  * @brief The SPFVertex copy construction is disallowed.  There's no need for
@@ -562,6 +565,8 @@ private:
    * \returns the reference to the output stream
    */
   friend std::ostream& operator<< (std::ostream& os, const SPFVertex::ListOfSPFVertex_t& vs);
+
+  friend class CandidateQueue;
 };
 
 /**
@@ -674,13 +679,47 @@ public:
    */
   uint32_t GetNumExtLSAs () const;
 
+  /**
+   * @brief Find the Link State Advertisements that differ between this
+   * database and another one.
+   *
+   * The External Link State Advertisements are not considered.
+   *
+   * @param lsdb the other database
+   * @param changed the set the IP addresses of the LSAs present in only
+   * one of the databases, or with different contents, are added to
+   */
+  void GetChangedLSAs (const GlobalRouteManagerLSDB &lsdb,
+                       std::set<Ipv4Address> &changed) const;
+
+  /**
+   * @brief Compare the External Link State Advertisements of this
+   * database and of another one.
+   *
+   * @param lsdb the other database
+   * @returns true if both databases hold the same External LSAs, in the
+   * same order
+   */
+  bool HasSameExtLSAs (const GlobalRouteManagerLSDB &lsdb) const;
 
 private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
   typedef std::pair<Ipv4Address, GlobalRoutingLSA*> LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
 
+  /**
+   * @brief Compare the contents of two Link State Advertisements, except
+   * their SPF status.
+   *
+   * @param lsa1 the first LSA
+   * @param lsa2 the second LSA
+   * @returns true if the LSAs have the same contents
+   */
+  static bool IsSameLSA (GlobalRoutingLSA* lsa1, GlobalRoutingLSA* lsa2);
+
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
+  /// the LSAs of m_database with a TransitNetwork link record, by link data
+  std::unordered_map<Ipv4Address, LSDBPair_t, Ipv4AddressHash> m_linkDataIndex;
 
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
@@ -735,6 +774,17 @@ public:
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database, and recompute the routes of the
+ * routers affected by the changes of the Link State Advertisements since
+ * the previous computation
+ *
+ * This is equivalent to DeleteGlobalRoutes (), BuildGlobalRoutingDatabase ()
+ * and InitializeRoutes (), except that the routing tables of the routers
+ * whose routes cannot have changed are left untouched.
+ */
+  virtual void UpdateRoutes ();
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  */
@@ -766,8 +816,41 @@ private:
  */
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
+  /**
+   * \brief The Link State Advertisements looked up by the SPF calculation
+   * of a router, which its routes depend on
+   */
+  struct SPFLookups
+  {
+    std::vector<Ipv4Address> lsas; //!< the link state IDs looked up, sorted
+    std::vector<Ipv4Address> linkData; //!< the link data looked up, sorted
+    bool externals; //!< whether the External LSAs were processed
+  };
+
   SPFVertex* m_spfroot; //!< the root node
+  /// the index in the NodeList of the node of m_spfroot, or the number of nodes if none
+  uint32_t m_spfrootNodeIndex;
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+  std::map<Ipv4Address, SPFLookups> m_spfLookups; //!< the lookups of the last SPF calculation of each router
+  SPFLookups* m_spfrootLookups; //!< the lookups of the SPF calculation in progress, if any
+
+  /**
+   * \brief Look up an LSA by its link state ID, and record the lookup in
+   * m_spfrootLookups
+   *
+   * \param addr the link state ID
+   * \returns the LSA, or 0 if none
+   */
+  GlobalRoutingLSA* SPFGetLSA (Ipv4Address addr);
+
+  /**
+   * \brief Look up an LSA by the link data of one of its TransitNetwork
+   * link records, and record the lookup in m_spfrootLookups
+   *
+   * \param addr the link data
+   * \returns the LSA, or 0 if none
+   */
+  GlobalRoutingLSA* SPFGetLSAByLinkData (Ipv4Address addr);
 
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
@@ -789,6 +872,39 @@ private:
    */
   void SPFCalculate (Ipv4Address root);
 
+  /**
+   * \brief Calculate the shortest path first (SPF) tree
+   *
+   * \param root the root node
+   * \param rootNodeIndex the index in the NodeList of the node of the root
+   */
+  void SPFCalculate (Ipv4Address root, uint32_t rootNodeIndex);
+
+  /**
+   * \brief Sort the lookups of the SPF calculation in progress, and stop
+   * recording them
+   */
+  void SPFFinishLookups ();
+
+  /**
+   * \brief Test if the routes of a router may have changed.
+   *
+   * The routes of a router only depend on the Link State Advertisements
+   * its last SPF calculation looked up.  An LSA which was not looked up
+   * can only be reached now through a link record added to one that was,
+   * which then changed too.
+   *
+   * \param root the router
+   * \param changed the link state IDs of the LSAs which changed since the
+   * previous computation
+   * \param changedLinkData the link data of the TransitNetwork link records
+   * of the LSAs which changed, before and after the change
+   * \param extChanged whether the External LSAs changed
+   * \returns true if the routes of the router must be recomputed
+   */
+  bool IsRootAffected (Ipv4Address root, const std::set<Ipv4Address> &changed,
+                       const std::set<Ipv4Address> &changedLinkData, bool extChanged) const;
+
   /**
    * \brief Process Stub nodes
    *
@@ -65,6 +65,17 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and recompute the routes of the nodes
+ * affected by the changes since the previous computation
+ *
+ * The result is the same as DeleteGlobalRoutes (), BuildGlobalRoutingDatabase ()
+ * and InitializeRoutes (), but the routing tables of the nodes whose routes
+ * cannot have changed (e.g., stub nodes far from the change) are left
+ * untouched.
+ */
+  static void UpdateRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IP_PREFIX_TRIE_H
+#define IP_PREFIX_TRIE_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4Routing
+ * \ingroup ipv6Routing
+ *
+ * \brief Binary trie indexing values by IP prefix, used by the routing
+ * protocols to find the routes matching a destination without scanning
+ * their whole routing table.
+ *
+ * Addresses and prefixes are given as arrays of bytes in network order
+ * (as produced by Ipv4Address::Serialize or Ipv6Address::GetBytes), so
+ * that the same trie serves IPv4 and IPv6. Several values can be stored
+ * for the same prefix (e.g., equal-cost routes); they are kept in
+ * insertion order.
+ *
+ * The trie is meant to be rebuilt from the routing table when the table
+ * changes: values cannot be removed one by one, but Clear () keeps the
+ * memory of the nodes for the next build. A lookup visits at most one
+ * node per bit of the address, regardless of the number of prefixes.
+ *
+ * \tparam T the type of the values
+ */
+template <typename T>
+class IpPrefixTrie
+{
+public:
+  IpPrefixTrie ();
+
+  /**
+   * \brief Remove all the values.
+   */
+  void Clear (void);
+
+  /**
+   * \brief Add a value.
+   * \param prefix the prefix bytes, in network order; the bits beyond
+   * the prefix length are ignored
+   * \param prefixLength the length of the prefix, in bits
+   * \param value the value
+   */
+  void Insert (const uint8_t *prefix, uint8_t prefixLength, const T &value);
+
+  /**
+   * \brief Find the prefixes matching an address.
+   *
+   * The value lists of the matching prefixes are stored in the matches
+   * array, from the shortest to the longest prefix. Prefixes without
+   * values are skipped.
+   *
+   * \param address the address bytes, in network order
+   * \param addressLength the length of the address, in bits
+   * \param matches an array of at least addressLength + 1 elements
+   * \return the number of matching prefixes
+   */
+  uint32_t Lookup (const uint8_t *address, uint8_t addressLength,
+                   const std::vector<T> **matches) const;
+
+private:
+  /// A node of the trie
+  struct Node
+  {
+    uint32_t m_children[2]; //!< indexes of the children (0 if none)
+    std::vector<T> m_values; //!< values stored for the prefix of this node
+  };
+
+  /**
+   * \brief Get a bit of an address.
+   * \param address the address bytes
+   * \param bit the index of the bit, from the most significant one
+   * \return the bit
+   */
+  static uint8_t GetBit (const uint8_t *address, uint8_t bit);
+
+  std::vector<Node> m_nodes; //!< the nodes; the first one is the root
+  uint32_t m_usedNodes;      //!< number of nodes in use
+};
+
+template <typename T>
+IpPrefixTrie<T>::IpPrefixTrie ()
+  : m_nodes (1),
+    m_usedNodes (1)
+{
+  m_nodes[0].m_children[0] = 0;
+  m_nodes[0].m_children[1] = 0;
+}
+
+template <typename T>
+void
+IpPrefixTrie<T>::Clear (void)
+{
+  // the nodes beyond m_usedNodes are reset when they are reused
+  m_usedNodes = 1;
+  m_nodes[0].m_children[0] = 0;
+  m_nodes[0].m_children[1] = 0;
+  m_nodes[0].m_values.clear ();
+}
+
+template <typename T>
+uint8_t
+IpPrefixTrie<T>::GetBit (const uint8_t *address, uint8_t bit)
+{
+  return (address[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+template <typename T>
+void
+IpPrefixTrie<T>::Insert (const uint8_t *prefix, uint8_t prefixLength, const T &value)
+{
+  uint32_t node = 0;
+  for (uint8_t bit = 0; bit < prefixLength; bit++)
+    {
+      uint8_t b = GetBit (prefix, bit);
+      uint32_t child = m_nodes[node].m_children[b];
+      if (child == 0)
+        {
+          child = m_usedNodes++;
+          if (child == m_nodes.size ())
+            {
+              m_nodes.push_back (Node ());
+            }
+          m_nodes[child].m_children[0] = 0;
+          m_nodes[child].m_children[1] = 0;
+          m_nodes[child].m_values.clear ();
+          m_nodes[node].m_children[b] = child;
+        }
+      node = child;
+    }
+  m_nodes[node].m_values.push_back (value);
+}
+
+template <typename T>
+uint32_t
+IpPrefixTrie<T>::Lookup (const uint8_t *address, uint8_t addressLength,
+                         const std::vector<T> **matches) const
+{
+  uint32_t nMatches = 0;
+  uint32_t node = 0;
+  for (uint8_t bit = 0; ; bit++)
+    {
+      const Node &n = m_nodes[node];
+      if (!n.m_values.empty ())
+        {
+          matches[nMatches++] = &n.m_values;
+        }
+      if (bit == addressLength)
+        {
+          break;
+        }
+      node = n.m_children[GetBit (address, bit)];
+      if (node == 0)
+        {
+          break;
+        }
+    }
+  NS_ASSERT (nMatches <= addressLength + 1u);
+  return nMatches;
+}
+
+} // namespace ns3
+
+#endif /* IP_PREFIX_TRIE_H */
@@ -22,6 +22,8 @@
 #include "ipv4-end-point.h"
 #include "ipv4-interface-address.h"
 #include "ns3/log.h"
+#include <algorithm>
+#include <vector>
 
 
 namespace ns3 {
@@ -43,30 +45,113 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_ports.clear ();
+  m_index.clear ();
+  m_entries.clear ();
+}
+
+Ipv4EndPointDemux::Tuple::Tuple ()
+  : m_localPort (0),
+    m_peerPort (0)
+{
+}
+
+Ipv4EndPointDemux::Tuple::Tuple (Ipv4Address localAddress, uint16_t localPort,
+                                 Ipv4Address peerAddress, uint16_t peerPort)
+  : m_localAddress (localAddress),
+    m_localPort (localPort),
+    m_peerAddress (peerAddress),
+    m_peerPort (peerPort)
+{
 }
 
 bool
-Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv4EndPointDemux::Tuple::operator== (const Tuple &other) const
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  return m_localPort == other.m_localPort
+         && m_peerPort == other.m_peerPort
+         && m_localAddress == other.m_localAddress
+         && m_peerAddress == other.m_peerAddress;
+}
+
+size_t
+Ipv4EndPointDemux::TupleHash::operator() (const Tuple &tuple) const
+{
+  uint64_t addresses = (static_cast<uint64_t> (tuple.m_localAddress.Get ()) << 32)
+    | tuple.m_peerAddress.Get ();
+  uint64_t ports = (static_cast<uint64_t> (tuple.m_localPort) << 16) | tuple.m_peerPort;
+  uint64_t h = (addresses ^ (ports * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
+Ipv4EndPointDemux::Tuple
+Ipv4EndPointDemux::GetTuple (Ipv4EndPoint *endPoint)
+{
+  return Tuple (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  Entry entry;
+  entry.m_all = m_endPoints.insert (m_endPoints.end (), endPoint);
+  EndPoints &portEndPoints = m_ports[endPoint->GetLocalPort ()];
+  entry.m_port = portEndPoints.insert (portEndPoints.end (), endPoint);
+  entry.m_tuple = GetTuple (endPoint);
+  m_index.insert (std::make_pair (entry.m_tuple, endPoint));
+  m_entries[endPoint] = entry;
+  endPoint->SetChangeCallback (MakeCallback (&Ipv4EndPointDemux::Reindex, this));
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void
+Ipv4EndPointDemux::RemoveFromIndex (Ipv4EndPoint *endPoint, const Tuple &tuple)
+{
+  std::pair<Index::iterator, Index::iterator> range = m_index.equal_range (tuple);
+  for (Index::iterator i = range.first; i != range.second; i++)
     {
-      if ((*i)->GetLocalPort  () == port) 
+      if (i->second == endPoint)
         {
-          return true;
+          m_index.erase (i);
+          return;
         }
     }
-  return false;
+  NS_ASSERT_MSG (false, "End point " << endPoint << " is not indexed");
+}
+
+void
+Ipv4EndPointDemux::Reindex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  std::unordered_map<Ipv4EndPoint *, Entry>::iterator entry = m_entries.find (endPoint);
+  NS_ASSERT (entry != m_entries.end ());
+  RemoveFromIndex (endPoint, entry->second.m_tuple);
+  entry->second.m_tuple = GetTuple (endPoint);
+  m_index.insert (std::make_pair (entry->second.m_tuple, endPoint));
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<uint16_t, EndPoints>::iterator portEndPoints = m_ports.find (port);
+  if (portEndPoints == m_ports.end ())
+    {
+      return false;
+    }
+  for (EndPointsI i = portEndPoints->second.begin (); i != portEndPoints->second.end (); i++) 
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr &&
+      if ((*i)->GetLocalAddress () == addr &&
           (*i)->GetBoundNetDevice () == boundNetDevice)
         {
           return true;
@@ -85,10 +170,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
 }
 
 Ipv4EndPoint *
@@ -101,10 +183,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -124,10 +203,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv4Address address,
       NS_LOG_WARN ("Duplicated endpoint.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -136,13 +212,11 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::pair<Index::iterator, Index::iterator> range =
+    m_index.equal_range (Tuple (localAddress, localPort, peerAddress, peerPort));
+  for (Index::iterator i = range.first; i != range.second; i++)
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress &&
-          ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+      if (i->second->GetBoundNetDevice () == boundNetDevice || i->second->GetBoundNetDevice () == 0)
         {
           NS_LOG_WARN ("Duplicated endpoint.");
           return 0;
@@ -150,26 +224,28 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void 
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<Ipv4EndPoint *, Entry>::iterator entry = m_entries.find (endPoint);
+  if (entry == m_entries.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
     }
+  RemoveFromIndex (endPoint, entry->second.m_tuple);
+  std::unordered_map<uint16_t, EndPoints>::iterator portEndPoints = m_ports.find (endPoint->GetLocalPort ());
+  portEndPoints->second.erase (entry->second.m_port);
+  if (portEndPoints->second.empty ())
+    {
+      m_ports.erase (portEndPoints);
+    }
+  m_endPoints.erase (entry->second.m_all);
+  m_entries.erase (entry);
+  delete endPoint;
 }
 
 /*
@@ -189,54 +265,29 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
   return ret;
 }
 
-
-/*
- * If we have an exact match, we return it.
- * Otherwise, if we find a generic match, we return it.
- * Otherwise, we return 0.
- */
-Ipv4EndPointDemux::EndPoints
-Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport, 
-                           Ipv4Address saddr, uint16_t sport,
-                           Ptr<Ipv4Interface> incomingInterface)
+void
+Ipv4EndPointDemux::LookupTuple (const Tuple &tuple, Ptr<Ipv4Interface> incomingInterface,
+                                EndPoints &endPoints)
 {
-  NS_LOG_FUNCTION (this << daddr << dport << saddr << sport << incomingInterface);
-  
-  EndPoints retval1; // Matches exact on local port, wildcards on others
-  EndPoints retval2; // Matches exact on local port/adder, wildcards on others
-  EndPoints retval3; // Matches all but local address
-  EndPoints retval4; // Exact match on all 4
-
-  NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr << ":" << dport);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  NS_LOG_FUNCTION (this << tuple.m_localAddress << tuple.m_localPort
+                        << tuple.m_peerAddress << tuple.m_peerPort);
+  std::pair<Index::iterator, Index::iterator> range = m_index.equal_range (tuple);
+  for (Index::iterator i = range.first; i != range.second; i++)
     {
-      Ipv4EndPoint* endP = *i;
-
-      NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
-                                                 << " daddr=" << endP->GetLocalAddress ()
-                                                 << " sport=" << endP->GetPeerPort ()
-                                                 << " saddr=" << endP->GetPeerAddress ());
+      Ipv4EndPoint* endP = i->second;
 
       if (!endP->IsRxEnabled ())
         {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
+          NS_LOG_LOGIC ("Skipping endpoint " << endP
                         << " because endpoint can not receive packets");
           continue;
         }
 
-      if (endP->GetLocalPort () != dport) 
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
       if (endP->GetBoundNetDevice ())
         {
           if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
             {
-              NS_LOG_LOGIC ("Skipping endpoint " << &endP
+              NS_LOG_LOGIC ("Skipping endpoint " << endP
                                                  << " because endpoint is bound to specific device and"
                                                  << endP->GetBoundNetDevice ()
                                                  << " does not match packet device " << incomingInterface->GetDevice ());
@@ -244,93 +295,77 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
             }
         }
 
-      bool localAddressMatchesExact = false;
-      bool localAddressIsAny = false;
-      bool localAddressIsSubnetAny = false;
+      NS_LOG_LOGIC ("Found endpoint " << endP << " " << endP->GetLocalAddress () << ":" << endP->GetLocalPort ()
+                                      << " " << endP->GetPeerAddress () << ":" << endP->GetPeerPort ());
+      endPoints.push_back (endP);
+    }
+}
+
+/*
+ * If we have an exact match, we return it.
+ * Otherwise, if we find a generic match, we return it.
+ * Otherwise, we return 0.
+ */
+Ipv4EndPointDemux::EndPoints
+Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport, 
+                           Ipv4Address saddr, uint16_t sport,
+                           Ptr<Ipv4Interface> incomingInterface)
+{
+  NS_LOG_FUNCTION (this << daddr << dport << saddr << sport << incomingInterface);
 
-      // We have 3 cases:
-      // 1) Exact local / destination address match
-      // 2) Local endpoint bound to Any -> matches anything
-      // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g., x.y.z.255 in a /24 net) and direct destination match.
+  NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr << ":" << dport);
+  EndPoints retval;
+  if (m_ports.find (dport) == m_ports.end ())
+    {
+      return retval;
+    }
 
-      if (endP->GetLocalAddress () == daddr)
-        {
-          // Case 1:
-          localAddressMatchesExact = true;
-        }
-      else if (endP->GetLocalAddress () == Ipv4Address::GetAny ())
+  // Exact match on all 4 - this is the case of an open TCP connection, for example.
+  LookupTuple (Tuple (daddr, dport, saddr, sport), incomingInterface, retval);
+  if (retval.empty ())
+    {
+      // The local addresses that match the destination as wildcards:
+      // Any, and x.y.z.0 for a subnet-directed broadcast packet (e.g.,
+      // x.y.z.255 in a /24 net) or a direct destination in the subnet of
+      // an address of the incoming interface.  An end point whose local
+      // address is the destination address is an exact match instead.
+      std::vector<Ipv4Address> wildcards;
+      if (daddr != Ipv4Address::GetAny ())
         {
-          // Case 2:
-          localAddressIsAny = true;
+          wildcards.push_back (Ipv4Address::GetAny ());
         }
-      else
+      for (uint32_t i = 0; incomingInterface && i < incomingInterface->GetNAddresses (); i++)
         {
-          // Case 3:
-          for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+          Ipv4Address addrNetpart = addr.GetLocal ().CombineMask (addr.GetMask ());
+          if (addrNetpart != daddr && addrNetpart != Ipv4Address::GetAny ()
+              && daddr.CombineMask (addr.GetMask ()) == addrNetpart
+              && std::find (wildcards.begin (), wildcards.end (), addrNetpart) == wildcards.end ())
             {
-              Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-
-              Ipv4Address addrNetpart = addr.GetLocal ().CombineMask (addr.GetMask ());
-              if (endP->GetLocalAddress () == addrNetpart)
-                {
-                  NS_LOG_LOGIC ("Endpoint is SubnetDirectedAny " << endP->GetLocalAddress () << "/" << addr.GetMask ().GetPrefixLength ());
-
-                  Ipv4Address daddrNetPart = daddr.CombineMask (addr.GetMask ());
-                  if (addrNetpart == daddrNetPart)
-                    {
-                      localAddressIsSubnetAny = true;
-                    }
-                }
+              wildcards.push_back (addrNetpart);
             }
-
-          // if no match here, keep looking
-          if (!localAddressIsSubnetAny)
-            continue;
         }
 
-      bool remotePortMatchesExact = endP->GetPeerPort () == sport;
-      bool remotePortMatchesWildCard = endP->GetPeerPort () == 0;
-      bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
-      bool remoteAddressMatchesWildCard = endP->GetPeerAddress () == Ipv4Address::GetAny ();
-
-      // If remote does not match either with exact or wildcard,
-      // skip this one
-      if (!(remotePortMatchesExact || remotePortMatchesWildCard))
-        continue;
-      if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        continue;
-
-      bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
-
-      if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All 4 match - this is the case of an open TCP connection, for example.
-          NS_LOG_LOGIC ("Found an endpoint for case 4, adding " << endP->GetLocalAddress () << ":" << endP->GetLocalPort ());
-          retval4.push_back (endP);
-        }
-      if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All but local address - no idea what this case could be.
-          NS_LOG_LOGIC ("Found an endpoint for case 3, adding " << endP->GetLocalAddress () << ":" << endP->GetLocalPort ());
-          retval3.push_back (endP);
+      // All but local address - no idea what this case could be.
+      for (std::vector<Ipv4Address>::iterator i = wildcards.begin (); i != wildcards.end (); i++)
+        {
+          LookupTuple (Tuple (*i, dport, saddr, sport), incomingInterface, retval);
         }
-      if (localAddressMatchesExact && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
-        { // Only local port and local address matches exactly - Not yet opened connection
-          NS_LOG_LOGIC ("Found an endpoint for case 2, adding " << endP->GetLocalAddress () << ":" << endP->GetLocalPort ());
-          retval2.push_back (endP);
+      // Only local port and local address matches exactly - Not yet opened connection
+      if (retval.empty ())
+        {
+          LookupTuple (Tuple (daddr, dport, Ipv4Address::GetAny (), 0), incomingInterface, retval);
         }
-      if (localAddressMatchesWildCard && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
-        { // Only local port matches exactly - Endpoint open to "any" connection
-          NS_LOG_LOGIC ("Found an endpoint for case 1, adding " << endP->GetLocalAddress () << ":" << endP->GetLocalPort ());
-          retval1.push_back (endP);
+      // Only local port matches exactly - Endpoint open to "any" connection
+      if (retval.empty ())
+        {
+          for (std::vector<Ipv4Address>::iterator i = wildcards.begin (); i != wildcards.end (); i++)
+            {
+              LookupTuple (Tuple (*i, dport, Ipv4Address::GetAny (), 0), incomingInterface, retval);
+            }
         }
     }
 
-  // Here we find the most exact match
-  EndPoints retval;
-  if (!retval4.empty ()) retval = retval4;
-  else if (!retval3.empty ()) retval = retval3;
-  else if (!retval2.empty ()) retval = retval2;
-  else retval = retval1;
-
   NS_ABORT_MSG_IF (retval.size () > 1, "Too many endpoints - perhaps you created too many sockets without binding them to different NetDevices.");
   return retval;  // might be empty if no matches
 }
@@ -343,16 +378,18 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  std::unordered_map<uint16_t, EndPoints>::iterator portEndPoints = m_ports.find (dport);
+  if (portEndPoints == m_ports.end ())
+    {
+      return 0;
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (EndPointsI i = portEndPoints->second.begin (); i != portEndPoints->second.end (); i++) 
     {
-      if ((*i)->GetLocalPort () != dport) 
-        {
-          continue;
-        }
       if ((*i)->GetLocalAddress () == daddr &&
           (*i)->GetPeerPort () == sport &&
           (*i)->GetPeerAddress () == saddr) 
@@ -47,6 +47,7 @@ Ipv4EndPoint::~Ipv4EndPoint ()
   m_rxCallback.Nullify ();
   m_icmpCallback.Nullify ();
   m_destroyCallback.Nullify ();
+  m_changeCallback.Nullify ();
 }
 
 Ipv4Address 
@@ -61,6 +62,10 @@ Ipv4EndPoint::SetLocalAddress (Ipv4Address address)
 {
   NS_LOG_FUNCTION (this << address);
   m_localAddr = address;
+  if (!m_changeCallback.IsNull ())
+    {
+      m_changeCallback (this);
+    }
 }
 
 uint16_t 
@@ -90,6 +95,10 @@ Ipv4EndPoint::SetPeer (Ipv4Address address, uint16_t port)
   NS_LOG_FUNCTION (this << address << port);
   m_peerAddr = address;
   m_peerPort = port;
+  if (!m_changeCallback.IsNull ())
+    {
+      m_changeCallback (this);
+    }
 }
 
 void
@@ -128,6 +137,13 @@ Ipv4EndPoint::SetDestroyCallback (Callback<void> callback)
   m_destroyCallback = callback;
 }
 
+void 
+Ipv4EndPoint::SetChangeCallback (Callback<void, Ipv4EndPoint *> callback)
+{
+  NS_LOG_FUNCTION (this << &callback);
+  m_changeCallback = callback;
+}
+
 void 
 Ipv4EndPoint::ForwardUp (Ptr<Packet> p, const Ipv4Header& header, uint16_t sport,
                          Ptr<Ipv4Interface> incomingInterface)
@@ -141,6 +141,15 @@ public:
    */
   void SetDestroyCallback (Callback<void> callback);
 
+  /**
+   * \brief Set the callback invoked when the local address or the peer
+   * of the end point change.
+   *
+   * It is used by the Ipv4EndPointDemux to keep its index up to date.
+   * \param callback callback function
+   */
+  void SetChangeCallback (Callback<void, Ipv4EndPoint *> callback);
+
   /**
    * \brief Forward the packet to the upper level.
    *
@@ -223,6 +232,11 @@ private:
    */
   Callback<void> m_destroyCallback;
 
+  /**
+   * \brief The change callback.
+   */
+  Callback<void, Ipv4EndPoint *> m_changeCallback;
+
   /**
    * \brief true if the endpoint can receive packets.
    */
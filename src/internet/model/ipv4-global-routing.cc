@@ -17,6 +17,7 @@
 //
 
 #include <vector>
+#include <algorithm>
 #include <iomanip>
 #include "ns3/names.h"
 #include "ns3/log.h"
@@ -53,13 +54,21 @@ Ipv4GlobalRouting::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&Ipv4GlobalRouting::m_respondToInterfaceEvents),
                    MakeBooleanChecker ())
+    .AddAttribute ("IncrementalUpdates",
+                   "Set to true if, upon Interface notification events, only the routes of the nodes which may be affected are recomputed",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4GlobalRouting::m_incrementalUpdates),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_incrementalUpdates (false),
+    m_routeTriesValid (false),
+    m_routeTriesUsable (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -80,6 +89,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_routeTriesValid = false;
 }
 
 void 
@@ -90,6 +100,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_routeTriesValid = false;
 }
 
 void 
@@ -105,6 +116,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_routeTriesValid = false;
 }
 
 void 
@@ -118,6 +130,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_routeTriesValid = false;
 }
 
 void 
@@ -133,6 +146,7 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  m_routeTriesValid = false;
 }
 
 
@@ -146,71 +160,92 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
-  NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  UpdateRouteTries ();
+  if (m_routeTriesUsable)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      uint8_t destBytes[4];
+      dest.Serialize (destBytes);
+      // the host routes, then the network routes (whatever their mask),
+      // then the first external route are considered, as in the scan below
+      // without random ECMP routing, only the first route is used
+      CollectRoutes (m_hostRouteTrie, destBytes, oif, !m_randomEcmpRouting, allRoutes);
+      if (allRoutes.size () == 0)
         {
-          if (oif != 0)
-            {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
-            }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
+          CollectRoutes (m_networkRouteTrie, destBytes, oif, !m_randomEcmpRouting, allRoutes);
+        }
+      if (allRoutes.size () == 0)
+        {
+          CollectRoutes (m_ASexternalRouteTrie, destBytes, oif, true, allRoutes);
         }
     }
-  if (allRoutes.size () == 0) // if no host route is found
+  else
     {
-      NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
+      for (HostRoutesCI i = m_hostRoutes.begin (); 
+           i != m_hostRoutes.end (); 
+           i++) 
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          NS_ASSERT ((*i)->IsHost ());
+          if ((*i)->GetDest ().IsEqual (dest)) 
             {
               if (oif != 0)
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
+                  if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
                     {
                       NS_LOG_LOGIC ("Not on requested interface, skipping");
                       continue;
                     }
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
+              allRoutes.push_back (*i);
+              NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
             }
         }
-    }
-  if (allRoutes.size () == 0)  // consider external if no host/network found
-    {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      if (allRoutes.size () == 0) // if no host route is found
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
+          for (NetworkRoutesI j = m_networkRoutes.begin (); 
+               j != m_networkRoutes.end (); 
+               j++) 
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
+              Ipv4Mask mask = (*j)->GetDestNetworkMask ();
+              Ipv4Address entry = (*j)->GetDestNetwork ();
+              if (mask.IsMatch (dest, entry)) 
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
+                  if (oif != 0)
                     {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
+                      if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
+                        {
+                          NS_LOG_LOGIC ("Not on requested interface, skipping");
+                          continue;
+                        }
                     }
+                  allRoutes.push_back (*j);
+                  NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
+                }
+            }
+        }
+      if (allRoutes.size () == 0)  // consider external if no host/network found
+        {
+          for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
+               k != m_ASexternalRoutes.end ();
+               k++)
+            {
+              Ipv4Mask mask = (*k)->GetDestNetworkMask ();
+              Ipv4Address entry = (*k)->GetDestNetwork ();
+              if (mask.IsMatch (dest, entry))
+                {
+                  NS_LOG_LOGIC ("Found external route" << *k);
+                  if (oif != 0)
+                    {
+                      if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
+                        {
+                          NS_LOG_LOGIC ("Not on requested interface, skipping");
+                          continue;
+                        }
+                    }
+                  allRoutes.push_back (*k);
+                  break;
                 }
-              allRoutes.push_back (*k);
-              break;
             }
         }
     }
@@ -245,6 +280,120 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 }
 
+bool
+Ipv4GlobalRouting::CompareRouteIndex (const RouteRef &a, const RouteRef &b)
+{
+  return a.index < b.index;
+}
+
+void
+Ipv4GlobalRouting::CollectRoutes (const IpPrefixTrie<RouteRef> &trie, const uint8_t *dest,
+                                  Ptr<NetDevice> oif, bool firstOnly,
+                                  std::vector<Ipv4RoutingTableEntry *> &routes) const
+{
+  const std::vector<RouteRef> *matches[33];
+  uint32_t nMatches = trie.Lookup (dest, 32, matches);
+  if (nMatches == 0)
+    {
+      return;
+    }
+  if (firstOnly)
+    {
+      // the values of each prefix are in list order: the first route of
+      // the list is the first acceptable route of one of the prefixes
+      const RouteRef *first = 0;
+      for (uint32_t m = 0; m < nMatches; m++)
+        {
+          for (std::vector<RouteRef>::const_iterator c = matches[m]->begin (); c != matches[m]->end (); c++)
+            {
+              if (first != 0 && first->index < c->index)
+                {
+                  break;
+                }
+              if (oif == 0 || oif == m_ipv4->GetNetDevice (c->route->GetInterface ()))
+                {
+                  first = &(*c);
+                  break;
+                }
+            }
+        }
+      if (first != 0)
+        {
+          routes.push_back (first->route);
+        }
+      return;
+    }
+  const std::vector<RouteRef> *candidates = matches[0];
+  std::vector<RouteRef> merged;
+  if (nMatches > 1)
+    {
+      // restore the order of the list among the matching prefixes
+      for (uint32_t m = 0; m < nMatches; m++)
+        {
+          merged.insert (merged.end (), matches[m]->begin (), matches[m]->end ());
+        }
+      std::sort (merged.begin (), merged.end (), &Ipv4GlobalRouting::CompareRouteIndex);
+      candidates = &merged;
+    }
+  for (std::vector<RouteRef>::const_iterator c = candidates->begin (); c != candidates->end (); c++)
+    {
+      if (oif != 0 && oif != m_ipv4->GetNetDevice (c->route->GetInterface ()))
+        {
+          NS_LOG_LOGIC ("Not on requested interface, skipping");
+          continue;
+        }
+      routes.push_back (c->route);
+    }
+}
+
+void
+Ipv4GlobalRouting::UpdateRouteTries (void)
+{
+  if (m_routeTriesValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_hostRouteTrie.Clear ();
+  m_networkRouteTrie.Clear ();
+  m_ASexternalRouteTrie.Clear ();
+  m_routeTriesValid = true;
+  m_routeTriesUsable = true;
+
+  RouteRef ref;
+  uint8_t address[4];
+  ref.index = 0;
+  for (HostRoutesCI i = m_hostRoutes.begin (); i != m_hostRoutes.end (); i++, ref.index++)
+    {
+      ref.route = *i;
+      (*i)->GetDest ().Serialize (address);
+      m_hostRouteTrie.Insert (address, 32, ref);
+    }
+  const std::list<Ipv4RoutingTableEntry *> *networkLists[2] = { &m_networkRoutes, &m_ASexternalRoutes };
+  IpPrefixTrie<RouteRef> *networkTries[2] = { &m_networkRouteTrie, &m_ASexternalRouteTrie };
+  for (uint32_t l = 0; l < 2; l++)
+    {
+      ref.index = 0;
+      for (NetworkRoutesCI j = networkLists[l]->begin (); j != networkLists[l]->end (); j++, ref.index++)
+        {
+          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
+          uint8_t prefixLength = mask.GetPrefixLength ();
+          if (prefixLength > 0 && mask.Get () != (0xffffffff << (32 - prefixLength)))
+            {
+              NS_LOG_LOGIC ("Non-contiguous mask " << mask << ", the routes will be scanned");
+              m_routeTriesUsable = false;
+              m_hostRouteTrie.Clear ();
+              m_networkRouteTrie.Clear ();
+              m_ASexternalRouteTrie.Clear ();
+              return;
+            }
+          ref.route = *j;
+          (*j)->GetDestNetwork ().Serialize (address);
+          networkTries[l]->Insert (address, prefixLength, ref);
+        }
+    }
+}
+
 uint32_t 
 Ipv4GlobalRouting::GetNRoutes (void) const
 {
@@ -321,6 +470,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
               delete *i;
               m_hostRoutes.erase (i);
+              m_routeTriesValid = false;
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
               return;
             }
@@ -338,6 +488,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
           delete *j;
           m_networkRoutes.erase (j);
+          m_routeTriesValid = false;
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -354,6 +505,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
           delete *k;
           m_ASexternalRoutes.erase (k);
+          m_routeTriesValid = false;
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -392,6 +544,10 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostRouteTrie.Clear ();
+  m_networkRouteTrie.Clear ();
+  m_ASexternalRouteTrie.Clear ();
+  m_routeTriesValid = false;
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -531,15 +687,29 @@ Ipv4GlobalRouting::RouteInput  (Ptr<const Packet> p, const Ipv4Header &header, P
                     // route request.
     }
 }
+void
+Ipv4GlobalRouting::RecomputeRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_incrementalUpdates)
+    {
+      GlobalRouteManager::UpdateRoutes ();
+    }
+  else
+    {
+      GlobalRouteManager::DeleteGlobalRoutes ();
+      GlobalRouteManager::BuildGlobalRoutingDatabase ();
+      GlobalRouteManager::InitializeRoutes ();
+    }
+}
+
 void 
 Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
 {
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      RecomputeRoutes ();
     }
 }
 
@@ -549,9 +719,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
   NS_LOG_FUNCTION (this << i);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      RecomputeRoutes ();
     }
 }
 
@@ -561,9 +729,7 @@ Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress ad
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      RecomputeRoutes ();
     }
 }
 
@@ -573,9 +739,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
   NS_LOG_FUNCTION (this << interface << address);
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      RecomputeRoutes ();
     }
 }
 
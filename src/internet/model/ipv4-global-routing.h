@@ -21,6 +21,7 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +29,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/ip-prefix-trie.h"
 
 namespace ns3 {
 
@@ -65,6 +67,10 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * The routes are indexed by IpPrefixTrie instances, rebuilt on the first
+ * lookup after the routes change, so that the cost of a lookup does not
+ * grow with the number of routes.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -232,10 +238,17 @@ protected:
   void DoDispose (void);
 
 private:
+  /**
+   * \brief Recompute the global routes after an interface event.
+   */
+  void RecomputeRoutes (void);
+
   /// Set to true if packets are randomly routed among ECMP; set to false for using only one route consistently
   bool m_randomEcmpRouting;
   /// Set to true if this interface should respond to interface events by globallly recomputing routes 
   bool m_respondToInterfaceEvents;
+  /// Set to true if the routes are recomputed only for the nodes affected by interface events
+  bool m_incrementalUpdates;
   /// A uniform random number generator for randomly routing packets among ECMP 
   Ptr<UniformRandomVariable> m_rand;
 
@@ -268,10 +281,50 @@ private:
    */
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /// A route, as indexed by the tries
+  struct RouteRef
+  {
+    uint32_t index;               //!< the position of the route in its list
+    Ipv4RoutingTableEntry *route; //!< the route
+  };
+
+  /**
+   * \brief Order routes by their position in their list.
+   * \param a the first route
+   * \param b the second route
+   * \return true if the first route comes first
+   */
+  static bool CompareRouteIndex (const RouteRef &a, const RouteRef &b);
+
+  /**
+   * \brief Find the routes of a trie matching a destination.
+   * \param trie the trie
+   * \param dest the destination address bytes
+   * \param oif output interface if any (put 0 otherwise)
+   * \param firstOnly whether only the first matching route is wanted
+   * \param routes the vector the matching routes are appended to, in
+   * the order of their list
+   */
+  void CollectRoutes (const IpPrefixTrie<RouteRef> &trie, const uint8_t *dest,
+                      Ptr<NetDevice> oif, bool firstOnly,
+                      std::vector<Ipv4RoutingTableEntry *> &routes) const;
+
+  /**
+   * \brief Rebuild the tries of the routes, if the routes changed since
+   * the last lookup.
+   */
+  void UpdateRouteTries (void);
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  IpPrefixTrie<RouteRef> m_hostRouteTrie;       //!< Routes to hosts, indexed by address
+  IpPrefixTrie<RouteRef> m_networkRouteTrie;    //!< Routes to networks, indexed by prefix
+  IpPrefixTrie<RouteRef> m_ASexternalRouteTrie; //!< External routes, indexed by prefix
+  bool m_routeTriesValid;  //!< whether the tries reflect the route lists
+  bool m_routeTriesUsable; //!< false if some network mask is not contiguous
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
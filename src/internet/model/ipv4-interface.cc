@@ -67,7 +67,9 @@ Ipv4Interface::Ipv4Interface ()
     m_node (0), 
     m_device (0),
     m_tc (0),
-    m_cache (0)
+    m_cache (0),
+    m_arp (0),
+    m_loopback (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -85,6 +87,7 @@ Ipv4Interface::DoDispose (void)
   m_device = 0;
   m_tc = 0;
   m_cache = 0;
+  m_arp = 0;
   Object::DoDispose ();
 }
 
@@ -101,6 +104,7 @@ Ipv4Interface::SetDevice (Ptr<NetDevice> device)
 {
   NS_LOG_FUNCTION (this << device);
   m_device = device;
+  m_loopback = (DynamicCast<LoopbackNetDevice> (device) != 0);
   DoSetup ();
 }
 
@@ -123,8 +127,8 @@ Ipv4Interface::DoSetup (void)
     {
       return;
     }
-  Ptr<ArpL3Protocol> arp = m_node->GetObject<ArpL3Protocol> ();
-  m_cache = arp->CreateCache (m_device, this);
+  m_arp = m_node->GetObject<ArpL3Protocol> ();
+  m_cache = m_arp->CreateCache (m_device, this);
 }
 
 Ptr<NetDevice>
@@ -220,7 +224,7 @@ Ipv4Interface::Send (Ptr<Packet> p, const Ipv4Header & hdr, Ipv4Address dest)
 
   // Check for a loopback device, if it's the case we don't pass through
   // traffic control layer
-  if (DynamicCast<LoopbackNetDevice> (m_device))
+  if (m_loopback)
     {
       /// \todo additional checks needed here (such as whether multicast
       /// goes to loopback)?
@@ -247,7 +251,6 @@ Ipv4Interface::Send (Ptr<Packet> p, const Ipv4Header & hdr, Ipv4Address dest)
   if (m_device->NeedsArp ())
     {
       NS_LOG_LOGIC ("Needs ARP" << " " << dest);
-      Ptr<ArpL3Protocol> arp = m_node->GetObject<ArpL3Protocol> ();
       Address hardwareDestination;
       bool found = false;
       if (dest.IsBroadcast ())
@@ -281,7 +284,7 @@ Ipv4Interface::Send (Ptr<Packet> p, const Ipv4Header & hdr, Ipv4Address dest)
           if (!found)
             {
               NS_LOG_LOGIC ("ARP Lookup");
-              found = arp->Lookup (p, hdr, dest, m_device, m_cache, &hardwareDestination);
+              found = m_arp->Lookup (p, hdr, dest, m_device, m_cache, &hardwareDestination);
             }
         }
 
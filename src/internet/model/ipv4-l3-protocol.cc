@@ -110,6 +110,10 @@ Ipv4L3Protocol::GetTypeId (void)
 Ipv4L3Protocol::Ipv4L3Protocol()
 {
   NS_LOG_FUNCTION (this);
+  m_ipForwardCallback = MakeCallback (&Ipv4L3Protocol::IpForward, this);
+  m_ipMulticastForwardCallback = MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this);
+  m_localDeliverCallback = MakeCallback (&Ipv4L3Protocol::LocalDeliver, this);
+  m_routeInputErrorCallback = MakeCallback (&Ipv4L3Protocol::RouteInputError, this);
 }
 
 Ipv4L3Protocol::~Ipv4L3Protocol ()
@@ -562,7 +566,10 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
 
   if (ipv4Interface->IsUp ())
     {
-      m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+      if (!m_rxTrace.IsEmpty ())
+        {
+          m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+        }
     }
   else
     {
@@ -632,11 +639,10 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
 
   NS_ASSERT_MSG (m_routingProtocol != 0, "Need a routing protocol object to process packets");
   if (!m_routingProtocol->RouteInput (packet, ipHeader, device,
-                                      MakeCallback (&Ipv4L3Protocol::IpForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::IpMulticastForward, this),
-                                      MakeCallback (&Ipv4L3Protocol::LocalDeliver, this),
-                                      MakeCallback (&Ipv4L3Protocol::RouteInputError, this)
-                                      ))
+                                      m_ipForwardCallback,
+                                      m_ipMulticastForwardCallback,
+                                      m_localDeliverCallback,
+                                      m_routeInputErrorCallback))
     {
       NS_LOG_WARN ("No route found for forwarding packet.  Drop.");
       m_dropTrace (ipHeader, packet, DROP_NO_ROUTE, m_node->GetObject<Ipv4> (), interface);
@@ -709,11 +715,15 @@ Ipv4L3Protocol::SendWithHeader (Ptr<Packet> packet,
 
 void
 Ipv4L3Protocol::CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet,
-                                    Ptr<Ipv4> ipv4, uint32_t interface)
+                             uint32_t interface)
 {
+  if (m_txTrace.IsEmpty ())
+    {
+      return;
+    }
   Ptr<Packet> packetCopy = packet->Copy ();
   packetCopy->AddHeader (ipHeader);
-  m_txTrace (packetCopy, ipv4, interface);
+  m_txTrace (packetCopy, m_node->GetObject<Ipv4> (), interface);
 }
 
 void 
@@ -779,7 +789,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
               NS_ASSERT (packetCopy->GetSize () <= outInterface->GetDevice ()->GetMtu ());
 
               m_sendOutgoingTrace (ipHeader, packetCopy, ifaceIndex);
-              CallTxTrace (ipHeader, packetCopy, m_node->GetObject<Ipv4> (), ifaceIndex);
+              CallTxTrace (ipHeader, packetCopy, ifaceIndex);
               outInterface->Send (packetCopy, ipHeader, destination);
             }
         }
@@ -803,7 +813,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
               ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
               Ptr<Packet> packetCopy = packet->Copy ();
               m_sendOutgoingTrace (ipHeader, packetCopy, ifaceIndex);
-              CallTxTrace (ipHeader, packetCopy, m_node->GetObject<Ipv4> (), ifaceIndex);
+              CallTxTrace (ipHeader, packetCopy, ifaceIndex);
               outInterface->Send (packetCopy, ipHeader, destination);
               return;
             }
@@ -922,10 +932,10 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   Ptr<NetDevice> outDev = route->GetOutputDevice ();
   int32_t interface = GetInterfaceForDevice (outDev);
   NS_ASSERT (interface >= 0);
-  Ptr<Ipv4Interface> outInterface = GetInterface (interface);
+  Ptr<Ipv4Interface> outInterface = m_interfaces[interface];
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
 
-  if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
+  if (!route->GetGateway ().IsEqual (Ipv4Address::GetAny ()))
     {
       if (outInterface->IsUp ())
         {
@@ -936,13 +946,13 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
               DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
               for ( std::list<Ipv4PayloadHeaderPair>::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
                 {
-                  CallTxTrace (it->second, it->first, m_node->GetObject<Ipv4> (), interface);
+                  CallTxTrace (it->second, it->first, interface);
                   outInterface->Send (it->first, it->second, route->GetGateway ());
                 }
             }
           else
             {
-              CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv4> (), interface);
+              CallTxTrace (ipHeader, packet, interface);
               outInterface->Send (packet, ipHeader, route->GetGateway ());
             }
         }
@@ -964,13 +974,13 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
               for ( std::list<Ipv4PayloadHeaderPair>::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
                 {
                   NS_LOG_LOGIC ("Sending fragment " << *(it->first) );
-                  CallTxTrace (it->second, it->first, m_node->GetObject<Ipv4> (), interface);
+                  CallTxTrace (it->second, it->first, interface);
                   outInterface->Send (it->first, it->second, ipHeader.GetDestination ());
                 }
             }
           else
             {
-              CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv4> (), interface);
+              CallTxTrace (ipHeader, packet, interface);
               outInterface->Send (packet, ipHeader, ipHeader.GetDestination ());
             }
         }
@@ -1415,8 +1425,6 @@ Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Head
 
   NS_LOG_FUNCTION (this << *packet << outIfaceMtu << &listFragments);
 
-  Ptr<Packet> p = packet->Copy ();
-
   NS_ASSERT_MSG( (ipv4Header.GetSerializedSize() == 5*4),
                  "IPv4 fragmentation implementation only works without option headers." );
 
@@ -1437,7 +1445,7 @@ Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Head
     {
       Ipv4Header fragmentHeader = ipv4Header;
 
-      if (p->GetSize () > offset + fragmentSize )
+      if (packet->GetSize () > offset + fragmentSize )
         {
           moreFragment = true;
           currentFragmentablePartSize = fragmentSize;
@@ -1446,7 +1454,7 @@ Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Head
       else
         {
           moreFragment = false;
-          currentFragmentablePartSize = p->GetSize () - offset;
+          currentFragmentablePartSize = packet->GetSize () - offset;
           if (!isLastFragment)
             {
               fragmentHeader.SetMoreFragments ();
@@ -1458,7 +1466,8 @@ Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Head
         }
 
       NS_LOG_LOGIC ("Fragment creation - " << offset << ", " << currentFragmentablePartSize  );
-      Ptr<Packet> fragment = p->CreateFragment (offset, currentFragmentablePartSize);
+      // The fragments share the data of the original packet
+      Ptr<Packet> fragment = packet->CreateFragment (offset, currentFragmentablePartSize);
       NS_LOG_LOGIC ("Fragment created - " << offset << ", " << fragment->GetSize ()  );
 
       fragmentHeader.SetFragmentOffset (offset+originalOffset);
@@ -1472,11 +1481,6 @@ Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Head
       NS_LOG_LOGIC ("Fragment check - " << fragmentHeader.GetFragmentOffset ()  );
 
       NS_LOG_LOGIC ("New fragment Header " << fragmentHeader);
-
-      std::ostringstream oss;
-      oss << fragmentHeader;
-      fragment->Print (oss);
-
       NS_LOG_LOGIC ("New fragment " << *fragment);
 
       listFragments.push_back (Ipv4PayloadHeaderPair (fragment, fragmentHeader));
@@ -1498,7 +1502,6 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
   uint32_t idProto = uint32_t (ipHeader.GetIdentification ()) << 16 | uint32_t (ipHeader.GetProtocol ());
   std::pair<uint64_t, uint32_t> key;
   bool ret = false;
-  Ptr<Packet> p = packet->Copy ();
 
   key.first = addressCombination;
   key.second = idProto;
@@ -1521,7 +1524,8 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 
   NS_LOG_LOGIC ("Adding fragment - Size: " << packet->GetSize ( ) << " - Offset: " << (ipHeader.GetFragmentOffset ()) );
 
-  fragments->AddFragment (p, ipHeader.GetFragmentOffset (), !ipHeader.IsLastFragment () );
+  // The packet is a copy made by LocalDeliver, it can be stored as is
+  fragments->AddFragment (packet, ipHeader.GetFragmentOffset (), !ipHeader.IsLastFragment () );
 
   if ( fragments->IsEntire () )
     {
@@ -1541,7 +1545,8 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
 }
 
 Ipv4L3Protocol::Fragments::Fragments ()
-  : m_moreFragment (0)
+  : m_moreFragment (0),
+    m_contiguousEnd (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -1556,22 +1561,31 @@ Ipv4L3Protocol::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentO
 {
   NS_LOG_FUNCTION (this << fragment << fragmentOffset << moreFragment);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
+  // A fragment is inserted after the ones with the same offset
+  std::multimap<uint16_t, Ptr<Packet> >::iterator it = m_fragments.upper_bound (fragmentOffset);
 
-  for (it = m_fragments.begin (); it != m_fragments.end (); it++)
+  if (it == m_fragments.end ())
     {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
+      m_moreFragment = moreFragment;
     }
 
-  if (it == m_fragments.end ())
+  m_fragments.insert (it, std::make_pair (fragmentOffset, fragment));
+
+  if (fragmentOffset > m_contiguousEnd)
     {
-      m_moreFragment = moreFragment;
+      return;
     }
 
-  m_fragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+  // Extend the contiguous data with this fragment and with the ones
+  // it joins to it.  The fragments starting before the previous end
+  // were already covered.
+  // Fragments might overlap in strange ways.
+  uint32_t previousEnd = m_contiguousEnd;
+  m_contiguousEnd = std::max (m_contiguousEnd, fragmentOffset + fragment->GetSize ());
+  for (it = m_fragments.upper_bound (previousEnd); it != m_fragments.end () && it->first <= m_contiguousEnd; it++)
+    {
+      m_contiguousEnd = std::max (m_contiguousEnd, it->first + it->second->GetSize ());
+    }
 }
 
 bool
@@ -1579,29 +1593,8 @@ Ipv4L3Protocol::Fragments::IsEntire () const
 {
   NS_LOG_FUNCTION (this);
 
-  bool ret = !m_moreFragment && m_fragments.size () > 0;
-
-  if (ret)
-    {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-        {
-          // overlapping fragments do exist
-          NS_LOG_LOGIC ("Checking overlaps " << lastEndOffset << " - " << it->second );
-
-          if (lastEndOffset < it->second)
-            {
-              ret = false;
-              break;
-            }
-          // fragments might overlap in strange ways
-          uint16_t fragmentEnd = it->first->GetSize () + it->second;
-          lastEndOffset = std::max ( lastEndOffset, fragmentEnd );
-        }
-    }
-
-  return ret;
+  return !m_moreFragment && m_fragments.size () > 0
+         && m_fragments.rbegin ()->first <= m_contiguousEnd;
 }
 
 Ptr<Packet>
@@ -1609,32 +1602,34 @@ Ipv4L3Protocol::Fragments::GetPacket () const
 {
   NS_LOG_FUNCTION (this);
 
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
+  std::multimap<uint16_t, Ptr<Packet> >::const_iterator it = m_fragments.begin ();
 
-  Ptr<Packet> p = it->first->Copy ();
-  uint16_t lastEndOffset = p->GetSize ();
+  Ptr<Packet> p = it->second->Copy ();
+  uint32_t lastEndOffset = p->GetSize ();
+  // Copy each byte only once while gathering the fragments
+  p->ReserveAtEnd (m_contiguousEnd - lastEndOffset);
   it++;
 
   for ( ; it != m_fragments.end (); it++)
     {
-      if ( lastEndOffset > it->second )
+      if ( lastEndOffset > it->first )
         {
           // The fragments are overlapping.
           // We do not overwrite the "old" with the "new" because we do not know when each arrived.
           // This is different from what Linux does.
           // It is not possible to emulate a fragmentation attack.
-          uint32_t newStart = lastEndOffset - it->second;
-          if ( it->first->GetSize () > newStart )
+          uint32_t newStart = lastEndOffset - it->first;
+          if ( it->second->GetSize () > newStart )
             {
-              uint32_t newSize = it->first->GetSize () - newStart;
-              Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
+              uint32_t newSize = it->second->GetSize () - newStart;
+              Ptr<Packet> tempFragment = it->second->CreateFragment (newStart, newSize);
               p->AddAtEnd (tempFragment);
             }
         }
       else
         {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
+          NS_LOG_LOGIC ("Adding: " << *(it->second) );
+          p->AddAtEnd (it->second);
         }
       lastEndOffset = p->GetSize ();
     }
@@ -1647,29 +1642,30 @@ Ipv4L3Protocol::Fragments::GetPartialPacket () const
 {
   NS_LOG_FUNCTION (this);
   
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
+  std::multimap<uint16_t, Ptr<Packet> >::const_iterator it = m_fragments.begin ();
 
   Ptr<Packet> p = Create<Packet> ();
-  uint16_t lastEndOffset = 0;
+  uint32_t lastEndOffset = 0;
 
-  if ( m_fragments.begin ()->second > 0 )
+  if ( m_fragments.begin ()->first > 0 )
     {
       return p;
     }
 
+  p->ReserveAtEnd (m_contiguousEnd);
   for ( it = m_fragments.begin (); it != m_fragments.end (); it++)
     {
-      if ( lastEndOffset > it->second )
+      if ( lastEndOffset > it->first )
         {
-          uint32_t newStart = lastEndOffset - it->second;
-          uint32_t newSize = it->first->GetSize () - newStart;
-          Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
+          uint32_t newStart = lastEndOffset - it->first;
+          uint32_t newSize = it->second->GetSize () - newStart;
+          Ptr<Packet> tempFragment = it->second->CreateFragment (newStart, newSize);
           p->AddAtEnd (tempFragment);
         }
-      else if ( lastEndOffset == it->second )
+      else if ( lastEndOffset == it->first )
         {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
+          NS_LOG_LOGIC ("Adding: " << *(it->second) );
+          p->AddAtEnd (it->second);
         }
       lastEndOffset = p->GetSize ();
     }
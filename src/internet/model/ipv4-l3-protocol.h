@@ -426,13 +426,11 @@ private:
    * \brief Make a copy of the packet, add the header and invoke the TX trace callback
    * \param ipHeader the IP header that will be added to the packet
    * \param packet the packet
-   * \param ipv4 the Ipv4 protocol
    * \param interface the interface index
    *
-   * Note: If the TracedCallback API ever is extended, we could consider
-   * to check for connected functions before adding the header
+   * Nothing is done if no function is connected to the TX trace.
    */
-  void CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  void CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet, uint32_t interface);
 
   /**
    * \brief Container of the IPv4 Interfaces.
@@ -490,6 +488,13 @@ private:
 
   Ptr<Ipv4RoutingProtocol> m_routingProtocol; //!< Routing protocol associated with the stack
 
+  // The callbacks passed to RouteInput for every received packet,
+  // which are created once instead of once per packet.
+  Ipv4RoutingProtocol::UnicastForwardCallback m_ipForwardCallback; //!< Callback to IpForward
+  Ipv4RoutingProtocol::MulticastForwardCallback m_ipMulticastForwardCallback; //!< Callback to IpMulticastForward
+  Ipv4RoutingProtocol::LocalDeliverCallback m_localDeliverCallback; //!< Callback to LocalDeliver
+  Ipv4RoutingProtocol::ErrorCallback m_routeInputErrorCallback; //!< Callback to RouteInputError
+
   SocketList m_sockets; //!< List of IPv4 raw sockets.
 
   /**
@@ -541,9 +546,16 @@ private:
     bool m_moreFragment;
 
     /**
-     * \brief The current fragments.
+     * \brief The current fragments, sorted by offset.
+     */
+    std::multimap<uint16_t, Ptr<Packet> > m_fragments;
+
+    /**
+     * \brief The end of the data received without gaps from offset 0.
+     *
+     * All the fragments starting at or before this offset are covered.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_fragments;
+    uint32_t m_contiguousEnd;
 
   };
 
@@ -54,7 +54,9 @@ Ipv4StaticRouting::GetTypeId (void)
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting () 
-  : m_ipv4 (0)
+  : m_networkRouteTrieValid (false),
+    m_networkRouteTrieUsable (false),
+    m_ipv4 (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -73,6 +75,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (make_pair (route,metric));
+  m_networkRouteTrieValid = false;
 }
 
 void 
@@ -87,6 +90,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (make_pair (route,metric));
+  m_networkRouteTrieValid = false;
 }
 
 void 
@@ -144,6 +148,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
                                                         networkMask,
                                                         outputInterface);
   m_networkRoutes.push_back (make_pair (route,0));
+  m_networkRouteTrieValid = false;
 }
 
 uint32_t 
@@ -224,8 +229,6 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION (this << dest << " " << oif);
   Ptr<Ipv4Route> rtentry = 0;
-  uint16_t longest_mask = 0;
-  uint32_t shortest_metric = 0xffffffff;
   /* when sending on local multicast, there have to be interface specified */
   if (dest.IsLocalMulticast ())
     {
@@ -240,56 +243,102 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  // Among the routes matching the destination (on the requested
+  // interface), the one with the longest mask wins. Among routes with
+  // the same mask, the last one with the lowest metric wins, except for
+  // host routes, for which the first one wins.
+  Ipv4RoutingTableEntry *bestRoute = 0;
+  UpdateNetworkRouteTrie ();
+  if (m_networkRouteTrieUsable)
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      Ipv4Address entry = (j)->GetDestNetwork ();
-      NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
-      if (mask.IsMatch (dest, entry)) 
+      uint8_t destBytes[4];
+      dest.Serialize (destBytes);
+      const std::vector<NetworkRouteRef> *matches[33];
+      uint32_t nMatches = m_networkRouteTrie.Lookup (destBytes, 32, matches);
+      for (uint32_t m = nMatches; m > 0 && bestRoute == 0; m--)
         {
-          NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
-          if (oif != 0)
+          uint32_t shortestMetric = 0xffffffff;
+          for (std::vector<NetworkRouteRef>::const_iterator i = matches[m - 1]->begin ();
+               i != matches[m - 1]->end ();
+               i++)
             {
-              if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
+              if (oif != 0 && oif != m_ipv4->GetNetDevice (i->route->GetInterface ()))
                 {
                   NS_LOG_LOGIC ("Not on requested interface, skipping");
                   continue;
                 }
+              if (i->metric > shortestMetric)
+                {
+                  NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+                  continue;
+                }
+              shortestMetric = i->metric;
+              bestRoute = i->route;
+              if (i->prefixLength == 32)
+                {
+                  break;
+                }
             }
-          if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-              NS_LOG_LOGIC ("Previous match longer, skipping");
-              continue;
-            }
-          if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-              shortest_metric = 0xffffffff;
-            }
-          longest_mask = masklen;
-          if (metric > shortest_metric)
-            {
-              NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
-              continue;
-            }
-          shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
-          uint32_t interfaceIdx = route->GetInterface ();
-          rtentry = Create<Ipv4Route> ();
-          rtentry->SetDestination (route->GetDest ());
-          rtentry->SetSource (m_ipv4->SourceAddressSelection (interfaceIdx, route->GetDest ()));
-          rtentry->SetGateway (route->GetGateway ());
-          rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-          if (masklen == 32)
+        }
+    }
+  else
+    {
+      uint16_t longest_mask = 0;
+      uint32_t shortest_metric = 0xffffffff;
+      for (NetworkRoutesI i = m_networkRoutes.begin (); 
+           i != m_networkRoutes.end (); 
+           i++) 
+        {
+          Ipv4RoutingTableEntry *j=i->first;
+          uint32_t metric =i->second;
+          Ipv4Mask mask = (j)->GetDestNetworkMask ();
+          uint16_t masklen = mask.GetPrefixLength ();
+          Ipv4Address entry = (j)->GetDestNetwork ();
+          NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
+          if (mask.IsMatch (dest, entry)) 
             {
-              break;
+              NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
+              if (oif != 0)
+                {
+                  if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
+                    {
+                      NS_LOG_LOGIC ("Not on requested interface, skipping");
+                      continue;
+                    }
+                }
+              if (masklen < longest_mask) // Not interested if got shorter mask
+                {
+                  NS_LOG_LOGIC ("Previous match longer, skipping");
+                  continue;
+                }
+              if (masklen > longest_mask) // Reset metric if longer masklen
+                {
+                  shortest_metric = 0xffffffff;
+                }
+              longest_mask = masklen;
+              if (metric > shortest_metric)
+                {
+                  NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+                  continue;
+                }
+              shortest_metric = metric;
+              bestRoute = j;
+              if (masklen == 32)
+                {
+                  break;
+                }
             }
         }
     }
+  if (bestRoute != 0)
+    {
+      uint32_t interfaceIdx = bestRoute->GetInterface ();
+      rtentry = Create<Ipv4Route> ();
+      rtentry->SetDestination (bestRoute->GetDest ());
+      rtentry->SetSource (m_ipv4->SourceAddressSelection (interfaceIdx, bestRoute->GetDest ()));
+      rtentry->SetGateway (bestRoute->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+    }
   if (rtentry != 0)
     {
       NS_LOG_LOGIC ("Matching route via " << rtentry->GetGateway () << " at the end");
@@ -301,6 +350,38 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
   return rtentry;
 }
 
+void
+Ipv4StaticRouting::UpdateNetworkRouteTrie (void)
+{
+  if (m_networkRouteTrieValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_networkRouteTrie.Clear ();
+  m_networkRouteTrieUsable = true;
+  for (NetworkRoutesCI i = m_networkRoutes.begin (); i != m_networkRoutes.end (); i++)
+    {
+      Ipv4Mask mask = i->first->GetDestNetworkMask ();
+      uint8_t prefixLength = mask.GetPrefixLength ();
+      if (prefixLength > 0 && mask.Get () != (0xffffffff << (32 - prefixLength)))
+        {
+          NS_LOG_LOGIC ("Non-contiguous mask " << mask << ", the routes will be scanned");
+          m_networkRouteTrieUsable = false;
+          m_networkRouteTrie.Clear ();
+          break;
+        }
+      NetworkRouteRef ref;
+      ref.route = i->first;
+      ref.metric = i->second;
+      ref.prefixLength = prefixLength;
+      uint8_t network[4];
+      i->first->GetDestNetwork ().Serialize (network);
+      m_networkRouteTrie.Insert (network, prefixLength, ref);
+    }
+  m_networkRouteTrieValid = true;
+}
+
 Ptr<Ipv4MulticastRoute>
 Ipv4StaticRouting::LookupStatic (
   Ipv4Address origin, 
@@ -449,6 +530,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
         {
           delete j->first;
           m_networkRoutes.erase (j);
+          m_networkRouteTrieValid = false;
           return;
         }
       tmp++;
@@ -575,6 +657,8 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_networkRouteTrie.Clear ();
+  m_networkRouteTrieValid = false;
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -615,6 +699,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_networkRouteTrieValid = false;
         }
       else
         {
@@ -662,6 +747,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_networkRouteTrieValid = false;
         }
       else
         {
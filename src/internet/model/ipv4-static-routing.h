@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ip-prefix-trie.h"
 
 namespace ns3 {
 
@@ -224,6 +225,10 @@ public:
  *
  * \param i The index (into the routing table) of the route to remove.
  *
+ * The network routes are indexed by an IpPrefixTrie, rebuilt on the
+ * first lookup after the routes change, so that the cost of a lookup
+ * does not grow with the number of routes.
+ *
  * \see Ipv4RoutingTableEntry
  * \see Ipv4StaticRouting::GetRoute
  * \see Ipv4StaticRouting::AddRoute
@@ -395,6 +400,14 @@ private:
   /// Iterator for container for the multicast routes
   typedef std::list<Ipv4MulticastRoutingTableEntry *>::iterator MulticastRoutesI;
 
+  /// A network route, as indexed by the trie
+  struct NetworkRouteRef
+  {
+    Ipv4RoutingTableEntry *route; //!< the route
+    uint32_t metric;              //!< the metric of the route
+    uint8_t prefixLength;         //!< the length of the network mask
+  };
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -403,6 +416,12 @@ private:
    */
   Ptr<Ipv4Route> LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /**
+   * \brief Rebuild the trie of the network routes, if they changed
+   * since the last lookup.
+   */
+  void UpdateNetworkRouteTrie (void);
+
   /**
    * \brief Lookup in the multicast forwarding table for destination.
    * \param origin source address
@@ -418,6 +437,22 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes, indexed by destination prefix.
+   */
+  IpPrefixTrie<NetworkRouteRef> m_networkRouteTrie;
+
+  /**
+   * \brief whether m_networkRouteTrie reflects m_networkRoutes.
+   */
+  bool m_networkRouteTrieValid;
+
+  /**
+   * \brief false if some network mask is not contiguous, in which case
+   * the network routes are scanned instead of using the trie.
+   */
+  bool m_networkRouteTrieUsable;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -43,28 +43,106 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_ports.clear ();
+  m_index.clear ();
+  m_entries.clear ();
 }
 
-bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv6EndPointDemux::Tuple::Tuple ()
+  : m_localPort (0),
+    m_peerPort (0)
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+}
+
+Ipv6EndPointDemux::Tuple::Tuple (Ipv6Address localAddress, uint16_t localPort,
+                                 Ipv6Address peerAddress, uint16_t peerPort)
+  : m_localAddress (localAddress),
+    m_localPort (localPort),
+    m_peerAddress (peerAddress),
+    m_peerPort (peerPort)
+{
+}
+
+bool Ipv6EndPointDemux::Tuple::operator== (const Tuple &other) const
+{
+  return m_localPort == other.m_localPort
+         && m_peerPort == other.m_peerPort
+         && m_localAddress == other.m_localAddress
+         && m_peerAddress == other.m_peerAddress;
+}
+
+size_t Ipv6EndPointDemux::TupleHash::operator() (const Tuple &tuple) const
+{
+  Ipv6AddressHash addressHash;
+  uint64_t ports = (static_cast<uint64_t> (tuple.m_localPort) << 16) | tuple.m_peerPort;
+  uint64_t h = (addressHash (tuple.m_localAddress) * 0x9e3779b97f4a7c15ULL)
+    ^ addressHash (tuple.m_peerAddress) ^ ports;
+  h *= 0xff51afd7ed558ccdULL;
+  return static_cast<size_t> (h ^ (h >> 32));
+}
+
+Ipv6EndPointDemux::Tuple Ipv6EndPointDemux::GetTuple (Ipv6EndPoint *endPoint)
+{
+  return Tuple (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                endPoint->GetPeerAddress (), endPoint->GetPeerPort ());
+}
+
+Ipv6EndPoint* Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  Entry entry;
+  entry.m_all = m_endPoints.insert (m_endPoints.end (), endPoint);
+  EndPoints &portEndPoints = m_ports[endPoint->GetLocalPort ()];
+  entry.m_port = portEndPoints.insert (portEndPoints.end (), endPoint);
+  entry.m_tuple = GetTuple (endPoint);
+  m_index.insert (std::make_pair (entry.m_tuple, endPoint));
+  m_entries[endPoint] = entry;
+  endPoint->SetChangeCallback (MakeCallback (&Ipv6EndPointDemux::Reindex, this));
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  return endPoint;
+}
+
+void Ipv6EndPointDemux::RemoveFromIndex (Ipv6EndPoint *endPoint, const Tuple &tuple)
+{
+  std::pair<Index::iterator, Index::iterator> range = m_index.equal_range (tuple);
+  for (Index::iterator i = range.first; i != range.second; i++)
     {
-      if ((*i)->GetLocalPort  () == port)
+      if (i->second == endPoint)
         {
-          return true;
+          m_index.erase (i);
+          return;
         }
     }
-  return false;
+  NS_ASSERT_MSG (false, "End point " << endPoint << " is not indexed");
+}
+
+void Ipv6EndPointDemux::Reindex (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  std::unordered_map<Ipv6EndPoint *, Entry>::iterator entry = m_entries.find (endPoint);
+  NS_ASSERT (entry != m_entries.end ());
+  RemoveFromIndex (endPoint, entry->second.m_tuple);
+  entry->second.m_tuple = GetTuple (endPoint);
+  m_index.insert (std::make_pair (entry->second.m_tuple, endPoint));
+}
+
+bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<uint16_t, EndPoints>::iterator portEndPoints = m_ports.find (port);
+  if (portEndPoints == m_ports.end ())
+    {
+      return false;
+    }
+  for (EndPointsI i = portEndPoints->second.begin (); i != portEndPoints->second.end (); i++)
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr &&
+      if ((*i)->GetLocalAddress () == addr &&
           (*i)->GetBoundNetDevice () == boundNetDevice)
         {
           return true;
@@ -82,10 +160,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (Ipv6Address::GetAny (), port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
@@ -97,10 +172,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, uint16_t port)
@@ -118,10 +190,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv6Ad
       NS_LOG_WARN ("Duplicated endpoint.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
@@ -129,13 +198,11 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::pair<Index::iterator, Index::iterator> range =
+    m_index.equal_range (Tuple (localAddress, localPort, peerAddress, peerPort));
+  for (Index::iterator i = range.first; i != range.second; i++)
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress &&
-          ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+      if (i->second->GetBoundNetDevice () == boundNetDevice || i->second->GetBoundNetDevice () == 0)
         {
           NS_LOG_WARN ("Duplicated endpoint.");
           return 0;
@@ -143,69 +210,46 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<Ipv6EndPoint *, Entry>::iterator entry = m_entries.find (endPoint);
+  if (entry == m_entries.end ())
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      return;
+    }
+  RemoveFromIndex (endPoint, entry->second.m_tuple);
+  std::unordered_map<uint16_t, EndPoints>::iterator portEndPoints = m_ports.find (endPoint->GetLocalPort ());
+  portEndPoints->second.erase (entry->second.m_port);
+  if (portEndPoints->second.empty ())
+    {
+      m_ports.erase (portEndPoints);
     }
+  m_endPoints.erase (entry->second.m_all);
+  m_entries.erase (entry);
+  delete endPoint;
 }
 
-/*
- * If we have an exact match, we return it.
- * Otherwise, if we find a generic match, we return it.
- * Otherwise, we return 0.
- */
-Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint16_t dport,
-                                                        Ipv6Address saddr, uint16_t sport,
-                                                        Ptr<Ipv6Interface> incomingInterface)
+void Ipv6EndPointDemux::LookupTuple (const Tuple &tuple, Ptr<Ipv6Interface> incomingInterface,
+                                     EndPoints &endPoints)
 {
-  NS_LOG_FUNCTION (this << daddr << dport << saddr << sport << incomingInterface);
-
-  EndPoints retval1; /* Matches exact on local port, wildcards on others */
-  EndPoints retval2; /* Matches exact on local port/adder, wildcards on others */
-  EndPoints retval3; /* Matches all but local address */
-  EndPoints retval4; /* Exact match on all 4 */
-
-  NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  NS_LOG_FUNCTION (this << tuple.m_localAddress << tuple.m_localPort
+                        << tuple.m_peerAddress << tuple.m_peerPort);
+  std::pair<Index::iterator, Index::iterator> range = m_index.equal_range (tuple);
+  for (Index::iterator i = range.first; i != range.second; i++)
     {
-      Ipv6EndPoint* endP = *i;
-
-      NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
-                                                 << " daddr=" << endP->GetLocalAddress ()
-                                                 << " sport=" << endP->GetPeerPort ()
-                                                 << " saddr=" << endP->GetPeerAddress ());
+      Ipv6EndPoint* endP = i->second;
 
       if (!endP->IsRxEnabled ())
         {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
+          NS_LOG_LOGIC ("Skipping endpoint " << endP
                         << " because endpoint can not receive packets");
           continue;
         }
 
-      if (endP->GetLocalPort () != dport)
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
-
       if (endP->GetBoundNetDevice ())
         {
           if (!incomingInterface)
@@ -214,7 +258,7 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
             }
           if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
             {
-              NS_LOG_LOGIC ("Skipping endpoint " << &endP
+              NS_LOG_LOGIC ("Skipping endpoint " << endP
                                                  << " because endpoint is bound to specific device and"
                                                  << endP->GetBoundNetDevice ()
                                                  << " does not match packet device " << incomingInterface->GetDevice ());
@@ -222,67 +266,45 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
             }
         }
 
-      /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
-      NS_LOG_DEBUG ("dest addr " << daddr);
-
-      bool localAddressMatchesWildCard = endP->GetLocalAddress () == Ipv6Address::GetAny ();
-      bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
-      bool localAddressMatchesAllRouters = endP->GetLocalAddress () == Ipv6Address::GetAllRoutersMulticast ();
+      endPoints.push_back (endP);
+    }
+}
 
-      /* if no match here, keep looking */
-      if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        {
-          continue;
-        }
-      bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
-      bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
-      bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
-      bool remoteAddressMatchesWildCard = endP->GetPeerAddress () == Ipv6Address::GetAny ();
-
-      /* If remote does not match either with exact or wildcard,i
-         skip this one */
-      if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
-        {
-          continue;
-        }
-      if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-          continue;
-        }
+/*
+ * If we have an exact match, we return it.
+ * Otherwise, if we find a generic match, we return it.
+ * Otherwise, we return 0.
+ */
+Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint16_t dport,
+                                                        Ipv6Address saddr, uint16_t sport,
+                                                        Ptr<Ipv6Interface> incomingInterface)
+{
+  NS_LOG_FUNCTION (this << daddr << dport << saddr << sport << incomingInterface);
 
-      /* Now figure out which return list to add this one to */
-      if (localAddressMatchesWildCard
-          && remotePeerMatchesWildCard
-          && remoteAddressMatchesWildCard)
-        { /* Only local port matches exactly */
-          retval1.push_back (endP);
-        }
-      if ((localAddressMatchesExact || (localAddressMatchesAllRouters))
-          && remotePeerMatchesWildCard
-          && remoteAddressMatchesWildCard)
-        { /* Only local port and local address matches exactly */
-          retval2.push_back (endP);
-        }
-      if (localAddressMatchesWildCard
-          && remotePeerMatchesExact
-          && remoteAddressMatchesExact)
-        { /* All but local address */
-          retval3.push_back (endP);
-        }
-      if (localAddressMatchesExact
-          && remotePeerMatchesExact
-          && remoteAddressMatchesExact)
-        { /* All 4 match */
-          retval4.push_back (endP);
-        }
+  NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
+  EndPoints retval;
+  if (m_ports.find (dport) == m_ports.end ())
+    {
+      return retval;
     }
 
-  // Here we find the most exact match
-  EndPoints retval;
-  if (!retval4.empty ()) retval = retval4;
-  else if (!retval3.empty ()) retval = retval3;
-  else if (!retval2.empty ()) retval = retval2;
-  else retval = retval1;
+  /* All 4 match */
+  LookupTuple (Tuple (daddr, dport, saddr, sport), incomingInterface, retval);
+  /* All but local address */
+  if (retval.empty ())
+    {
+      LookupTuple (Tuple (Ipv6Address::GetAny (), dport, saddr, sport), incomingInterface, retval);
+    }
+  /* Only local port and local address matches exactly */
+  if (retval.empty ())
+    {
+      LookupTuple (Tuple (daddr, dport, Ipv6Address::GetAny (), 0), incomingInterface, retval);
+    }
+  /* Only local port matches exactly */
+  if (retval.empty ())
+    {
+      LookupTuple (Tuple (Ipv6Address::GetAny (), dport, Ipv6Address::GetAny (), 0), incomingInterface, retval);
+    }
 
   NS_ABORT_MSG_IF (retval.size () > 1, "Too many endpoints - perhaps you created too many sockets without binding them to different NetDevices.");
   return retval;  // might be empty if no matches
@@ -293,14 +315,15 @@ Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport,
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<uint16_t, EndPoints>::iterator portEndPoints = m_ports.find (dport);
+  if (portEndPoints == m_ports.end ())
     {
-      uint32_t tmp = 0;
+      return 0;
+    }
 
-      if ((*i)->GetLocalPort () != dport)
-        {
-          continue;
-        }
+  for (EndPointsI i = portEndPoints->second.begin (); i != portEndPoints->second.end (); i++)
+    {
+      uint32_t tmp = 0;
 
       if ((*i)->GetLocalAddress () == dst && (*i)->GetPeerPort () == sport
           && (*i)->GetPeerAddress () == src)
@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <list>
+#include <unordered_map>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
 
@@ -34,6 +35,11 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The end points are indexed by local port and by four-tuple, so that a
+ * lookup does not depend on the number of end points (e.g., the
+ * connections of a server). The end points notify the demux when their
+ * address or peer change.
  */
 class Ipv6EndPointDemux
 {
@@ -153,6 +159,99 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  /**
+   * \brief The four-tuple of an end point, used as key of the index.
+   */
+  struct Tuple
+  {
+    Tuple ();
+    /**
+     * \brief Constructor.
+     * \param localAddress the local address
+     * \param localPort the local port
+     * \param peerAddress the peer address
+     * \param peerPort the peer port
+     */
+    Tuple (Ipv6Address localAddress, uint16_t localPort,
+           Ipv6Address peerAddress, uint16_t peerPort);
+    /**
+     * \brief Equality operator.
+     * \param other the other tuple
+     * \return true if the tuples are equal
+     */
+    bool operator== (const Tuple &other) const;
+
+    Ipv6Address m_localAddress; //!< the local address
+    uint16_t m_localPort;       //!< the local port
+    Ipv6Address m_peerAddress;  //!< the peer address
+    uint16_t m_peerPort;        //!< the peer port
+  };
+
+  /**
+   * \brief Hash function of the four-tuples.
+   */
+  struct TupleHash
+  {
+    /**
+     * \brief Hash a four-tuple.
+     * \param tuple the tuple
+     * \return the hash
+     */
+    size_t operator() (const Tuple &tuple) const;
+  };
+
+  /**
+   * \brief Index of the end points by four-tuple.
+   */
+  typedef std::unordered_multimap<Tuple, Ipv6EndPoint *, TupleHash> Index;
+
+  /**
+   * \brief The position of an end point in the containers of the demux.
+   */
+  struct Entry
+  {
+    EndPointsI m_all;  //!< position in the list of all the end points
+    EndPointsI m_port; //!< position in the list of the end points of its local port
+    Tuple m_tuple;     //!< four-tuple under which the end point is indexed
+  };
+
+  /**
+   * \brief Get the four-tuple of an end point.
+   * \param endPoint the end point
+   * \return the four-tuple
+   */
+  static Tuple GetTuple (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add an end point to the containers of the demux.
+   * \param endPoint the end point
+   * \return the end point
+   */
+  Ipv6EndPoint *Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the index.
+   * \param endPoint the end point
+   * \param tuple the four-tuple under which it is indexed
+   */
+  void RemoveFromIndex (Ipv6EndPoint *endPoint, const Tuple &tuple);
+
+  /**
+   * \brief Index an end point again, after its address or peer changed.
+   * \param endPoint the end point
+   */
+  void Reindex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Add the end points indexed under a four-tuple that can receive
+   * a packet from an interface.
+   * \param tuple the four-tuple
+   * \param incomingInterface the incoming interface
+   * \param endPoints the list the end points are added to
+   */
+  void LookupTuple (const Tuple &tuple, Ptr<Ipv6Interface> incomingInterface,
+                    EndPoints &endPoints);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -178,6 +277,21 @@ private:
    * \brief A list of IPv6 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The IPv6 end points of each local port.
+   */
+  std::unordered_map<uint16_t, EndPoints> m_ports;
+
+  /**
+   * \brief The IPv6 end points indexed by four-tuple.
+   */
+  Index m_index;
+
+  /**
+   * \brief The position of each IPv6 end point in the containers.
+   */
+  std::unordered_map<Ipv6EndPoint *, Entry> m_entries;
 };
 
 } /* namespace ns3 */
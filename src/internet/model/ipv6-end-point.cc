@@ -47,6 +47,7 @@ Ipv6EndPoint::~Ipv6EndPoint ()
   m_rxCallback.Nullify ();
   m_icmpCallback.Nullify ();
   m_destroyCallback.Nullify ();
+  m_changeCallback.Nullify ();
 }
 
 Ipv6Address Ipv6EndPoint::GetLocalAddress ()
@@ -57,6 +58,10 @@ Ipv6Address Ipv6EndPoint::GetLocalAddress ()
 void Ipv6EndPoint::SetLocalAddress (Ipv6Address addr)
 {
   m_localAddr = addr;
+  if (!m_changeCallback.IsNull ())
+    {
+      m_changeCallback (this);
+    }
 }
 
 uint16_t Ipv6EndPoint::GetLocalPort ()
@@ -94,6 +99,10 @@ void Ipv6EndPoint::SetPeer (Ipv6Address addr, uint16_t port)
 {
   m_peerAddr = addr;
   m_peerPort = port;
+  if (!m_changeCallback.IsNull ())
+    {
+      m_changeCallback (this);
+    }
 }
 
 void Ipv6EndPoint::SetRxCallback (Callback<void, Ptr<Packet>, Ipv6Header, uint16_t, Ptr<Ipv6Interface> > callback)
@@ -111,6 +120,11 @@ void Ipv6EndPoint::SetDestroyCallback (Callback<void> callback)
   m_destroyCallback = callback;
 }
 
+void Ipv6EndPoint::SetChangeCallback (Callback<void, Ipv6EndPoint *> callback)
+{
+  m_changeCallback = callback;
+}
+
 void Ipv6EndPoint::ForwardUp (Ptr<Packet> p, Ipv6Header header, uint16_t port, Ptr<Ipv6Interface> incomingInterface)
 {
   if (!m_rxCallback.IsNull ())
@@ -577,10 +577,6 @@ void Ipv6ExtensionFragment::GetFragments (Ptr<Packet> packet, Ipv6Header ipv6Hea
 
       ipv6Header.SetPayloadLength (fragment->GetSize ());
 
-      std::ostringstream oss;
-      oss << ipv6Header;
-      fragment->Print (oss);
-
       listFragments.push_back (Ipv6PayloadHeaderPair (fragment, ipv6Header));
     }
   while (moreFragment);
@@ -622,7 +618,9 @@ void Ipv6ExtensionFragment::HandleFragmentsTimeout (std::pair<Ipv6Address, uint3
 }
 
 Ipv6ExtensionFragment::Fragments::Fragments ()
-  : m_moreFragment (0)
+  : m_moreFragment (0),
+    m_chainEnd (0),
+    m_chainSize (0)
 {
 }
 
@@ -632,22 +630,26 @@ Ipv6ExtensionFragment::Fragments::~Fragments ()
 
 void Ipv6ExtensionFragment::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
 {
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
-
-  for (it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
-    {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
-    }
+  // A fragment is inserted after the ones with the same offset
+  std::multimap<uint16_t, Ptr<Packet> >::iterator it = m_packetFragments.upper_bound (fragmentOffset);
 
   if (it == m_packetFragments.end ())
     {
       m_moreFragment = moreFragment;
     }
 
-  m_packetFragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+  it = m_packetFragments.insert (it, std::make_pair (fragmentOffset, fragment));
+
+  // If the fragment starts where the chain ends, it extends the chain
+  // together with the fragments which follow it without gaps.
+  // A fragment overlapping the chain never joins it, hence the packet
+  // is never entire, as the fragments must not overlap.
+  while (it != m_packetFragments.end () && it->first == m_chainEnd)
+    {
+      m_chainEnd += it->second->GetSize ();
+      m_chainSize++;
+      it++;
+    }
 }
 
 void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfragmentablePart)
@@ -657,34 +659,19 @@ void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfrag
 
 bool Ipv6ExtensionFragment::Fragments::IsEntire () const
 {
-  bool ret = !m_moreFragment && m_packetFragments.size () > 0;
-
-  if (ret)
-    {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
-        {
-          if (lastEndOffset != it->second)
-            {
-              ret = false;
-              break;
-            }
-
-          lastEndOffset += it->first->GetSize ();
-        }
-    }
-
-  return ret;
+  return !m_moreFragment && m_packetFragments.size () > 0
+         && m_chainSize == m_packetFragments.size ();
 }
 
 Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPacket () const
 {
   Ptr<Packet> p =  m_unfragmentable->Copy ();
+  // Copy each byte only once while gathering the fragments
+  p->ReserveAtEnd (m_chainEnd);
 
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  for (std::multimap<uint16_t, Ptr<Packet> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
     {
-      p->AddAtEnd (it->first);
+      p->AddAtEnd (it->second);
     }
 
   return p;
@@ -703,16 +690,17 @@ Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPartialPacket () const
       return p;
     }
 
-  uint16_t lastEndOffset = 0;
+  p->ReserveAtEnd (m_chainEnd);
+  uint32_t lastEndOffset = 0;
 
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
+  for (std::multimap<uint16_t, Ptr<Packet> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
     {
-      if (lastEndOffset != it->second)
+      if (lastEndOffset != it->first)
         {
           break;
         }
-      p->AddAtEnd (it->first);
-      lastEndOffset += it->first->GetSize ();
+      p->AddAtEnd (it->second);
+      lastEndOffset += it->second->GetSize ();
     }
 
   return p;
@@ -384,9 +384,20 @@ private:
     bool m_moreFragment;
 
     /**
-     * \brief The current fragments.
+     * \brief The current fragments, sorted by offset.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_packetFragments;
+    std::multimap<uint16_t, Ptr<Packet> > m_packetFragments;
+
+    /**
+     * \brief The end of the chain of fragments starting at offset 0,
+     * in which each fragment starts where the previous one ends.
+     */
+    uint32_t m_chainEnd;
+
+    /**
+     * \brief The number of fragments in the chain.
+     */
+    uint32_t m_chainSize;
 
     /**
      * \brief The unfragmentable part.
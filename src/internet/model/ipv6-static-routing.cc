@@ -47,7 +47,9 @@ TypeId Ipv6StaticRouting::GetTypeId ()
 }
 
 Ipv6StaticRouting::Ipv6StaticRouting ()
-  : m_ipv6 (0)
+  : m_networkRouteTrieValid (false),
+    m_networkRouteTrieUsable (false),
+    m_ipv6 (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -152,6 +154,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface);
   m_networkRoutes.push_back (std::make_pair (route, metric));
+  m_networkRouteTrieValid = false;
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -165,6 +168,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface, prefixToUse);
   m_networkRoutes.push_back (std::make_pair (route, metric));
+  m_networkRouteTrieValid = false;
 }
 
 void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, uint32_t interface, uint32_t metric)
@@ -173,6 +177,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   Ipv6RoutingTableEntry* route = new Ipv6RoutingTableEntry ();
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, interface);
   m_networkRoutes.push_back (std::make_pair (route, metric));
+  m_networkRouteTrieValid = false;
 }
 
 void Ipv6StaticRouting::SetDefaultRoute (Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse, uint32_t metric)
@@ -197,6 +202,7 @@ void Ipv6StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   Ipv6Prefix networkMask = Ipv6Prefix (8);
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, outputInterface);
   m_networkRoutes.push_back (std::make_pair (route, 0));
+  m_networkRouteTrieValid = false;
 }
 
 uint32_t Ipv6StaticRouting::GetNMulticastRoutes () const
@@ -285,8 +291,6 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
 {
   NS_LOG_FUNCTION (this << dst << interface);
   Ptr<Ipv6Route> rtentry = 0;
-  uint16_t longestMask = 0;
-  uint32_t shortestMetric = 0xffffffff;
 
   /* when sending on link-local multicast, there have to be interface specified */
   if (dst.IsLinkLocalMulticast ())
@@ -300,70 +304,116 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
       return rtentry;
     }
 
-  for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+  // Among the routes matching the destination (on the requested
+  // interface), the one with the longest prefix wins. Among routes with
+  // the same prefix, the last one with the lowest metric wins, except for
+  // host routes, for which the first one wins.
+  Ipv6RoutingTableEntry *bestRoute = 0;
+  UpdateNetworkRouteTrie ();
+  if (m_networkRouteTrieUsable)
     {
-      Ipv6RoutingTableEntry* j = it->first;
-      uint32_t metric = it->second;
-      Ipv6Prefix mask = j->GetDestNetworkPrefix ();
-      uint16_t maskLen = mask.GetPrefixLength ();
-      Ipv6Address entry = j->GetDestNetwork ();
-
-      NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
-
-      if (mask.IsMatch (dst, entry))
+      uint8_t dstBytes[16];
+      dst.GetBytes (dstBytes);
+      const std::vector<NetworkRouteRef> *matches[129];
+      uint32_t nMatches = m_networkRouteTrie.Lookup (dstBytes, 128, matches);
+      for (uint32_t m = nMatches; m > 0 && bestRoute == 0; m--)
         {
-          NS_LOG_LOGIC ("Found global network route " << *j << ", mask length " << maskLen << ", metric " << metric);
-
-          /* if interface is given, check the route will output on this interface */
-          if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
+          uint32_t shortestMetric = 0xffffffff;
+          for (std::vector<NetworkRouteRef>::const_iterator it = matches[m - 1]->begin ();
+               it != matches[m - 1]->end ();
+               it++)
             {
-              if (maskLen < longestMask)
+              if (interface && interface != m_ipv6->GetNetDevice (it->route->GetInterface ()))
                 {
-                  NS_LOG_LOGIC ("Previous match longer, skipping");
                   continue;
                 }
-
-              if (maskLen > longestMask)
-                {
-                  shortestMetric = 0xffffffff;
-                }
-
-              longestMask = maskLen;
-              if (metric > shortestMetric)
+              if (it->metric > shortestMetric)
                 {
                   NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
                   continue;
                 }
-
-              shortestMetric = metric;
-              Ipv6RoutingTableEntry* route = j;
-              uint32_t interfaceIdx = route->GetInterface ();
-              rtentry = Create<Ipv6Route> ();
-
-              if (route->GetGateway ().IsAny ())
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
-                }
-              else if (route->GetDest ().IsAny ()) /* default route */
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
-                }
-              else
+              shortestMetric = it->metric;
+              bestRoute = it->route;
+              if (it->prefixLength == 128)
                 {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
+                  break;
                 }
+            }
+        }
+    }
+  else
+    {
+      uint16_t longestMask = 0;
+      uint32_t shortestMetric = 0xffffffff;
+      for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+        {
+          Ipv6RoutingTableEntry* j = it->first;
+          uint32_t metric = it->second;
+          Ipv6Prefix mask = j->GetDestNetworkPrefix ();
+          uint16_t maskLen = mask.GetPrefixLength ();
+          Ipv6Address entry = j->GetDestNetwork ();
+
+          NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
+
+          if (mask.IsMatch (dst, entry))
+            {
+              NS_LOG_LOGIC ("Found global network route " << *j << ", mask length " << maskLen << ", metric " << metric);
 
-              rtentry->SetDestination (route->GetDest ());
-              rtentry->SetGateway (route->GetGateway ());
-              rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
-              if (maskLen == 128)
+              /* if interface is given, check the route will output on this interface */
+              if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
                 {
-                  break;
+                  if (maskLen < longestMask)
+                    {
+                      NS_LOG_LOGIC ("Previous match longer, skipping");
+                      continue;
+                    }
+
+                  if (maskLen > longestMask)
+                    {
+                      shortestMetric = 0xffffffff;
+                    }
+
+                  longestMask = maskLen;
+                  if (metric > shortestMetric)
+                    {
+                      NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+                      continue;
+                    }
+
+                  shortestMetric = metric;
+                  bestRoute = j;
+                  if (maskLen == 128)
+                    {
+                      break;
+                    }
                 }
             }
         }
     }
 
+  if (bestRoute != 0)
+    {
+      uint32_t interfaceIdx = bestRoute->GetInterface ();
+      rtentry = Create<Ipv6Route> ();
+
+      if (bestRoute->GetGateway ().IsAny ())
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, bestRoute->GetDest ()));
+        }
+      else if (bestRoute->GetDest ().IsAny ()) /* default route */
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, bestRoute->GetPrefixToUse ().IsAny () ? dst : bestRoute->GetPrefixToUse ()));
+        }
+      else
+        {
+          rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, bestRoute->GetGateway ()));
+        }
+
+      rtentry->SetDestination (bestRoute->GetDest ());
+      rtentry->SetGateway (bestRoute->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
+    }
+
   if (rtentry)
     {
       NS_LOG_LOGIC ("Matching route via " << rtentry->GetDestination () << " (Through " << rtentry->GetGateway () << ") at the end");
@@ -371,6 +421,46 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
   return rtentry;
 }
 
+void Ipv6StaticRouting::UpdateNetworkRouteTrie (void)
+{
+  if (m_networkRouteTrieValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_networkRouteTrie.Clear ();
+  m_networkRouteTrieUsable = true;
+  for (NetworkRoutesCI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+    {
+      Ipv6Prefix prefix = it->first->GetDestNetworkPrefix ();
+      uint8_t prefixLength = prefix.GetPrefixLength ();
+      uint8_t prefixBytes[16];
+      prefix.GetBytes (prefixBytes);
+      bool contiguous = true;
+      for (uint8_t i = 0; i < 16; i++)
+        {
+          uint8_t bits = prefixLength > i * 8 ? prefixLength - i * 8 : 0;
+          uint8_t expected = bits >= 8 ? 0xff : (uint8_t)(0xff00 >> bits);
+          contiguous = contiguous && prefixBytes[i] == expected;
+        }
+      if (!contiguous)
+        {
+          NS_LOG_LOGIC ("Non-contiguous prefix " << prefix << ", the routes will be scanned");
+          m_networkRouteTrieUsable = false;
+          m_networkRouteTrie.Clear ();
+          break;
+        }
+      NetworkRouteRef ref;
+      ref.route = it->first;
+      ref.metric = it->second;
+      ref.prefixLength = prefixLength;
+      uint8_t network[16];
+      it->first->GetDestNetwork ().GetBytes (network);
+      m_networkRouteTrie.Insert (network, prefixLength, ref);
+    }
+  m_networkRouteTrieValid = true;
+}
+
 void Ipv6StaticRouting::DoDispose ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -380,6 +470,8 @@ void Ipv6StaticRouting::DoDispose ()
       delete j->first;
     }
   m_networkRoutes.clear ();
+  m_networkRouteTrie.Clear ();
+  m_networkRouteTrieValid = false;
 
   for (MulticastRoutesI i = m_multicastRoutes.begin (); i != m_multicastRoutes.end (); i = m_multicastRoutes.erase (i))
     {
@@ -530,6 +622,7 @@ void Ipv6StaticRouting::RemoveRoute (uint32_t index)
         {
           delete it->first;
           m_networkRoutes.erase (it);
+          m_networkRouteTrieValid = false;
           return;
         }
       tmp++;
@@ -549,6 +642,7 @@ void Ipv6StaticRouting::RemoveRoute (Ipv6Address network, Ipv6Prefix prefix, uin
         {
           delete it->first;
           m_networkRoutes.erase (it);
+          m_networkRouteTrieValid = false;
           return;
         }
     }
@@ -674,6 +768,7 @@ void Ipv6StaticRouting::NotifyInterfaceDown (uint32_t i)
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_networkRouteTrieValid = false;
         }
       else
         {
@@ -719,6 +814,7 @@ void Ipv6StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAd
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_networkRouteTrieValid = false;
         }
       else
         {
@@ -763,6 +859,7 @@ void Ipv6StaticRouting::NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv
             {
               delete j->first;
               j = m_networkRoutes.erase (j);
+              m_networkRouteTrieValid = false;
             }
           else
             {
@@ -30,6 +30,7 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/ip-prefix-trie.h"
 
 namespace ns3 {
 
@@ -56,6 +57,10 @@ class Ipv6MulticastRoutingTableEntry;
  * Ipv6RoutingProtocol that defines the interface methods that a routing
  * protocol must support.
  *
+ * The network routes are indexed by an IpPrefixTrie, rebuilt on the
+ * first lookup after the routes change, so that the cost of a lookup
+ * does not grow with the number of routes.
+ *
  * \see Ipv6RoutingProtocol
  * \see Ipv6ListRouting
  * \see Ipv6ListRouting::AddRoutingProtocol
@@ -264,6 +269,14 @@ private:
   /// Iterator for container for the multicast routes
   typedef std::list<Ipv6MulticastRoutingTableEntry *>::iterator MulticastRoutesI;
 
+  /// A network route, as indexed by the trie
+  struct NetworkRouteRef
+  {
+    Ipv6RoutingTableEntry *route; //!< the route
+    uint32_t metric;              //!< the metric of the route
+    uint8_t prefixLength;         //!< the length of the network prefix
+  };
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -272,6 +285,12 @@ private:
    */
   Ptr<Ipv6Route> LookupStatic (Ipv6Address dest, Ptr<NetDevice> = 0);
 
+  /**
+   * \brief Rebuild the trie of the network routes, if they changed
+   * since the last lookup.
+   */
+  void UpdateNetworkRouteTrie (void);
+
   /**
    * \brief Lookup in the multicast forwarding table for destination.
    * \param origin source address
@@ -286,6 +305,22 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes, indexed by destination prefix.
+   */
+  IpPrefixTrie<NetworkRouteRef> m_networkRouteTrie;
+
+  /**
+   * \brief whether m_networkRouteTrie reflects m_networkRoutes.
+   */
+  bool m_networkRouteTrieValid;
+
+  /**
+   * \brief false if some network prefix is not contiguous, in which case
+   * the network routes are scanned instead of using the trie.
+   */
+  bool m_networkRouteTrieUsable;
+
   /**
    * \brief the forwarding table for multicast.
    */
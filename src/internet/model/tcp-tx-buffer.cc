@@ -96,7 +96,8 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n)
+  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n),
+    m_lostUpTo (n)
 {
 }
 
@@ -163,12 +164,17 @@ TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
 
   if (m_sentList.size () > 0)
     {
+      m_sentIndex.erase (m_sentList.front ()->m_startSeq);
+      UnscoreItem (m_sentList.front ());
       m_sentList.front ()->m_startSeq = seq;
+      IndexSentItem (m_sentList.begin ());
+      ScoreItem (m_sentList.front ());
     }
 
   // if you change the head with data already sent, something bad will happen
   NS_ASSERT (m_sentList.size () == 0);
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_lostUpTo = seq;
 }
 
 bool
@@ -294,7 +300,8 @@ TcpTxBuffer::GetNewSegment (uint32_t numBytes)
   NS_ASSERT (it != m_appList.end ());
 
   m_appList.erase (it);
-  m_sentList.insert (m_sentList.end (), item);
+  IndexSentItem (m_sentList.insert (m_sentList.end (), item));
+  ScoreItem (item);
   m_sentSize += item->m_packet->GetSize ();
 
   return item;
@@ -308,36 +315,32 @@ TcpTxBuffer::GetTransmittedSegment (uint32_t numBytes, const SequenceNumber32 &s
   NS_ASSERT (numBytes <= m_sentSize);
   NS_ASSERT (m_sentList.size () >= 1);
 
-  auto it = m_sentList.begin ();
+  auto it = FindSentItem (seq);
   bool listEdited = false;
   uint32_t s = numBytes;
 
   // Avoid to merge different packet for this retransmission if flags are
   // different.
-  for (; it != m_sentList.end(); ++it)
+  if (it != m_sentList.end () && (*it)->m_startSeq == seq)
     {
-      if ((*it)->m_startSeq == seq)
+      auto next = it;
+      next++;
+      if (next != m_sentList.end ())
         {
-          auto next = it;
-          next++;
-          if (next != m_sentList.end ())
+          // Next is not sacked... there is the possibility to merge
+          if (! (*next)->m_sacked)
             {
-              // Next is not sacked... there is the possibility to merge
-              if (! (*next)->m_sacked)
-                {
-                  s = std::min(s, (*it)->m_packet->GetSize () + (*next)->m_packet->GetSize ());
-                }
-              else
-                {
-                  // Next is sacked... better to retransmit only the first segment
-                  s = std::min(s, (*it)->m_packet->GetSize ());
-                }
+              s = std::min(s, (*it)->m_packet->GetSize () + (*next)->m_packet->GetSize ());
             }
           else
             {
+              // Next is sacked... better to retransmit only the first segment
               s = std::min(s, (*it)->m_packet->GetSize ());
             }
-          break;
+        }
+      else
+        {
+          s = std::min(s, (*it)->m_packet->GetSize ());
         }
     }
 
@@ -345,8 +348,10 @@ TcpTxBuffer::GetTransmittedSegment (uint32_t numBytes, const SequenceNumber32 &s
 
   if (! item->m_retrans)
     {
+      UnscoreItem (item);
       m_retrans += item->m_packet->GetSize ();
       item->m_retrans = true;
+      ScoreItem (item);
     }
 
   return item;
@@ -395,10 +400,70 @@ TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const
   NS_LOG_INFO ("Split of size " << size << " result: t1 " << *t1 << " t2 " << *t2);
 }
 
+TcpTxBuffer::PacketList::iterator
+TcpTxBuffer::FindSentItem (const SequenceNumber32 &seq)
+{
+  SentIndex::iterator i = m_sentIndex.upper_bound (seq);
+  if (i == m_sentIndex.begin ())
+    {
+      return m_sentList.begin ();
+    }
+  return (--i)->second;
+}
+
+void
+TcpTxBuffer::IndexSentItem (PacketList::iterator it)
+{
+  m_sentIndex[(*it)->m_startSeq] = it;
+}
+
+void
+TcpTxBuffer::ScoreItem (const TcpTxItem *item)
+{
+  if (item->m_sacked)
+    {
+      m_sackedSeqs.insert (item->m_startSeq);
+    }
+  if (item->m_lost)
+    {
+      m_lostSeqs.insert (item->m_startSeq);
+    }
+  if (!item->m_sacked && !item->m_retrans)
+    {
+      m_pendingSeqs.insert (item->m_startSeq);
+      if (item->m_lost)
+        {
+          m_pendingLostSeqs.insert (item->m_startSeq);
+        }
+    }
+}
+
+void
+TcpTxBuffer::UnscoreItem (const TcpTxItem *item)
+{
+  m_sackedSeqs.erase (item->m_startSeq);
+  m_lostSeqs.erase (item->m_startSeq);
+  m_pendingSeqs.erase (item->m_startSeq);
+  m_pendingLostSeqs.erase (item->m_startSeq);
+}
+
+void
+TcpTxBuffer::RebuildScoreboard ()
+{
+  m_sackedSeqs.clear ();
+  m_lostSeqs.clear ();
+  m_pendingSeqs.clear ();
+  m_pendingLostSeqs.clear ();
+  for (auto it = m_sentList.begin (); it != m_sentList.end (); ++it)
+    {
+      ScoreItem (*it);
+    }
+}
+
 TcpTxItem*
 TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listStartFrom,
                                 uint32_t numBytes, const SequenceNumber32 &seq,
-                                bool *listEdited) const
+                                bool *listEdited)
 {
   NS_LOG_FUNCTION (this << numBytes << seq);
 
@@ -432,14 +497,23 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
   Ptr<Packet> currentPacket = nullptr;
   TcpTxItem *currentItem = nullptr;
   TcpTxItem *outItem = nullptr;
+  bool isSentList = &list == &m_sentList;
   PacketList::iterator it = list.begin ();
   SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+  if (isSentList && it != list.end ())
+    {
+      // The items of the sent list know their sequence, so the walk can
+      // start from the one that contains seq.
+      it = FindSentItem (seq);
+      beginOfCurrentPacket = (*it)->m_startSeq;
+    }
+
   while (it != list.end ())
     {
       currentItem = *it;
       currentPacket = currentItem->m_packet;
-      NS_ASSERT_MSG (list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+      NS_ASSERT_MSG (!isSentList || currentItem->m_startSeq >= m_firstByteSeq,
                      "start: " << m_firstByteSeq << " currentItem start: " <<
                      currentItem->m_startSeq);
 
@@ -469,7 +543,15 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
               SplitItems (firstPart, currentItem, seq - beginOfCurrentPacket);
 
               // insert firstPart before currentItem
-              list.insert (it, firstPart);
+              PacketList::iterator firstPartIt = list.insert (it, firstPart);
+              if (isSentList)
+                {
+                  // firstPart takes the place of currentItem in the
+                  // scoreboard, with the same flags
+                  IndexSentItem (firstPartIt);
+                  IndexSentItem (it);
+                  ScoreItem (currentItem);
+                }
               if (listEdited)
                 {
                   *listEdited = true;
@@ -513,11 +595,22 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
                   // current > outPacket in the list. Merge current with the
                   // previous, and recurse.
                   NS_ASSERT (it != list.begin ());
+                  PacketList::iterator currentIt = it;
                   TcpTxItem *previous = *(--it);
 
-                  list.erase (it);
+                  if (isSentList)
+                    {
+                      m_sentIndex.erase (currentItem->m_startSeq);
+                      UnscoreItem (currentItem);
+                      UnscoreItem (previous);
+                    }
+                  list.erase (currentIt);
 
                   MergeItems (previous, currentItem);
+                  if (isSentList)
+                    {
+                      ScoreItem (previous);
+                    }
                   delete currentItem;
                   if (listEdited)
                     {
@@ -535,7 +628,15 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
               SplitItems (firstPart, currentItem, numBytes);
 
               // insert firstPart before currentItem
-              list.insert (it, firstPart);
+              PacketList::iterator firstPartIt = list.insert (it, firstPart);
+              if (isSentList)
+                {
+                  // firstPart takes the place of currentItem in the
+                  // scoreboard, with the same flags
+                  IndexSentItem (firstPartIt);
+                  IndexSentItem (it);
+                  ScoreItem (currentItem);
+                }
               if (listEdited)
                 {
                   *listEdited = true;
@@ -563,7 +664,17 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
           TcpTxItem *next = (*it); // Please remember we have incremented it
                                    // in the previous if
 
+          if (isSentList)
+            {
+              UnscoreItem (currentItem);
+              UnscoreItem (next);
+            }
           MergeItems (currentItem, next);
+          if (isSentList)
+            {
+              m_sentIndex.erase (next->m_startSeq);
+              ScoreItem (currentItem);
+            }
           list.erase (it);
 
           delete next;
@@ -693,6 +804,8 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
 
           RemoveFromCounts (item, pktSize);
 
+          m_sentIndex.erase (item->m_startSeq);
+          UnscoreItem (item);
           i = m_sentList.erase (i);
           NS_LOG_INFO ("Removed " << *item << " lost: " << m_lostOut <<
                        " retrans: " << m_retrans << " sacked: " << m_sackedOut <<
@@ -705,7 +818,11 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
           NS_LOG_INFO (*item);
           // PacketTags are preserved when fragmenting
           item->m_packet = item->m_packet->CreateFragment (offset, pktSize);
+          m_sentIndex.erase (item->m_startSeq);
+          UnscoreItem (item);
           item->m_startSeq += offset;
+          IndexSentItem (i);
+          ScoreItem (item);
           m_size -= offset;
           m_sentSize -= offset;
           m_firstByteSeq += offset;
@@ -733,8 +850,11 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
           // It is not possible to have the UNA sacked; otherwise, it would
           // have been ACKed. This is, most likely, our wrong guessing
           // when adding Reno dupacks in the count.
+          UnscoreItem (head);
           head->m_sacked = false;
           m_sackedOut -= head->m_packet->GetSize ();
+          ScoreItem (head);
+          m_lostUpTo = m_firstByteSeq;
           NS_LOG_INFO ("Moving the SACK flag from the HEAD to another segment");
           AddRenoSack ();
           MarkHeadAsLost ();
@@ -749,6 +869,10 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
     {
       m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
     }
+  if (m_lostUpTo < m_firstByteSeq)
+    {
+      m_lostUpTo = m_firstByteSeq;
+    }
 
   NS_LOG_DEBUG ("Discarded up to " << seq << " lost: " << m_lostOut <<
                 " retrans: " << m_retrans << " sacked: " << m_sackedOut);
@@ -768,15 +892,21 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list)
 
   for (auto option_it = list.begin (); option_it != list.end (); ++option_it)
     {
-      PacketList::iterator item_it = m_sentList.begin ();
-      SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
       if (m_firstByteSeq + m_sentSize < (*option_it).first && !modified)
         {
           NS_LOG_INFO ("Not updating scoreboard, the option block is outside the sent list");
           return false;
         }
 
+      // The items before the one containing the start of the block can
+      // not be covered by it
+      PacketList::iterator item_it = FindSentItem ((*option_it).first);
+      SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
+      if (item_it != m_sentList.end ())
+        {
+          beginOfCurrentPacket = (*item_it)->m_startSeq;
+        }
+
       while (item_it != m_sentList.end ())
         {
           uint32_t pktSize = (*item_it)->m_packet->GetSize ();
@@ -798,6 +928,7 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list)
                 }
               else
                 {
+                  UnscoreItem (*item_it);
                   if ((*item_it)->m_lost)
                     {
                       (*item_it)->m_lost = false;
@@ -806,6 +937,7 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list)
 
                   (*item_it)->m_sacked = true;
                   m_sackedOut += (*item_it)->m_packet->GetSize ();
+                  ScoreItem (*item_it);
 
                   if (m_highestSack.first == m_sentList.end()
                       || m_highestSack.second <= beginOfCurrentPacket + pktSize)
@@ -852,8 +984,6 @@ void
 TcpTxBuffer::UpdateLostCount ()
 {
   NS_LOG_FUNCTION (this);
-  uint32_t sacked = 0;
-  SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
   if (m_highestSack.first == m_sentList.end ())
     {
       NS_LOG_INFO ("Status before the update: " << *this <<
@@ -865,32 +995,49 @@ TcpTxBuffer::UpdateLostCount ()
                    ", will start from item " << *(*m_highestSack.first));
     }
 
-  for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+  // Count the sacked items from the highest one down to the second item:
+  // the item where the count reaches the threshold, and everything below,
+  // is lost if not sacked.
+  SequenceNumber32 headSeq = m_sentList.front ()->m_startSeq;
+  SequenceNumber32 thresholdSeq = (*m_highestSack.first)->m_startSeq;
+  ScoreboardSet::const_iterator sackedIt = m_sackedSeqs.upper_bound (thresholdSeq);
+  uint32_t sacked = 0;
+  while (sacked < m_dupAckThresh && sackedIt != m_sackedSeqs.begin ()
+         && *(--sackedIt) != headSeq)
     {
-      TcpTxItem *item = *it;
-      if (item->m_sacked)
-        {
-          sacked++;
-        }
+      thresholdSeq = *sackedIt;
+      sacked++;
+    }
 
-      if (sacked >= m_dupAckThresh)
+  if (sacked >= m_dupAckThresh)
+    {
+      // The items below m_lostUpTo are already lost or sacked
+      PacketList::iterator it = m_sentIndex.find (thresholdSeq)->second;
+      SequenceNumber32 thresholdEnd = thresholdSeq + (*it)->m_packet->GetSize ();
+      for (; it != m_sentList.begin () && (*it)->m_startSeq >= m_lostUpTo; --it)
         {
+          TcpTxItem *item = *it;
           if (!item->m_sacked && !item->m_lost)
             {
+              UnscoreItem (item);
               item->m_lost = true;
               m_lostOut += item->m_packet->GetSize ();
+              ScoreItem (item);
             }
         }
-      beginOfCurrentPacket -= item->m_packet->GetSize ();
-    }
 
-  if (sacked >= m_dupAckThresh)
-    {
       TcpTxItem *item = *m_sentList.begin ();
       if (!item->m_lost)
         {
+          UnscoreItem (item);
           item->m_lost = true;
           m_lostOut += item->m_packet->GetSize ();
+          ScoreItem (item);
+        }
+
+      if (m_lostUpTo < thresholdEnd)
+        {
+          m_lostUpTo = thresholdEnd;
         }
     }
   NS_LOG_INFO ("Status after the update: " << *this);
@@ -902,37 +1049,25 @@ TcpTxBuffer::IsLost (const SequenceNumber32 &seq) const
 {
   NS_LOG_FUNCTION (this << seq);
 
-  SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-  PacketList::const_iterator it;
-
   if (seq >= m_highestSack.second)
     {
       return false;
     }
 
-  // In theory, using a map and hints when inserting elements can improve
-  // performance
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // The first item starting at or after seq which is lost or sacked decides
+  ScoreboardSet::const_iterator lost = m_lostSeqs.lower_bound (seq);
+  ScoreboardSet::const_iterator sacked = m_sackedSeqs.lower_bound (seq);
+  if (lost != m_lostSeqs.end ()
+      && (sacked == m_sackedSeqs.end () || *lost <= *sacked))
     {
-      // Search for the right iterator before calling IsLost()
-      if (beginOfCurrentPacket >= seq)
-        {
-          if ((*it)->m_lost == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
-              return true;
-            }
-
-          if ((*it)->m_sacked == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
-              return false;
-            }
-        }
-
-      beginOfCurrentPacket += (*it)->m_packet->GetSize ();
+      NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
+      return true;
     }
 
+  if (sacked != m_sackedSeqs.end ())
+    {
+      NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
+    }
   return false;
 }
 
@@ -954,35 +1089,28 @@ TcpTxBuffer::NextSeg (SequenceNumber32 *seq, bool isRecovery) const
    *
    *     (1.c) IsLost (S2) returns true.
    */
-  PacketList::const_iterator it;
-  TcpTxItem *item;
   SequenceNumber32 seqPerRule3;
   bool isSeqPerRule3Valid = false;
-  SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
 
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // Condition 1.a , 1.b , and 1.c
+  if (!m_pendingLostSeqs.empty ())
     {
-      item = *it;
-
-      // Condition 1.a , 1.b , and 1.c
-      if (item->m_retrans == false && item->m_sacked == false)
+      NS_LOG_INFO("IsLost, returning" << *m_pendingLostSeqs.begin ());
+      *seq = *m_pendingLostSeqs.begin ();
+      return true;
+    }
+  else if (isRecovery && !m_pendingSeqs.empty ())
+    {
+      // The first candidate is taken, unless its sequence is zero (as an
+      // unset seqPerRule3 would be) and another one follows
+      ScoreboardSet::const_iterator pending = m_pendingSeqs.begin ();
+      if (pending->GetValue () == 0 && std::next (pending) != m_pendingSeqs.end ())
         {
-          if (item->m_lost)
-            {
-              NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
-              *seq = beginOfCurrentPkt;
-              return true;
-            }
-          else if (seqPerRule3.GetValue () == 0 && isRecovery)
-            {
-              NS_LOG_INFO ("Saving for rule 3 the seq " << beginOfCurrentPkt);
-              isSeqPerRule3Valid = true;
-              seqPerRule3 = beginOfCurrentPkt;
-            }
+          ++pending;
         }
-
-      // Nothing found, iterate
-      beginOfCurrentPkt += item->m_packet->GetSize ();
+      NS_LOG_INFO ("Saving for rule 3 the seq " << *pending);
+      isSeqPerRule3Valid = true;
+      seqPerRule3 = *pending;
     }
 
   /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1185,7 +1313,9 @@ TcpTxBuffer::ResetRenoSack ()
       (*it)->m_sacked = false;
     }
 
+  RebuildScoreboard ();
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_lostUpTo = m_firstByteSeq;
 }
 
 void
@@ -1203,11 +1333,14 @@ TcpTxBuffer::ResetSentList ()
       m_sentList.pop_back ();
     }
 
+  m_sentIndex.clear ();
+  RebuildScoreboard ();
   m_sentSize = 0;
   m_lostOut = 0;
   m_retrans = 0;
   m_sackedOut = 0;
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_lostUpTo = m_firstByteSeq;
 }
 
 void
@@ -1218,6 +1351,8 @@ TcpTxBuffer::ResetLastSegmentSent ()
     {
       TcpTxItem *item = m_sentList.back ();
 
+      m_sentIndex.erase (item->m_startSeq);
+      UnscoreItem (item);
       m_sentList.pop_back ();
       m_sentSize -= item->m_packet->GetSize ();
       if (item->m_retrans)
@@ -1225,6 +1360,10 @@ TcpTxBuffer::ResetLastSegmentSent ()
           m_retrans -= item->m_packet->GetSize ();
         }
       m_appList.insert (m_appList.begin (), item);
+      if (m_lostUpTo > m_firstByteSeq + m_sentSize)
+        {
+          m_lostUpTo = m_firstByteSeq + m_sentSize;
+        }
     }
   ConsistencyCheck ();
 }
@@ -1271,6 +1410,8 @@ TcpTxBuffer::SetSentListLost (bool resetSack)
       (*it)->m_retrans = false;
     }
 
+  RebuildScoreboard ();
+  m_lostUpTo = m_firstByteSeq + m_sentSize;
   NS_LOG_INFO ("Set sent list lost, status: " << *this);
   NS_ASSERT_MSG (m_sentSize >= m_sackedOut + m_lostOut, *this);
   ConsistencyCheck ();
@@ -1301,8 +1442,10 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead ()
 
   if (m_sentList.front ()->m_retrans)
     {
+      UnscoreItem (m_sentList.front ());
       m_sentList.front ()->m_retrans = false;
       m_retrans -= m_sentList.front ()->m_packet->GetSize ();
+      ScoreItem (m_sentList.front ());
     }
   ConsistencyCheck ();
 }
@@ -1312,6 +1455,8 @@ TcpTxBuffer::MarkHeadAsLost ()
 {
   if (m_sentList.size () > 0)
     {
+      UnscoreItem (m_sentList.front ());
+
       // If the head is sacked (reneging by the receiver the previously sent
       // information) we revert the sacked flag.
       // A sacked head means that we should advance SND.UNA.. so it's an error.
@@ -1332,6 +1477,8 @@ TcpTxBuffer::MarkHeadAsLost ()
           m_sentList.front()->m_lost = true;
           m_lostOut += m_sentList.front ()->m_packet->GetSize ();
         }
+
+      ScoreItem (m_sentList.front ());
     }
   ConsistencyCheck ();
 }
@@ -1356,8 +1503,10 @@ TcpTxBuffer::AddRenoSack (void)
   // Add to the sacked size the size of the first "not sacked" segment
   if (it != m_sentList.end ())
     {
+      UnscoreItem (*it);
       (*it)->m_sacked = true;
       m_sackedOut += (*it)->m_packet->GetSize ();
+      ScoreItem (*it);
       m_highestSack = std::make_pair (it, (*it)->m_startSeq);
       NS_LOG_INFO ("Added a Reno SACK, status: " << *this);
     }
@@ -1383,9 +1532,24 @@ TcpTxBuffer::ConsistencyCheck () const
   uint32_t sacked = 0;
   uint32_t lost = 0;
   uint32_t retrans = 0;
+  SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
+  uint32_t scored = 0;
 
   for (auto it = m_sentList.begin (); it != m_sentList.end (); ++it)
     {
+      const TcpTxItem *item = *it;
+      bool pending = !item->m_sacked && !item->m_retrans;
+      NS_ASSERT_MSG (item->m_startSeq == beginOfCurrentPacket,
+                     "Item " << *item << " should start at " << beginOfCurrentPacket);
+      NS_ASSERT_MSG (m_sackedSeqs.count (item->m_startSeq) == item->m_sacked
+                     && m_lostSeqs.count (item->m_startSeq) == item->m_lost
+                     && m_pendingSeqs.count (item->m_startSeq) == pending
+                     && m_pendingLostSeqs.count (item->m_startSeq) == (pending && item->m_lost),
+                     "Item " << *item << " out of sync with the scoreboard");
+      NS_ASSERT_MSG (item->m_sacked || item->m_lost || item->m_startSeq >= m_lostUpTo,
+                     "Item " << *item << " not lost below " << m_lostUpTo);
+      scored += item->m_sacked + item->m_lost + pending + (pending && item->m_lost);
+      beginOfCurrentPacket += item->m_packet->GetSize ();
       if ((*it)->m_sacked)
         {
           sacked += (*it)->m_packet->GetSize ();
@@ -1398,8 +1562,15 @@ TcpTxBuffer::ConsistencyCheck () const
         {
           retrans += (*it)->m_packet->GetSize ();
         }
+      auto indexed = m_sentIndex.find ((*it)->m_startSeq);
+      NS_ASSERT_MSG (indexed != m_sentIndex.end () && indexed->second == it,
+                     "Item " << **it << " not indexed");
     }
 
+  NS_ASSERT_MSG (m_sentIndex.size () == m_sentList.size (), "Indexed: " <<
+                 m_sentIndex.size () << " sent items: " << m_sentList.size ());
+  NS_ASSERT_MSG (m_sackedSeqs.size () + m_lostSeqs.size () + m_pendingSeqs.size ()
+                 + m_pendingLostSeqs.size () == scored, "Stale items in the scoreboard");
   NS_ASSERT_MSG (sacked == m_sackedOut, "Counted SACK: " << sacked <<
                  " stored SACK: " << m_sackedOut);
   NS_ASSERT_MSG (lost == m_lostOut, " Counted lost: " << lost <<
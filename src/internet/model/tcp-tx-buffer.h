@@ -28,6 +28,8 @@
 #include "ns3/nstime.h"
 #include "ns3/tcp-option-sack.h"
 #include "ns3/packet.h"
+#include <map>
+#include <set>
 
 namespace ns3 {
 class Packet;
@@ -146,6 +148,18 @@ public:
  * connection, the TcpSocketImplementation should provide hints through
  * the MarkHeadAsLost and AddRenoSack methods.
  *
+ * Scoreboard indexes
+ * ------------------
+ *
+ * With large windows the sent list holds thousands of items, and the
+ * scoreboard is queried on every ACK. Besides the list, the buffer keeps
+ * the starting sequence of the sent items in ordered sets, one for each
+ * class of items the queries look for (sacked, lost, not yet retransmitted),
+ * so that IsLost and NextSeg find their answer in logarithmic time, and
+ * Update goes straight to the items covered by a SACK block. UpdateLostCount
+ * remembers the sequence below which every item not sacked is already
+ * marked lost, and does not walk that part of the list again.
+ *
  * \see BytesInFlight
  * \see Size
  * \see SizeFromSequence
@@ -410,6 +424,8 @@ private:
   friend std::ostream & operator<< (std::ostream & os, TcpTxBuffer const & tcpTxBuf);
 
   typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+  typedef std::map<SequenceNumber32, PacketList::iterator> SentIndex; //!< index of the sent items by starting sequence
+  typedef std::set<SequenceNumber32> ScoreboardSet; //!< starting sequences of some sent items
 
   /**
    * \brief Update the lost count
@@ -426,8 +442,8 @@ private:
    * The {New}Reno cases, for now, are managed in TcpSocketBase through the
    * call to MarkHeadAsLost.
    * This function is, therefore, called after a SACK option has been received,
-   * and updates the lost count. It can be probably optimized by not walking
-   * the entire list, but a subset.
+   * and updates the lost count. The items below m_lostUpTo are not walked,
+   * since they are already lost or sacked.
    *
    */
   void UpdateLostCount ();
@@ -560,7 +576,44 @@ private:
    */
   TcpTxItem* GetPacketFromList (PacketList &list, const SequenceNumber32 &startingSeq,
                                 uint32_t numBytes, const SequenceNumber32 &requestedSeq,
-                                bool *listEdited = nullptr) const;
+                                bool *listEdited = nullptr);
+
+  /**
+   * \brief Find the item of the sent list that contains a sequence number
+   *
+   * The items are found through m_sentIndex instead of walking the list.
+   *
+   * \param seq the sequence number
+   * \return the item containing seq, or the first item if seq is before it
+   */
+  PacketList::iterator FindSentItem (const SequenceNumber32 &seq);
+
+  /**
+   * \brief Index an item of the sent list by its starting sequence number
+   * \param it the item
+   */
+  void IndexSentItem (PacketList::iterator it);
+
+  /**
+   * \brief Add an item of the sent list to the scoreboard sets of its flags
+   *
+   * Each change of the flags or of the starting sequence of a sent item must
+   * be surrounded by UnscoreItem and ScoreItem.
+   *
+   * \param item the item
+   */
+  void ScoreItem (const TcpTxItem *item);
+
+  /**
+   * \brief Remove an item of the sent list from the scoreboard sets
+   * \param item the item
+   */
+  void UnscoreItem (const TcpTxItem *item);
+
+  /**
+   * \brief Rebuild the scoreboard sets from the flags of the sent list
+   */
+  void RebuildScoreboard ();
 
   /**
    * \brief Merge two TcpTxItem
@@ -601,12 +654,18 @@ private:
 
   PacketList m_appList;  //!< Buffer for application data
   PacketList m_sentList; //!< Buffer for sent (but not acked) data
+  SentIndex m_sentIndex; //!< Items of m_sentList by starting sequence
+  ScoreboardSet m_sackedSeqs;      //!< Sacked items
+  ScoreboardSet m_lostSeqs;        //!< Lost items
+  ScoreboardSet m_pendingSeqs;     //!< Items neither sacked nor retransmitted
+  ScoreboardSet m_pendingLostSeqs; //!< Lost items neither sacked nor retransmitted
   uint32_t m_maxBuffer;  //!< Max number of data bytes in buffer (SND.WND)
   uint32_t m_size;       //!< Size of all data in this buffer
   uint32_t m_sentSize;   //!< Size of sent (and not discarded) segments
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   std::pair <PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
+  SequenceNumber32 m_lostUpTo; //!< Each sent item not sacked starting below it is lost
 
   uint32_t m_lostOut   {0}; //!< Number of lost bytes
   uint32_t m_sackedOut {0}; //!< Number of sacked bytes
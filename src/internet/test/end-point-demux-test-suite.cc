@@ -0,0 +1,260 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Tests of the lookups of the IPv4 and IPv6 end point demultiplexers:
+// exact matches of connections, fallback to listening and subnet-bound
+// end points, end points whose address or peer change after their
+// allocation, and ephemeral port allocation.
+
+#include "ns3/test.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-interface-address.h"
+#include "ns3/simple-net-device.h"
+#include "../model/ipv4-end-point.h"
+#include "../model/ipv4-end-point-demux.h"
+#include "../model/ipv6-end-point.h"
+#include "../model/ipv6-end-point-demux.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv4EndPointDemux lookup test.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Look up the end point receiving a packet.
+   * \param demux the demux
+   * \param daddr destination address
+   * \param dport destination port
+   * \param saddr source address
+   * \param sport source port
+   * \return the end point, or 0 if none
+   */
+  Ipv4EndPoint *Lookup (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                        Ipv4Address saddr, uint16_t sport);
+
+  Ptr<Ipv4Interface> m_interface; //!< The incoming interface
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Ipv4EndPointDemux lookups")
+{
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::Lookup (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                                   Ipv4Address saddr, uint16_t sport)
+{
+  Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, m_interface);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  m_interface = CreateObject<Ipv4Interface> ();
+  m_interface->AddAddress (Ipv4InterfaceAddress (Ipv4Address ("10.1.1.1"), Ipv4Mask ("255.255.255.0")));
+  Ipv4Address local ("10.1.1.1");
+  Ipv4Address peer ("10.1.1.2");
+  Ipv4EndPointDemux demux;
+
+  // a listening socket and its connections
+  Ipv4EndPoint *listener = demux.Allocate (0, Ipv4Address::GetAny (), 80);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "Allocation failed");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, Ipv4Address::GetAny (), 80), 0, "Duplicated end point allocated");
+  std::vector<Ipv4EndPoint *> connections;
+  for (uint16_t i = 0; i < 1000; i++)
+    {
+      connections.push_back (demux.Allocate (0, local, 80, peer, 1024 + i));
+      NS_TEST_ASSERT_MSG_NE (connections.back (), 0, "Allocation failed");
+    }
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, 80, peer, 1024), 0, "Duplicated end point allocated");
+  for (uint16_t i = 0; i < 1000; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 80, peer, 1024 + i), connections[i], "Wrong connection");
+      NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1024 + i), connections[i], "Wrong connection");
+    }
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 80, peer, 2024), listener, "The listener should get new connections");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 81, peer, 1024), 0, "No end point on this port");
+
+  // an end point that can not receive packets is skipped
+  connections[0]->SetRxEnabled (false);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 80, peer, 1024), listener, "Disabled connection not skipped");
+  connections[0]->SetRxEnabled (true);
+
+  // a listener bound to the local address is preferred to a wildcard one
+  Ipv4EndPoint *wildcardListener = demux.Allocate (0, Ipv4Address::GetAny (), 81);
+  Ipv4EndPoint *boundListener = demux.Allocate (0, local, 81);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 81, peer, 2024), boundListener, "Wrong listener");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, Ipv4Address ("10.1.1.255"), 81, peer, 2024), wildcardListener, "Wrong listener");
+  demux.DeAllocate (boundListener);
+  demux.DeAllocate (wildcardListener);
+
+  // a listener bound to another device does not get the packets
+  Ptr<NetDevice> device = CreateObject<SimpleNetDevice> ();
+  Ipv4EndPoint *deviceListener = demux.Allocate (device, 8080);
+  deviceListener->BindToNetDevice (device);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 8080, peer, 2024), 0, "Bound to another device");
+  demux.DeAllocate (deviceListener);
+
+  // an end point bound to the subnet gets the subnet-directed broadcasts
+  Ipv4EndPoint *subnet = demux.Allocate (0, Ipv4Address ("10.1.1.0"), 53);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, Ipv4Address ("10.1.1.255"), 53, peer, 2024), subnet, "Subnet-directed broadcast");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, Ipv4Address ("10.2.1.255"), 53, peer, 2024), 0, "Other subnet");
+
+  // a client connection gets its peer and local address after the allocation
+  Ipv4EndPoint *client = demux.Allocate ();
+  uint16_t clientPort = client->GetLocalPort ();
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, clientPort, peer, 80), client, "Unconnected client");
+  client->SetPeer (peer, 80);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, clientPort, peer, 80), client, "Connected client");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, clientPort, peer, 81), 0, "Connected client, other peer");
+  client->SetLocalAddress (local);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, clientPort, peer, 80), client, "Connected client");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, clientPort, peer, 80), 0, "Duplicated end point allocated");
+
+  // ephemeral ports are not reused while they are allocated
+  Ipv4EndPoint *client2 = demux.Allocate (local);
+  NS_TEST_EXPECT_MSG_NE (client2->GetLocalPort (), clientPort, "Ephemeral port reused");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (clientPort), true, "Port should be in use");
+  demux.DeAllocate (client);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (clientPort), false, "Port should be free");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, clientPort, peer, 80), 0, "Deallocated client");
+
+  // deallocated connections fall back to the listener
+  demux.DeAllocate (connections[1]);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 80, peer, 1025), listener, "Deallocated connection");
+  demux.DeAllocate (listener);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 80, peer, 1025), 0, "Deallocated listener");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().size (), 1001u, "Wrong number of end points");
+
+  m_interface = 0;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Ipv6EndPointDemux lookup test.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Look up the end point receiving a packet.
+   * \param demux the demux
+   * \param daddr destination address
+   * \param dport destination port
+   * \param saddr source address
+   * \param sport source port
+   * \return the end point, or 0 if none
+   */
+  Ipv6EndPoint *Lookup (Ipv6EndPointDemux &demux, Ipv6Address daddr, uint16_t dport,
+                        Ipv6Address saddr, uint16_t sport);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Ipv6EndPointDemux lookups")
+{
+}
+
+Ipv6EndPoint *
+Ipv6EndPointDemuxTestCase::Lookup (Ipv6EndPointDemux &demux, Ipv6Address daddr, uint16_t dport,
+                                   Ipv6Address saddr, uint16_t sport)
+{
+  Ipv6EndPointDemux::EndPoints endPoints = demux.Lookup (daddr, dport, saddr, sport, 0);
+  return endPoints.empty () ? 0 : endPoints.front ();
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6Address local ("2001:1::1");
+  Ipv6Address peer ("2001:1::2");
+  Ipv6EndPointDemux demux;
+
+  Ipv6EndPoint *listener = demux.Allocate (0, Ipv6Address::GetAny (), 80);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "Allocation failed");
+  std::vector<Ipv6EndPoint *> connections;
+  for (uint16_t i = 0; i < 1000; i++)
+    {
+      connections.push_back (demux.Allocate (0, local, 80, peer, 1024 + i));
+      NS_TEST_ASSERT_MSG_NE (connections.back (), 0, "Allocation failed");
+    }
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, 80, peer, 1024), 0, "Duplicated end point allocated");
+  for (uint16_t i = 0; i < 1000; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 80, peer, 1024 + i), connections[i], "Wrong connection");
+      NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1024 + i), connections[i], "Wrong connection");
+    }
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 80, peer, 2024), listener, "The listener should get new connections");
+
+  Ipv6EndPoint *wildcardListener = demux.Allocate (0, Ipv6Address::GetAny (), 81);
+  Ipv6EndPoint *boundListener = demux.Allocate (0, local, 81);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 81, peer, 2024), boundListener, "Wrong listener");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, Ipv6Address ("2001:1::3"), 81, peer, 2024), wildcardListener, "Wrong listener");
+  demux.DeAllocate (boundListener);
+  demux.DeAllocate (wildcardListener);
+
+  Ipv6EndPoint *client = demux.Allocate ();
+  uint16_t clientPort = client->GetLocalPort ();
+  client->SetPeer (peer, 80);
+  client->SetLocalAddress (local);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, clientPort, peer, 80), client, "Connected client");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, clientPort, peer, 81), 0, "Connected client, other peer");
+  demux.DeAllocate (client);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (clientPort), false, "Port should be free");
+
+  demux.DeAllocate (connections[1]);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 80, peer, 1025), listener, "Deallocated connection");
+  demux.DeAllocate (listener);
+  NS_TEST_EXPECT_MSG_EQ (Lookup (demux, local, 80, peer, 1025), 0, "Deallocated listener");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetEndPoints ().size (), 999u, "Wrong number of end points");
+}
+
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ();
+};
+
+EndPointDemuxTestSuite::EndPointDemuxTestSuite ()
+  : TestSuite ("end-point-demux", UNIT)
+{
+  AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+}
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
@@ -27,6 +27,8 @@
 #include "ns3/candidate-queue.h"
 #include "ns3/simulator.h"
 #include <cstdlib> // for rand()
+#include <list>
+#include <algorithm>
 
 using namespace ns3;
 
@@ -226,6 +228,103 @@ GlobalRouteManagerImplTestCase::DoRun (void)
 }
 
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief CandidateQueue ordering test, against a sorted list
+ */
+class CandidateQueueTestCase : public TestCase
+{
+public:
+  CandidateQueueTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Compare two vertices, as the CandidateQueue does.
+   * \param v1 first vertex
+   * \param v2 second vertex
+   * \returns true if v1 should be popped before v2
+   */
+  static bool IsBefore (const SPFVertex* v1, const SPFVertex* v2);
+};
+
+CandidateQueueTestCase::CandidateQueueTestCase ()
+  : TestCase ("CandidateQueue pops the vertices in order")
+{
+}
+
+bool
+CandidateQueueTestCase::IsBefore (const SPFVertex* v1, const SPFVertex* v2)
+{
+  if (v1->GetDistanceFromRoot () != v2->GetDistanceFromRoot ())
+    {
+      return v1->GetDistanceFromRoot () < v2->GetDistanceFromRoot ();
+    }
+  return v1->GetVertexType () == SPFVertex::VertexNetwork
+         && v2->GetVertexType () == SPFVertex::VertexRouter;
+}
+
+void
+CandidateQueueTestCase::DoRun (void)
+{
+  // the reference is a list sorted with stable algorithms, where vertices
+  // with equal keys are kept in push (or reorder) order
+  CandidateQueue candidate;
+  std::list<SPFVertex*> reference;
+  uint32_t nextId = 1;
+
+  for (int i = 0; i < 2000; ++i)
+    {
+      int action = std::rand () % 4;
+      if (action < 2 || reference.empty ())
+        {
+          SPFVertex *v = new SPFVertex;
+          v->SetVertexId (Ipv4Address (nextId++));
+          v->SetDistanceFromRoot (std::rand () % 20);
+          v->SetVertexType (std::rand () % 2 ? SPFVertex::VertexRouter : SPFVertex::VertexNetwork);
+          candidate.Push (v);
+          reference.insert (std::upper_bound (reference.begin (), reference.end (), v,
+                                              &CandidateQueueTestCase::IsBefore), v);
+        }
+      else if (action == 2)
+        {
+          // decrease the distance of a random vertex
+          std::list<SPFVertex*>::iterator it = reference.begin ();
+          std::advance (it, std::rand () % reference.size ());
+          SPFVertex *v = *it;
+          NS_TEST_ASSERT_MSG_EQ (candidate.Find (v->GetVertexId ()), v, "Vertex not found");
+          if (v->GetDistanceFromRoot () == 0)
+            {
+              continue;
+            }
+          v->SetDistanceFromRoot (std::rand () % v->GetDistanceFromRoot ());
+          candidate.Reorder (v);
+          reference.erase (it);
+          reference.insert (std::upper_bound (reference.begin (), reference.end (), v,
+                                              &CandidateQueueTestCase::IsBefore), v);
+        }
+      else
+        {
+          SPFVertex *v = candidate.Pop ();
+          NS_TEST_ASSERT_MSG_EQ (v, reference.front (), "Wrong vertex popped");
+          reference.pop_front ();
+          NS_TEST_ASSERT_MSG_EQ (candidate.Find (v->GetVertexId ()), 0, "Popped vertex found");
+          delete v;
+        }
+      NS_TEST_ASSERT_MSG_EQ (candidate.Size (), reference.size (), "Wrong size");
+    }
+  while (!candidate.Empty ())
+    {
+      SPFVertex *v = candidate.Pop ();
+      NS_TEST_ASSERT_MSG_EQ (v, reference.front (), "Wrong vertex popped");
+      reference.pop_front ();
+      delete v;
+    }
+}
+
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -243,6 +342,7 @@ GlobalRouteManagerImplTestSuite::GlobalRouteManagerImplTestSuite ()
   : TestSuite ("global-route-manager-impl", UNIT)
 {
   AddTestCase (new GlobalRouteManagerImplTestCase (), TestCase::QUICK);
+  AddTestCase (new CandidateQueueTestCase (), TestCase::QUICK);
 }
 
 static GlobalRouteManagerImplTestSuite g_globalRoutingManagerImplTestSuite; //!< Static variable for test initialization
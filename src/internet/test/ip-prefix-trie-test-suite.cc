@@ -0,0 +1,403 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Tests of the prefix tries indexing the routes of the static and
+// global routing protocols: the routes found through the tries are
+// compared with the ones found by scanning the routing tables, which is
+// what the protocols do when a route has a non-contiguous mask.
+
+#include "ns3/test.h"
+#include "ns3/ip-prefix-trie.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/boolean.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IpPrefixTrie lookup test, against a scan of the prefixes.
+ */
+class IpPrefixTrieLookupTestCase : public TestCase
+{
+public:
+  IpPrefixTrieLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+IpPrefixTrieLookupTestCase::IpPrefixTrieLookupTestCase ()
+  : TestCase ("IpPrefixTrie finds the prefixes matching an address")
+{
+}
+
+void
+IpPrefixTrieLookupTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  IpPrefixTrie<uint32_t> trie;
+
+  // rebuild the trie a few times, to exercise Clear
+  for (uint32_t build = 0; build < 3; build++)
+    {
+      std::vector<std::pair<uint32_t, uint8_t> > prefixes;
+      trie.Clear ();
+      for (uint32_t i = 0; i < 500; i++)
+        {
+          // few distinct high bits, so that prefixes overlap
+          uint32_t prefix = (random->GetInteger (0, 3) << 28) | random->GetInteger (0, 0xfffffff);
+          uint8_t prefixLength = random->GetInteger (0, 32);
+          uint8_t bytes[4] = { uint8_t (prefix >> 24), uint8_t (prefix >> 16), uint8_t (prefix >> 8), uint8_t (prefix) };
+          trie.Insert (bytes, prefixLength, i);
+          prefixes.push_back (std::make_pair (prefix, prefixLength));
+        }
+
+      for (uint32_t i = 0; i < 1000; i++)
+        {
+          uint32_t address = (random->GetInteger (0, 3) << 28) | random->GetInteger (0, 0xfffffff);
+          if (i % 2)
+            {
+              // an address inside one of the prefixes
+              address = prefixes[random->GetInteger (0, prefixes.size () - 1)].first ^ random->GetInteger (0, 0xff);
+            }
+          uint8_t bytes[4] = { uint8_t (address >> 24), uint8_t (address >> 16), uint8_t (address >> 8), uint8_t (address) };
+          const std::vector<uint32_t> *matches[33];
+          uint32_t nMatches = trie.Lookup (bytes, 32, matches);
+
+          // expected values, by prefix length
+          std::vector<std::vector<uint32_t> > expected (33);
+          for (uint32_t p = 0; p < prefixes.size (); p++)
+            {
+              uint8_t len = prefixes[p].second;
+              uint32_t mask = len == 0 ? 0 : 0xffffffff << (32 - len);
+              if ((address & mask) == (prefixes[p].first & mask))
+                {
+                  expected[len].push_back (p);
+                }
+            }
+          uint32_t m = 0;
+          for (uint32_t len = 0; len <= 32; len++)
+            {
+              if (expected[len].empty ())
+                {
+                  continue;
+                }
+              NS_TEST_ASSERT_MSG_LT (m, nMatches, "Missing match for prefix length " << len);
+              NS_TEST_ASSERT_MSG_EQ ((*matches[m] == expected[len]), true, "Wrong values for prefix length " << len);
+              m++;
+            }
+          NS_TEST_ASSERT_MSG_EQ (m, nMatches, "Unexpected matches");
+        }
+    }
+}
+
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the IPv4 static and global routing protocols find
+ * the same routes with and without their tries.
+ */
+class Ipv4RoutingTrieTestCase : public TestCase
+{
+public:
+  Ipv4RoutingTrieTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Compare two routes.
+   * \param a the first route
+   * \param b the second route
+   * \param dest the destination of the lookup
+   */
+  void CompareRoutes (Ptr<Ipv4Route> a, Ptr<Ipv4Route> b, Ipv4Address dest);
+};
+
+Ipv4RoutingTrieTestCase::Ipv4RoutingTrieTestCase ()
+  : TestCase ("IPv4 static and global routing lookups through the tries")
+{
+}
+
+void
+Ipv4RoutingTrieTestCase::CompareRoutes (Ptr<Ipv4Route> a, Ptr<Ipv4Route> b, Ipv4Address dest)
+{
+  NS_TEST_ASSERT_MSG_EQ ((a != 0), (b != 0), "Route found only once for " << dest);
+  if (a != 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (a->GetDestination (), b->GetDestination (), "Different route for " << dest);
+      NS_TEST_EXPECT_MSG_EQ (a->GetGateway (), b->GetGateway (), "Different route for " << dest);
+      NS_TEST_EXPECT_MSG_EQ (a->GetOutputDevice (), b->GetOutputDevice (), "Different route for " << dest);
+      NS_TEST_EXPECT_MSG_EQ (a->GetSource (), b->GetSource (), "Different route for " << dest);
+    }
+}
+
+void
+Ipv4RoutingTrieTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  NodeContainer nodes (node);
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  internet.Install (nodes);
+  SimpleNetDeviceHelper simpleHelper;
+  Ipv4AddressHelper ipv4Helper ("172.16.0.0", "255.255.255.0");
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NetDeviceContainer device = simpleHelper.Install (nodes);
+      ipv4Helper.Assign (device);
+      ipv4Helper.NewNetwork ();
+      devices.Add (device);
+    }
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+
+  Ptr<Ipv4StaticRouting> staticTrie = CreateObject<Ipv4StaticRouting> ();
+  Ptr<Ipv4StaticRouting> staticScan = CreateObject<Ipv4StaticRouting> ();
+  Ptr<Ipv4GlobalRouting> globalTrie = CreateObject<Ipv4GlobalRouting> ();
+  Ptr<Ipv4GlobalRouting> globalScan = CreateObject<Ipv4GlobalRouting> ();
+  staticTrie->SetIpv4 (ipv4);
+  staticScan->SetIpv4 (ipv4);
+  globalTrie->SetIpv4 (ipv4);
+  globalScan->SetIpv4 (ipv4);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (2);
+  for (uint32_t i = 0; i < 400; i++)
+    {
+      // overlapping prefixes, with duplicates (i.e., equal-cost routes)
+      uint32_t interface = random->GetInteger (1, 4);
+      Ipv4Address gateway (0xac100000 | ((interface - 1) << 8) | random->GetInteger (2, 254));
+      uint8_t prefixLength = random->GetInteger (8, 32);
+      Ipv4Mask mask (prefixLength == 0 ? 0 : 0xffffffff << (32 - prefixLength));
+      Ipv4Address network (0x0a000000 | (random->GetInteger (0, 3) << 22) | random->GetInteger (0, 0xff));
+      uint32_t metric = random->GetInteger (0, 2);
+      staticTrie->AddNetworkRouteTo (network, mask, gateway, interface, metric);
+      staticScan->AddNetworkRouteTo (network, mask, gateway, interface, metric);
+      if (prefixLength == 32)
+        {
+          globalTrie->AddHostRouteTo (network, gateway, interface);
+          globalScan->AddHostRouteTo (network, gateway, interface);
+        }
+      else if (i % 8 == 0)
+        {
+          globalTrie->AddASExternalRouteTo (network, mask, gateway, interface);
+          globalScan->AddASExternalRouteTo (network, mask, gateway, interface);
+        }
+      else
+        {
+          globalTrie->AddNetworkRouteTo (network, mask, gateway, interface);
+          globalScan->AddNetworkRouteTo (network, mask, gateway, interface);
+        }
+    }
+  staticTrie->SetDefaultRoute (Ipv4Address ("172.16.3.1"), 4, 5);
+  staticScan->SetDefaultRoute (Ipv4Address ("172.16.3.1"), 4, 5);
+  // a route with a non-contiguous mask, which is never used, forces the
+  // scan of the routing tables
+  staticScan->AddNetworkRouteTo (Ipv4Address ("254.0.1.1"), Ipv4Mask ("255.0.255.255"),
+                                 Ipv4Address ("172.16.0.1"), 1);
+  globalScan->AddNetworkRouteTo (Ipv4Address ("254.0.1.1"), Ipv4Mask ("255.0.255.255"),
+                                 Ipv4Address ("172.16.0.1"), 1);
+
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Ipv4Header header;
+      Ipv4Address dest (0x0a000000 | (random->GetInteger (0, 3) << 22) | random->GetInteger (0, 0x1ff));
+      header.SetDestination (dest);
+      Ptr<NetDevice> oif = 0;
+      if (i % 3 == 0)
+        {
+          oif = devices.Get (random->GetInteger (0, 3));
+        }
+      Socket::SocketErrno err;
+      CompareRoutes (staticTrie->RouteOutput (Create<Packet> (), header, oif, err),
+                     staticScan->RouteOutput (Create<Packet> (), header, oif, err), dest);
+      CompareRoutes (globalTrie->RouteOutput (Create<Packet> (), header, oif, err),
+                     globalScan->RouteOutput (Create<Packet> (), header, oif, err), dest);
+    }
+
+  // with random ECMP routing, the same routes are candidates
+  globalTrie->SetAttribute ("RandomEcmpRouting", BooleanValue (true));
+  globalScan->SetAttribute ("RandomEcmpRouting", BooleanValue (true));
+  globalTrie->AssignStreams (4);
+  globalScan->AssignStreams (4);
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Ipv4Header header;
+      Ipv4Address dest (0x0a000000 | (random->GetInteger (0, 3) << 22) | random->GetInteger (0, 0x1ff));
+      header.SetDestination (dest);
+      Socket::SocketErrno err;
+      CompareRoutes (globalTrie->RouteOutput (Create<Packet> (), header, 0, err),
+                     globalScan->RouteOutput (Create<Packet> (), header, 0, err), dest);
+    }
+  globalTrie->SetAttribute ("RandomEcmpRouting", BooleanValue (false));
+  globalScan->SetAttribute ("RandomEcmpRouting", BooleanValue (false));
+
+  // the tries follow the changes of the routes
+  while (staticTrie->GetNRoutes () > 100)
+    {
+      staticTrie->RemoveRoute (0);
+      staticScan->RemoveRoute (0);
+      globalTrie->RemoveRoute (0);
+      globalScan->RemoveRoute (0);
+    }
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Ipv4Header header;
+      Ipv4Address dest (0x0a000000 | (random->GetInteger (0, 3) << 22) | random->GetInteger (0, 0x1ff));
+      header.SetDestination (dest);
+      Socket::SocketErrno err;
+      CompareRoutes (staticTrie->RouteOutput (Create<Packet> (), header, 0, err),
+                     staticScan->RouteOutput (Create<Packet> (), header, 0, err), dest);
+      CompareRoutes (globalTrie->RouteOutput (Create<Packet> (), header, 0, err),
+                     globalScan->RouteOutput (Create<Packet> (), header, 0, err), dest);
+    }
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the IPv6 static routing protocol finds the same
+ * routes with and without its trie.
+ */
+class Ipv6RoutingTrieTestCase : public TestCase
+{
+public:
+  Ipv6RoutingTrieTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv6RoutingTrieTestCase::Ipv6RoutingTrieTestCase ()
+  : TestCase ("IPv6 static routing lookups through the trie")
+{
+}
+
+void
+Ipv6RoutingTrieTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  NodeContainer nodes (node);
+  InternetStackHelper internet;
+  internet.SetIpv4StackInstall (false);
+  internet.Install (nodes);
+  SimpleNetDeviceHelper simpleHelper;
+  Ipv6AddressHelper ipv6Helper (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NetDeviceContainer device = simpleHelper.Install (nodes);
+      ipv6Helper.Assign (device);
+      ipv6Helper.NewNetwork ();
+      devices.Add (device);
+    }
+  Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
+
+  Ptr<Ipv6StaticRouting> trie = CreateObject<Ipv6StaticRouting> ();
+  Ptr<Ipv6StaticRouting> scan = CreateObject<Ipv6StaticRouting> ();
+  trie->SetIpv6 (ipv6);
+  scan->SetIpv6 (ipv6);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (3);
+  for (uint32_t i = 0; i < 400; i++)
+    {
+      uint32_t interface = random->GetInteger (1, 4);
+      uint8_t prefixLength = random->GetInteger (16, 128);
+      uint8_t bytes[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+      bytes[4] = random->GetInteger (0, 3);
+      bytes[15] = random->GetInteger (0, 0xff);
+      Ipv6Address network (bytes);
+      uint32_t metric = random->GetInteger (0, 2);
+      trie->AddNetworkRouteTo (network, Ipv6Prefix (prefixLength), interface, metric);
+      scan->AddNetworkRouteTo (network, Ipv6Prefix (prefixLength), interface, metric);
+    }
+  uint8_t nonContiguous[16] = { 0xff, 0xff, 0, 0xff };
+  scan->AddNetworkRouteTo (Ipv6Address ("fe00:1:0:1::"), Ipv6Prefix (nonContiguous), 1);
+
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      Ipv6Header header;
+      uint8_t bytes[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+      bytes[4] = random->GetInteger (0, 3);
+      bytes[15] = random->GetInteger (0, 0xff);
+      bytes[14] = random->GetInteger (0, 1);
+      Ipv6Address dest (bytes);
+      header.SetDestinationAddress (dest);
+      Ptr<NetDevice> oif = 0;
+      if (i % 3 == 0)
+        {
+          oif = devices.Get (random->GetInteger (0, 3));
+        }
+      Socket::SocketErrno err;
+      Ptr<Ipv6Route> a = trie->RouteOutput (Create<Packet> (), header, oif, err);
+      Ptr<Ipv6Route> b = scan->RouteOutput (Create<Packet> (), header, oif, err);
+      NS_TEST_ASSERT_MSG_EQ ((a != 0), (b != 0), "Route found only once for " << dest);
+      if (a != 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (a->GetDestination (), b->GetDestination (), "Different route for " << dest);
+          NS_TEST_EXPECT_MSG_EQ (a->GetOutputDevice (), b->GetOutputDevice (), "Different route for " << dest);
+          NS_TEST_EXPECT_MSG_EQ (a->GetSource (), b->GetSource (), "Different route for " << dest);
+        }
+    }
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IP prefix trie TestSuite
+ */
+class IpPrefixTrieTestSuite : public TestSuite
+{
+public:
+  IpPrefixTrieTestSuite ();
+};
+
+IpPrefixTrieTestSuite::IpPrefixTrieTestSuite ()
+  : TestSuite ("ip-prefix-trie", UNIT)
+{
+  AddTestCase (new IpPrefixTrieLookupTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4RoutingTrieTestCase, TestCase::QUICK);
+  AddTestCase (new Ipv6RoutingTrieTestCase, TestCase::QUICK);
+}
+
+static IpPrefixTrieTestSuite g_ipPrefixTrieTestSuite; //!< Static variable for test initialization
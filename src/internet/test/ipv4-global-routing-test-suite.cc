@@ -15,6 +15,7 @@
  */
 
 #include <vector>
+#include <sstream>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/inet-socket-address.h"
@@ -41,6 +42,7 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-global-routing.h"
+#include "ns3/global-router-interface.h"
 #include "ns3/bridge-helper.h"
 
 using namespace ns3;
@@ -1244,6 +1246,175 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that UpdateRoutingTables gives the same routes as
+ * RecomputeRoutingTables, and only recomputes the affected nodes.
+ */
+class Ipv4GlobalRoutingIncrementalTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingIncrementalTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Get the global routes of the nodes.
+   * \param nodes the nodes
+   * \returns the routes of each node, as text
+   */
+  std::vector<std::string> GetRoutes (NodeContainer nodes);
+
+  /**
+   * \brief Get the first global route of a node.
+   * \param node the node
+   * \returns the first route of the node, or 0 if none
+   */
+  Ipv4RoutingTableEntry* GetFirstRoute (Ptr<Node> node);
+
+  /**
+   * \brief Update the routes, and compare them with recomputed ones.
+   * \param nodes the nodes
+   * \param step the description of the topology change
+   */
+  void CheckUpdate (NodeContainer nodes, std::string step);
+};
+
+Ipv4GlobalRoutingIncrementalTestCase::Ipv4GlobalRoutingIncrementalTestCase ()
+  : TestCase ("Incremental global routing updates")
+{
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingIncrementalTestCase::GetRoutes (NodeContainer nodes)
+{
+  std::vector<std::string> routes;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      std::ostringstream oss;
+      for (uint32_t j = 0; j < gr->GetNRoutes (); j++)
+        {
+          oss << *gr->GetRoute (j) << std::endl;
+        }
+      routes.push_back (oss.str ());
+    }
+  return routes;
+}
+
+Ipv4RoutingTableEntry*
+Ipv4GlobalRoutingIncrementalTestCase::GetFirstRoute (Ptr<Node> node)
+{
+  Ptr<Ipv4GlobalRouting> gr = node->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  return gr->GetNRoutes () > 0 ? gr->GetRoute (0) : 0;
+}
+
+void
+Ipv4GlobalRoutingIncrementalTestCase::CheckUpdate (NodeContainer nodes, std::string step)
+{
+  Ipv4GlobalRoutingHelper::UpdateRoutingTables ();
+  std::vector<std::string> updated = GetRoutes (nodes);
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> recomputed = GetRoutes (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (updated[i], recomputed[i], "Different routes for node " << i << " after " << step);
+    }
+}
+
+// Ring of five routers, with two hosts on each router and a LAN between
+// routers 0 and 1.  Links are brought down and up, and a route is
+// injected, and after each change the updated routes are compared with the
+// recomputed ones.  (The ring has an odd size so that there are no
+// equal-cost paths to the LAN, which SPFNexthopCalculation does not
+// support.)
+void
+Ipv4GlobalRoutingIncrementalTestCase::DoRun (void)
+{
+  NodeContainer routers;
+  routers.Create (5);
+  NodeContainer hosts;
+  hosts.Create (10);
+  NodeContainer nodes (routers, hosts);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  std::vector<Ipv4InterfaceContainer> ring;
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      ring.push_back (ipv4.Assign (devHelper.Install (NodeContainer (routers.Get (i), routers.Get ((i + 1) % 5)))));
+      ipv4.NewNetwork ();
+    }
+  std::vector<Ipv4InterfaceContainer> access;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      access.push_back (ipv4.Assign (devHelper.Install (NodeContainer (routers.Get (i / 2), hosts.Get (i)))));
+      ipv4.NewNetwork ();
+    }
+  devHelper.SetNetDevicePointToPointMode (false);
+  ipv4.SetBase ("10.2.0.0", "255.255.255.0");
+  ipv4.Assign (devHelper.Install (NodeContainer (routers.Get (0), routers.Get (1))));
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  CheckUpdate (nodes, "no change");
+
+  // Host 0 (on router 0) is away from a change on the ring between routers 2
+  // and 3: its routes are kept.
+  Ipv4RoutingTableEntry *hostRoute = GetFirstRoute (hosts.Get (0));
+  Ptr<Ipv4> ipv4Router2 = ring[2].Get (0).first;
+  uint32_t ifRouter2 = ring[2].Get (0).second;
+  ipv4Router2->SetDown (ifRouter2);
+  Ipv4GlobalRoutingHelper::UpdateRoutingTables ();
+  NS_TEST_EXPECT_MSG_EQ (GetFirstRoute (hosts.Get (0)), hostRoute, "The routes of host 0 were recomputed");
+  CheckUpdate (nodes, "ring link down");
+
+  ipv4Router2->SetUp (ifRouter2);
+  CheckUpdate (nodes, "ring link up");
+
+  // host 4 loses its link to router 2
+  Ptr<Ipv4> ipv4Host4 = access[4].Get (1).first;
+  uint32_t ifHost4 = access[4].Get (1).second;
+  ipv4Host4->SetDown (ifHost4);
+  CheckUpdate (nodes, "access link down");
+  ipv4Host4->SetUp (ifHost4);
+  CheckUpdate (nodes, "access link up");
+
+  // router 1 leaves the LAN
+  Ptr<Ipv4> ipv4Router1 = routers.Get (1)->GetObject<Ipv4> ();
+  uint32_t ifRouter1 = ipv4Router1->GetNInterfaces () - 1;
+  ipv4Router1->SetDown (ifRouter1);
+  CheckUpdate (nodes, "LAN link down");
+  ipv4Router1->SetUp (ifRouter1);
+  CheckUpdate (nodes, "LAN link up");
+
+  routers.Get (4)->GetObject<GlobalRouter> ()->InjectRoute (Ipv4Address ("192.168.0.0"), Ipv4Mask ("255.255.0.0"));
+  CheckUpdate (nodes, "route injection");
+
+  // a new island of two routers is not reachable from the ring: the
+  // routes of router 0 are kept
+  NodeContainer island;
+  island.Create (2);
+  internet.Install (island);
+  devHelper.SetNetDevicePointToPointMode (true);
+  ipv4.SetBase ("10.3.0.0", "255.255.255.252");
+  ipv4.Assign (devHelper.Install (island));
+  NodeContainer allNodes (nodes, island);
+  Ipv4RoutingTableEntry *routerRoute = GetFirstRoute (routers.Get (0));
+  Ipv4GlobalRoutingHelper::UpdateRoutingTables ();
+  NS_TEST_EXPECT_MSG_EQ (GetFirstRoute (routers.Get (0)), routerRoute, "The routes of router 0 were recomputed");
+  CheckUpdate (allNodes, "new island");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -1267,6 +1438,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingIncrementalTestCase, TestCase::QUICK);
   }
 
 static Ipv4GlobalRoutingTestSuite g_globalRoutingTestSuite; //!< Static variable for test initialization
@@ -20,6 +20,8 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -49,6 +51,24 @@ private:
   void TestTransmittedBlock ();
   /** \brief Test the generation of the "next" block */
   void TestNextSeg ();
+  /** \brief Test the scoreboard queries with a large window */
+  void TestLargeWindow ();
+  /** \brief Test the scoreboard queries with the Reno SACKs */
+  void TestRenoSack ();
+
+  /**
+   * \brief Check that a packet carries the bytes starting at a sequence number
+   * \param p the packet returned by the buffer
+   * \param seq the expected sequence number of the first byte
+   * \param size the expected size of the packet
+   */
+  void CheckPayload (Ptr<const Packet> p, SequenceNumber32 seq, uint32_t size);
+  /**
+   * \brief Get the sequence numbers and the sizes of the sent items
+   * \param txBuf the buffer
+   * \return the sent items, as printed by the buffer
+   */
+  static std::string GetSentItems (const TcpTxBuffer &txBuf);
 };
 
 TcpTxBufferTestCase::TcpTxBufferTestCase ()
@@ -81,6 +101,10 @@ TcpTxBufferTestCase::DoRun ()
                        &TcpTxBufferTestCase::TestTransmittedBlock, this);
   Simulator::Schedule (Seconds (0.0),
                        &TcpTxBufferTestCase::TestNextSeg, this);
+  Simulator::Schedule (Seconds (0.0),
+                       &TcpTxBufferTestCase::TestLargeWindow, this);
+  Simulator::Schedule (Seconds (0.0),
+                       &TcpTxBufferTestCase::TestRenoSack, this);
 
   Simulator::Run ();
   Simulator::Destroy ();
@@ -267,6 +291,205 @@ TcpTxBufferTestCase::TestNextSeg ()
                          "Data inside the buffer");
 }
 
+void
+TcpTxBufferTestCase::TestLargeWindow ()
+{
+  TcpTxBuffer txBuf;
+  SequenceNumber32 head (1);
+  SequenceNumber32 ret;
+  uint32_t segmentSize = 100;
+  uint32_t nSegments = 1000;
+  txBuf.SetHeadSequence (head);
+  txBuf.SetSegmentSize (segmentSize);
+  txBuf.SetDupAckThresh (3);
+  txBuf.SetMaxBufferSize (2 * nSegments * segmentSize);
+  Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack> ();
+
+  txBuf.Add (Create<Packet> (nSegments * segmentSize));
+  for (uint32_t i = 0; i < nSegments; ++i)
+    {
+      txBuf.CopyFromSequence (segmentSize, head + (segmentSize * i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), nSegments * segmentSize,
+                         "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), false,
+                         "NextSeq returned without data to send");
+
+  // SACK the segments 10 and 20: nothing is lost yet
+  for (uint32_t i = 10; i <= 20; i += 10)
+    {
+      SequenceNumber32 begin = head + (segmentSize * i);
+      sack->AddSackBlock (TcpOptionSack::SackBlock (begin, begin + segmentSize));
+      NS_TEST_ASSERT_MSG_EQ (txBuf.Update (sack->GetSackList ()), true,
+                             "SACK block not applied");
+      sack->ClearSackList ();
+    }
+  for (uint32_t i = 0; i < nSegments; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head + (segmentSize * i)), false,
+                             "Segment " << i << " lost with two SACKed segments");
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), false,
+                         "NextSeq returned without lost segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, true), true,
+                         "No NextSeq for rule 3 in recovery");
+  NS_TEST_ASSERT_MSG_EQ (ret, head, "Different NextSeq than expected for rule 3");
+
+  // A block that does not match the segments is discarded
+  sack->AddSackBlock (TcpOptionSack::SackBlock (head + 3050, head + 3150));
+  NS_TEST_ASSERT_MSG_EQ (txBuf.Update (sack->GetSackList ()), false,
+                         "SACK block not matching the segments applied");
+  sack->ClearSackList ();
+
+  // The third SACKed segment marks the segments below the first one as lost
+  sack->AddSackBlock (TcpOptionSack::SackBlock (head + (segmentSize * 30),
+                                                head + (segmentSize * 31)));
+  txBuf.Update (sack->GetSackList ());
+  sack->ClearSackList ();
+  for (uint32_t i = 0; i < nSegments; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head + (segmentSize * i)), (i < 10),
+                             "Wrong lost status of segment " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), (nSegments - 13) * segmentSize,
+                         "TxBuf miscalculates size of in flight segments");
+
+  // Retransmit the lost segments; then only rule 3 can return something
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), true,
+                             "No NextSeq with lost segments");
+      NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * i),
+                             "Different NextSeq than expected for lost segments");
+      txBuf.CopyFromSequence (segmentSize, ret);
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), (nSegments - 3) * segmentSize,
+                         "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), false,
+                         "NextSeq returned after retransmitting the lost segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, true), true,
+                         "No NextSeq for rule 3 in recovery");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * 11),
+                         "Different NextSeq than expected for rule 3");
+
+  // Two more SACKed segments move the lost mark up to the segment 30
+  for (uint32_t i = 40; i <= 50; i += 10)
+    {
+      SequenceNumber32 begin = head + (segmentSize * i);
+      sack->AddSackBlock (TcpOptionSack::SackBlock (begin, begin + segmentSize));
+      txBuf.Update (sack->GetSackList ());
+      sack->ClearSackList ();
+    }
+  for (uint32_t i = 0; i < nSegments; ++i)
+    {
+      bool lost = (i < 10) || (i > 10 && i < 30 && i != 20);
+      NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head + (segmentSize * i)), lost,
+                             "Wrong lost status of segment " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), true,
+                         "No NextSeq with lost segments");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * 11),
+                         "Different NextSeq than expected for lost segments");
+
+  // A partial ACK up to the segment 15
+  txBuf.DiscardUpTo (head + (segmentSize * 15));
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), true,
+                         "No NextSeq after a partial ACK");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * 15),
+                         "Different NextSeq than expected after a partial ACK");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), (nSegments - 15 - 4 - 14) * segmentSize,
+                         "TxBuf miscalculates size of in flight segments");
+
+  // Retransmit the lost segments, then new data is returned
+  txBuf.Add (Create<Packet> (10 * segmentSize));
+  for (uint32_t i = 15; i < 30; ++i)
+    {
+      if (i == 20)
+        {
+          continue;
+        }
+      NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), true,
+                             "No NextSeq with lost segments");
+      NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * i),
+                             "Different NextSeq than expected for lost segments");
+      txBuf.CopyFromSequence (segmentSize, ret);
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), true,
+                         "No NextSeq with new data");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * nSegments),
+                         "Different NextSeq than expected with new data");
+
+  // After an RTO, everything not SACKed is lost and is retransmitted again
+  txBuf.SetSentListLost ();
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), 0,
+                         "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), true,
+                         "No NextSeq after an RTO");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * 15),
+                         "Different NextSeq than expected after an RTO");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head + (segmentSize * 60)), false,
+                         "Segment above the highest SACK lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head + (segmentSize * 45)), true,
+                         "Segment below the highest SACK not lost after an RTO");
+
+  txBuf.DiscardUpTo (head + (segmentSize * (nSegments + 10)));
+  NS_TEST_ASSERT_MSG_EQ (txBuf.Size (), 0, "Data inside the buffer");
+}
+
+void
+TcpTxBufferTestCase::TestRenoSack ()
+{
+  TcpTxBuffer txBuf;
+  SequenceNumber32 head (1);
+  SequenceNumber32 ret;
+  uint32_t segmentSize = 100;
+  txBuf.SetHeadSequence (head);
+  txBuf.SetSegmentSize (segmentSize);
+  txBuf.SetDupAckThresh (3);
+
+  txBuf.Add (Create<Packet> (10 * segmentSize));
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      txBuf.CopyFromSequence (segmentSize, head + (segmentSize * i));
+    }
+
+  // Three dupacks, then the head is considered lost
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      txBuf.AddRenoSack ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head), false,
+                         "Head lost before being marked");
+  txBuf.MarkHeadAsLost ();
+  NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head), true, "Head not lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), 6 * segmentSize,
+                         "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), true, "No NextSeq");
+  NS_TEST_ASSERT_MSG_EQ (ret, head, "Different NextSeq than expected");
+  txBuf.CopyFromSequence (segmentSize, ret);
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, true), true, "No NextSeq for rule 3");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * 4),
+                         "Different NextSeq than expected for rule 3");
+
+  // A partial ACK moves the Reno SACK of the new head further
+  txBuf.DiscardUpTo (head + segmentSize);
+  NS_TEST_ASSERT_MSG_EQ (txBuf.IsLost (head + segmentSize), true,
+                         "New head not lost after a partial ACK");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, false), true, "No NextSeq");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + segmentSize, "Different NextSeq than expected");
+
+  // Reset the SACKs: nothing but the head is lost
+  txBuf.ResetRenoSack ();
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), 8 * segmentSize,
+                         "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, true), true, "No NextSeq");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + segmentSize, "Different NextSeq than expected");
+  txBuf.CopyFromSequence (segmentSize, ret);
+  NS_TEST_ASSERT_MSG_EQ (txBuf.NextSeg (&ret, true), true, "No NextSeq for rule 3");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * 2),
+                         "Different NextSeq than expected for rule 3");
+}
+
 void
 TcpTxBufferTestCase::TestNewBlock ()
 {
@@ -337,9 +560,127 @@ TcpTxBufferTestCase::TestNewBlock ()
                          "Size is different than expected");
 }
 
+void
+TcpTxBufferTestCase::CheckPayload (Ptr<const Packet> p, SequenceNumber32 seq, uint32_t size)
+{
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), size,
+                         "Returned packet has different size than requested");
+  std::vector<uint8_t> data (p->GetSize ());
+  p->CopyData (data.data (), data.size ());
+  for (uint32_t i = 0; i < data.size (); ++i)
+    {
+      // the byte at sequence number n carries the value n % 251
+      NS_TEST_ASSERT_MSG_EQ (static_cast<uint32_t> (data[i]), (seq.GetValue () + i) % 251,
+                             "Returned packet does not start at the requested sequence number");
+    }
+}
+
+std::string
+TcpTxBufferTestCase::GetSentItems (const TcpTxBuffer &txBuf)
+{
+  std::ostringstream oss;
+  oss << txBuf;
+  std::string items = oss.str ();
+  std::size_t begin = items.find ('{');
+  if (begin == std::string::npos)
+    {
+      return "";
+    }
+  return items.substr (begin, items.find (", size = ") - begin);
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock ()
 {
+  TcpTxBuffer txBuf;
+  txBuf.SetHeadSequence (SequenceNumber32 (1));
+  txBuf.SetSegmentSize (100);
+
+  std::vector<uint8_t> data (1000);
+  for (uint32_t i = 0; i < data.size (); ++i)
+    {
+      data[i] = (i + 1) % 251;
+    }
+  txBuf.Add (Create<Packet> (data.data (), data.size ()));
+
+  // send ten segments, so that the sent list holds ten items
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      txBuf.CopyFromSequence (100, SequenceNumber32 (1 + i * 100));
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), 1000,
+                         "TxBuf miscalculates size of in flight segments");
+
+  // is exactly the same as previous
+  Ptr<Packet> ret = txBuf.CopyFromSequence (100, SequenceNumber32 (301));
+  CheckPayload (ret, SequenceNumber32 (301), 100);
+
+  // starts over the boundary, but ends earlier
+  ret = txBuf.CopyFromSequence (50, SequenceNumber32 (401));
+  CheckPayload (ret, SequenceNumber32 (401), 50);
+
+  // starts over the boundary, but ends after
+  ret = txBuf.CopyFromSequence (150, SequenceNumber32 (501));
+  CheckPayload (ret, SequenceNumber32 (501), 150);
+
+  // starts inside a packet, ends right
+  ret = txBuf.CopyFromSequence (50, SequenceNumber32 (251));
+  CheckPayload (ret, SequenceNumber32 (251), 50);
+
+  // starts inside a packet, ends earlier in the same packet
+  ret = txBuf.CopyFromSequence (20, SequenceNumber32 (711));
+  CheckPayload (ret, SequenceNumber32 (711), 20);
+
+  // starts inside a packet, ends in another packet
+  ret = txBuf.CopyFromSequence (100, SequenceNumber32 (851));
+  CheckPayload (ret, SequenceNumber32 (851), 100);
+
+  NS_TEST_ASSERT_MSG_EQ (GetSentItems (txBuf),
+                         "{[1;101|100][0]}{[101;201|100][0]}{[201;251|50][0]}"
+                         "{[251;301|50][retrans],[0]}{[301;401|100][retrans],[0]}"
+                         "{[401;451|50][retrans],[0]}{[451;501|50][0]}"
+                         "{[501;651|150][retrans],[0]}{[651;701|50][0]}{[701;711|10][0]}"
+                         "{[711;731|20][retrans],[0]}{[731;801|70][0]}{[801;851|50][0]}"
+                         "{[851;951|100][retrans],[0]}{[951;1001|50][0]}",
+                         "The sent items were not split or merged as expected");
+
+  // the second parts of the split items are found by their sequence number
+  ret = txBuf.CopyFromSequence (50, SequenceNumber32 (451));
+  CheckPayload (ret, SequenceNumber32 (451), 50);
+  ret = txBuf.CopyFromSequence (30, SequenceNumber32 (731));
+  CheckPayload (ret, SequenceNumber32 (731), 30);
+
+  // a retransmission starting at an item merges at most the following one
+  ret = txBuf.CopyFromSequence (400, SequenceNumber32 (401));
+  CheckPayload (ret, SequenceNumber32 (401), 100);
+
+  NS_TEST_ASSERT_MSG_EQ (GetSentItems (txBuf),
+                         "{[1;101|100][0]}{[101;201|100][0]}{[201;251|50][0]}"
+                         "{[251;301|50][retrans],[0]}{[301;401|100][retrans],[0]}"
+                         "{[401;501|100][retrans],[0]}"
+                         "{[501;651|150][retrans],[0]}{[651;701|50][0]}{[701;711|10][0]}"
+                         "{[711;731|20][retrans],[0]}{[731;761|30][retrans],[0]}"
+                         "{[761;801|40][0]}{[801;851|50][0]}"
+                         "{[851;951|100][retrans],[0]}{[951;1001|50][0]}",
+                         "The sent items were not split or merged as expected");
+
+  // the head is discarded in the middle of an item
+  txBuf.DiscardUpTo (SequenceNumber32 (551));
+  ret = txBuf.CopyFromSequence (100, SequenceNumber32 (601));
+  CheckPayload (ret, SequenceNumber32 (601), 100);
+
+  NS_TEST_ASSERT_MSG_EQ (GetSentItems (txBuf),
+                         "{[551;601|50][retrans],[0]}{[601;701|100][retrans],[0]}"
+                         "{[701;711|10][0]}{[711;731|20][retrans],[0]}"
+                         "{[731;761|30][retrans],[0]}{[761;801|40][0]}{[801;851|50][0]}"
+                         "{[851;951|100][retrans],[0]}{[951;1001|50][0]}",
+                         "The sent items were not split or merged as expected");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.GetRetransmitsCount (), 300,
+                         "TxBuf miscalculates size of retransmitted segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.BytesInFlight (), 750,
+                         "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf.Size (), 450,
+                         "Size is different than expected");
 }
 
 void
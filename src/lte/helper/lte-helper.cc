@@ -38,6 +38,7 @@
 #include <ns3/lte-spectrum-phy.h>
 #include <ns3/lte-chunk-processor.h>
 #include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/lte-fast-spectrum-channel.h>
 #include <ns3/friis-spectrum-propagation-loss.h>
 #include <ns3/trace-fading-loss-model.h>
 #include <ns3/isotropic-antenna-model.h>
@@ -194,6 +195,17 @@ TypeId LteHelper::GetTypeId (void)
                    UintegerValue (1),
                    MakeUintegerAccessor (&LteHelper::m_noOfCcs),
                    MakeUintegerChecker<uint16_t> (MIN_NO_CC, MAX_NO_CC))
+    .AddAttribute ("UseFastPhyMode",
+                   "If true, the channels are LteFastSpectrumChannel instances, "
+                   "which aggregate the signals of the other cells into a "
+                   "single interference signal per receiver, with the link "
+                   "losses cached; this overrides the SpectrumChannel type. "
+                   "Only to be used with static nodes or deterministic "
+                   "pathloss models. If false, each signal is propagated "
+                   "to each receiver.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteHelper::m_useFastPhyMode),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -227,8 +239,15 @@ LteHelper::ChannelModelInitialization (void)
   // PathLossModel Objects are vectors --> in InstallSingleEnb we will set the frequency
   NS_LOG_FUNCTION (this << m_noOfCcs);
 
-  m_downlinkChannel = m_channelFactory.Create<SpectrumChannel> ();
-  m_uplinkChannel = m_channelFactory.Create<SpectrumChannel> ();
+  ObjectFactory channelFactory = m_channelFactory;
+  if (m_useFastPhyMode)
+    {
+      // keep the attributes set for the channel, if any
+      channelFactory.SetTypeId (LteFastSpectrumChannel::GetTypeId ());
+      channelFactory.Set ("CacheLinkLosses", BooleanValue (true));
+    }
+  m_downlinkChannel = channelFactory.Create<SpectrumChannel> ();
+  m_uplinkChannel = channelFactory.Create<SpectrumChannel> ();
 
   m_downlinkPathlossModel = m_pathlossModelFactory.Create ();
   Ptr<SpectrumPropagationLossModel> dlSplm = m_downlinkPathlossModel->GetObject<SpectrumPropagationLossModel> ();
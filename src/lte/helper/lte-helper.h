@@ -837,6 +837,13 @@ private:
    */
   bool m_useCa;
 
+  /**
+   * The `UseFastPhyMode` attribute. If true, LteFastSpectrumChannel
+   * instances aggregating the interference of the other cells are used
+   * instead of the configured SpectrumChannel type.
+   */
+  bool m_useFastPhyMode;
+
   /**
    * This contains all the information about each component carrier
    */
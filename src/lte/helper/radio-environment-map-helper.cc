@@ -40,6 +40,7 @@
 
 #include <fstream>
 #include <limits>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -144,6 +145,15 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("DirectEvaluation",
+                   "If true, the signals transmitted on the channel during one "
+                   "subframe are recorded and the SINR of all the points of the "
+                   "map is computed from them in a single pass, instead of "
+                   "deploying batches of listeners on the channel. This requires "
+                   "a channel providing the TxSigParams trace source.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_directEvaluation),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -181,7 +191,7 @@ void
 RadioEnvironmentMapHelper::Install ()
 {
   NS_LOG_FUNCTION (this);
-  if (!m_rem.empty ())
+  if (!m_rem.empty () || m_outFile.is_open ())
     {
       NS_FATAL_ERROR ("only one REM supported per instance of RadioEnvironmentMapHelper");
     }
@@ -220,6 +230,19 @@ RadioEnvironmentMapHelper::DelayedInstall ()
   NS_LOG_FUNCTION (this);
   m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
   m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+
+  if (m_directEvaluation)
+    {
+      // record the signals of the subframe that the first batch of
+      // listeners would have received
+      bool connected = m_channel->TraceConnectWithoutContext ("TxSigParams",
+                                                              MakeCallback (&RadioEnvironmentMapHelper::RecordSignal, this));
+      NS_ABORT_MSG_UNLESS (connected, "the channel at " << m_channelPath << " does not provide the TxSigParams trace source");
+      Simulator::Schedule (Seconds (0.0006),
+                           &RadioEnvironmentMapHelper::RunDirectEvaluation,
+                           this);
+      return;
+    }
   
   if ((double)m_xRes * (double) m_yRes < (double) m_maxPointsPerIteration)
     {
@@ -340,6 +363,84 @@ RadioEnvironmentMapHelper::PrintAndReset ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::RecordSignal (Ptr<SpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+  RecordedSignal signal;
+  signal.txTime = Simulator::Now ();
+  signal.params = params;
+  m_signals.push_back (signal);
+}
+
+void
+RadioEnvironmentMapHelper::RunDirectEvaluation ()
+{
+  NS_LOG_FUNCTION (this);
+  m_channel->TraceDisconnectWithoutContext ("TxSigParams",
+                                            MakeCallback (&RadioEnvironmentMapHelper::RecordSignal, this));
+  NS_LOG_LOGIC (m_signals.size () << " signals recorded");
+
+  Ptr<RemSpectrumPhy> phy = CreateObject<RemSpectrumPhy> ();
+  Ptr<MobilityModel> bmm = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+  bmm->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+  phy->SetRxSpectrumModel (LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth));
+  phy->SetMobility (bmm);
+  phy->SetUseDataChannel (m_useDataChannel);
+  phy->SetRbId (m_rbId);
+
+  typedef std::pair<Time, Ptr<SpectrumSignalParameters> > RxSignal;
+  std::vector<RxSignal> rxSignals;
+  rxSignals.reserve (m_signals.size ());
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      for (double y = m_yMin; y < m_yMax + 0.5*m_yStep ; y += m_yStep)
+        {
+          bmm->SetPosition (Vector (x, y, m_z));
+          BuildingsHelper::MakeConsistent (bmm);
+          rxSignals.clear ();
+          for (std::vector<RecordedSignal>::const_iterator it = m_signals.begin ();
+               it != m_signals.end ();
+               ++it)
+            {
+              Time delay;
+              Ptr<SpectrumSignalParameters> rxParams = m_channel->CalcRxSignalParameters (it->params, phy, delay);
+              if (rxParams != 0)
+                {
+                  rxSignals.push_back (std::make_pair (it->txTime + delay, rxParams));
+                }
+            }
+          // accumulate the received powers in the order in which the
+          // channel would have delivered the signals to a listener
+          std::stable_sort (rxSignals.begin (), rxSignals.end (),
+                            [] (const RxSignal &a, const RxSignal &b) { return a.first < b.first; });
+          phy->Reset ();
+          for (std::vector<RxSignal>::const_iterator it = rxSignals.begin ();
+               it != rxSignals.end ();
+               ++it)
+            {
+              phy->StartRx (it->second);
+            }
+          Vector pos = bmm->GetPosition ();
+          NS_LOG_LOGIC ("output: " << pos.x << "\t"
+                        << pos.y << "\t"
+                        << pos.z << "\t"
+                        << phy->GetSinr (m_noisePower));
+          m_outFile << pos.x << "\t"
+                    << pos.y << "\t"
+                    << pos.z << "\t"
+                    << phy->GetSinr (m_noisePower)
+                    << "\n";
+        }
+    }
+
+  m_channel->RemoveRx (phy);
+  phy->Dispose ();
+  m_signals.clear ();
+  Finalize ();
+}
+
 void 
 RadioEnvironmentMapHelper::Finalize ()
 {
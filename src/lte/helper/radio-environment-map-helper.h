@@ -24,7 +24,9 @@
 
 
 #include <ns3/object.h>
+#include <ns3/nstime.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,6 +37,7 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class SpectrumSignalParameters;
 
 /** 
  * \ingroup lte
@@ -42,6 +45,23 @@ class MobilityModel;
  * Generates a 2D map of the SINR from the strongest transmitter in the
  * downlink of an LTE FDD system. For instructions on usage, please refer to
  * the User Documentation.
+ *
+ * By default, the map is generated by deploying batches of RemSpectrumPhy
+ * listeners on the channel, one batch per subframe. If the
+ * `DirectEvaluation` attribute is set, the signals transmitted on the
+ * channel during one subframe are recorded instead, and the SINR of every
+ * point of the map is then computed in a single pass with
+ * SpectrumChannel::CalcRxSignalParameters, using one listener that is moved
+ * from point to point and whose results are written to the output file as
+ * they are computed. This removes the per-point memory cost and the
+ * scheduling of the batches. The output is the same as with the
+ * listener batches, provided that the transmitted signals do not change
+ * from one subframe to the next and that the propagation models neither
+ * depend on the simulation time nor draw random variables per link (such
+ * as the shadowing of the buildings propagation loss models), since all the
+ * points are evaluated at the same time with the same listener. The
+ * channel must provide the `TxSigParams` trace source, as
+ * MultiModelSpectrumChannel does.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -108,6 +128,27 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Record a signal transmitted on the channel, to be used by
+   * RunDirectEvaluation().
+   *
+   * \param params the parameters of the transmitted signal
+   */
+  void RecordSignal (Ptr<SpectrumSignalParameters> params);
+
+  /**
+   * Compute the SINR of all the points of the map from the recorded
+   * signals, write them to the output file and call Finalize().
+   */
+  void RunDirectEvaluation ();
+
+  /// A signal transmitted on the channel and recorded by RecordSignal().
+  struct RecordedSignal
+  {
+    Time txTime;  ///< Time at which the signal was transmitted.
+    Ptr<SpectrumSignalParameters> params;  ///< Parameters of the signal.
+  };
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -120,6 +161,9 @@ private:
   /// List of listeners in the environment.
   std::list<RemPoint> m_rem;
 
+  /// Signals recorded for the direct evaluation of the map.
+  std::vector<RecordedSignal> m_signals;
+
   double m_xMin;   ///< The `XMin` attribute.
   double m_xMax;   ///< The `XMax` attribute.
   uint16_t m_xRes; ///< The `XRes` attribute.
@@ -151,6 +195,7 @@ private:
 
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
+  bool m_directEvaluation;  ///< The `DirectEvaluation` attribute.
 
 }; // end of `class RadioEnvironmentMapHelper`
 
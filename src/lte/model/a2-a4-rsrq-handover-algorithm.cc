@@ -28,6 +28,7 @@
 #include "a2-a4-rsrq-handover-algorithm.h"
 #include <ns3/log.h>
 #include <ns3/uinteger.h>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -156,13 +157,15 @@ A2A4RsrqHandoverAlgorithm::DoReportUeMeas (uint16_t rnti,
       if (measResults.haveMeasResultNeighCells
           && !measResults.measResultListEutra.empty ())
         {
+          // the row of the UE is looked up (or created) once for the whole report
+          MeasurementRow_t &row = m_neighbourCellMeasures[rnti];
           for (std::list <LteRrcSap::MeasResultEutra>::iterator it = measResults.measResultListEutra.begin ();
                it != measResults.measResultListEutra.end ();
                ++it)
             {
               NS_ASSERT_MSG (it->haveRsrqResult == true,
                              "RSRQ measurement is missing from cellId " << it->physCellId);
-              UpdateNeighbourMeasurements (rnti, it->physCellId, it->rsrqResult);
+              UpdateNeighbourMeasurements (row, it->physCellId, it->rsrqResult);
             }
         }
       else
@@ -197,14 +200,14 @@ A2A4RsrqHandoverAlgorithm::EvaluateHandover (uint16_t rnti,
       NS_LOG_LOGIC ("Number of neighbour cells = " << it1->second.size ());
       uint16_t bestNeighbourCellId = 0;
       uint8_t bestNeighbourRsrq = 0;
-      MeasurementRow_t::iterator it2;
+      MeasurementRow_t::const_iterator it2;
       for (it2 = it1->second.begin (); it2 != it1->second.end (); ++it2)
         {
-          if ((it2->second->m_rsrq > bestNeighbourRsrq)
-              && IsValidNeighbour (it2->first))
+          if ((it2->m_rsrq > bestNeighbourRsrq)
+              && IsValidNeighbour (it2->m_cellId))
             {
-              bestNeighbourCellId = it2->first;
-              bestNeighbourRsrq = it2->second->m_rsrq;
+              bestNeighbourCellId = it2->m_cellId;
+              bestNeighbourRsrq = it2->m_rsrq;
             }
         }
 
@@ -245,47 +248,38 @@ A2A4RsrqHandoverAlgorithm::IsValidNeighbour (uint16_t cellId)
 }
 
 
+bool
+A2A4RsrqHandoverAlgorithm::CompareCellId (const UeMeasure &a, const UeMeasure &b)
+{
+  return a.m_cellId < b.m_cellId;
+}
+
+
 void
-A2A4RsrqHandoverAlgorithm::UpdateNeighbourMeasurements (uint16_t rnti,
+A2A4RsrqHandoverAlgorithm::UpdateNeighbourMeasurements (MeasurementRow_t &row,
                                                         uint16_t cellId,
                                                         uint8_t rsrq)
 {
-  NS_LOG_FUNCTION (this << rnti << cellId << (uint16_t) rsrq);
-  MeasurementTable_t::iterator it1;
-  it1 = m_neighbourCellMeasures.find (rnti);
+  NS_LOG_FUNCTION (this << cellId << (uint16_t) rsrq);
 
-  if (it1 == m_neighbourCellMeasures.end ())
-    {
-      // insert a new UE entry
-      MeasurementRow_t row;
-      std::pair<MeasurementTable_t::iterator, bool> ret;
-      ret = m_neighbourCellMeasures.insert (std::pair<uint16_t, MeasurementRow_t> (rnti, row));
-      NS_ASSERT (ret.second);
-      it1 = ret.first;
-    }
+  // the row is kept sorted by cell ID, so that the neighbour cells are
+  // evaluated in the same order regardless of the order of the reports
+  UeMeasure key;
+  key.m_cellId = cellId;
+  MeasurementRow_t::iterator it = std::lower_bound (row.begin (), row.end (), key,
+                                                    &A2A4RsrqHandoverAlgorithm::CompareCellId);
 
-  NS_ASSERT (it1 != m_neighbourCellMeasures.end ());
-  Ptr<UeMeasure> neighbourCellMeasures;
-  std::map<uint16_t, Ptr<UeMeasure> >::iterator it2;
-  it2 = it1->second.find (cellId);
-
-  if (it2 != it1->second.end ())
-    {
-      neighbourCellMeasures = it2->second;
-      neighbourCellMeasures->m_cellId = cellId;
-      neighbourCellMeasures->m_rsrp = 0;
-      neighbourCellMeasures->m_rsrq = rsrq;
-    }
-  else
+  if (it == row.end () || it->m_cellId != cellId)
     {
       // insert a new cell entry
-      neighbourCellMeasures = Create<UeMeasure> ();
-      neighbourCellMeasures->m_cellId = cellId;
-      neighbourCellMeasures->m_rsrp = 0;
-      neighbourCellMeasures->m_rsrq = rsrq;
-      it1->second[cellId] = neighbourCellMeasures;
+      UeMeasure neighbourCellMeasures;
+      neighbourCellMeasures.m_cellId = cellId;
+      it = row.insert (it, neighbourCellMeasures);
     }
 
+  it->m_rsrp = 0;
+  it->m_rsrq = rsrq;
+
 } // end of UpdateNeighbourMeasurements
 
 
@@ -31,9 +31,8 @@
 #include <ns3/lte-handover-algorithm.h>
 #include <ns3/lte-handover-management-sap.h>
 #include <ns3/lte-rrc-sap.h>
-#include <ns3/simple-ref-count.h>
-#include <ns3/ptr.h>
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3 {
 
@@ -124,19 +123,6 @@ private:
    */
   bool IsValidNeighbour (uint16_t cellId);
 
-  /**
-   * Called when Event A4 is reported, then update the measurements table.
-   * If the RNTI and/or cell ID is not found in the table, a corresponding
-   * entry will be created. Only the latest measurements are stored in the
-   * table.
-   *
-   * \param rnti The RNTI of the UE who reported the event.
-   * \param cellId The cell ID of the measured cell.
-   * \param rsrq The RSRQ of the cell as measured by the UE.
-   */
-  void UpdateNeighbourMeasurements (uint16_t rnti, uint16_t cellId,
-                                    uint8_t rsrq);
-
   /// The expected measurement identity for A2 measurements.
   uint8_t m_a2MeasId;
   /// The expected measurement identity for A4 measurements.
@@ -146,25 +132,46 @@ private:
    * Measurements reported by a UE for a cell ID. The values are quantized
    * according 3GPP TS 36.133 section 9.1.4 and 9.1.7.
    */
-  class UeMeasure : public SimpleRefCount<UeMeasure>
+  struct UeMeasure
   {
-  public:
     uint16_t m_cellId;  ///< Cell ID.
     uint8_t m_rsrp;     ///< RSRP in quantized format. \todo Can be removed?
     uint8_t m_rsrq;     ///< RSRQ in quantized format.
   };
 
   /**
-   * Measurements reported by a UE for several cells. The structure is a map
-   * indexed by the cell ID.
+   * Measurements reported by a UE for several cells. The structure is a
+   * vector sorted by cell ID, which is updated in place by each report.
    */
-  typedef std::map<uint16_t, Ptr<UeMeasure> > MeasurementRow_t;
+  typedef std::vector<UeMeasure> MeasurementRow_t;
 
   /**
-   * Measurements reported by several UEs. The structure is a map indexed by
-   * the RNTI of the UE.
+   * Measurements reported by several UEs. The structure is a hash table
+   * indexed by the RNTI of the UE.
    */
-  typedef std::map<uint16_t, MeasurementRow_t> MeasurementTable_t;
+  typedef std::unordered_map<uint16_t, MeasurementRow_t> MeasurementTable_t;
+
+  /**
+   * Order the measurements by cell ID.
+   *
+   * \param a The first measurement.
+   * \param b The second measurement.
+   * \return True if the cell ID of the first measurement is lower.
+   */
+  static bool CompareCellId (const UeMeasure &a, const UeMeasure &b);
+
+  /**
+   * Called when Event A4 is reported, then update the measurements of the
+   * UE. If the cell ID is not found in the row of the UE, a corresponding
+   * entry will be created. Only the latest measurements are stored in the
+   * table.
+   *
+   * \param row The measurements reported by the UE.
+   * \param cellId The cell ID of the measured cell.
+   * \param rsrq The RSRQ of the cell as measured by the UE.
+   */
+  void UpdateNeighbourMeasurements (MeasurementRow_t &row, uint16_t cellId,
+                                    uint8_t rsrq);
 
   /// Table of measurement reports from all UEs.
   MeasurementTable_t m_neighbourCellMeasures;
@@ -115,6 +115,48 @@ typedef std::map<HOL_group,std::set<LteFlowId_t> >::iterator t_it_HOLgroupToUEs;
 //typedef std::map<LteFlowId_t,map_RBG_to_CQI> map_flowId_to_CQI_map;
 
 
+/// The CQI state of a UE with flows to be scheduled in the current TTI
+struct CqaDlUe
+{
+  const SbMeasResult_s *sbMeas; ///< the last subband CQI report of the UE, or 0 if none
+  uint8_t cqiSum; ///< sum of the subband CQIs of the UE over all the RBGs and layers
+  std::vector<CQI_value> rbgCqi; ///< CQI of the first layer in each RBG, at least 1
+  double coitaSum; ///< sum of rbgCqi over the RBGs still available
+  CQI_value worstAllocatedCqi; ///< lowest CQI among the RBGs allocated to the UE
+  int nAllocatedRbgs; ///< number of RBGs allocated to the UE
+};
+
+/// A flow to be scheduled in the current TTI
+struct CqaDlFlow
+{
+  CqaDlUe *ue; ///< the CQI state of the UE of the flow
+  std::map <uint16_t, CqasFlowPerf_t>::iterator stats; ///< the flow stats of the UE, if any
+  double tbrWeight; ///< ratio of the target throughput to the averaged throughput, at least 1
+  int hol; ///< head of line delay, at least 1
+  int amountOfDataToTransfer; ///< bits in the RLC queues of the flow
+  int amountOfAssignedResources; ///< bits of the TB if the flow gets the current RBG
+};
+
+/**
+ * Remove an RBG from the RBGs still available in the current TTI
+ * \param availableRBGs the RBGs still available
+ * \param ues the UEs whose CoItA sums are updated
+ * \param rbg the RBG to remove
+ */
+static void
+CqaRemoveAvailableRbg (std::set<int> &availableRBGs, std::map<uint16_t, CqaDlUe> &ues, int rbg)
+{
+  availableRBGs.erase (rbg);
+  for (std::map<uint16_t, CqaDlUe>::iterator it = ues.begin (); it != ues.end (); it++)
+    {
+      if (it->second.sbMeas != 0)
+        {
+          it->second.coitaSum -= it->second.rbgCqi.at (rbg);
+        }
+    }
+}
+
+
 /**
  * CQA key comparator
  * \param key1 the first item
@@ -514,23 +556,7 @@ CqaFfMacScheduler::GetRbgSize (int dlbandwidth)
 unsigned int
 CqaFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
+  return CountActiveLcs (m_rlcBufferReq, rnti);
 }
 
 
@@ -1158,122 +1184,119 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
     };
 
 
-  // Prepare data for the scheduling mechanism
-  // map: UE, to the amount of traffic they have to transfer
-  std::map<LteFlowId_t, int> UeToAmountOfDataToTransfer;
-  //Initialize the map per UE, how much resources is already assigned to the user
-  std::map<LteFlowId_t, int> UeToAmountOfAssignedResources;
-  // prepare values to calculate FF metric, this metric will be the same for all flows(logical channels) that belong to the same RNTI
-  std::map < uint16_t, uint8_t > sbCqiSum;
-
-  for( std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itrbr = m_rlcBufferReq.begin ();
-       itrbr!=m_rlcBufferReq.end (); itrbr++)
+  // availableRBGs - set that contains indexes of available resource block groups
+  std::set<int> availableRBGs;
+  for (int i = 0; i <  numberOfRBGs; i++)
     {
-
-      LteFlowId_t flowId = itrbr->first;                // Prepare data for the scheduling mechanism
-      // check first the channel conditions for this UE, if CQI!=0
-      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-      itCqi = m_a30CqiRxed.find ((*itrbr).first.m_rnti);
-      std::map <uint16_t,uint8_t>::iterator itTxMode;
-      itTxMode = m_uesTxMode.find ((*itrbr).first.m_rnti);
-      if (itTxMode == m_uesTxMode.end ())
-        {
-          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itrbr).first.m_rnti);
-        }
-      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-
-      uint8_t cqiSum = 0;
-      for (int k = 0; k < numberOfRBGs; k++)
+      if (rbgMap.at (i) == false)
         {
-          for (uint8_t j = 0; j < nLayer; j++)
-            {
-              if (itCqi == m_a30CqiRxed.end ())
-                {
-                  cqiSum += 1;  // no info on this user -> lowest MCS
-                }
-              else
-                {
-                  cqiSum += (*itCqi).second.m_higherLayerSelected.at (k).m_sbCqi.at(j);
-                }
-            }
+          availableRBGs.insert (i);
         }
+    }
 
-      if (cqiSum == 0)
-        {
-          NS_LOG_INFO ("Skip this flow, CQI==0, rnti:"<<(*itrbr).first.m_rnti);
-          continue;
-        }
-      
-      // map: UE, to the amount of traffic they have to transfer
-      int amountOfDataToTransfer =  8*((int)m_rlcBufferReq.find (flowId)->second.m_rlcRetransmissionQueueSize +
-                                       (int)m_rlcBufferReq.find (flowId)->second.m_rlcTransmissionQueueSize);
+  // Prepare data for the scheduling mechanism, once per TTI: the CQI state
+  // of each UE is shared by its flows, so that the RBG loop below does not
+  // repeat the per-flow lookups and the CoItA sum over the available RBGs
+  std::map<uint16_t, CqaDlUe> ues;
+  std::map<LteFlowId_t, CqaDlFlow> dlFlows;
 
-      UeToAmountOfDataToTransfer.insert (std::pair<LteFlowId_t,int>(flowId,amountOfDataToTransfer));
-      UeToAmountOfAssignedResources.insert (std::pair<LteFlowId_t,int>(flowId,0));
+  for( std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itrbr = m_rlcBufferReq.begin ();
+       itrbr!=m_rlcBufferReq.end (); itrbr++)
+    {
 
-      uint8_t sum = 0;
-      for (int i = 0; i < numberOfRBGs; i++)
+      LteFlowId_t flowId = itrbr->first;                // Prepare data for the scheduling mechanism
+      std::map<uint16_t, CqaDlUe>::iterator itUe = ues.find (flowId.m_rnti);
+      if (itUe == ues.end ())
         {
+          // check first the channel conditions for this UE, if CQI!=0
           std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-          itCqi = m_a30CqiRxed.find ((*itrbr).first.m_rnti);
+          itCqi = m_a30CqiRxed.find (flowId.m_rnti);
           std::map <uint16_t,uint8_t>::iterator itTxMode;
-          itTxMode = m_uesTxMode.find ((*itrbr).first.m_rnti);
+          itTxMode = m_uesTxMode.find (flowId.m_rnti);
           if (itTxMode == m_uesTxMode.end ())
             {
-              NS_FATAL_ERROR ("No Transmission Mode info on user " << (*itrbr).first.m_rnti);
+              NS_FATAL_ERROR ("No Transmission Mode info on user " << flowId.m_rnti);
             }
           int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-          std::vector <uint8_t> sbCqis;
-          if (itCqi == m_a30CqiRxed.end ())
+
+          CqaDlUe ue;
+          ue.sbMeas = (itCqi == m_a30CqiRxed.end ()) ? 0 : &(*itCqi).second;
+          ue.cqiSum = 0;
+          for (int k = 0; k < numberOfRBGs; k++)
             {
-              for (uint8_t k = 0; k < nLayer; k++)
+              for (uint8_t j = 0; j < nLayer; j++)
                 {
-                  sbCqis.push_back (1);                        // start with lowest value
+                  if (ue.sbMeas == 0)
+                    {
+                      ue.cqiSum += 1;  // no info on this user -> lowest MCS
+                    }
+                  else
+                    {
+                      ue.cqiSum += ue.sbMeas->m_higherLayerSelected.at (k).m_sbCqi.at (j);
+                    }
                 }
             }
-          else
-            {
-              sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-            }
-
-          uint8_t cqi1 = sbCqis.at (0);
-          uint8_t cqi2 = 0;
-          if (sbCqis.size () > 1)
-            {
-              cqi2 = sbCqis.at (1);
-            }
 
-          uint8_t sbCqi = 0;
-          if ((cqi1 > 0)||(cqi2 > 0))               // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+          ue.coitaSum = 0;
+          if (ue.sbMeas != 0)
             {
-              for (uint8_t k = 0; k < nLayer; k++)
+              // if no info on the channel, use the worst CQI
+              ue.rbgCqi.assign (numberOfRBGs, 1);
+              for (int i = 0; i < numberOfRBGs && i < (int)ue.sbMeas->m_higherLayerSelected.size (); i++)
                 {
-                  if (sbCqis.size () > k)
-                    {
-                      sbCqi = sbCqis.at (k);
-                    }
-                  else
+                  const std::vector<uint8_t> &sbCqi = ue.sbMeas->m_higherLayerSelected[i].m_sbCqi;
+                  if (sbCqi.size () > 0 && sbCqi[0] > 0)
                     {
-                      // no info on this subband
-                      sbCqi = 0;
+                      ue.rbgCqi[i] = sbCqi[0];
                     }
-                  sum += sbCqi;
                 }
-            }               // end if cqi
-        }        // end of rbgNum
+              for (std::set<int>::iterator it = availableRBGs.begin (); it != availableRBGs.end (); it++)
+                {
+                  ue.coitaSum += ue.rbgCqi[*it];
+                }
+            }
+          ue.worstAllocatedCqi = 15;
+          ue.nAllocatedRbgs = 0;
+          itUe = ues.insert (std::pair<uint16_t, CqaDlUe> (flowId.m_rnti, ue)).first;
+        }
 
-      sbCqiSum.insert (std::pair<uint16_t, uint8_t> ((*itrbr).first.m_rnti, sum));
+      if (itUe->second.cqiSum == 0)
+        {
+          NS_LOG_INFO ("Skip this flow, CQI==0, rnti:"<<flowId.m_rnti);
+          continue;
+        }
+
+      CqaDlFlow flow;
+      flow.ue = &itUe->second;
+      flow.stats = m_flowStatsDl.find (flowId.m_rnti);
+      flow.tbrWeight = 1.0;
+      if (flow.stats != m_flowStatsDl.end ())
+        {
+          flow.tbrWeight = (*flow.stats).second.targetThroughput / (*flow.stats).second.lastAveragedThroughput;
+          if (flow.tbrWeight < 1.0)
+            flow.tbrWeight = 1.0;
+        }
+      std::map<LteFlowId_t,int>::iterator itHol = UEtoHOL.find (flowId);
+      flow.hol = (itHol == UEtoHOL.end ()) ? 0 : itHol->second;
+      if (flow.hol == 0)
+        flow.hol = 1;
+      // the amount of traffic the flow has to transfer
+      flow.amountOfDataToTransfer = 8*((int)itrbr->second.m_rlcRetransmissionQueueSize +
+                                       (int)itrbr->second.m_rlcTransmissionQueueSize);
+      flow.amountOfAssignedResources = 0;
+      dlFlows.insert (std::pair<LteFlowId_t, CqaDlFlow> (flowId, flow));
     }
 
-  // availableRBGs - set that contains indexes of available resource block groups
-  std::set<int> availableRBGs;
-  for (int i = 0; i <  numberOfRBGs; i++)
+  // MCS and achievable rate of an RBG for each CQI value (= TB size / TTI)
+  int mcsPerCqi[16];
+  double ratePerCqi[16];
+  for (uint8_t cqi = 0; cqi < 16; cqi++)
     {
-      if (rbgMap.at (i) == false)
-        {
-          availableRBGs.insert (i);
-        }
+      mcsPerCqi[cqi] = m_amc->GetMcsFromCqi (cqi);
+      ratePerCqi[cqi] = (m_amc->GetDlTbSizeFromMcs (mcsPerCqi[cqi], rbgSize) / 8) / 0.001;
     }
+  bool cqaFfMetric = (m_CqaMetric.compare ("CqaFf") == 0);
+  bool cqaPfMetric = (m_CqaMetric.compare ("CqaPf") == 0);
 
   t_it_HOLgroupToUEs itGBRgroups = map_GBRHOLgroupToUE.begin ();
   t_it_HOLgroupToUEs itnonGBRgroups = map_nonGBRHOLgroupToUE.begin ();
@@ -1283,7 +1306,7 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
   // while there are more resources available, loop through the users that are grouped by HOL value
   while (availableRBGs.size ()>0)
     {
-      if (UeToAmountOfDataToTransfer.size() == 0)
+      if (dlFlows.size() == 0)
         {
           NS_LOG_INFO ("No UEs to be scheduled (no data or CQI==0),");
           break;
@@ -1311,13 +1334,10 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
         {
           bool currentRBchecked = false;
           int currentRB = *(availableRBGs.begin ());
-          std::map<LteFlowId_t, CQI_value> UeToCQIValue;
-          std::map<LteFlowId_t, double > UeToCoitaMetric;
-          std::map<LteFlowId_t, bool> UeHasReachedGBR;
           double maximumValueMetric = 0;
           LteFlowId_t userWithMaximumMetric;
-          UeToCQIValue.clear ();
-          UeToCoitaMetric.clear ();
+          CqaDlFlow *flowWithMaximumMetric = 0;
+          CQI_value cqiOfUserWithMaximumMetric = 1;
 
           // Iterate through the users and calculate which user will use the best of the current resource bloc.end()k and assign to that user.
           for (std::set<LteFlowId_t>::iterator it=itCurrentGroup->second.begin (); it!=itCurrentGroup->second.end (); it++)
@@ -1325,126 +1345,50 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
               LteFlowId_t flowId = *it;
               uint8_t cqi_value = 1;                           //higher better, maximum is 15
               double coita_metric = 1;
-              double coita_sum = 0;
               double metric = 0;
-              uint8_t worstCQIAmongRBGsAllocatedForThisUser = 15;
-              int numberOfRBGAllocatedForThisUser = 0;
-              LogicalChannelConfigListElement_s lc = m_ueLogicalChannelsConfigList.find (flowId)->second;
-              std::map <uint16_t,SbMeasResult_s>::iterator itRntiCQIsMap = m_a30CqiRxed.find (flowId.m_rnti);
-
-              std::map <uint16_t, CqasFlowPerf_t>::iterator itStats;
 
               if ((m_ffrSapProvider->IsDlRbgAvailableForUe (currentRB, flowId.m_rnti)) == false)
                 {
                   continue;
                 }
 
-              if (m_flowStatsDl.find (flowId.m_rnti) == m_flowStatsDl.end ())
+              std::map<LteFlowId_t, CqaDlFlow>::iterator itFlow = dlFlows.find (flowId);
+              if (itFlow == dlFlows.end () || itFlow->second.stats == m_flowStatsDl.end ())
                 {
                   continue;                               // TO DO:  check if this should be logged and how.
                 }
               currentRBchecked = true;
+              CqaDlFlow &flow = itFlow->second;
+              const CqaDlUe &ue = *flow.ue;
 
-              itStats = m_flowStatsDl.find (flowId.m_rnti);
-              double tbr_weight = (*itStats).second.targetThroughput / (*itStats).second.lastAveragedThroughput;
-              if (tbr_weight < 1.0)
-                tbr_weight = 1.0;
-
-              if (itRntiCQIsMap != m_a30CqiRxed.end ())
+              if (ue.sbMeas != 0)
                 {
-                  for(std::set<int>::iterator it=availableRBGs.begin (); it!=availableRBGs.end (); it++)
-                    {
-                      try
-                        {
-                          int val = (itRntiCQIsMap->second.m_higherLayerSelected.at (*it).m_sbCqi.at (0));
-                          if (val==0)
-                            val=1;                                             //if no info, use minimum
-                          if (*it == currentRB)
-                            cqi_value = val;
-                          coita_sum+=val;
-
-                        }
-                      catch(std::out_of_range&)
-                        {
-                          coita_sum+=1;                                      //if no info on channel use the worst cqi
-                          NS_LOG_INFO ("No CQI for lcId:"<<flowId.m_lcId<<" rnti:"<<flowId.m_rnti<<" at subband:"<<currentRB);
-                          //std::cout<<"\n No CQI for lcId:.....................................";
-                        }
-                    }
-                  coita_metric =cqi_value/coita_sum;
-                  UeToCQIValue.insert (std::pair<LteFlowId_t,CQI_value>(flowId,cqi_value));
-                  UeToCoitaMetric.insert (std::pair<LteFlowId_t, double>(flowId,coita_metric));
-                }
-
-              if (allocationMapPerRntiPerLCId.find (flowId.m_rnti)==allocationMapPerRntiPerLCId.end ())
-                {
-                  worstCQIAmongRBGsAllocatedForThisUser=cqi_value;
+                  cqi_value = ue.rbgCqi[currentRB];
+                  coita_metric = cqi_value/ue.coitaSum;
                 }
-              else {
-
-                  numberOfRBGAllocatedForThisUser = (allocationMapPerRntiPerLCId.find (flowId.m_rnti)->second.size ());
-
-                  for (std::multimap <uint8_t, qos_rb_and_CQI_assigned_to_lc>::iterator itRBG = allocationMapPerRntiPerLCId.find (flowId.m_rnti)->second.begin ();
-                       itRBG!=allocationMapPerRntiPerLCId.find (flowId.m_rnti)->second.end (); itRBG++)
-                    {
-                      qos_rb_and_CQI_assigned_to_lc e = itRBG->second;
-                      if (e.cqi_value_for_lc < worstCQIAmongRBGsAllocatedForThisUser)
-                        worstCQIAmongRBGsAllocatedForThisUser=e.cqi_value_for_lc;
-                    }
-
-                  if (cqi_value < worstCQIAmongRBGsAllocatedForThisUser)
-                    {
-                      worstCQIAmongRBGsAllocatedForThisUser=cqi_value;
-                    }
-                }
-
-              int mcsForThisUser = m_amc->GetMcsFromCqi (worstCQIAmongRBGsAllocatedForThisUser);
-              int tbSize = m_amc->GetDlTbSizeFromMcs (mcsForThisUser, (numberOfRBGAllocatedForThisUser+1) * rbgSize)/8;                           // similar to calculation of TB size (size of TB in bytes according to table 7.1.7.2.1-1 of 36.213)
-
 
-              double achievableRate = (( m_amc->GetDlTbSizeFromMcs (mcsForThisUser, rbgSize)/ 8) / 0.001);
-              double pf_weight = achievableRate / (*itStats).second.secondLastAveragedThroughput;
-
-              UeToAmountOfAssignedResources.find (flowId)->second = 8*tbSize;
-              FfMacSchedSapProvider::SchedDlRlcBufferReqParameters lcBufferInfo = m_rlcBufferReq.find (flowId)->second;
-
-              if (UeToAmountOfDataToTransfer.find (flowId)->second - UeToAmountOfAssignedResources.find (flowId)->second < 0)
+              uint8_t worstCQIAmongRBGsAllocatedForThisUser = cqi_value;
+              if (ue.nAllocatedRbgs > 0 && ue.worstAllocatedCqi < worstCQIAmongRBGsAllocatedForThisUser)
                 {
-                  UeHasReachedGBR.insert (std::pair<LteFlowId_t,bool>(flowId,false));
+                  worstCQIAmongRBGsAllocatedForThisUser = ue.worstAllocatedCqi;
                 }
 
-              double bitRateWithNewRBG = 0;
+              int mcsForThisUser = mcsPerCqi[worstCQIAmongRBGsAllocatedForThisUser];
+              int tbSize = m_amc->GetDlTbSizeFromMcs (mcsForThisUser, (ue.nAllocatedRbgs+1) * rbgSize)/8;                           // similar to calculation of TB size (size of TB in bytes according to table 7.1.7.2.1-1 of 36.213)
 
-              if (m_flowStatsDl.find (flowId.m_rnti)!= m_flowStatsDl.end ())                         // there are some statistics{
-                {
-                  bitRateWithNewRBG = (1.0 - (1.0 / m_timeWindow)) * (m_flowStatsDl.find (flowId.m_rnti)->second.lastAveragedThroughput) + ((1.0 / m_timeWindow) * (double)(tbSize*1000));
-                }
-              else
-                {
-                  bitRateWithNewRBG = (1.0 / m_timeWindow) * (double)(tbSize*1000);
-                }
 
-              if(bitRateWithNewRBG > lc.m_eRabGuaranteedBitrateDl)
-                {
-                  UeHasReachedGBR.insert (std::pair<LteFlowId_t,bool>(flowId,true));
-                }
-              else
-                {
-                  UeHasReachedGBR.insert (std::pair<LteFlowId_t,bool>(flowId,false));
-                }
+              double achievableRate = ratePerCqi[worstCQIAmongRBGsAllocatedForThisUser];
+              double pf_weight = achievableRate / (*flow.stats).second.secondLastAveragedThroughput;
 
-              int hol = UEtoHOL.find (flowId)->second;
+              flow.amountOfAssignedResources = 8*tbSize;
 
-              if (hol==0)
-                hol=1;
-
-              if ( m_CqaMetric.compare ("CqaFf") == 0)
+              if (cqaFfMetric)
                 {
-                  metric = coita_metric*tbr_weight*hol;
+                  metric = coita_metric*flow.tbrWeight*flow.hol;
                 }
-              else if (m_CqaMetric.compare ("CqaPf") == 0)
+              else if (cqaPfMetric)
                 {
-                  metric = tbr_weight*pf_weight*hol;
+                  metric = flow.tbrWeight*pf_weight*flow.hol;
                 }
               else
                 {
@@ -1455,18 +1399,20 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
                 {
                   maximumValueMetric = metric;
                   userWithMaximumMetric = flowId;
+                  flowWithMaximumMetric = &flow;
+                  cqiOfUserWithMaximumMetric = cqi_value;
                 }
             }
 
-          if (!currentRBchecked)
+          if (!currentRBchecked || flowWithMaximumMetric == 0)
             {
               // erase current RBG from the list of available RBG
-              availableRBGs.erase (currentRB);
+              CqaRemoveAvailableRbg (availableRBGs, ues, currentRB);
               continue;
             }
 
           qos_rb_and_CQI_assigned_to_lc s;
-          s.cqi_value_for_lc = UeToCQIValue.find (userWithMaximumMetric)->second;
+          s.cqi_value_for_lc = cqiOfUserWithMaximumMetric;
           s.resource_block_index = currentRB;
 
           itMap = allocationMapPerRntiPerLCId.find (userWithMaximumMetric.m_rnti);
@@ -1481,12 +1427,17 @@ CqaFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
             {
               itMap->second.insert (std::pair<uint8_t,qos_rb_and_CQI_assigned_to_lc> (userWithMaximumMetric.m_lcId,s));
             }
+          CqaDlUe *ueWithMaximumMetric = flowWithMaximumMetric->ue;
+          ueWithMaximumMetric->nAllocatedRbgs++;
+          if (s.cqi_value_for_lc < ueWithMaximumMetric->worstAllocatedCqi)
+            {
+              ueWithMaximumMetric->worstAllocatedCqi = s.cqi_value_for_lc;
+            }
 
           // erase current RBG from the list of available RBG
-          availableRBGs.erase (currentRB);
+          CqaRemoveAvailableRbg (availableRBGs, ues, currentRB);
 
-          if (UeToAmountOfDataToTransfer.find (userWithMaximumMetric)->second <= UeToAmountOfAssignedResources.find (userWithMaximumMetric)->second*tolerance)
-          //||(UeHasReachedGBR.find(userWithMaximumMetric)->second == true))
+          if (flowWithMaximumMetric->amountOfDataToTransfer <= flowWithMaximumMetric->amountOfAssignedResources*tolerance)
             {
               itCurrentGroup->second.erase (userWithMaximumMetric);
             }
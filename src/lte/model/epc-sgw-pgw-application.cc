@@ -162,21 +162,20 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
 {
   NS_LOG_FUNCTION (this << source << dest << packet << packet->GetSize ());
   m_rxTunPktTrace (packet->Copy ());
-  Ptr<Packet> pCopy = packet->Copy ();
 
   uint8_t ipType;
-  pCopy->CopyData (&ipType, 1);
+  packet->CopyData (&ipType, 1);
   ipType = (ipType>>4) & 0x0f;
 
   // get IP address of UE
   if (ipType == 0x04)
     {
       Ipv4Header ipv4Header;
-      pCopy->RemoveHeader (ipv4Header);
+      packet->PeekHeader (ipv4Header);
       Ipv4Address ueAddr =  ipv4Header.GetDestination ();
       NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
       // find corresponding UeInfo address
-      std::map<Ipv4Address, Ptr<UeInfo> >::iterator it = m_ueInfoByAddrMap.find (ueAddr);
+      std::unordered_map<Ipv4Address, Ptr<UeInfo>, Ipv4AddressHash>::iterator it = m_ueInfoByAddrMap.find (ueAddr);
       if (it == m_ueInfoByAddrMap.end ())
         {        
           NS_LOG_WARN ("unknown UE address " << ueAddr);
@@ -198,11 +197,11 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
   else if (ipType == 0x06)
     {
       Ipv6Header ipv6Header;
-      pCopy->RemoveHeader (ipv6Header);
+      packet->PeekHeader (ipv6Header);
       Ipv6Address ueAddr =  ipv6Header.GetDestinationAddress ();
       NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
       // find corresponding UeInfo address
-      std::map<Ipv6Address, Ptr<UeInfo> >::iterator it = m_ueInfoByAddrMap6.find (ueAddr);
+      std::unordered_map<Ipv6Address, Ptr<UeInfo>, Ipv6AddressHash>::iterator it = m_ueInfoByAddrMap6.find (ueAddr);
       if (it == m_ueInfoByAddrMap6.end ())
         {        
           NS_LOG_WARN ("unknown UE address " << ueAddr);
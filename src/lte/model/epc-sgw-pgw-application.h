@@ -23,6 +23,8 @@
 #define EPC_SGW_PGW_APPLICATION_H
 
 #include <ns3/address.h>
+#include <ns3/ipv4-address.h>
+#include <ns3/ipv6-address.h>
 #include <ns3/socket.h>
 #include <ns3/virtual-net-device.h>
 #include <ns3/traced-callback.h>
@@ -37,6 +39,7 @@
 #include <ns3/epc-s1ap-sap.h>
 #include <ns3/epc-s11-sap.h>
 #include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -290,12 +293,12 @@ public:
   /**
    * Map telling for each UE IPv4 address the corresponding UE info 
    */
-  std::map<Ipv4Address, Ptr<UeInfo> > m_ueInfoByAddrMap;
+  std::unordered_map<Ipv4Address, Ptr<UeInfo>, Ipv4AddressHash> m_ueInfoByAddrMap;
 
   /**
    * Map telling for each UE IPv6 address the corresponding UE info 
    */
-  std::map<Ipv6Address, Ptr<UeInfo> > m_ueInfoByAddrMap6;
+  std::unordered_map<Ipv6Address, Ptr<UeInfo>, Ipv6AddressHash> m_ueInfoByAddrMap6;
 
   /**
    * Map telling for each IMSI the corresponding UE info 
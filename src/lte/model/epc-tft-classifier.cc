@@ -40,6 +40,32 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
+/// Number of flows after which the classification cache is flushed
+static const size_t MAX_CACHED_FLOWS = 4096;
+
+bool
+EpcTftClassifier::Ipv4FlowKey::operator== (const Ipv4FlowKey &other) const
+{
+  return localAddress == other.localAddress && remoteAddress == other.remoteAddress
+         && localPort == other.localPort && remotePort == other.remotePort
+         && tos == other.tos && direction == other.direction;
+}
+
+size_t
+EpcTftClassifier::Ipv4FlowKeyHash::operator() (const Ipv4FlowKey &key) const
+{
+  uint64_t h = ((uint64_t) key.localAddress << 32) | key.remoteAddress;
+  h ^= ((uint64_t) key.localPort << 48) ^ ((uint64_t) key.remotePort << 32)
+    ^ ((uint64_t) key.tos << 8) ^ key.direction;
+  // 64-bit finalizer of MurmurHash3
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
 EpcTftClassifier::EpcTftClassifier ()
 {
   NS_LOG_FUNCTION (this);
@@ -50,6 +76,7 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
 {
   NS_LOG_FUNCTION (this << tft << id);
   m_tftMap[id] = tft;
+  m_ipv4FlowCache.clear ();
 
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
@@ -60,6 +87,7 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_ipv4FlowCache.clear ();
 }
 
  
@@ -68,10 +96,8 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 {
   NS_LOG_FUNCTION (this << p << p->GetSize () << direction);
 
-  Ptr<Packet> pCopy = p->Copy ();
-
   uint8_t ipType;
-  pCopy->CopyData (&ipType, 1);
+  p->CopyData (&ipType, 1);
   ipType = (ipType>>4) & 0x0f;
 
   Ipv4Address localAddressIpv4;
@@ -88,8 +114,10 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 
   if (ipType == 0x04)
     {
+      // peek at the headers instead of removing them from a copy of the packet
       Ipv4Header ipv4Header;
-      pCopy->RemoveHeader (ipv4Header);
+      p->PeekHeader (ipv4Header);
+      uint32_t headerSize = ipv4Header.GetSerializedSize ();
 
       if (direction ==  EpcTft::UPLINK)
         {
@@ -120,19 +148,25 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
       // i.e. it is the first one but it is not the last one
       if (fragmentOffset == 0)
         {
-          if (protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
+          if ((protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
+              || (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20))
             {
-              UdpHeader udpHeader;
-              pCopy->RemoveHeader (udpHeader);
+              // both UDP and TCP headers start with the source and destination ports
+              uint8_t buffer[64]; // the largest IPv4 header is 60 bytes long
+              NS_ASSERT (headerSize + 4 <= sizeof (buffer));
+              NS_ABORT_MSG_IF (p->CopyData (buffer, headerSize + 4) < headerSize + 4,
+                               "EpcTftClassifier::Classify - truncated packet");
+              uint16_t sourcePort = (buffer[headerSize] << 8) | buffer[headerSize + 1];
+              uint16_t destinationPort = (buffer[headerSize + 2] << 8) | buffer[headerSize + 3];
               if (direction ==  EpcTft::UPLINK)
                 {
-                  localPort = udpHeader.GetSourcePort ();
-                  remotePort = udpHeader.GetDestinationPort ();
+                  localPort = sourcePort;
+                  remotePort = destinationPort;
                 }
               else
                 {
-                  remotePort = udpHeader.GetSourcePort ();
-                  localPort = udpHeader.GetDestinationPort ();
+                  remotePort = sourcePort;
+                  localPort = destinationPort;
                 }
               if (!isLastFragment)
                 {
@@ -145,33 +179,6 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
                   m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (localPort, remotePort);
                 }
             }
-          else if (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20)
-            {
-              TcpHeader tcpHeader;
-              pCopy->RemoveHeader (tcpHeader);
-              if (direction ==  EpcTft::UPLINK)
-                {
-                  localPort = tcpHeader.GetSourcePort ();
-                  remotePort = tcpHeader.GetDestinationPort ();
-                }
-              else
-                {
-                  remotePort = tcpHeader.GetSourcePort ();
-                  localPort = tcpHeader.GetDestinationPort ();
-                }
-
-              if (!isLastFragment)
-                {
-                  std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-                      std::make_tuple (ipv4Header.GetSource ().Get (),
-                                       ipv4Header.GetDestination ().Get (),
-                                       protocol,
-                                       ipv4Header.GetIdentification ());
-
-                  m_classifiedIpv4Fragments[fragmentKey] = std::make_pair (localPort, remotePort);
-                }
-            }
-
           // else
           //   First fragment but not enough data for port info or not UDP/TCP protocol.
           //   Nothing can be done, i.e. we cannot get port info from packet.
@@ -204,6 +211,7 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
     }
   else if (ipType == 0x06)
     {
+      Ptr<Packet> pCopy = p->Copy ();
       Ipv6Header ipv6Header;
       pCopy->RemoveHeader (ipv6Header);
 
@@ -270,6 +278,27 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
           << " remotePort=" << remotePort
           << " tos=0x" << (uint16_t) tos );
 
+      // the packets of a flow are all classified in the same way,
+      // so the TFTs are only evaluated for the first one
+      Ipv4FlowKey flowKey;
+      flowKey.localAddress = localAddressIpv4.Get ();
+      flowKey.remoteAddress = remoteAddressIpv4.Get ();
+      flowKey.localPort = localPort;
+      flowKey.remotePort = remotePort;
+      flowKey.tos = tos;
+      flowKey.direction = direction;
+      std::unordered_map<Ipv4FlowKey, uint32_t, Ipv4FlowKeyHash>::const_iterator cacheIt = m_ipv4FlowCache.find (flowKey);
+      if (cacheIt != m_ipv4FlowCache.end ())
+        {
+          NS_LOG_LOGIC ("cached classification, TFT ID = " << cacheIt->second);
+          return cacheIt->second;
+        }
+      if (m_ipv4FlowCache.size () >= MAX_CACHED_FLOWS)
+        {
+          NS_LOG_LOGIC ("flushing the classification cache");
+          m_ipv4FlowCache.clear ();
+        }
+
       // now it is possible to classify the packet!
       // we use a reverse iterator since filter priority is not implemented properly.
       // This way, since the default bearer is expected to be added first, it will be evaluated last.
@@ -284,9 +313,11 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
           if (tft->Matches (direction, remoteAddressIpv4, localAddressIpv4, remotePort, localPort, tos))
             {
               NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
+              m_ipv4FlowCache[flowKey] = it->first;
               return it->first; // the id of the matching TFT
             }
         }
+      m_ipv4FlowCache[flowKey] = 0;
     }
   else if (ipType == 0x06)
     {
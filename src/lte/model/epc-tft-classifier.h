@@ -28,6 +28,7 @@
 #include "ns3/epc-tft.h"
 
 #include <map>
+#include <unordered_map>
 
 
 namespace ns3 {
@@ -50,6 +51,12 @@ class Packet;
  *
  * When we cannot cache the port info, the TFT of the default bearer is used. This may happen
  * if there is reordering or losses of IP packets.
+ *
+ * The result of the classification of IPv4 packets is cached by flow
+ * (addresses, ports and type of service), so that the TFTs are only
+ * evaluated for the first packet of each flow. The cache is flushed
+ * when a TFT is added or deleted; a TFT must therefore not be modified
+ * after it is added to the classifier.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
 {
@@ -85,9 +92,38 @@ public:
   uint32_t Classify (Ptr<Packet> p, EpcTft::Direction direction);
   
 protected:
-  
+
+  /// The fields of an IPv4 packet against which the TFTs are matched
+  struct Ipv4FlowKey
+  {
+    uint32_t localAddress;  ///< local (UE) address
+    uint32_t remoteAddress; ///< remote address
+    uint16_t localPort;     ///< local port
+    uint16_t remotePort;    ///< remote port
+    uint8_t tos;            ///< type of service
+    uint8_t direction;      ///< the EpcTft::Direction
+    /**
+     * \param other the other key
+     * \return true if the two keys are equal
+     */
+    bool operator== (const Ipv4FlowKey &other) const;
+  };
+
+  /// Hash function of Ipv4FlowKey
+  struct Ipv4FlowKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator() (const Ipv4FlowKey &key) const;
+  };
+
   std::map <uint32_t, Ptr<EpcTft> > m_tftMap; ///< TFT map
 
+  /// Identifier of the TFT matching each IPv4 flow already classified (0 if none)
+  std::unordered_map<Ipv4FlowKey, uint32_t, Ipv4FlowKeyHash> m_ipv4FlowCache;
+
   std::map < std::tuple<uint32_t, uint32_t, uint8_t, uint16_t>,
              std::pair<uint32_t, uint32_t> >
       m_classifiedIpv4Fragments; ///< Map with already classified IPv4 Fragments
@@ -29,6 +29,7 @@
 #include "ns3/epc-x2-sap.h"
 
 #include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -213,7 +214,7 @@ private:
    * Map the targetCellId to the corresponding (sourceSocket, remoteIpAddr) to be used
    * to send the X2 message
    */
-  std::map < uint16_t, Ptr<X2IfaceInfo> > m_x2InterfaceSockets;
+  std::unordered_map < uint16_t, Ptr<X2IfaceInfo> > m_x2InterfaceSockets;
 
   /**
    * Map the localSocket (the one receiving the X2 message) 
@@ -396,23 +396,7 @@ FdTbfqFfMacScheduler::GetRbgSize (int dlbandwidth)
 unsigned int
 FdTbfqFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
+  return CountActiveLcs (m_rlcBufferReq, rnti);
 }
 
 
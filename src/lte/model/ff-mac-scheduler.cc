@@ -66,6 +66,26 @@ FfMacScheduler::GetTypeId (void)
   return tid;
 }
 
+unsigned int
+FfMacScheduler::CountActiveLcs (const std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> &rlcBufferReq,
+                                uint16_t rnti)
+{
+  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::const_iterator it;
+  unsigned int lcActive = 0;
+  // the flows are sorted by RNTI, so only the flows of this UE are visited
+  for (it = rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0));
+       it != rlcBufferReq.end () && (*it).first.m_rnti == rnti; it++)
+    {
+      if (((*it).second.m_rlcTransmissionQueueSize > 0)
+          || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*it).second.m_rlcStatusPduSize > 0))
+        {
+          lcActive++;
+        }
+    }
+  return (lcActive);
+}
+
 
 } // namespace ns3
 
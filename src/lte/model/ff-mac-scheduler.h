@@ -23,6 +23,9 @@
 #define FF_MAC_SCHEDULER_H
 
 #include <ns3/object.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <ns3/lte-common.h>
+#include <map>
 
 
 namespace ns3 {
@@ -129,7 +132,18 @@ public:
   virtual LteFfrSapUser* GetLteFfrSapUser () = 0;
   
 protected:
-    
+
+  /**
+   * Count the logical channels of a UE with data to transmit, i.e. with a
+   * non-empty transmission or retransmission queue or a pending status PDU
+   *
+   * \param rlcBufferReq the last RLC buffer status of each flow
+   * \param rnti the RNTI of the UE
+   * \return the number of active logical channels of the UE
+   */
+  static unsigned int CountActiveLcs (const std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> &rlcBufferReq,
+                                      uint16_t rnti);
+
   UlCqiFilter_t m_ulCqiFilter; ///< UL CQI filter
 
 };
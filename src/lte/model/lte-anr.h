@@ -31,7 +31,7 @@
 #include <ns3/object.h>
 #include <ns3/lte-rrc-sap.h>
 #include <ns3/lte-anr-sap.h>
-#include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -214,8 +214,8 @@ private:
     bool detectedAsNeighbour; ///< detected as neighbor
   };
 
-  /// cellId
-  typedef std::map<uint16_t, NeighbourRelation_t> NeighbourRelationTable_t;
+  /// Neighbour relations, hashed by cellId
+  typedef std::unordered_map<uint16_t, NeighbourRelation_t> NeighbourRelationTable_t;
 
   /// neighbor relation table
   NeighbourRelationTable_t m_neighbourRelationTable; 
@@ -25,6 +25,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 namespace ns3 {
 
@@ -69,13 +70,23 @@ protected:
   mutable uint8_t m_numSerializationPendingBits; //!< number of pending bits
   mutable bool m_isDataSerialized; //!< true if data is serialized
   mutable Buffer m_serializationResult; //!< serialization result
+  mutable std::vector<uint8_t> m_serializationOctets; //!< octets not yet copied to m_serializationResult
 
   /**
-   * Function to write in m_serializationResult, after resizing its size
+   * Function to write an octet, which is copied to m_serializationResult
+   * together with the others by FinalizeSerialization()
    * \param octet bits to write
    */
   void WriteOctet (uint8_t octet) const;
 
+  /**
+   * Serialize the least significant bits of a word, most significant
+   * bit first. All the other serialization functions use this one.
+   * \param value the bits to serialize
+   * \param nBits the number of bits to serialize (at most 32)
+   */
+  void SerializeBits (uint32_t value, uint8_t nBits) const;
+
   // Serialization functions
 
   /**
@@ -117,7 +128,8 @@ protected:
    */
   void SerializeNull () const;
   /**
-   * Finalizes an in progress serialization.
+   * Finalizes an in progress serialization, copying the serialized
+   * octets to m_serializationResult.
    */
   void FinalizeSerialization () const;
 
@@ -263,6 +275,17 @@ protected:
 
   // Deserialization functions
 
+  /**
+   * Deserialize a word, most significant bit first. All the other
+   * deserialization functions use this one.
+   * \param value buffer to store the result
+   * \param nBits the number of bits to deserialize (at most 32)
+   * \param bIterator buffer iterator
+   * \returns the modified buffer iterator
+   */
+  Buffer::Iterator DeserializeBits (uint32_t *value, uint8_t nBits,
+                                    Buffer::Iterator bIterator);
+
   /**
    * Deserialize a bitset
    * \param data buffer to store the result
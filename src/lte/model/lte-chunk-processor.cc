@@ -50,7 +50,10 @@ void
 LteChunkProcessor::Start ()
 {
   NS_LOG_FUNCTION (this);
-  m_sumValues = 0;
+  if (m_sumValues != 0)
+    {
+      (*m_sumValues) = 0.0;
+    }
   m_totDuration = MicroSeconds (0);
 }
 
@@ -59,11 +62,17 @@ void
 LteChunkProcessor::EvaluateChunk (const SpectrumValue& sinr, Time duration)
 {
   NS_LOG_FUNCTION (this << sinr << duration);
-  if (m_sumValues == 0)
+  if (m_sumValues == 0 || m_sumValues->GetSpectrumModel () != sinr.GetSpectrumModel ())
     {
       m_sumValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
+      m_meanValues = Create<SpectrumValue> (sinr.GetSpectrumModel ());
+    }
+  double seconds = duration.GetSeconds ();
+  Values::const_iterator valueIt = sinr.ConstValuesBegin ();
+  for (Values::iterator sumIt = m_sumValues->ValuesBegin (); sumIt != m_sumValues->ValuesEnd (); ++sumIt, ++valueIt)
+    {
+      *sumIt += *valueIt * seconds;
     }
-  (*m_sumValues) += sinr * duration.GetSeconds ();
   m_totDuration += duration;
 }
 
@@ -73,10 +82,16 @@ LteChunkProcessor::End ()
   NS_LOG_FUNCTION (this);
   if (m_totDuration.GetSeconds () > 0)
     {
+      double seconds = m_totDuration.GetSeconds ();
+      Values::const_iterator sumIt = m_sumValues->ConstValuesBegin ();
+      for (Values::iterator meanIt = m_meanValues->ValuesBegin (); meanIt != m_meanValues->ValuesEnd (); ++meanIt, ++sumIt)
+        {
+          *meanIt = *sumIt / seconds;
+        }
       std::vector<LteChunkProcessorCallback>::iterator it;
       for (it = m_lteChunkProcessorCallbacks.begin (); it != m_lteChunkProcessorCallbacks.end (); it++)
         {
-          (*it)((*m_sumValues) / m_totDuration.GetSeconds ());
+          (*it)(*m_meanValues);
         }
     }
   else
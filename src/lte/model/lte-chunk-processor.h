@@ -72,6 +72,8 @@ public:
     * \brief Collect SpectrumValue and duration of signal
     *
     * Passed values are collected in m_sumValues and m_totDuration variables.
+    * The buffer of m_sumValues is allocated once and reused, so that
+    * evaluating a chunk does not allocate memory.
     *
     * \param sinr the SINR
     * \param duration the duration
@@ -88,7 +90,8 @@ public:
   virtual void End ();
 
 private:
-  Ptr<SpectrumValue> m_sumValues; ///< sum values
+  Ptr<SpectrumValue> m_sumValues; ///< sum values, reused across calculations
+  Ptr<SpectrumValue> m_meanValues; ///< buffer holding the value passed to the callbacks
   Time m_totDuration; ///< total duration
 
   std::vector<LteChunkProcessorCallback> m_lteChunkProcessorCallbacks; ///< chunk processor callback
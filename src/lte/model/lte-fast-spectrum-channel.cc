@@ -0,0 +1,200 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/node.h>
+#include <ns3/net-device.h>
+#include <ns3/mobility-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
+
+#include <cmath>
+
+#include "lte-fast-spectrum-channel.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteFastSpectrumChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (LteFastSpectrumChannel);
+
+LteFastSpectrumChannel::LteFastSpectrumChannel ()
+  : m_txAggregatable (false),
+    m_txCellId (0),
+    m_txCtrl (false),
+    m_txPss (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteFastSpectrumChannel::~LteFastSpectrumChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+LteFastSpectrumChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteFastSpectrumChannel")
+    .SetParent<MultiModelSpectrumChannel> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LteFastSpectrumChannel> ()
+  ;
+  return tid;
+}
+
+void
+LteFastSpectrumChannel::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_deliverEvent.Cancel ();
+  m_interference.clear ();
+  m_txParams = 0;
+  MultiModelSpectrumChannel::DoDispose ();
+}
+
+void
+LteFastSpectrumChannel::ClassifySignal (Ptr<const SpectrumSignalParameters> txParams)
+{
+  NS_LOG_FUNCTION (this << txParams);
+  m_txParams = txParams;
+  m_txAggregatable = true;
+  m_txPss = false;
+  Ptr<const LteSpectrumSignalParametersDataFrame> dataParams = DynamicCast<const LteSpectrumSignalParametersDataFrame> (txParams);
+  Ptr<const LteSpectrumSignalParametersDlCtrlFrame> dlCtrlParams = DynamicCast<const LteSpectrumSignalParametersDlCtrlFrame> (txParams);
+  Ptr<const LteSpectrumSignalParametersUlSrsFrame> ulSrsParams = DynamicCast<const LteSpectrumSignalParametersUlSrsFrame> (txParams);
+  if (dataParams != 0)
+    {
+      m_txCellId = dataParams->cellId;
+      m_txCtrl = false;
+    }
+  else if (dlCtrlParams != 0)
+    {
+      m_txCellId = dlCtrlParams->cellId;
+      m_txCtrl = true;
+      m_txPss = dlCtrlParams->pss;
+    }
+  else if (ulSrsParams != 0)
+    {
+      m_txCellId = ulSrsParams->cellId;
+      m_txCtrl = true;
+    }
+  else
+    {
+      m_txAggregatable = false;
+    }
+}
+
+bool
+LteFastSpectrumChannel::DoHandleRx (Ptr<const SpectrumSignalParameters> txParams, Ptr<const SpectrumValue> rxPsd,
+                                    Ptr<MobilityModel> txMobility, Ptr<SpectrumPhy> receiver,
+                                    double pathLossDb, Time delay)
+{
+  NS_LOG_FUNCTION (this << txParams << receiver << pathLossDb << delay);
+
+  if (txParams != m_txParams)
+    {
+      ClassifySignal (txParams);
+    }
+  if (!m_txAggregatable)
+    {
+      return false;
+    }
+  Ptr<LteSpectrumPhy> lteReceiver = DynamicCast<LteSpectrumPhy> (receiver);
+  if (lteReceiver == 0 || lteReceiver->GetCellId () == 0 || lteReceiver->GetCellId () == m_txCellId)
+    {
+      // not LTE, a UE which is still looking for a cell, or the serving cell
+      return false;
+    }
+
+  Interference &interference = m_interference[InterferenceKey_t (receiver, m_txCtrl, txParams->duration)];
+  if (interference.psd == 0)
+    {
+      NS_LOG_LOGIC ("new interference to " << receiver << " ctrl " << m_txCtrl);
+      interference.psd = Create<SpectrumValue> (rxPsd->GetSpectrumModel ());
+      interference.delay = delay;
+      if (!m_deliverEvent.IsRunning ())
+        {
+          // the other cells transmit at the same time, so that they
+          // are aggregated before this event runs
+          m_deliverEvent = Simulator::ScheduleNow (&LteFastSpectrumChannel::DeliverInterference, this);
+        }
+    }
+  else if (delay < interference.delay)
+    {
+      interference.delay = delay;
+    }
+
+  if (!m_txPss && GetSpectrumPropagationLossModel () == 0)
+    {
+      // only the single-frequency loss: no need to copy the PSD
+      double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+      Values::const_iterator rxIt = rxPsd->ConstValuesBegin ();
+      for (Values::iterator it = interference.psd->ValuesBegin (); it != interference.psd->ValuesEnd (); ++it, ++rxIt)
+        {
+          *it += *rxIt * pathGainLinear;
+        }
+    }
+  else
+    {
+      Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters> ();
+      rxParams->psd = Copy<SpectrumValue> (rxPsd);
+      rxParams->duration = txParams->duration;
+      ApplyPropagation (rxParams, txMobility, receiver, pathLossDb);
+      *(interference.psd) += *(rxParams->psd);
+      if (m_txPss)
+        {
+          interference.pssList.push_back (std::make_pair (m_txCellId, rxParams->psd));
+        }
+    }
+  return true;
+}
+
+void
+LteFastSpectrumChannel::DeliverInterference ()
+{
+  NS_LOG_FUNCTION (this << m_interference.size ());
+  for (InterferenceMap_t::const_iterator it = m_interference.begin (); it != m_interference.end (); ++it)
+    {
+      Ptr<SpectrumPhy> receiver = std::get<0> (it->first);
+      Ptr<LteSpectrumSignalParametersInterference> params = Create<LteSpectrumSignalParametersInterference> ();
+      params->ctrl = std::get<1> (it->first);
+      params->duration = std::get<2> (it->first);
+      params->psd = it->second.psd;
+      params->pssList = it->second.pssList;
+      Ptr<SpectrumSignalParameters> rxParams = params;
+
+      Ptr<NetDevice> netDev = receiver->GetDevice ();
+      if (netDev)
+        {
+          Simulator::ScheduleWithContext (netDev->GetNode ()->GetId (), it->second.delay,
+                                          &SpectrumPhy::StartRx, receiver, rxParams);
+        }
+      else
+        {
+          Simulator::Schedule (it->second.delay, &SpectrumPhy::StartRx, receiver, rxParams);
+        }
+    }
+  m_interference.clear ();
+}
+
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_FAST_SPECTRUM_CHANNEL_H
+#define LTE_FAST_SPECTRUM_CHANNEL_H
+
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/event-id.h>
+#include <ns3/nstime.h>
+
+#include <list>
+#include <map>
+#include <tuple>
+
+namespace ns3 {
+
+
+/**
+ * \ingroup lte
+ *
+ * A MultiModelSpectrumChannel implementing the fast PHY abstraction
+ * mode of the LteHelper.
+ *
+ * The LTE signals that a synchronized LteSpectrumPhy receives from
+ * other cells are only interference to it. Rather than delivering each
+ * of them in its own event, their received PSDs (after the path loss
+ * and the SpectrumPropagationLossModel of each link) are summed into a
+ * single LteSpectrumSignalParametersInterference per receiver, per
+ * signal class (data or control) and per duration, which is added to
+ * the LteInterference of the receiver. This saves the copy of the signal
+ * parameters, the reception event and the evaluation of the chunk
+ * processors for each interferer, while the SINR seen by the receiver
+ * is the same, except that the interference starts with the smallest
+ * propagation delay of the aggregated signals.
+ *
+ * The PSS of the aggregated DL control frames is still reported to the
+ * UE, for its measurements. Signals from the serving cell and all the
+ * signals to a UE which is not synchronized to a cell yet are delivered
+ * as usual.
+ */
+class LteFastSpectrumChannel : public MultiModelSpectrumChannel
+{
+public:
+  LteFastSpectrumChannel ();
+  virtual ~LteFastSpectrumChannel ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+protected:
+  virtual void DoDispose ();
+
+  // inherited from MultiModelSpectrumChannel
+  virtual bool DoHandleRx (Ptr<const SpectrumSignalParameters> txParams, Ptr<const SpectrumValue> rxPsd,
+                           Ptr<MobilityModel> txMobility, Ptr<SpectrumPhy> receiver,
+                           double pathLossDb, Time delay);
+
+private:
+  /**
+   * Deliver the interference aggregated so far to the receivers.
+   */
+  void DeliverInterference ();
+
+  /**
+   * Find out whether a signal is an LTE signal that the other cells
+   * can treat as interference, and store its properties in the
+   * m_tx* members.
+   *
+   * \param txParams the signal
+   */
+  void ClassifySignal (Ptr<const SpectrumSignalParameters> txParams);
+
+  /// Aggregated interference: receiver, control (true) or data (false) signals, duration
+  typedef std::tuple<Ptr<SpectrumPhy>, bool, Time> InterferenceKey_t;
+
+  /// The interference aggregated for a receiver
+  struct Interference
+  {
+    Ptr<SpectrumValue> psd; ///< the sum of the received PSDs
+    Time delay;             ///< the smallest propagation delay
+    std::list<std::pair<uint16_t, Ptr<SpectrumValue> > > pssList; ///< the received PSS, with their cell ID
+  };
+
+  /// Container: InterferenceKey_t, Interference
+  typedef std::map<InterferenceKey_t, Interference> InterferenceMap_t;
+
+  InterferenceMap_t m_interference; ///< the interference to be delivered
+  EventId m_deliverEvent; ///< the event delivering m_interference
+
+  Ptr<const SpectrumSignalParameters> m_txParams; ///< the last signal classified by ClassifySignal ()
+  bool m_txAggregatable; ///< whether m_txParams is aggregated
+  uint16_t m_txCellId;   ///< the cell of m_txParams
+  bool m_txCtrl;         ///< whether m_txParams is a control signal
+  bool m_txPss;          ///< whether m_txParams carries the PSS
+};
+
+
+} // namespace ns3
+
+#endif /* LTE_FAST_SPECTRUM_CHANNEL_H */
@@ -25,6 +25,8 @@
 #include <ns3/simulator.h>
 #include <ns3/log.h>
 
+#include <algorithm>
+
 
 namespace ns3 {
 
@@ -53,6 +55,8 @@ LteInterference::DoDispose ()
   m_rxSignal = 0;
   m_allSignals = 0;
   m_noise = 0;
+  m_interf = 0;
+  m_sinr = 0;
   Object::DoDispose ();
 } 
 
@@ -75,18 +79,25 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
   if (m_receiving == false)
     {
       NS_LOG_LOGIC ("first signal");
-      m_rxSignal = rxPsd->Copy ();
+      if (m_rxSignal == 0 || m_rxSignal->GetSpectrumModel () != rxPsd->GetSpectrumModel ())
+        {
+          m_rxSignal = rxPsd->Copy ();
+        }
+      else
+        {
+          std::copy (rxPsd->ConstValuesBegin (), rxPsd->ConstValuesEnd (), m_rxSignal->ValuesBegin ());
+        }
       m_lastChangeTime = Now ();
       m_receiving = true;
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
           (*it)->Start ();
         }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
           (*it)->Start ();
         }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
           (*it)->Start (); 
         }
@@ -115,15 +126,15 @@ LteInterference::EndRx ()
     {
       ConditionallyEvaluateChunk ();
       m_receiving = false;
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
           (*it)->End ();
         }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
           (*it)->End ();
         }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
           (*it)->End (); 
         }
@@ -188,19 +199,36 @@ LteInterference::ConditionallyEvaluateChunk ()
     {
       NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-
-      SpectrumValue sinr = (*m_rxSignal) / interf;
       Time duration = Now () - m_lastChangeTime;
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
+      if (!m_sinrChunkProcessorList.empty () || !m_interfChunkProcessorList.empty ())
+        {
+          // interference plus noise and SINR in a single pass over the
+          // bands, into buffers which are reused for all the chunks
+          // the iterators are walked in lockstep, which is only valid if
+          // the values share the bands, as the SpectrumValue operators check
+          NS_ASSERT (m_allSignals->GetSpectrumModel () == m_rxSignal->GetSpectrumModel ());
+          NS_ASSERT (m_noise->GetSpectrumModel () == m_rxSignal->GetSpectrumModel ());
+          AllocateChunkBuffers (m_rxSignal->GetSpectrumModel ());
+          Values::const_iterator allIt = m_allSignals->ConstValuesBegin ();
+          Values::const_iterator rxIt = m_rxSignal->ConstValuesBegin ();
+          Values::const_iterator noiseIt = m_noise->ConstValuesBegin ();
+          Values::iterator interfIt = m_interf->ValuesBegin ();
+          Values::iterator sinrIt = m_sinr->ValuesBegin ();
+          for (; rxIt != m_rxSignal->ConstValuesEnd (); ++allIt, ++rxIt, ++noiseIt, ++interfIt, ++sinrIt)
+            {
+              *interfIt = *allIt - *rxIt + *noiseIt;
+              *sinrIt = *rxIt / *interfIt;
+            }
+        }
+      for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (sinr, duration);
+          (*it)->EvaluateChunk (*m_sinr, duration);
         }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
         {
-          (*it)->EvaluateChunk (interf, duration);
+          (*it)->EvaluateChunk (*m_interf, duration);
         }
-      for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
+      for (std::vector<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
           (*it)->EvaluateChunk (*m_rxSignal, duration);
         }
@@ -208,6 +236,17 @@ LteInterference::ConditionallyEvaluateChunk ()
     }
 }
 
+void
+LteInterference::AllocateChunkBuffers (Ptr<const SpectrumModel> model)
+{
+  if (m_interf == 0 || m_interf->GetSpectrumModel () != model)
+    {
+      NS_LOG_LOGIC (this << " allocating the chunk buffers");
+      m_interf = Create<SpectrumValue> (model);
+      m_sinr = Create<SpectrumValue> (model);
+    }
+}
+
 void
 LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd)
 {
@@ -217,6 +256,7 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // reset m_allSignals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
   m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  AllocateChunkBuffers (noisePsd->GetSpectrumModel ());
   if (m_receiving == true)
     {
       // abort rx
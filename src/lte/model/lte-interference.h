@@ -27,7 +27,7 @@
 #include <ns3/nstime.h>
 #include <ns3/spectrum-value.h>
 
-#include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -122,6 +122,13 @@ private:
    * Considitionally evaluate chunk
    */
   void ConditionallyEvaluateChunk ();
+  /**
+   * Make sure that the buffers holding the interference and the SINR
+   * of a chunk use the given SpectrumModel
+   *
+   * @param model the SpectrumModel
+   */
+  void AllocateChunkBuffers (Ptr<const SpectrumModel> model);
   /**
    * Add signal function
    *
@@ -152,6 +159,15 @@ private:
 
   Ptr<const SpectrumValue> m_noise; ///< the noise value
 
+  Ptr<SpectrumValue> m_interf; /**< buffer holding the interference
+                                * plus noise of the last chunk, reused
+                                * for all the chunks
+                                */
+
+  Ptr<SpectrumValue> m_sinr; /**< buffer holding the SINR of the last
+                              * chunk, reused for all the chunks
+                              */
+
   Time m_lastChangeTime;     /**< the time of the last change in
                                 m_TotalPower */
 
@@ -160,15 +176,15 @@ private:
 
   /** all the processor instances that need to be notified whenever
   a new interference chunk is calculated */
-  std::list<Ptr<LteChunkProcessor> > m_rsPowerChunkProcessorList;
+  std::vector<Ptr<LteChunkProcessor> > m_rsPowerChunkProcessorList;
 
   /** all the processor instances that need to be notified whenever
       a new SINR chunk is calculated */
-  std::list<Ptr<LteChunkProcessor> > m_sinrChunkProcessorList;
+  std::vector<Ptr<LteChunkProcessor> > m_sinrChunkProcessorList;
 
   /** all the processor instances that need to be notified whenever
       a new interference chunk is calculated */
-  std::list<Ptr<LteChunkProcessor> > m_interfChunkProcessorList;
+  std::vector<Ptr<LteChunkProcessor> > m_interfChunkProcessorList;
 
 
 };
@@ -35,6 +35,7 @@
 #include <ns3/pointer.h>
 #include <stdint.h>
 #include <cmath>
+#include <algorithm>
 #include "stdlib.h"
 #include <ns3/lte-mi-error-model.h>
 
@@ -331,83 +332,78 @@ static const double cEcrTable [9][38] = {
 };
 
 
+/**
+ * The MI map of a modulation order, i.e., the MI as a function of the
+ * SINR (linear), sampled on a uniform SINR axis
+ */
+struct MiMap
+{
+  const double *axis;  ///< the SINR axis
+  const double *mi;    ///< the MI values
+  uint16_t size;       ///< the number of samples
+  double scalingCoeff; ///< the inverse of the distance between two SINR samples
+};
+
+/**
+ * \param mcs the MCS
+ * \return the MI map of the modulation order used by the given MCS
+ */
+static const MiMap &
+GetMiMap (uint8_t mcs)
+{
+  // since the values in the SINR axes are uniformly spaced, we have
+  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+  // the scaling coefficient is always the same, so we compute it once
+  // to speed up the calculation
+  static const MiMap qpsk = {MI_map_qpsk_axis, MI_map_qpsk, MI_MAP_QPSK_SIZE,
+                             (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0])};
+  static const MiMap qam16 = {MI_map_16qam_axis, MI_map_16qam, MI_MAP_16QAM_SIZE,
+                              (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0])};
+  static const MiMap qam64 = {MI_map_64qam_axis, MI_map_64qam, MI_MAP_64QAM_SIZE,
+                              (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0])};
+  if (mcs <= MI_QPSK_MAX_ID)
+    {
+      return qpsk;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID)
+    {
+      return qam16;
+    }
+  return qam64;
+}
+
+/**
+ * \param sinrLin the SINR (linear)
+ * \param map the MI map of the modulation order
+ * \return the MI
+ */
+static inline double
+SinrToMi (double sinrLin, const MiMap &map)
+{
+  if (sinrLin > map.axis[map.size - 1])
+    {
+      return 1;
+    }
+  double sinrIndexDouble = (sinrLin - map.axis[0]) * map.scalingCoeff + 1;
+  uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
+  NS_ASSERT_MSG (sinrIndex < map.size, "MI map out of data");
+  return map.mi[sinrIndex];
+}
+
+
 double 
 LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
   
+  const MiMap &miMap = GetMiMap (mcs);
   double MI;
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  
   for (uint32_t i = 0; i < map.size (); i++)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
-        {
-
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-            {
-              MI = 1;
-            }
-          else 
-            { 
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk = 
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
-            }
-        }
-      else
-        {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
-            {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else 
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam = 
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
-            }
-          else // 64-QAM
-            {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam = 
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
-            }
-        }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
+      double sinrLin = sinr[map[i]];
+      MI = SinrToMi (sinrLin, miMap);
+      NS_LOG_LOGIC (" RB " << map[i] << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
       MIsum += MI;
     }
   MI = MIsum / map.size ();
@@ -415,6 +411,19 @@ LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, ui
   return MI;
 }
 
+void
+LteMiErrorModel::MapSinrToMi (const SpectrumValue& sinr, uint8_t mcs, std::vector<double>& mi)
+{
+  NS_LOG_FUNCTION (sinr << (uint32_t) mcs);
+  const MiMap &miMap = GetMiMap (mcs);
+  mi.resize (sinr.ConstValuesEnd () - sinr.ConstValuesBegin ());
+  Values::const_iterator sinrIt = sinr.ConstValuesBegin ();
+  for (std::vector<double>::iterator miIt = mi.begin (); miIt != mi.end (); ++miIt, ++sinrIt)
+    {
+      *miIt = SinrToMi (*sinrIt, miMap);
+    }
+}
+
 
 double 
 LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
@@ -554,11 +563,46 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
 
 
 TbStats_t
-LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory)
+LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) size << (uint32_t) mcs);
+  return GetTbStatsFromMi (Mib (sinr, map, mcs), size, mcs, miHistory);
+}
+
+std::vector<TbStats_t>
+LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<TbDecodificationParams_t>& tbs)
+{
+  NS_LOG_FUNCTION (sinr << tbs.size ());
+  // MI of every RB, for each modulation order (QPSK, 16-QAM, 64-QAM),
+  // computed the first time a TB using that modulation order is found
+  std::vector<double> rbMi[3];
+  std::vector<TbStats_t> stats;
+  stats.reserve (tbs.size ());
+  for (std::vector<TbDecodificationParams_t>::const_iterator tb = tbs.begin (); tb != tbs.end (); ++tb)
+    {
+      NS_ASSERT (tb->rbMap != 0 && tb->miHistory != 0);
+      uint8_t modulation = (tb->mcs <= MI_QPSK_MAX_ID) ? 0 : ((tb->mcs <= MI_16QAM_MAX_ID) ? 1 : 2);
+      if (rbMi[modulation].empty ())
+        {
+          MapSinrToMi (sinr, tb->mcs, rbMi[modulation]);
+        }
+      const std::vector<double> &mi = rbMi[modulation];
+      double miSum = 0.0;
+      for (std::vector<int>::const_iterator rb = tb->rbMap->begin (); rb != tb->rbMap->end (); ++rb)
+        {
+          NS_ASSERT (*rb >= 0 && static_cast<std::size_t> (*rb) < mi.size ());
+          miSum += mi[*rb];
+        }
+      stats.push_back (GetTbStatsFromMi (miSum / tb->rbMap->size (), tb->size, tb->mcs, *tb->miHistory));
+    }
+  return stats;
+}
+
+TbStats_t
+LteMiErrorModel::GetTbStatsFromMi (double tbMi, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
+{
+  NS_LOG_FUNCTION (tbMi << (uint32_t) size << (uint32_t) mcs);
 
-  double tbMi = Mib(sinr, map, mcs);
   double MI = 0.0;
   double Reff = 0.0;
   NS_ASSERT (mcs < 29);
@@ -72,6 +72,15 @@ struct TbStats_t
   double tbler; ///< tbler
   double mi; ///< mi
 };
+
+/// TbDecodificationParams_t structure, a TB to be evaluated by the error model
+struct TbDecodificationParams_t
+{
+  const std::vector<int> *rbMap; ///< the actives RBs for the TB
+  uint16_t size; ///< the size in bytes of the TB
+  uint8_t mcs; ///< the MCS of the TB
+  const HarqProcessInfoList_t *miHistory; ///< MI of past transmissions (in case of retx)
+};
   
 
 
@@ -109,7 +118,29 @@ public:
    * \param miHistory  MI of past transmissions (in case of retx)
    * \return the TB error rate and MI
    */
-  static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory);
+  static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
+
+  /**
+   * \brief run the error-model algorithm for all the TBs received in a subframe
+   *
+   * The MI of every RB is computed at most once per modulation order, in a
+   * single pass over the perceived SINR values, and then averaged over the
+   * RBs of each TB. The results are the same as the ones obtained by calling
+   * GetTbDecodificationStats for each TB.
+   *
+   * \param sinr the perceived sinrs in the whole bandwidth
+   * \param tbs the TBs
+   * \return the TB error rate and MI of each TB, in the same order as tbs
+   */
+  static std::vector<TbStats_t> GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<TbDecodificationParams_t>& tbs);
+
+  /**
+   * \brief find the MI of every RB for the modulation of the specified MCS
+   * \param sinr the perceived sinrs in the whole bandwidth
+   * \param mcs the MCS
+   * \param mi the MI of every RB
+   */
+  static void MapSinrToMi (const SpectrumValue& sinr, uint8_t mcs, std::vector<double>& mi);
   
   /** 
   * \brief run the error-model algorithm for the specified PCFICH+PDCCH channels
@@ -119,7 +150,16 @@ public:
   static double GetPcfichPdcchError (const SpectrumValue& sinr);
 
 
-//private:
+private:
+  /**
+   * \brief run the error-model algorithm for a TB with the given MI
+   * \param tbMi the mmib of the TB
+   * \param size the size in bytes of the TB
+   * \param mcs the MCS of the TB
+   * \param miHistory  MI of past transmissions (in case of retx)
+   * \return the TB error rate and MI
+   */
+  static TbStats_t GetTbStatsFromMi (double tbMi, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
 
 
 
@@ -6799,6 +6799,7 @@ void
 RrcUlDcchMessage::PreSerialize () const
 {
   SerializeUlDcchMessage (m_messageType);
+  FinalizeSerialization ();
 }
 
 Buffer::Iterator
@@ -6860,6 +6861,7 @@ void
 RrcDlDcchMessage::PreSerialize () const
 {
   SerializeDlDcchMessage (m_messageType);
+  FinalizeSerialization ();
 }
 
 Buffer::Iterator
@@ -6921,6 +6923,7 @@ void
 RrcUlCcchMessage::PreSerialize () const
 {
   SerializeUlCcchMessage (m_messageType);
+  FinalizeSerialization ();
 }
 
 Buffer::Iterator
@@ -6982,6 +6985,7 @@ void
 RrcDlCcchMessage::PreSerialize () const
 {
   SerializeDlCcchMessage (m_messageType);
+  FinalizeSerialization ();
 }
 
 Buffer::Iterator
@@ -667,6 +667,7 @@ LteSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
   Ptr<LteSpectrumSignalParametersDataFrame> lteDataRxParams = DynamicCast<LteSpectrumSignalParametersDataFrame> (spectrumRxParams);
   Ptr<LteSpectrumSignalParametersDlCtrlFrame> lteDlCtrlRxParams = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (spectrumRxParams);
   Ptr<LteSpectrumSignalParametersUlSrsFrame> lteUlSrsRxParams = DynamicCast<LteSpectrumSignalParametersUlSrsFrame> (spectrumRxParams);
+  Ptr<LteSpectrumSignalParametersInterference> lteInterferenceRxParams = DynamicCast<LteSpectrumSignalParametersInterference> (spectrumRxParams);
   if (lteDataRxParams != 0)
     {
       m_interferenceData->AddSignal (rxPsd, duration);
@@ -682,6 +683,28 @@ LteSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumRxParams)
       m_interferenceCtrl->AddSignal (rxPsd, duration);
       StartRxUlSrs (lteUlSrsRxParams);
     }
+  else if (lteInterferenceRxParams != 0)
+    {
+      // aggregated LTE signals of other cells -> interference only,
+      // except for the PSS used by the UE measurements
+      if (lteInterferenceRxParams->ctrl)
+        {
+          m_interferenceCtrl->AddSignal (rxPsd, duration);
+          if (!m_ltePhyRxPssCallback.IsNull ())
+            {
+              for (std::list<std::pair<uint16_t, Ptr<SpectrumValue> > >::const_iterator it = lteInterferenceRxParams->pssList.begin ();
+                   it != lteInterferenceRxParams->pssList.end ();
+                   ++it)
+                {
+                  m_ltePhyRxPssCallback (it->first, it->second);
+                }
+            }
+        }
+      else
+        {
+          m_interferenceData->AddSignal (rxPsd, duration);
+        }
+    }
   else
     {
       // other type of signal (could be 3G, GSM, whatever) -> interference
@@ -971,12 +994,15 @@ LteSpectrumPhy::EndRxData ()
   NS_ASSERT (m_transmissionMode < m_txModeGain.size ());
   m_sinrPerceived *= m_txModeGain.at (m_transmissionMode);
   
-  while (itTb!=m_expectedTbs.end ())
+  if ((m_dataErrorModelEnabled)&&(m_rxPacketBurstList.size ()>0)) // avoid to check for errors when there is no actual data transmitted
     {
-      if ((m_dataErrorModelEnabled)&&(m_rxPacketBurstList.size ()>0)) // avoid to check for errors when there is no actual data transmitted
+      // retrieve the HARQ info of all the TBs, and evaluate them at once
+      std::vector<HarqProcessInfoList_t> harqInfoLists (m_expectedTbs.size ());
+      std::vector<TbDecodificationParams_t> tbParams (m_expectedTbs.size ());
+      uint32_t tbIndex = 0;
+      for (itTb = m_expectedTbs.begin (); itTb != m_expectedTbs.end (); itTb++, tbIndex++)
         {
-          // retrieve HARQ info
-          HarqProcessInfoList_t harqInfoList;
+          HarqProcessInfoList_t &harqInfoList = harqInfoLists[tbIndex];
           if ((*itTb).second.ndi == 0)
             {
               // TB retxed: retrieve HARQ history
@@ -990,7 +1016,18 @@ LteSpectrumPhy::EndRxData ()
                   harqInfoList = m_harqPhyModule->GetHarqProcessInfoUl ((*itTb).first.m_rnti, ulHarqId);
                 }
             }
-          TbStats_t tbStats = LteMiErrorModel::GetTbDecodificationStats (m_sinrPerceived, (*itTb).second.rbBitmap, (*itTb).second.size, (*itTb).second.mcs, harqInfoList);
+          tbParams[tbIndex].rbMap = &(*itTb).second.rbBitmap;
+          tbParams[tbIndex].size = (*itTb).second.size;
+          tbParams[tbIndex].mcs = (*itTb).second.mcs;
+          tbParams[tbIndex].miHistory = &harqInfoList;
+        }
+      std::vector<TbStats_t> tbStatsList = LteMiErrorModel::GetTbDecodificationStats (m_sinrPerceived, tbParams);
+
+      tbIndex = 0;
+      for (itTb = m_expectedTbs.begin (); itTb != m_expectedTbs.end (); itTb++, tbIndex++)
+        {
+          const HarqProcessInfoList_t &harqInfoList = harqInfoLists[tbIndex];
+          const TbStats_t &tbStats = tbStatsList[tbIndex];
           (*itTb).second.mi = tbStats.mi;
           (*itTb).second.corrupt = m_random->GetValue () > tbStats.tbler ? false : true;
           NS_LOG_DEBUG (this << "RNTI " << (*itTb).first.m_rnti << " size " << (*itTb).second.size << " mcs " << (uint32_t)(*itTb).second.mcs << " bitmap " << (*itTb).second.rbBitmap.size () << " layer " << (uint16_t)(*itTb).first.m_layer << " TBLER " << tbStats.tbler << " corrupted " << (*itTb).second.corrupt);
@@ -1019,9 +1056,7 @@ LteSpectrumPhy::EndRxData ()
               params.m_rv = harqInfoList.size ();
               m_ulPhyReception (params);
             }
-       }
-      
-      itTb++;
+        }
     }
     std::map <uint16_t, DlInfoListElement_s> harqDlInfoMap;
     for (std::list<Ptr<PacketBurst> >::const_iterator i = m_rxPacketBurstList.begin (); 
@@ -1213,6 +1248,12 @@ LteSpectrumPhy::SetCellId (uint16_t cellId)
   m_cellId = cellId;
 }
 
+uint16_t
+LteSpectrumPhy::GetCellId () const
+{
+  return m_cellId;
+}
+
 void
 LteSpectrumPhy::SetComponentCarrierId (uint8_t componentCarrierId)
 {
@@ -333,6 +333,12 @@ public:
    */
   void SetCellId (uint16_t cellId);
 
+  /**
+   *
+   * \return the Cell Identifier, or 0 if not synchronized to a cell yet
+   */
+  uint16_t GetCellId () const;
+
   /**
    *
    * \param componentCarrierId the component carrier id
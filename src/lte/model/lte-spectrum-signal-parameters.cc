@@ -147,6 +147,27 @@ LteSpectrumSignalParametersUlSrsFrame::Copy ()
 }
 
 
+LteSpectrumSignalParametersInterference::LteSpectrumSignalParametersInterference ()
+  : ctrl (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteSpectrumSignalParametersInterference::LteSpectrumSignalParametersInterference (const LteSpectrumSignalParametersInterference& p)
+: SpectrumSignalParameters (p)
+{
+  NS_LOG_FUNCTION (this << &p);
+  ctrl = p.ctrl;
+  pssList = p.pssList;
+}
+
+Ptr<SpectrumSignalParameters>
+LteSpectrumSignalParametersInterference::Copy ()
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<LteSpectrumSignalParametersInterference> lssp (new LteSpectrumSignalParametersInterference (*this), false);
+  return lssp;
+}
 
 
 
@@ -24,6 +24,7 @@
 
 
 #include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-value.h>
 
 namespace ns3 {
 
@@ -152,6 +153,36 @@ struct LteSpectrumSignalParametersUlSrsFrame : public SpectrumSignalParameters
 };
 
 
+/**
+* \ingroup lte
+*
+* Signal parameters for the aggregated interference of the LTE signals
+* of other cells, as delivered by the LteFastSpectrumChannel. The PSS
+* of the aggregated DL CTRL frames is reported to the receiver as if
+* the frames were received one by one.
+*/
+struct LteSpectrumSignalParametersInterference : public SpectrumSignalParameters
+{
+  
+  // inherited from SpectrumSignalParameters
+  virtual Ptr<SpectrumSignalParameters> Copy ();
+  
+  /**
+  * default constructor
+  */
+  LteSpectrumSignalParametersInterference ();
+  
+  /**
+  * copy constructor
+  * \param p the LteSpectrumSignalParametersInterference to copy
+  */
+  LteSpectrumSignalParametersInterference (const LteSpectrumSignalParametersInterference& p);
+  
+  bool ctrl; ///< true if interfering with control signals (DL CTRL, UL SRS), false if with data
+  std::list<std::pair<uint16_t, Ptr<SpectrumValue> > > pssList; ///< cell ID and received PSD of the aggregated DL CTRL frames carrying the PSS
+};
+
+
 }  // namespace ns3
 
 
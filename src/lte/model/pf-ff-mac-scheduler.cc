@@ -44,6 +44,15 @@ static const int PfType0AllocationRbg[4] = {
 };  // see table 7.1.6.1-1 of 36.213
 
 
+/// A UE which can be allocated new RBGs in the current TTI
+struct PfDlCandidate
+{
+  std::map <uint16_t, pfsFlowPerf_t>::iterator flow; ///< the flow stats of the UE
+  const SbMeasResult_s *sbMeas; ///< the last subband CQI report of the UE, or 0 if none
+  int nLayer; ///< number of layers of the UE transmission mode
+};
+
+
 NS_OBJECT_ENSURE_REGISTERED (PfFfMacScheduler);
 
 
@@ -352,23 +361,7 @@ PfFfMacScheduler::GetRbgSize (int dlbandwidth)
 unsigned int
 PfFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
+  return CountActiveLcs (m_rlcBufferReq, rnti);
 }
 
 
@@ -920,93 +913,115 @@ PfFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sched
 
 
 
+  // Collect once per TTI the UEs which can be allocated new RBGs, in RNTI
+  // order, so that the RBG loop below only evaluates the subband CQIs
+  // instead of repeating the per-UE lookups for each RBG.
+  std::vector<PfDlCandidate> candidates;
+  candidates.reserve (m_flowStatsDl.size ());
+  std::map <uint16_t, pfsFlowPerf_t>::iterator it;
+  for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+    {
+      std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
+      if (itRnti != rntiAllocated.end ())
+        {
+          // UE already allocated for HARQ -> drop it
+          NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
+          continue;
+        }
+      if (!HarqProcessAvailability ((*it).first))
+        {
+          // UE without HARQ process available -> drop it
+          NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
+          continue;
+        }
+      if (LcActivePerFlow ((*it).first) == 0)
+        {
+          // this UE has no data to transmit
+          continue;
+        }
+      std::map <uint16_t,uint8_t>::iterator itTxMode;
+      itTxMode = m_uesTxMode.find ((*it).first);
+      if (itTxMode == m_uesTxMode.end ())
+        {
+          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
+        }
+      PfDlCandidate candidate;
+      candidate.flow = it;
+      std::map <uint16_t,SbMeasResult_s>::iterator itCqi = m_a30CqiRxed.find ((*it).first);
+      candidate.sbMeas = (itCqi == m_a30CqiRxed.end ()) ? 0 : &(*itCqi).second;
+      candidate.nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+      candidates.push_back (candidate);
+    }
+
+  // achievable rate of an RBG for each CQI value (= TB size / TTI)
+  uint8_t mcsPerCqi[16];
+  double ratePerCqi[16];
+  for (uint8_t cqi = 0; cqi < 16; cqi++)
+    {
+      mcsPerCqi[cqi] = m_amc->GetMcsFromCqi (cqi);
+      ratePerCqi[cqi] = (m_amc->GetDlTbSizeFromMcs (mcsPerCqi[cqi], rbgSize) / 8) / 0.001;
+    }
+  double worstMcsRate = (m_amc->GetDlTbSizeFromMcs (0, rbgSize) / 8) / 0.001;
+
   for (int i = 0; i < rbgNum; i++)
     {
       NS_LOG_INFO (this << " ALLOCATION for RBG " << i << " of " << rbgNum);
       if (rbgMap.at (i) == false)
         {
-          std::map <uint16_t, pfsFlowPerf_t>::iterator it;
           std::map <uint16_t, pfsFlowPerf_t>::iterator itMax = m_flowStatsDl.end ();
           double rcqiMax = 0.0;
-          for (it = m_flowStatsDl.begin (); it != m_flowStatsDl.end (); it++)
+          for (std::vector<PfDlCandidate>::const_iterator itCand = candidates.begin (); itCand != candidates.end (); itCand++)
             {
+              it = itCand->flow;
               if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, (*it).first)) == false)
                 continue;
 
-              std::set <uint16_t>::iterator itRnti = rntiAllocated.find ((*it).first);
-              if ((itRnti != rntiAllocated.end ())||(!HarqProcessAvailability ((*it).first)))
-                {
-                  // UE already allocated for HARQ or without HARQ process available -> drop it
-                  if (itRnti != rntiAllocated.end ())
-                    {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ tx" << (uint16_t)(*it).first);
-                    }
-                  if (!HarqProcessAvailability ((*it).first))
-                    {
-                      NS_LOG_DEBUG (this << " RNTI discared for HARQ id" << (uint16_t)(*it).first);
-                    }
-                  continue;
-                }
-              std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-              itCqi = m_a30CqiRxed.find ((*it).first);
-              std::map <uint16_t,uint8_t>::iterator itTxMode;
-              itTxMode = m_uesTxMode.find ((*it).first);
-              if (itTxMode == m_uesTxMode.end ())
-                {
-                  NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                }
-              int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-              std::vector <uint8_t> sbCqi;
-              if (itCqi == m_a30CqiRxed.end ())
-                {
-                  for (uint8_t k = 0; k < nLayer; k++)
-                    {
-                      sbCqi.push_back (1);  // start with lowest value
-                    }
-                }
-              else
+              int nLayer = itCand->nLayer;
+              // with no CQI report, start with lowest value on all the layers
+              const std::vector <uint8_t> *sbCqi = 0;
+              uint8_t cqi1 = 1;
+              uint8_t cqi2 = (nLayer > 1) ? 1 : 0;
+              if (itCand->sbMeas != 0)
                 {
-                  sbCqi = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                }
-              uint8_t cqi1 = sbCqi.at (0);
-              uint8_t cqi2 = 0;
-              if (sbCqi.size () > 1)
-                {
-                  cqi2 = sbCqi.at (1);
+                  sbCqi = &itCand->sbMeas->m_higherLayerSelected.at (i).m_sbCqi;
+                  cqi1 = sbCqi->at (0);
+                  cqi2 = (sbCqi->size () > 1) ? sbCqi->at (1) : 0;
                 }
 
               if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
                 {
-                  if (LcActivePerFlow ((*it).first) > 0)
+                  double achievableRate = 0.0;
+                  uint8_t mcs = 0;
+                  for (uint8_t k = 0; k < nLayer; k++)
                     {
-                      // this UE has data to transmit
-                      double achievableRate = 0.0;
-                      uint8_t mcs = 0;
-                      for (uint8_t k = 0; k < nLayer; k++)
+                      if (sbCqi == 0)
                         {
-                          if (sbCqi.size () > k)
-                            {
-                              mcs = m_amc->GetMcsFromCqi (sbCqi.at (k));
-                            }
-                          else
-                            {
-                              // no info on this subband -> worst MCS
-                              mcs = 0;
-                            }
-                          achievableRate += ((m_amc->GetDlTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001);   // = TB size / TTI
+                          mcs = mcsPerCqi[1];
+                          achievableRate += ratePerCqi[1];
                         }
-
-                      double rcqi = achievableRate / (*it).second.lastAveragedThroughput;
-                      NS_LOG_INFO (this << " RNTI " << (*it).first << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " avgThr " << (*it).second.lastAveragedThroughput << " RCQI " << rcqi);
-
-                      if (rcqi > rcqiMax)
+                      else if (sbCqi->size () > k)
+                        {
+                          mcs = mcsPerCqi[sbCqi->at (k)];
+                          achievableRate += ratePerCqi[sbCqi->at (k)];
+                        }
+                      else
                         {
-                          rcqiMax = rcqi;
-                          itMax = it;
+                          // no info on this subband -> worst MCS
+                          mcs = 0;
+                          achievableRate += worstMcsRate;
                         }
                     }
+
+                  double rcqi = achievableRate / (*it).second.lastAveragedThroughput;
+                  NS_LOG_INFO (this << " RNTI " << (*it).first << " MCS " << (uint32_t)mcs << " achievableRate " << achievableRate << " avgThr " << (*it).second.lastAveragedThroughput << " RCQI " << rcqi);
+
+                  if (rcqi > rcqiMax)
+                    {
+                      rcqiMax = rcqi;
+                      itMax = it;
+                    }
                 }   // end if cqi
-            } // end for m_rlcBufferReq
+            } // end for candidates
 
           if (itMax == m_flowStatsDl.end ())
             {
@@ -47,6 +47,17 @@ static const int PssType0AllocationRbg[4] = {
 };  // see table 7.1.6.1-1 of 36.213
 
 
+/// A UE selected by the TD scheduler in the current TTI
+struct PssDlCandidate
+{
+  std::map <uint16_t, pssFlowPerf_t>::iterator flow; ///< the entry of the UE in the TD scheduler result
+  const SbMeasResult_s *sbMeas; ///< the last subband CQI report of the UE, or 0 if none
+  int nLayer; ///< number of layers of the UE transmission mode
+  double weight; ///< PF weight of the UE, at least 1
+  uint8_t sbCqiSum; ///< sum of the subband CQIs of the UE over all the RBGs, for CoItA
+};
+
+
 NS_OBJECT_ENSURE_REGISTERED (PssFfMacScheduler);
 
 
@@ -380,23 +391,7 @@ PssFfMacScheduler::GetRbgSize (int dlbandwidth)
 unsigned int
 PssFfMacScheduler::LcActivePerFlow (uint16_t rnti)
 {
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it;
-  unsigned int lcActive = 0;
-  for (it = m_rlcBufferReq.begin (); it != m_rlcBufferReq.end (); it++)
-    {
-      if (((*it).first.m_rnti == rnti) && (((*it).second.m_rlcTransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcRetransmissionQueueSize > 0)
-                                           || ((*it).second.m_rlcStatusPduSize > 0) ))
-        {
-          lcActive++;
-        }
-      if ((*it).first.m_rnti > rnti)
-        {
-          break;
-        }
-    }
-  return (lcActive);
-
+  return CountActiveLcs (m_rlcBufferReq, rnti);
 }
 
 
@@ -1105,66 +1100,72 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
            } // end of m_flowStatsDl
         
         
+          // Collect once per TTI the UEs selected by the TD scheduler, in
+          // RNTI order, with their subband CQI report, number of layers and
+          // PF weight, so that the FD schedulers below only evaluate the
+          // subband CQIs for each (RBG, UE) pair.
+          std::vector<PssDlCandidate> candidates;
+          candidates.reserve (tdUeSet.size ());
+          for (it = tdUeSet.begin (); it != tdUeSet.end (); it++)
+            {
+              std::map <uint16_t,uint8_t>::iterator itTxMode;
+              itTxMode = m_uesTxMode.find ((*it).first);
+              if (itTxMode == m_uesTxMode.end ())
+                {
+                  NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
+                }
+              PssDlCandidate candidate;
+              candidate.flow = it;
+              std::map <uint16_t,SbMeasResult_s>::iterator itCqi = m_a30CqiRxed.find ((*it).first);
+              candidate.sbMeas = (itCqi == m_a30CqiRxed.end ()) ? 0 : &(*itCqi).second;
+              candidate.nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
+              // calculate PF weight
+              candidate.weight = (*it).second.targetThroughput / (*it).second.lastAveragedThroughput;
+              if (candidate.weight < 1.0)
+                candidate.weight = 1.0;
+              candidate.sbCqiSum = 0;
+              candidates.push_back (candidate);
+            }
+
           if ( m_fdSchedulerType.compare("CoItA") == 0)
             {
               // FD scheduler: Carrier over Interference to Average (CoItA)
-              std::map < uint16_t, uint8_t > sbCqiSum;
-              for (it = tdUeSet.begin (); it != tdUeSet.end (); it++)
+              for (std::vector<PssDlCandidate>::iterator itCand = candidates.begin (); itCand != candidates.end (); itCand++)
                 {
                   uint8_t sum = 0;
                   for (int i = 0; i < rbgNum; i++)
                     {
-                      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-                      itCqi = m_a30CqiRxed.find ((*it).first);
-                      std::map <uint16_t,uint8_t>::iterator itTxMode;
-                      itTxMode = m_uesTxMode.find ((*it).first);
-                      if (itTxMode == m_uesTxMode.end ())
-                        {
-                          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                        }
-                      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-                      std::vector <uint8_t> sbCqis;
-                      if (itCqi == m_a30CqiRxed.end ())
+                      // with no CQI report, start with lowest value on all the layers
+                      const std::vector <uint8_t> *sbCqis = 0;
+                      uint8_t cqi1 = 1;
+                      uint8_t cqi2 = (itCand->nLayer > 1) ? 1 : 0;
+                      if (itCand->sbMeas != 0)
                         {
-                          for (uint8_t k = 0; k < nLayer; k++)
-                            {
-                              sbCqis.push_back (1);  // start with lowest value
-                            }
-                        }
-                      else
-                        {
-                          sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                        }
-        
-                      uint8_t cqi1 = sbCqis.at (0);
-                      uint8_t cqi2 = 0;
-                      if (sbCqis.size () > 1)
-                        {
-                          cqi2 = sbCqis.at (1);
+                          sbCqis = &itCand->sbMeas->m_higherLayerSelected.at (i).m_sbCqi;
+                          cqi1 = sbCqis->at (0);
+                          cqi2 = (sbCqis->size () > 1) ? sbCqis->at (1) : 0;
                         }
-            
-                      uint8_t sbCqi = 0;
+
                       if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
                         {
-                          for (uint8_t k = 0; k < nLayer; k++) 
+                          for (uint8_t k = 0; k < itCand->nLayer; k++)
                             {
-                              if (sbCqis.size () > k)
-                                {                       
-           	                  sbCqi = sbCqis.at(k);
+                              if (sbCqis == 0)
+                                {
+                                  sum += 1;
                                 }
-                              else
+                              else if (sbCqis->size () > k)
                                 {
-                                  // no info on this subband 
-                                  sbCqi = 0;
+                                  sum += sbCqis->at (k);
                                 }
-                              sum += sbCqi;
+                              // else no info on this subband
                             }
                         }   // end if cqi
                     }// end of rbgNum
-              
-                  sbCqiSum.insert (std::pair<uint16_t, uint8_t> ((*it).first, sum));
-                }// end tdUeSet
-        
+
+                  itCand->sbCqiSum = sum;
+                }// end candidates
+
               for (int i = 0; i < rbgNum; i++)
                 {
                   if (rbgMap.at (i) == true)
@@ -1172,79 +1173,57 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
                   std::map <uint16_t, pssFlowPerf_t>::iterator itMax = tdUeSet.end ();
                   double metricMax = 0.0;
-                  for (it = tdUeSet.begin (); it != tdUeSet.end (); it++)
+                  for (std::vector<PssDlCandidate>::const_iterator itCand = candidates.begin (); itCand != candidates.end (); itCand++)
                     {
+                      it = itCand->flow;
                       if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, (*it).first)) == false)
                         continue;
 
-                      // calculate PF weight 
-                      double weight = (*it).second.targetThroughput / (*it).second.lastAveragedThroughput;
-                      if (weight < 1.0)
-                        weight = 1.0;
-        
-                      std::map < uint16_t, uint8_t>::iterator itSbCqiSum;
-                      itSbCqiSum = sbCqiSum.find((*it).first);
-        
-                      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-                      itCqi = m_a30CqiRxed.find ((*it).first);
-                      std::map <uint16_t,uint8_t>::iterator itTxMode;
-                      itTxMode = m_uesTxMode.find ((*it).first);
-                      if (itTxMode == m_uesTxMode.end())
-                        {
-                          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                        }
-                      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-                      std::vector <uint8_t> sbCqis;
-                      if (itCqi == m_a30CqiRxed.end ())
-                        {
-                          for (uint8_t k = 0; k < nLayer; k++)
-                            {
-                              sbCqis.push_back (1);  // start with lowest value
-                            }
-                        }
-                      else
-                        {
-                          sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                        }
-        
-                      uint8_t cqi1 = sbCqis.at( 0);
-                      uint8_t cqi2 = 0;
-                      if (sbCqis.size () > 1)
+                      const std::vector <uint8_t> *sbCqis = 0;
+                      uint8_t cqi1 = 1;
+                      uint8_t cqi2 = (itCand->nLayer > 1) ? 1 : 0;
+                      if (itCand->sbMeas != 0)
                         {
-                          cqi2 = sbCqis.at(1);
+                          sbCqis = &itCand->sbMeas->m_higherLayerSelected.at (i).m_sbCqi;
+                          cqi1 = sbCqis->at (0);
+                          cqi2 = (sbCqis->size () > 1) ? sbCqis->at (1) : 0;
                         }
-            
+
                       uint8_t sbCqi = 0;
                       double colMetric = 0.0;
                       if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
                         {
-                          for (uint8_t k = 0; k < nLayer; k++) 
+                          for (uint8_t k = 0; k < itCand->nLayer; k++)
                             {
-                              if (sbCqis.size () > k)
-                                {                       
-                                  sbCqi = sbCqis.at(k);
+                              if (sbCqis == 0)
+                                {
+                                  sbCqi = 1;
+                                }
+                              else if (sbCqis->size () > k)
+                                {
+                                  sbCqi = sbCqis->at (k);
                                 }
                               else
                                 {
-                                  // no info on this subband 
+                                  // no info on this subband
                                   sbCqi = 0;
                                 }
-                              colMetric += (double)sbCqi / (double)(*itSbCqiSum).second;
-           	                } 
+                              colMetric += (double)sbCqi / (double)itCand->sbCqiSum;
+                            }
                         }   // end if cqi
-        
+
                       double metric = 0.0;
                       if (colMetric != 0)
-                        metric= weight * colMetric;
+                        metric= itCand->weight * colMetric;
                       else
                         metric = 1;
-        
+
                       if (metric > metricMax )
                         {
                           metricMax = metric;
                           itMax = it;
                         }
-                    } // end of tdUeSet
+                    } // end of candidates
 
                   if (itMax == tdUeSet.end ())
                     {
@@ -1256,13 +1235,22 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
                       rbgMap.at (i) = true;
                     }
                 }// end of rbgNum
-        
+
             }// end of CoIta
-        
-        
+
+
           if ( m_fdSchedulerType.compare("PFsch") == 0)
             {
               // FD scheduler: Proportional Fair scheduled (PFsch)
+
+              // achievable rate of an RBG for each CQI value (= TB size / TTI)
+              double ratePerCqi[16];
+              for (uint8_t cqi = 0; cqi < 16; cqi++)
+                {
+                  ratePerCqi[cqi] = (m_amc->GetDlTbSizeFromMcs (m_amc->GetMcsFromCqi (cqi), rbgSize) / 8) / 0.001;
+                }
+              double worstMcsRate = (m_amc->GetDlTbSizeFromMcs (0, rbgSize) / 8) / 0.001;
+
               for (int i = 0; i < rbgNum; i++)
                 {
                   if (rbgMap.at (i) == true)
@@ -1270,74 +1258,54 @@ PssFfMacScheduler::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::Sche
 
                   std::map <uint16_t, pssFlowPerf_t>::iterator itMax = tdUeSet.end ();
                   double metricMax = 0.0;
-                  for (it = tdUeSet.begin (); it != tdUeSet.end (); it++)
+                  for (std::vector<PssDlCandidate>::const_iterator itCand = candidates.begin (); itCand != candidates.end (); itCand++)
                     {
+                      it = itCand->flow;
                       if ((m_ffrSapProvider->IsDlRbgAvailableForUe (i, (*it).first)) == false)
                         continue;
-                      // calculate PF weight 
-                      double weight = (*it).second.targetThroughput / (*it).second.lastAveragedThroughput;
-                      if (weight < 1.0)
-                        weight = 1.0;
-        
-                      std::map <uint16_t,SbMeasResult_s>::iterator itCqi;
-                      itCqi = m_a30CqiRxed.find ((*it).first);
-                      std::map <uint16_t,uint8_t>::iterator itTxMode;
-                      itTxMode = m_uesTxMode.find ((*it).first);
-                      if (itTxMode == m_uesTxMode.end())
-                        {
-                          NS_FATAL_ERROR ("No Transmission Mode info on user " << (*it).first);
-                        }
-                      int nLayer = TransmissionModesLayers::TxMode2LayerNum ((*itTxMode).second);
-                      std::vector <uint8_t> sbCqis;
-                      if (itCqi == m_a30CqiRxed.end ())
-                        {
-                          for (uint8_t k = 0; k < nLayer; k++)
-                            {
-                              sbCqis.push_back (1);  // start with lowest value
-                            }
-                        }
-                      else
-                        {
-                          sbCqis = (*itCqi).second.m_higherLayerSelected.at (i).m_sbCqi;
-                        }
-        
-                      uint8_t cqi1 = sbCqis.at(0);
-                      uint8_t cqi2 = 0;
-                      if (sbCqis.size () > 1)
+
+                      const std::vector <uint8_t> *sbCqis = 0;
+                      uint8_t cqi1 = 1;
+                      uint8_t cqi2 = (itCand->nLayer > 1) ? 1 : 0;
+                      if (itCand->sbMeas != 0)
                         {
-                          cqi2 = sbCqis.at(1);
+                          sbCqis = &itCand->sbMeas->m_higherLayerSelected.at (i).m_sbCqi;
+                          cqi1 = sbCqis->at (0);
+                          cqi2 = (sbCqis->size () > 1) ? sbCqis->at (1) : 0;
                         }
-                
+
                       double schMetric = 0.0;
                       if ((cqi1 > 0)||(cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
                         {
                           double achievableRate = 0.0;
-                          for (uint8_t k = 0; k < nLayer; k++) 
+                          for (uint8_t k = 0; k < itCand->nLayer; k++)
                             {
-                              uint8_t mcs = 0;
-                              if (sbCqis.size () > k)
-                                {                       
-                                  mcs = m_amc->GetMcsFromCqi (sbCqis.at (k));
+                              if (sbCqis == 0)
+                                {
+                                  achievableRate += ratePerCqi[1];
+                                }
+                              else if (sbCqis->size () > k)
+                                {
+                                  achievableRate += ratePerCqi[sbCqis->at (k)];
                                 }
                               else
                                 {
                                   // no info on this subband  -> worst MCS
-                                  mcs = 0;
+                                  achievableRate += worstMcsRate;
                                 }
-                              achievableRate += ((m_amc->GetDlTbSizeFromMcs (mcs, rbgSize) / 8) / 0.001); // = TB size / TTI
-            	  	    }
+                            }
                           schMetric = achievableRate / (*it).second.secondLastAveragedThroughput;
                         }   // end if cqi
-         
+
                       double metric = 0.0;
-                      metric= weight * schMetric;
-         
+                      metric= itCand->weight * schMetric;
+
                       if (metric > metricMax )
                         {
                           metricMax = metric;
                           itMax = it;
                         }
-                    } // end of tdUeSet
+                    } // end of candidates
 
                   if (itMax == tdUeSet.end ())
                     {
@@ -27,15 +27,213 @@
 #include <ns3/string.h>
 #include <ns3/double.h>
 #include "ns3/uinteger.h"
+#include <ns3/abort.h>
 #include <fstream>
+#include <sstream>
+#include <cstring>
 #include <ns3/simulator.h>
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceFadingLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED (TraceFadingLossModel);
-  
+
+/// Header of the binary fading trace files, followed by the samples
+struct BinaryFadingTraceHeader
+{
+  char magic[8];        ///< identifies the file format
+  uint32_t rbNum;       ///< number of RBs
+  uint32_t samplesNum;  ///< number of samples per RB
+};
+
+/// Magic number at the beginning of the binary fading trace files
+static const char g_binaryFadingTraceMagic[8] = { 'n', 's', '3', 'f', 'a', 'd', '0', '1' };
+
+/**
+ * \ingroup lte
+ *
+ * The samples of a fading trace file, shared by all the
+ * TraceFadingLossModel instances using that file. The samples of RB i are
+ * stored contiguously, starting at index i * samplesNum. The samples of a
+ * binary trace file are memory-mapped, those of an ASCII trace file are
+ * read into memory.
+ */
+class FadingTraceData : public SimpleRefCount<FadingTraceData>
+{
+public:
+  /**
+   * Return the samples of a trace file, loading them if no other
+   * instance of TraceFadingLossModel uses this file.
+   *
+   * \param fileName the name of the trace file
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB of the trace
+   * \return the samples of the trace file
+   */
+  static Ptr<const FadingTraceData> Get (std::string fileName, uint8_t rbNum, uint32_t samplesNum);
+
+  /**
+   * Read the samples of an ASCII trace file
+   *
+   * \param fileName the name of the trace file
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB of the trace
+   * \param samples the vector to store the samples into
+   */
+  static void ReadAscii (std::string fileName, uint8_t rbNum, uint32_t samplesNum, std::vector<double> &samples);
+
+  ~FadingTraceData ();
+
+  /**
+   * \param rb the RB
+   * \param index the index of the sample
+   * \return the fading sample (dB)
+   */
+  double GetSample (uint32_t rb, uint32_t index) const
+  {
+    NS_ASSERT (rb < m_rbNum && index < m_samplesNum);
+    return m_samples[rb * m_samplesNum + index];
+  }
+
+private:
+  /**
+   * Constructor
+   *
+   * \param key the key of the trace in the registry
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB of the trace
+   */
+  FadingTraceData (std::string key, uint32_t rbNum, uint32_t samplesNum);
+
+  /**
+   * Map a binary trace file, if the file is in the binary format
+   *
+   * \param fileName the name of the trace file
+   * \return false if the file is not a binary trace file
+   */
+  bool MapBinary (std::string fileName);
+
+  /// Traces currently loaded, indexed by file name and dimensions
+  typedef std::map<std::string, FadingTraceData *> Registry;
+  /// \return the traces currently loaded
+  static Registry & GetRegistry (void);
+
+  std::string m_key;                  ///< key of the trace in the registry
+  uint32_t m_rbNum;                   ///< number of RBs
+  uint32_t m_samplesNum;              ///< number of samples per RB
+  std::vector<double> m_asciiSamples; ///< samples read from an ASCII trace file
+  void *m_map;                        ///< mapping of a binary trace file
+  size_t m_mapSize;                   ///< size of the mapping
+  const double *m_samples;            ///< the samples
+};
+
+FadingTraceData::Registry &
+FadingTraceData::GetRegistry (void)
+{
+  static Registry registry;
+  return registry;
+}
+
+Ptr<const FadingTraceData>
+FadingTraceData::Get (std::string fileName, uint8_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (fileName << (uint16_t) rbNum << samplesNum);
+  std::ostringstream oss;
+  oss << fileName << "|" << (uint16_t) rbNum << "|" << samplesNum;
+  std::string key = oss.str ();
+  Registry::iterator it = GetRegistry ().find (key);
+  if (it != GetRegistry ().end ())
+    {
+      NS_LOG_LOGIC ("sharing the samples of " << fileName);
+      return it->second;
+    }
+
+  Ptr<FadingTraceData> trace = Ptr<FadingTraceData> (new FadingTraceData (key, rbNum, samplesNum), false);
+  if (!trace->MapBinary (fileName))
+    {
+      NS_LOG_LOGIC ("reading the ASCII trace " << fileName);
+      ReadAscii (fileName, rbNum, samplesNum, trace->m_asciiSamples);
+      trace->m_samples = trace->m_asciiSamples.data ();
+    }
+  GetRegistry ().insert (std::make_pair (key, PeekPointer (trace)));
+  return trace;
+}
+
+void
+FadingTraceData::ReadAscii (std::string fileName, uint8_t rbNum, uint32_t samplesNum, std::vector<double> &samples)
+{
+  NS_LOG_FUNCTION (fileName << (uint16_t) rbNum << samplesNum);
+  std::ifstream ifTraceFile;
+  ifTraceFile.open (fileName.c_str (), std::ifstream::in);
+  if (!ifTraceFile.good ())
+    {
+      NS_LOG_INFO (" File: " << fileName);
+      NS_ASSERT_MSG (ifTraceFile.good (), " Fading trace file not found");
+    }
+  samples.resize (static_cast<size_t> (rbNum) * samplesNum);
+  for (std::vector<double>::iterator it = samples.begin (); it != samples.end (); ++it)
+    {
+      ifTraceFile >> *it;
+    }
+  NS_ABORT_MSG_IF (ifTraceFile.fail (), "Fading trace file " << fileName << " has less than "
+                   << (uint16_t) rbNum << " x " << samplesNum << " samples");
+}
+
+FadingTraceData::FadingTraceData (std::string key, uint32_t rbNum, uint32_t samplesNum)
+  : m_key (key),
+    m_rbNum (rbNum),
+    m_samplesNum (samplesNum),
+    m_map (0),
+    m_mapSize (0),
+    m_samples (0)
+{
+}
+
+FadingTraceData::~FadingTraceData ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapSize);
+    }
+  GetRegistry ().erase (m_key);
+}
+
+bool
+FadingTraceData::MapBinary (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  int fd = open (fileName.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd == -1, "Fading trace file " << fileName << " not found");
+  BinaryFadingTraceHeader header;
+  if (read (fd, &header, sizeof (header)) != sizeof (header)
+      || std::memcmp (header.magic, g_binaryFadingTraceMagic, sizeof (header.magic)) != 0)
+    {
+      close (fd);
+      return false;
+    }
+  NS_ABORT_MSG_IF (header.rbNum != m_rbNum || header.samplesNum != m_samplesNum,
+                   "Fading trace file " << fileName << " has " << header.rbNum << " RBs and "
+                   << header.samplesNum << " samples, while the RbNum and SamplesNum attributes are "
+                   << m_rbNum << " and " << m_samplesNum);
+  struct stat st;
+  m_mapSize = sizeof (header) + static_cast<size_t> (m_rbNum) * m_samplesNum * sizeof (double);
+  NS_ABORT_MSG_IF (fstat (fd, &st) == -1 || static_cast<size_t> (st.st_size) != m_mapSize,
+                   "Fading trace file " << fileName << " is truncated");
+  void *map = mmap (0, m_mapSize, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  NS_ABORT_MSG_IF (map == MAP_FAILED, "Cannot map fading trace file " << fileName);
+  NS_LOG_LOGIC ("mapped the binary trace " << fileName);
+  m_map = map;
+  m_samples = reinterpret_cast<const double *> (static_cast<const char *> (m_map) + sizeof (header));
+  return true;
+}
 
 
 TraceFadingLossModel::TraceFadingLossModel ()
@@ -48,7 +246,7 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
+  m_fadingTrace = 0;
   m_windowOffsetsMap.clear ();
   m_startVariableMap.clear ();
 }
@@ -120,32 +318,31 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
-    {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
-    }
-
-//   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
-//   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
-    {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
-        {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
-        }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
-    }
+  m_fadingTrace = FadingTraceData::Get (m_traceFile, m_rbNum, m_samplesNum);
   m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
   m_lastWindowUpdate = Simulator::Now ();
 }
 
+void
+TraceFadingLossModel::ConvertTrace (std::string asciiFileName, std::string binaryFileName,
+                                    uint8_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (asciiFileName << binaryFileName << (uint16_t) rbNum << samplesNum);
+  std::vector<double> samples;
+  FadingTraceData::ReadAscii (asciiFileName, rbNum, samplesNum, samples);
+
+  BinaryFadingTraceHeader header;
+  std::memcpy (header.magic, g_binaryFadingTraceMagic, sizeof (header.magic));
+  header.rbNum = rbNum;
+  header.samplesNum = samplesNum;
+  std::ofstream ofTraceFile (binaryFileName.c_str (), std::ofstream::out | std::ofstream::binary);
+  NS_ABORT_MSG_IF (!ofTraceFile.good (), "Cannot open " << binaryFileName);
+  ofTraceFile.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  ofTraceFile.write (reinterpret_cast<const char *> (samples.data ()), samples.size () * sizeof (double));
+  ofTraceFile.close ();
+  NS_ABORT_MSG_IF (ofTraceFile.fail (), "Cannot write " << binaryFileName);
+}
+
 
 Ptr<SpectrumValue>
 TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
@@ -201,17 +398,17 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingTrace != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
   int subChannel = 0;
   while (vit != rxPsd->ValuesEnd ())
     {
-      NS_ASSERT (subChannel < 100);
+      NS_ASSERT (subChannel < m_rbNum);
       if (*vit != 0.)
         {
-          double fading = m_fadingTrace.at (subChannel).at (index);
+          double fading = m_fadingTrace->GetSample (subChannel, index);
           NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
           double power = *vit; // in Watt/Hz
           power = 10 * std::log10 (180000 * power); // in dB
@@ -34,12 +34,21 @@ namespace ns3 {
 
 
 class MobilityModel;
+class FadingTraceData;
 
 
 /**
  * \ingroup lte
  *
  * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace file is either the ASCII file produced by the
+ * fading_trace_generator.m script, or a binary file obtained from it with
+ * ConvertTrace (). Binary files are memory-mapped read-only, which makes
+ * loading them almost instantaneous and lets all the processes using the
+ * same file share a single copy of the samples. In both cases, the samples
+ * of a given file are loaded once and shared by all the instances of this
+ * model that use it.
  */
 class TraceFadingLossModel : public SpectrumPropagationLossModel
 {
@@ -70,6 +79,20 @@ public:
   */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * Convert an ASCII fading trace to the binary format that is
+   * memory-mapped by this model. The binary file stores the samples in
+   * the byte order of the host, and must only be used on hosts with the
+   * same byte order.
+   *
+   * \param asciiFileName the name of the ASCII trace file to read
+   * \param binaryFileName the name of the binary trace file to write
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples per RB of the trace
+   */
+  static void ConvertTrace (std::string asciiFileName, std::string binaryFileName,
+                            uint8_t rbNum, uint32_t samplesNum);
+
   
 private:
   /**
@@ -112,20 +135,9 @@ private:
   
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap; ///< start variable map
   
-  /**
-   * Vector with fading samples in time domain (for a fixed RB)
-   */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
-
-
-  
   std::string m_traceFile; ///< the trace file name
   
-  FadingTrace m_fadingTrace; ///< fading trace
+  Ptr<const FadingTraceData> m_fadingTrace; ///< fading trace, shared with the other instances using the same file
 
   
   Time m_traceLength; ///< the trace time
@@ -0,0 +1,273 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/lte-common.h"
+#include "ns3/eps-bearer.h"
+#include <cmath>
+#include <map>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestFastPhyMode");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test case checking that, in a seven-cell scenario, the
+ * `UseFastPhyMode` attribute of the LteHelper, which aggregates the
+ * interference of the other cells, gives the same DL and UL SINR and
+ * the same scheduled throughput as the full propagation of each signal.
+ */
+class LteFastPhyModeTestCase : public TestCase
+{
+public:
+  LteFastPhyModeTestCase ();
+  virtual ~LteFastPhyModeTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// The statistics collected in a run
+  struct Stats
+  {
+    std::map<uint32_t, double> dlSinrDb; ///< sum of the DL SINR samples, per cell and RNTI
+    std::map<uint32_t, uint32_t> dlSamples; ///< number of DL SINR samples, per cell and RNTI
+    std::map<uint32_t, double> ulSinrDb; ///< sum of the UL SINR samples, per cell and RNTI
+    std::map<uint32_t, uint32_t> ulSamples; ///< number of UL SINR samples, per cell and RNTI
+    uint64_t dlBytes; ///< TB bytes scheduled in DL
+    uint64_t ulBytes; ///< TB bytes scheduled in UL
+  };
+
+  /**
+   * Run the scenario
+   *
+   * \param fastPhyMode the `UseFastPhyMode` attribute
+   * \param stats the statistics to be collected
+   */
+  void RunScenario (bool fastPhyMode, Stats &stats);
+
+  /**
+   * DL SINR trace sink
+   *
+   * \param stats the statistics
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param rsrp the RSRP
+   * \param sinr the linear SINR
+   * \param componentCarrierId the component carrier ID
+   */
+  static void DlSinr (Stats *stats, uint16_t cellId, uint16_t rnti, double rsrp, double sinr, uint8_t componentCarrierId);
+
+  /**
+   * UL SINR trace sink
+   *
+   * \param stats the statistics
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param sinr the linear SINR
+   * \param componentCarrierId the component carrier ID
+   */
+  static void UlSinr (Stats *stats, uint16_t cellId, uint16_t rnti, double sinr, uint8_t componentCarrierId);
+
+  /**
+   * DL scheduling trace sink
+   *
+   * \param stats the statistics
+   * \param dlInfo the DL scheduling information
+   */
+  static void DlScheduling (Stats *stats, DlSchedulingCallbackInfo dlInfo);
+
+  /**
+   * UL scheduling trace sink
+   *
+   * \param stats the statistics
+   * \param frameNo the frame number
+   * \param subframeNo the subframe number
+   * \param rnti the RNTI
+   * \param mcs the MCS
+   * \param sizeTb the TB size
+   * \param componentCarrierId the component carrier ID
+   */
+  static void UlScheduling (Stats *stats, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                            uint8_t mcs, uint16_t sizeTb, uint8_t componentCarrierId);
+};
+
+LteFastPhyModeTestCase::LteFastPhyModeTestCase ()
+  : TestCase ("Fast PHY mode vs full signal propagation, seven cells")
+{
+}
+
+LteFastPhyModeTestCase::~LteFastPhyModeTestCase ()
+{
+}
+
+void
+LteFastPhyModeTestCase::DlSinr (Stats *stats, uint16_t cellId, uint16_t rnti, double rsrp, double sinr, uint8_t componentCarrierId)
+{
+  if (rnti == 0)
+    {
+      // not connected yet
+      return;
+    }
+  uint32_t key = (cellId << 16) | rnti;
+  stats->dlSinrDb[key] += 10 * std::log10 (sinr);
+  stats->dlSamples[key]++;
+}
+
+void
+LteFastPhyModeTestCase::UlSinr (Stats *stats, uint16_t cellId, uint16_t rnti, double sinr, uint8_t componentCarrierId)
+{
+  uint32_t key = (cellId << 16) | rnti;
+  stats->ulSinrDb[key] += 10 * std::log10 (sinr);
+  stats->ulSamples[key]++;
+}
+
+void
+LteFastPhyModeTestCase::DlScheduling (Stats *stats, DlSchedulingCallbackInfo dlInfo)
+{
+  stats->dlBytes += dlInfo.sizeTb1 + dlInfo.sizeTb2;
+}
+
+void
+LteFastPhyModeTestCase::UlScheduling (Stats *stats, uint32_t frameNo, uint32_t subframeNo, uint16_t rnti,
+                                      uint8_t mcs, uint16_t sizeTb, uint8_t componentCarrierId)
+{
+  stats->ulBytes += sizeTb;
+}
+
+void
+LteFastPhyModeTestCase::RunScenario (bool fastPhyMode, Stats &stats)
+{
+  stats.dlBytes = 0;
+  stats.ulBytes = 0;
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("UseFastPhyMode", BooleanValue (fastPhyMode));
+
+  // a central cell and a ring of six cells, with two UEs in each cell
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (7);
+  ueNodes.Create (14);
+  Ptr<ListPositionAllocator> enbPositionAlloc = CreateObject<ListPositionAllocator> ();
+  Ptr<ListPositionAllocator> uePositionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < 7; i++)
+    {
+      double x = 0.0;
+      double y = 0.0;
+      if (i > 0)
+        {
+          x = 500.0 * std::cos ((i - 1) * M_PI / 3);
+          y = 500.0 * std::sin ((i - 1) * M_PI / 3);
+        }
+      enbPositionAlloc->Add (Vector (x, y, 30.0));
+      uePositionAlloc->Add (Vector (x + 60.0, y + 20.0, 1.5));
+      uePositionAlloc->Add (Vector (x - 120.0, y + 150.0, 1.5));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (enbPositionAlloc);
+  mobility.Install (enbNodes);
+  mobility.SetPositionAllocator (uePositionAlloc);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i / 2));
+    }
+  // the two runs share the process, so that the streams are to be
+  // assigned for the random access to happen in the same way
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  lteHelper->AssignStreams (ueDevs, stream);
+  EpsBearer bearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+  lteHelper->ActivateDataRadioBearer (ueDevs, bearer);
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMapUe/*/LteUePhy/ReportCurrentCellRsrpSinr",
+                                 MakeBoundCallback (&LteFastPhyModeTestCase::DlSinr, &stats));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbPhy/ReportUeSinr",
+                                 MakeBoundCallback (&LteFastPhyModeTestCase::UlSinr, &stats));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/DlScheduling",
+                                 MakeBoundCallback (&LteFastPhyModeTestCase::DlScheduling, &stats));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/LteEnbMac/UlScheduling",
+                                 MakeBoundCallback (&LteFastPhyModeTestCase::UlScheduling, &stats));
+
+  Simulator::Stop (Seconds (0.3));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteFastPhyModeTestCase::DoRun (void)
+{
+  Stats fullStats;
+  Stats fastStats;
+  RunScenario (false, fullStats);
+  RunScenario (true, fastStats);
+
+  NS_TEST_ASSERT_MSG_EQ (fullStats.dlSamples.size (), 14, "Missing DL SINR samples");
+  NS_TEST_ASSERT_MSG_EQ (fullStats.ulSamples.size (), 14, "Missing UL SINR samples");
+  NS_TEST_ASSERT_MSG_EQ ((fastStats.dlSamples == fullStats.dlSamples), true, "Different DL SINR samples");
+  NS_TEST_ASSERT_MSG_EQ ((fastStats.ulSamples == fullStats.ulSamples), true, "Different UL SINR samples");
+  for (std::map<uint32_t, double>::const_iterator it = fullStats.dlSinrDb.begin (); it != fullStats.dlSinrDb.end (); ++it)
+    {
+      uint32_t samples = fullStats.dlSamples[it->first];
+      NS_TEST_ASSERT_MSG_EQ_TOL (fastStats.dlSinrDb[it->first] / samples, it->second / samples, 0.01,
+                                 "Different DL SINR for cell " << (it->first >> 16) << " RNTI " << (it->first & 0xffff));
+    }
+  for (std::map<uint32_t, double>::const_iterator it = fullStats.ulSinrDb.begin (); it != fullStats.ulSinrDb.end (); ++it)
+    {
+      uint32_t samples = fullStats.ulSamples[it->first];
+      NS_TEST_ASSERT_MSG_EQ_TOL (fastStats.ulSinrDb[it->first] / samples, it->second / samples, 0.01,
+                                 "Different UL SINR for cell " << (it->first >> 16) << " RNTI " << (it->first & 0xffff));
+    }
+  NS_TEST_ASSERT_MSG_GT (fullStats.dlBytes, 0, "No DL traffic");
+  NS_TEST_ASSERT_MSG_GT (fullStats.ulBytes, 0, "No UL traffic");
+  NS_TEST_ASSERT_MSG_EQ_TOL (fastStats.dlBytes, fullStats.dlBytes, fullStats.dlBytes * 0.01, "Different DL throughput");
+  NS_TEST_ASSERT_MSG_EQ_TOL (fastStats.ulBytes, fullStats.ulBytes, fullStats.ulBytes * 0.01, "Different UL throughput");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite for the fast PHY mode of the LteHelper.
+ */
+class LteFastPhyModeTestSuite : public TestSuite
+{
+public:
+  LteFastPhyModeTestSuite ();
+};
+
+LteFastPhyModeTestSuite::LteFastPhyModeTestSuite ()
+  : TestSuite ("lte-fast-phy-mode", SYSTEM)
+{
+  AddTestCase (new LteFastPhyModeTestCase (), TestCase::QUICK);
+}
+
+static LteFastPhyModeTestSuite lteFastPhyModeTestSuite;
@@ -84,6 +84,12 @@ LteInterferenceTestSuite::LteInterferenceTestSuite ()
   AddTestCase (new LteInterferenceTestCase ("d1=4500, d2=12600",  4500.000000, 12600.000000,  6.654462, 1.139831,  1.139781, 0.270399, 8, 2), TestCase::QUICK);
   AddTestCase (new LteInterferenceTestCase ("d1=5400, d2=12600",  5400.000000, 12600.000000,  4.621154, 0.791549,  0.876368, 0.193019, 6, 0), TestCase::QUICK);
 
+  // the aggregated interference of the fast PHY mode gives the same SINR
+  AddTestCase (new LteInterferenceTestCase ("d1=3000, d2=6000, fast PHY",  3000.000000, 6000.000000,  3.844681, 1.714583,  0.761558, 0.389662, 6, 4, true), TestCase::QUICK);
+  AddTestCase (new LteInterferenceTestCase ("d1=50, d2=100, fast PHY",  50.000000, 100.000000,  3.999955, 3.998520,  0.785259, 0.785042, 6, 6, true), TestCase::QUICK);
+  AddTestCase (new LteInterferenceTestCase ("d1=50, d2=1000, fast PHY",  50.000000, 1000.000000,  399.551632, 385.718468,  6.194952, 6.144825, 28, 28, true), TestCase::QUICK);
+  AddTestCase (new LteInterferenceTestCase ("d1=4500, d2=12600, fast PHY",  4500.000000, 12600.000000,  6.654462, 1.139831,  1.139781, 0.270399, 8, 2, true), TestCase::QUICK);
+
 
 }
 
@@ -94,14 +100,15 @@ static LteInterferenceTestSuite lteLinkAdaptationWithInterferenceTestSuite;
  * TestCase
  */
 
-LteInterferenceTestCase::LteInterferenceTestCase (std::string name, double d1, double d2, double dlSinr, double ulSinr, double dlSe, double ulSe, uint16_t dlMcs, uint16_t ulMcs)
+LteInterferenceTestCase::LteInterferenceTestCase (std::string name, double d1, double d2, double dlSinr, double ulSinr, double dlSe, double ulSe, uint16_t dlMcs, uint16_t ulMcs, bool fastPhyMode)
   : TestCase (name),
     m_d1 (d1),
     m_d2 (d2),
     m_expectedDlSinrDb (10 * std::log10 (dlSinr)),
     m_expectedUlSinrDb (10 * std::log10 (ulSinr)),
     m_dlMcs (dlMcs),
-    m_ulMcs (ulMcs)
+    m_ulMcs (ulMcs),
+    m_fastPhyMode (fastPhyMode)
 {
 }
 
@@ -122,6 +129,7 @@ LteInterferenceTestCase::DoRun (void)
   lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
   lteHelper->SetAttribute ("UseIdealRrc", BooleanValue (false));
   lteHelper->SetAttribute ("UsePdschForCqiGeneration", BooleanValue (true));
+  lteHelper->SetAttribute ("UseFastPhyMode", BooleanValue (m_fastPhyMode));
 
   //Disable Uplink Power Control
   Config::SetDefault ("ns3::LteUePhy::EnableUplinkPowerControl", BooleanValue (false));
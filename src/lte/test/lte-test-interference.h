@@ -63,8 +63,9 @@ public:
    * \param ulSe the UL se
    * \param dlMcs the DL MCS
    * \param ulMcs the UL MCS
+   * \param fastPhyMode the UseFastPhyMode attribute of the LteHelper
    */
-  LteInterferenceTestCase (std::string name, double d1, double d2, double dlSinr, double ulSinr, double dlSe, double ulSe, uint16_t dlMcs, uint16_t ulMcs);
+  LteInterferenceTestCase (std::string name, double d1, double d2, double dlSinr, double ulSinr, double dlSe, double ulSe, uint16_t dlMcs, uint16_t ulMcs, bool fastPhyMode = false);
   virtual ~LteInterferenceTestCase ();
 
   /**
@@ -94,6 +95,7 @@ private:
   double m_expectedUlSinrDb; ///< expected UL SINR in dB
   uint16_t m_dlMcs; ///< the DL MCS
   uint16_t m_ulMcs; ///< the UL MCS
+  bool m_fastPhyMode; ///< whether the fast PHY mode is used
 };
 
 #endif /* LTE_TEST_INTERFERENCE_H */
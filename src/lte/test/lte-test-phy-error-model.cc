@@ -50,6 +50,8 @@
 #include <ns3/unused.h>
 #include <ns3/ff-mac-scheduler.h>
 #include <ns3/buildings-helper.h>
+#include <ns3/lte-mi-error-model.h>
+#include <ns3/spectrum-value.h>
 
 #include "lte-test-phy-error-model.h"
 
@@ -61,6 +63,8 @@ LenaTestPhyErrorModelSuite::LenaTestPhyErrorModelSuite ()
   : TestSuite ("lte-phy-error-model", SYSTEM)
 {
   NS_LOG_INFO ("creating LenaTestPhyErrorModelTestCase");
+
+  AddTestCase (new LteMiErrorModelBatchTestCase, TestCase::QUICK);
   
   
   for (uint32_t rngRun = 1; rngRun <= 3; ++rngRun)
@@ -438,3 +442,68 @@ LenaDlCtrlPhyErrorModelTestCase::DoRun (void)
   
   Simulator::Destroy ();
 }
+
+
+LteMiErrorModelBatchTestCase::LteMiErrorModelBatchTestCase ()
+  : TestCase ("Batched evaluation of the TBs of a subframe by LteMiErrorModel")
+{
+}
+
+LteMiErrorModelBatchTestCase::~LteMiErrorModelBatchTestCase ()
+{
+}
+
+void
+LteMiErrorModelBatchTestCase::DoRun (void)
+{
+  const uint16_t nRb = 50;
+  std::vector<double> freqs;
+  for (uint16_t i = 0; i < nRb; i++)
+    {
+      freqs.push_back (2.1e9 + i * 180e3);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+  SpectrumValue sinr (model);
+  for (uint16_t i = 0; i < nRb; i++)
+    {
+      // SINR from -10 dB to 30 dB, covering all the modulation orders
+      sinr[i] = std::pow (10.0, (-10.0 + 40.0 * i / (nRb - 1)) / 10.0);
+    }
+
+  // one TB for each MCS, with overlapping RB allocations of different sizes
+  std::vector<std::vector<int> > rbMaps (29);
+  std::vector<HarqProcessInfoList_t> histories (29);
+  std::vector<TbDecodificationParams_t> tbs;
+  for (uint8_t mcs = 0; mcs < 29; mcs++)
+    {
+      for (int rb = (mcs * 7) % nRb; rb < nRb; rb += 1 + mcs % 4)
+        {
+          rbMaps[mcs].push_back (rb);
+        }
+      if (mcs % 3 == 0)
+        {
+          // previous transmission of the same TB with HARQ IR
+          HarqProcessInfoElement_t el;
+          el.m_mi = 0.3;
+          el.m_infoBits = 1000;
+          el.m_codeBits = 2000;
+          el.m_rv = 0;
+          histories[mcs].push_back (el);
+        }
+      TbDecodificationParams_t params;
+      params.rbMap = &rbMaps[mcs];
+      params.size = 100 + 40 * mcs;
+      params.mcs = mcs;
+      params.miHistory = &histories[mcs];
+      tbs.push_back (params);
+    }
+
+  std::vector<TbStats_t> batch = LteMiErrorModel::GetTbDecodificationStats (sinr, tbs);
+  NS_TEST_ASSERT_MSG_EQ (batch.size (), tbs.size (), "Wrong number of results");
+  for (uint8_t mcs = 0; mcs < 29; mcs++)
+    {
+      TbStats_t single = LteMiErrorModel::GetTbDecodificationStats (sinr, rbMaps[mcs], tbs[mcs].size, mcs, histories[mcs]);
+      NS_TEST_ASSERT_MSG_EQ (batch[mcs].tbler, single.tbler, "Different TBLER for MCS " << (uint16_t) mcs);
+      NS_TEST_ASSERT_MSG_EQ (batch[mcs].mi, single.mi, "Different MI for MCS " << (uint16_t) mcs);
+    }
+}
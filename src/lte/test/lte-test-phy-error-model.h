@@ -123,6 +123,25 @@ private:
 
 
 
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks that evaluating all the transport blocks of a subframe with
+ * a single call to LteMiErrorModel::GetTbDecodificationStats gives the same
+ * results as evaluating each transport block separately.
+ */
+class LteMiErrorModelBatchTestCase : public TestCase
+{
+public:
+  LteMiErrorModelBatchTestCase ();
+  virtual ~LteMiErrorModelBatchTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+
 /**
  * \ingroup lte-test
  * \ingroup tests
@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/spectrum-channel.h"
+#include "ns3/lte-helper.h"
+#include "ns3/radio-environment-map-helper.h"
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRadioEnvironmentMap");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test case checking that the map generated by the
+ * RadioEnvironmentMapHelper with the `DirectEvaluation` attribute set is
+ * the same as the map generated with batches of listeners.
+ */
+class LteRadioEnvironmentMapTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param rbId the `RbId` attribute of the RadioEnvironmentMapHelper
+   */
+  LteRadioEnvironmentMapTestCase (int32_t rbId);
+  virtual ~LteRadioEnvironmentMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Generate a map of a three-cell scenario
+   *
+   * \param directEvaluation the `DirectEvaluation` attribute
+   * \param fileName the name of the output file
+   */
+  void GenerateMap (bool directEvaluation, std::string fileName);
+
+  int32_t m_rbId; ///< the RB for which the map is generated
+};
+
+LteRadioEnvironmentMapTestCase::LteRadioEnvironmentMapTestCase (int32_t rbId)
+  : TestCase ("REM direct evaluation, RbId " + std::to_string (rbId)),
+    m_rbId (rbId)
+{
+}
+
+LteRadioEnvironmentMapTestCase::~LteRadioEnvironmentMapTestCase ()
+{
+}
+
+void
+LteRadioEnvironmentMapTestCase::GenerateMap (bool directEvaluation, std::string fileName)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (500.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (250.0, 400.0, 30.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  lteHelper->InstallEnbDevice (enbNodes);
+
+  std::ostringstream channelPath;
+  channelPath << "/ChannelList/" << lteHelper->GetDownlinkSpectrumChannel ()->GetId ();
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue (channelPath.str ()));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (700.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (40));
+  remHelper->SetAttribute ("YMin", DoubleValue (-300.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (600.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (30));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  remHelper->SetAttribute ("RbId", IntegerValue (m_rbId));
+  // several batches of listeners
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (500));
+  remHelper->SetAttribute ("DirectEvaluation", BooleanValue (directEvaluation));
+  remHelper->Install ();
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteRadioEnvironmentMapTestCase::DoRun (void)
+{
+  std::string batchFileName = CreateTempDirFilename ("rem-batches.out");
+  std::string directFileName = CreateTempDirFilename ("rem-direct.out");
+  GenerateMap (false, batchFileName);
+  GenerateMap (true, directFileName);
+
+  std::ifstream batchFile (batchFileName.c_str ());
+  std::ifstream directFile (directFileName.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (batchFile.is_open (), true, "Cannot open " << batchFileName);
+  NS_TEST_ASSERT_MSG_EQ (directFile.is_open (), true, "Cannot open " << directFileName);
+  std::string batchLine;
+  std::string directLine;
+  uint32_t nPoints = 0;
+  while (std::getline (batchFile, batchLine))
+    {
+      NS_TEST_ASSERT_MSG_EQ (bool (std::getline (directFile, directLine)), true, "Missing points in the direct map");
+      NS_TEST_ASSERT_MSG_EQ (directLine, batchLine, "Different point " << nPoints);
+      nPoints++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (bool (std::getline (directFile, directLine)), false, "Extra points in the direct map");
+  NS_TEST_ASSERT_MSG_EQ (nPoints, 40 * 30, "Wrong number of points");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite for the RadioEnvironmentMapHelper.
+ */
+class LteRadioEnvironmentMapTestSuite : public TestSuite
+{
+public:
+  LteRadioEnvironmentMapTestSuite ();
+};
+
+LteRadioEnvironmentMapTestSuite::LteRadioEnvironmentMapTestSuite ()
+  : TestSuite ("lte-radio-environment-map", SYSTEM)
+{
+  AddTestCase (new LteRadioEnvironmentMapTestCase (-1), TestCase::QUICK);
+  AddTestCase (new LteRadioEnvironmentMapTestCase (7), TestCase::QUICK);
+}
+
+static LteRadioEnvironmentMapTestSuite lteRadioEnvironmentMapTestSuite;
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/lte-spectrum-value-helper.h"
+#include "ns3/trace-fading-loss-model.h"
+#include <fstream>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestTraceFadingLossModel");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test case checking that the TraceFadingLossModel gives the same
+ * results with an ASCII fading trace and with its binary conversion.
+ */
+class LteTraceFadingBinaryTestCase : public TestCase
+{
+public:
+  LteTraceFadingBinaryTestCase ();
+  virtual ~LteTraceFadingBinaryTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a fading model using the given trace file
+   *
+   * \param fileName the name of the trace file
+   * \return the fading model
+   */
+  Ptr<TraceFadingLossModel> CreateModel (std::string fileName);
+
+  /// Compare the fading of the two models at the current time
+  void CheckFading (void);
+
+  Ptr<TraceFadingLossModel> m_asciiModel;   ///< model using the ASCII trace
+  Ptr<TraceFadingLossModel> m_binaryModel;  ///< model using the binary trace
+  Ptr<MobilityModel> m_enbMobility;         ///< the eNB mobility model
+  Ptr<MobilityModel> m_ueMobility;          ///< the UE mobility model
+  Ptr<SpectrumValue> m_txPsd;               ///< the transmitted PSD
+  uint32_t m_nChecks;                       ///< number of comparisons made
+};
+
+/// Number of RBs of the test trace
+static const uint8_t g_traceRbNum = 6;
+/// Number of samples per RB of the test trace
+static const uint32_t g_traceSamplesNum = 1000;
+
+LteTraceFadingBinaryTestCase::LteTraceFadingBinaryTestCase ()
+  : TestCase ("Binary fading trace"),
+    m_nChecks (0)
+{
+}
+
+LteTraceFadingBinaryTestCase::~LteTraceFadingBinaryTestCase ()
+{
+}
+
+Ptr<TraceFadingLossModel>
+LteTraceFadingBinaryTestCase::CreateModel (std::string fileName)
+{
+  Ptr<TraceFadingLossModel> model = CreateObject<TraceFadingLossModel> ();
+  model->SetAttribute ("TraceFilename", StringValue (fileName));
+  model->SetAttribute ("TraceLength", TimeValue (Seconds (1.0)));
+  model->SetAttribute ("SamplesNum", UintegerValue (g_traceSamplesNum));
+  model->SetAttribute ("WindowSize", TimeValue (Seconds (0.3)));
+  model->SetAttribute ("RbNum", UintegerValue (g_traceRbNum));
+  model->AssignStreams (1);
+  model->Initialize ();
+  return model;
+}
+
+void
+LteTraceFadingBinaryTestCase::CheckFading (void)
+{
+  Ptr<SpectrumValue> asciiRxPsd = m_asciiModel->CalcRxPowerSpectralDensity (m_txPsd, m_enbMobility, m_ueMobility);
+  Ptr<SpectrumValue> binaryRxPsd = m_binaryModel->CalcRxPowerSpectralDensity (m_txPsd, m_enbMobility, m_ueMobility);
+  for (uint8_t rb = 0; rb < g_traceRbNum; rb++)
+    {
+      NS_TEST_ASSERT_MSG_NE ((*asciiRxPsd)[rb], (*m_txPsd)[rb], "No fading applied to RB " << (uint16_t) rb);
+      NS_TEST_ASSERT_MSG_EQ ((*binaryRxPsd)[rb], (*asciiRxPsd)[rb], "Different fading for RB " << (uint16_t) rb
+                             << " at " << Simulator::Now ().GetSeconds () << " s");
+    }
+  m_nChecks++;
+}
+
+void
+LteTraceFadingBinaryTestCase::DoRun (void)
+{
+  std::string asciiFileName = CreateTempDirFilename ("fading-trace.fad");
+  std::string binaryFileName = CreateTempDirFilename ("fading-trace.fadb");
+  std::ofstream asciiFile (asciiFileName.c_str ());
+  asciiFile.precision (10);
+  for (uint32_t rb = 0; rb < g_traceRbNum; rb++)
+    {
+      for (uint32_t i = 0; i < g_traceSamplesNum; i++)
+        {
+          asciiFile << -3.0 + 10.0 * std::sin (0.05 * i + rb) << " ";
+        }
+      asciiFile << std::endl;
+    }
+  asciiFile.close ();
+  TraceFadingLossModel::ConvertTrace (asciiFileName, binaryFileName, g_traceRbNum, g_traceSamplesNum);
+
+  m_asciiModel = CreateModel (asciiFileName);
+  m_binaryModel = CreateModel (binaryFileName);
+  m_enbMobility = CreateObject<ConstantPositionMobilityModel> ();
+  m_enbMobility->SetPosition (Vector (0.0, 0.0, 30.0));
+  m_ueMobility = CreateObject<ConstantPositionMobilityModel> ();
+  m_ueMobility->SetPosition (Vector (100.0, 0.0, 1.5));
+  m_txPsd = Create<SpectrumValue> (LteSpectrumValueHelper::GetSpectrumModel (100, g_traceRbNum));
+  (*m_txPsd) = 1.0e-9;
+
+  for (double t = 0.0; t < 1.0; t += 0.007)
+    {
+      Simulator::Schedule (Seconds (t), &LteTraceFadingBinaryTestCase::CheckFading, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (m_nChecks, 143, "Wrong number of checks");
+
+  m_asciiModel = 0;
+  m_binaryModel = 0;
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite for the TraceFadingLossModel.
+ */
+class LteTraceFadingLossModelTestSuite : public TestSuite
+{
+public:
+  LteTraceFadingLossModelTestSuite ();
+};
+
+LteTraceFadingLossModelTestSuite::LteTraceFadingLossModelTestSuite ()
+  : TestSuite ("lte-trace-fading-loss-model", UNIT)
+{
+  AddTestCase (new LteTraceFadingBinaryTestCase, TestCase::QUICK);
+}
+
+static LteTraceFadingLossModelTestSuite lteTraceFadingLossModelTestSuite;
@@ -169,6 +169,82 @@ EpcTftClassifierTestCase::DoRun (void)
 
 
 
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test case to check that the classification of a flow changes when
+ * a TFT is added to or deleted from the classifier after the flow has
+ * already been classified, i.e., that the cached classification is flushed.
+ */
+class EpcTftClassifierCacheTestCase : public TestCase
+{
+public:
+  EpcTftClassifierCacheTestCase ();
+  virtual ~EpcTftClassifierCacheTestCase ();
+
+private:
+  /**
+   * Classify a UDP packet of the flow used by this test
+   * \param c the EPC TFT classifier
+   * \returns the ID of the TFT matching the packet
+   */
+  uint32_t Classify (Ptr<EpcTftClassifier> c);
+  virtual void DoRun (void);
+};
+
+EpcTftClassifierCacheTestCase::EpcTftClassifierCacheTestCase ()
+  : TestCase ("classification after adding and deleting a TFT")
+{
+}
+
+EpcTftClassifierCacheTestCase::~EpcTftClassifierCacheTestCase ()
+{
+}
+
+uint32_t
+EpcTftClassifierCacheTestCase::Classify (Ptr<EpcTftClassifier> c)
+{
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("9.1.1.1"));
+  ipHeader.SetDestination (Ipv4Address ("8.1.1.1"));
+  ipHeader.SetPayloadSize (8); // Full UDP header
+  ipHeader.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (4);
+  udpHeader.SetDestinationPort (1024);
+
+  Ptr<Packet> udpPacket = Create<Packet> ();
+  udpPacket->AddHeader (udpHeader);
+  udpPacket->AddHeader (ipHeader);
+  return c->Classify (udpPacket, EpcTft::UPLINK);
+}
+
+void
+EpcTftClassifierCacheTestCase::DoRun (void)
+{
+  Ptr<EpcTftClassifier> c = Create<EpcTftClassifier> ();
+  c->Add (EpcTft::Default (), 1);
+  NS_TEST_ASSERT_MSG_EQ (Classify (c), 1, "the flow should be classified by the default TFT");
+
+  Ptr<EpcTft> tft = Create<EpcTft> ();
+  EpcTft::PacketFilter pf;
+  pf.remotePortStart = 1024;
+  pf.remotePortEnd   = 1035;
+  tft->Add (pf);
+  c->Add (tft, 2);
+  NS_TEST_ASSERT_MSG_EQ (Classify (c), 2, "the flow should be classified by the TFT added after its first packet");
+
+  c->Delete (2);
+  NS_TEST_ASSERT_MSG_EQ (Classify (c), 1, "the flow should be classified by the default TFT after the deletion");
+
+  Ptr<EpcTft> otherTft = Create<EpcTft> ();
+  otherTft->Add (pf);
+  c->Add (otherTft, 3);
+  NS_TEST_ASSERT_MSG_EQ (Classify (c), 3, "the flow should be classified by the TFT added after the deletion");
+}
+
 
 /**
  * \ingroup lte-test
@@ -368,4 +444,10 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     5897,     0,    2), TestCase::QUICK);
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  5897,       10,     0,    2), TestCase::QUICK);
 
+
+  ///////////////////////////////////////////////////////
+  // check a flow classified before and after TFT changes
+  ///////////////////////////////////////////////////////
+
+  AddTestCase (new EpcTftClassifierCacheTestCase (), TestCase::QUICK);
 }
@@ -426,6 +426,21 @@ Buffer::AddAtEnd (const Buffer &o)
       return;
     }
 
+  if (m_data != o.m_data)
+    {
+      /**
+       * Append the bytes in place: this reuses the free space at the
+       * end of our data when we are its last writer, so that a series
+       * of appends after a call to ReserveAtEnd copies each byte once.
+       */
+      uint32_t size = o.GetSize ();
+      AddAtEnd (size);
+      // the added bytes are contiguous, after the zero area if any
+      o.CopyData (m_data->m_data + GetInternalEnd () - size, size);
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
+
   Buffer dst = CreateFullCopy ();
   Buffer src = o.CreateFullCopy ();
 
@@ -437,6 +452,38 @@ Buffer::AddAtEnd (const Buffer &o)
   NS_ASSERT (CheckInternalState ());
 }
 
+void
+Buffer::ReserveAtEnd (uint32_t end)
+{
+  NS_LOG_FUNCTION (this << end);
+  NS_ASSERT (CheckInternalState ());
+  bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+  if (GetInternalEnd () + end <= m_data->m_size && !isDirty)
+    {
+      return;
+    }
+  uint32_t newSize = GetInternalSize () + end;
+  struct Buffer::Data *newData = Buffer::Create (newSize);
+  memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
+  m_data->m_count--;
+  if (m_data->m_count == 0) 
+    {
+      Buffer::Recycle (m_data);
+    }
+  m_data = newData;
+
+  int32_t delta = -m_start;
+  m_zeroAreaStart += delta;
+  m_zeroAreaEnd += delta;
+  m_end += delta;
+  m_start += delta;
+
+  m_data->m_dirtyStart = m_start;
+  m_data->m_dirtyEnd = m_end;
+  LOG_INTERNAL_STATE ("reserve end=" << end << ", ");
+  NS_ASSERT (CheckInternalState ());
+}
+
 void 
 Buffer::RemoveAtStart (uint32_t start)
 {
@@ -846,25 +893,36 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  // the written bytes are all either before or after our zero area
+  uint8_t *to;
+  if (m_current <= m_zeroStart)
+    {
+      to = &m_data[m_current];
+    }
+  else
+    {
+      to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      memset (to, 0, toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
   memcpy (to, from, toCopy);
   m_current += toCopy;
 }
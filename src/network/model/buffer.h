@@ -529,6 +529,16 @@ private:
    * pointing to this Buffer.
    */
   void AddAtEnd (const Buffer &o);
+  /**
+   * \param end size to reserve
+   *
+   * Make room for end bytes at the end of the Buffer without
+   * changing its content, so that the next calls to AddAtEnd
+   * which add up to end bytes do not reallocate it.
+   * Any call to this method invalidates any Iterator
+   * pointing to this Buffer.
+   */
+  void ReserveAtEnd (uint32_t end);
   /**
    * \param start size to remove
    *
@@ -344,6 +344,12 @@ Packet::AddAtEnd (Ptr<const Packet> packet)
   m_metadata.AddAtEnd (packet->m_metadata);
 }
 void
+Packet::ReserveAtEnd (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_buffer.ReserveAtEnd (size);
+}
+void
 Packet::AddPaddingAtEnd (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
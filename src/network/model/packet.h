@@ -395,6 +395,16 @@ public:
    * \param packet packet to concatenate
    */
   void AddAtEnd (Ptr<const Packet> packet);
+  /**
+   * \brief Make room for size bytes at the end of the packet.
+   *
+   * The content of the packet is not changed. This is useful before
+   * concatenating many packets with AddAtEnd, since the bytes of the
+   * current packet are then copied only once.
+   *
+   * \param size number of bytes to reserve.
+   */
+  void ReserveAtEnd (uint32_t size);
   /**
    * \brief Add a zero-filled padding to the packet.
    *
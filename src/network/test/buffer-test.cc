@@ -376,6 +376,27 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // Concatenate buffers with zero areas after reserving room for them,
+  // and check that a buffer sharing the original data is not modified.
+  buffer = Buffer (2);
+  buffer.AddAtStart (1);
+  buffer.Begin ().WriteU8 (0x11);
+  Buffer shared = buffer;
+  Buffer tail = Buffer (1);
+  tail.AddAtEnd (1);
+  i = tail.End ();
+  i.Prev (1);
+  i.WriteU8 (0x22);
+  buffer.ReserveAtEnd (2 * tail.GetSize ());
+  ENSURE_WRITTEN_BYTES (buffer, 3, 0x11, 0x00, 0x00);
+  buffer.AddAtEnd (tail);
+  buffer.AddAtEnd (tail);
+  ENSURE_WRITTEN_BYTES (buffer, 7, 0x11, 0x00, 0x00, 0x00, 0x22, 0x00, 0x22);
+  ENSURE_WRITTEN_BYTES (shared, 3, 0x11, 0x00, 0x00);
+  ENSURE_WRITTEN_BYTES (tail, 2, 0x00, 0x22);
+  shared.AddAtEnd (shared);
+  ENSURE_WRITTEN_BYTES (shared, 6, 0x11, 0x00, 0x00, 0x11, 0x00, 0x00);
 }
 
 /**
@@ -19,6 +19,7 @@
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/string.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -83,6 +84,115 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((packet == 0), true, "There are really no packets in there");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * DropTailQueue ring buffer and batch operations unit tests.
+ */
+class DropTailQueueRingTestCase : public TestCase
+{
+public:
+  DropTailQueueRingTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Count a packet dropped
+   * \param p the packet
+   */
+  void Drop (Ptr<const Packet> p);
+  /**
+   * Count a packet dequeued
+   * \param p the packet
+   */
+  void Dequeued (Ptr<const Packet> p);
+
+  uint32_t m_nDropped;  //!< number of packets dropped
+  uint32_t m_nDequeued; //!< number of packets dequeued
+};
+
+DropTailQueueRingTestCase::DropTailQueueRingTestCase ()
+  : TestCase ("Check the ring buffer and the batch operations of the drop tail queue"),
+    m_nDropped (0),
+    m_nDequeued (0)
+{
+}
+
+void
+DropTailQueueRingTestCase::Drop (Ptr<const Packet> p)
+{
+  m_nDropped++;
+}
+
+void
+DropTailQueueRingTestCase::Dequeued (Ptr<const Packet> p)
+{
+  m_nDequeued++;
+}
+
+void
+DropTailQueueRingTestCase::DoRun (void)
+{
+  Ptr<DropTailQueue<Packet> > queue = CreateObject<DropTailQueue<Packet> > ();
+  queue->SetMaxSize (QueueSize ("200p"));
+  queue->TraceConnectWithoutContext ("Drop", MakeCallback (&DropTailQueueRingTestCase::Drop, this));
+  queue->TraceConnectWithoutContext ("Dequeue", MakeCallback (&DropTailQueueRingTestCase::Dequeued, this));
+
+  // Interleave enqueues and dequeues, so that the items wrap around the
+  // ring while it grows
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      packets.push_back (Create<Packet> (i + 1));
+    }
+  uint32_t next = 0;
+  for (uint32_t i = 0; i < 300; i++)
+    {
+      if (i % 3 == 2)
+        {
+          Ptr<Packet> p = queue->Dequeue ();
+          NS_TEST_EXPECT_MSG_EQ (p, packets[next], "Packet dequeued out of order");
+          next++;
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (packets[i]), true, "Packet " << i << " not enqueued");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 200, "Wrong number of packets");
+  NS_TEST_EXPECT_MSG_EQ (queue->Peek (), packets[next], "Wrong packet at the head");
+
+  // Dequeue a batch, then check the remaining items in order
+  std::vector<Ptr<Packet> > batch;
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueMany (batch, 150), 150, "Wrong number of packets dequeued");
+  for (uint32_t i = 0; i < batch.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (batch[i], packets[next++], "Packet dequeued out of order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), (251 + 300) * 25, "Wrong number of bytes");
+  batch.clear ();
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueMany (batch, 100), 50, "Wrong number of packets dequeued");
+  NS_TEST_EXPECT_MSG_EQ (batch.back (), packets.back (), "Wrong last packet dequeued");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ (queue->Dequeue (), 0, "Packet dequeued from an empty queue");
+  NS_TEST_EXPECT_MSG_EQ (m_nDequeued, 300, "Wrong number of Dequeue traces");
+
+  // Enqueue a batch which does not fit: the packets beyond the maximum size
+  // are dropped, as if they were enqueued one by one
+  NS_TEST_EXPECT_MSG_EQ (queue->EnqueueMany (packets), 200, "Wrong number of packets enqueued");
+  NS_TEST_EXPECT_MSG_EQ (m_nDropped, 100, "Wrong number of Drop traces");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPacketsBeforeEnqueue (), 100,
+                         "Wrong number of packets dropped before enqueue");
+  NS_TEST_EXPECT_MSG_EQ (queue->Peek (), packets[0], "Wrong packet at the head");
+
+  // Remove drops after dequeue
+  NS_TEST_EXPECT_MSG_EQ (queue->Remove (), packets[0], "Wrong packet removed");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPacketsAfterDequeue (), 1,
+                         "Wrong number of packets dropped after dequeue");
+  queue->Flush ();
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 0, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "The queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ (m_nDropped, 300, "Wrong number of Drop traces");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -96,6 +206,7 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new DropTailQueueRingTestCase (), TestCase::QUICK);
   }
 };
 
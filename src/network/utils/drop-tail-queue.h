@@ -20,6 +20,7 @@
 #define DROPTAIL_H
 
 #include "ns3/queue.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -27,6 +28,11 @@ namespace ns3 {
  * \ingroup queue
  *
  * \brief A FIFO packet queue that drops tail-end packets on overflow
+ *
+ * The items are stored in a ring buffer rather than in the list of the
+ * Queue base class, so that no memory is allocated per item. The ring
+ * doubles its capacity when it is full, hence it stops growing once it
+ * can hold as many items as the maximum size of the queue allows.
  */
 template <typename Item>
 class DropTailQueue : public Queue<Item>
@@ -50,14 +56,30 @@ public:
   virtual Ptr<Item> Dequeue (void);
   virtual Ptr<Item> Remove (void);
   virtual Ptr<const Item> Peek (void) const;
+  virtual uint32_t EnqueueMany (const std::vector<Ptr<Item> > &items);
+  virtual uint32_t DequeueMany (std::vector<Ptr<Item> > &items, uint32_t maxItems);
 
 private:
-  using Queue<Item>::Head;
-  using Queue<Item>::Tail;
-  using Queue<Item>::DoEnqueue;
-  using Queue<Item>::DoDequeue;
-  using Queue<Item>::DoRemove;
-  using Queue<Item>::DoPeek;
+  using Queue<Item>::NotifyEnqueue;
+  using Queue<Item>::NotifyDequeue;
+  using Queue<Item>::DropBeforeEnqueue;
+  using Queue<Item>::DropAfterDequeue;
+
+  /**
+   * Store an item at the tail of the ring, if it fits in the queue
+   * \param item the item
+   * \return true if the item was enqueued
+   */
+  bool PushTail (Ptr<Item> item);
+
+  /**
+   * Take the item at the head of the ring
+   * \return the item, which the ring must not be empty of
+   */
+  Ptr<Item> PopHead (void);
+
+  std::vector<Ptr<Item> > m_ring; //!< the items; the size is a power of two
+  uint32_t m_head;                //!< index of the head item in the ring
 
   NS_LOG_TEMPLATE_DECLARE;     //!< redefinition of the log component
 };
@@ -82,6 +104,7 @@ DropTailQueue<Item>::GetTypeId (void)
 template <typename Item>
 DropTailQueue<Item>::DropTailQueue () :
   Queue<Item> (),
+  m_head (0),
   NS_LOG_TEMPLATE_DEFINE ("DropTailQueue")
 {
   NS_LOG_FUNCTION (this);
@@ -93,13 +116,55 @@ DropTailQueue<Item>::~DropTailQueue ()
   NS_LOG_FUNCTION (this);
 }
 
+template <typename Item>
+bool
+DropTailQueue<Item>::PushTail (Ptr<Item> item)
+{
+  if (this->GetCurrentSize () + item > this->GetMaxSize ())
+    {
+      NS_LOG_LOGIC ("Queue full -- dropping pkt");
+      DropBeforeEnqueue (item);
+      return false;
+    }
+
+  uint32_t nItems = this->GetNPackets ();
+  if (nItems == m_ring.size ())
+    {
+      // Grow the ring, moving the items to the beginning of the new one
+      std::vector<Ptr<Item> > ring (m_ring.empty () ? 16 : 2 * m_ring.size ());
+      for (uint32_t i = 0; i < nItems; i++)
+        {
+          ring[i] = m_ring[(m_head + i) & (m_ring.size () - 1)];
+        }
+      m_ring.swap (ring);
+      m_head = 0;
+    }
+
+  m_ring[(m_head + nItems) & (m_ring.size () - 1)] = item;
+  NotifyEnqueue (item);
+  return true;
+}
+
+template <typename Item>
+Ptr<Item>
+DropTailQueue<Item>::PopHead (void)
+{
+  NS_ASSERT (this->GetNPackets () > 0);
+
+  Ptr<Item> item = m_ring[m_head];
+  m_ring[m_head] = 0;
+  m_head = (m_head + 1) & (m_ring.size () - 1);
+  NotifyDequeue (item);
+  return item;
+}
+
 template <typename Item>
 bool
 DropTailQueue<Item>::Enqueue (Ptr<Item> item)
 {
   NS_LOG_FUNCTION (this << item);
 
-  return DoEnqueue (Tail (), item);
+  return PushTail (item);
 }
 
 template <typename Item>
@@ -108,7 +173,13 @@ DropTailQueue<Item>::Dequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<Item> item = DoDequeue (Head ());
+  if (this->GetNPackets () == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  Ptr<Item> item = PopHead ();
 
   NS_LOG_LOGIC ("Popped " << item);
 
@@ -121,7 +192,15 @@ DropTailQueue<Item>::Remove (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<Item> item = DoRemove (Head ());
+  if (this->GetNPackets () == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  // packets are first dequeued and then dropped
+  Ptr<Item> item = PopHead ();
+  DropAfterDequeue (item);
 
   NS_LOG_LOGIC ("Removed " << item);
 
@@ -134,7 +213,45 @@ DropTailQueue<Item>::Peek (void) const
 {
   NS_LOG_FUNCTION (this);
 
-  return DoPeek (Head ());
+  if (this->GetNPackets () == 0)
+    {
+      NS_LOG_LOGIC ("Queue empty");
+      return 0;
+    }
+
+  return m_ring[m_head];
+}
+
+template <typename Item>
+uint32_t
+DropTailQueue<Item>::EnqueueMany (const std::vector<Ptr<Item> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  uint32_t nEnqueued = 0;
+  for (auto it = items.begin (); it != items.end (); ++it)
+    {
+      if (PushTail (*it))
+        {
+          nEnqueued++;
+        }
+    }
+  return nEnqueued;
+}
+
+template <typename Item>
+uint32_t
+DropTailQueue<Item>::DequeueMany (std::vector<Ptr<Item> > &items, uint32_t maxItems)
+{
+  NS_LOG_FUNCTION (this << maxItems);
+
+  uint32_t nDequeued = std::min (maxItems, this->GetNPackets ());
+  items.reserve (items.size () + nDequeued);
+  for (uint32_t i = 0; i < nDequeued; i++)
+    {
+      items.push_back (PopHead ());
+    }
+  return nDequeued;
 }
 
 } // namespace ns3
@@ -246,6 +246,18 @@ Mac48Address Mac48Address::GetMulticast (Ipv6Address addr)
   return etherAddr;
 }
 
+size_t Mac48AddressHash::operator() (Mac48Address const &x) const
+{
+  //the address bytes are packed so that the most variable ones
+  //(the last ones for allocated addresses) are the least significant
+  uint64_t h = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      h = (h << 8) | x.m_address[i];
+    }
+  return static_cast<size_t> (h);
+}
+
 std::ostream& operator<< (std::ostream& os, const Mac48Address & address)
 {
   uint8_t ad[6];
@@ -33,6 +33,7 @@
 #include <string>
 #include <sstream>
 #include <list>
+#include <vector>
 
 namespace ns3 {
 
@@ -232,7 +233,11 @@ private:
  * Queue is a template class. The type of the objects stored within the queue
  * is specified by the type parameter, which can be any class providing a
  * GetSize () method (e.g., Packet, QueueDiscItem, etc.). Subclasses need to
- * implement the DoEnqueue, DoDequeue, DoRemove and DoPeek methods.
+ * implement the Enqueue, Dequeue, Remove and Peek methods. They can store
+ * the items in the list of this class, through the DoEnqueue, DoDequeue,
+ * DoRemove and DoPeek methods, or in a container of their own, calling
+ * NotifyEnqueue, NotifyDequeue, DropBeforeEnqueue and DropAfterDequeue to
+ * keep the statistics and fire the traces.
  *
  * Users of the Queue template class usually hold a queue through a smart pointer,
  * hence forward declaration is recommended to avoid pulling the implementation
@@ -286,6 +291,23 @@ public:
    */
   virtual Ptr<const Item> Peek (void) const = 0;
 
+  /**
+   * Place several items into the Queue, as if Enqueue was called for each
+   * of them in turn
+   * \param items the items to enqueue
+   * \return the number of items successfully enqueued
+   */
+  virtual uint32_t EnqueueMany (const std::vector<Ptr<Item> > &items);
+
+  /**
+   * Remove several items from the Queue, as if Dequeue was called until
+   * the queue is empty or enough items are dequeued
+   * \param items the vector the dequeued items are appended to
+   * \param maxItems the maximum number of items to dequeue
+   * \return the number of items dequeued
+   */
+  virtual uint32_t DequeueMany (std::vector<Ptr<Item> > &items, uint32_t maxItems);
+
   /**
    * Flush the queue.
    */
@@ -357,6 +379,24 @@ protected:
    */
   Ptr<const Item> DoPeek (ConstIterator pos) const;
 
+  /**
+   * \brief Account for an item stored in the queue and fire the Enqueue trace
+   * \param item the enqueued item
+   *
+   * This method is called by DoEnqueue and by the subclasses that store the
+   * items in a container of their own.
+   */
+  void NotifyEnqueue (Ptr<Item> item);
+
+  /**
+   * \brief Account for an item taken from the queue and fire the Dequeue trace
+   * \param item the dequeued item
+   *
+   * This method is called by DoDequeue and DoRemove and by the subclasses that
+   * store the items in a container of their own.
+   */
+  void NotifyDequeue (Ptr<Item> item);
+
   /**
    * \brief Drop a packet before enqueue
    * \param item item that was dropped
@@ -450,7 +490,15 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item)
     }
 
   m_packets.insert (pos, item);
+  NotifyEnqueue (item);
+
+  return true;
+}
 
+template <typename Item>
+void
+Queue<Item>::NotifyEnqueue (Ptr<Item> item)
+{
   uint32_t size = item->GetSize ();
   m_nBytes += size;
   m_nTotalReceivedBytes += size;
@@ -460,8 +508,20 @@ Queue<Item>::DoEnqueue (ConstIterator pos, Ptr<Item> item)
 
   NS_LOG_LOGIC ("m_traceEnqueue (p)");
   m_traceEnqueue (item);
+}
 
-  return true;
+template <typename Item>
+void
+Queue<Item>::NotifyDequeue (Ptr<Item> item)
+{
+  NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
+  NS_ASSERT (m_nPackets.Get () > 0);
+
+  m_nBytes -= item->GetSize ();
+  m_nPackets--;
+
+  NS_LOG_LOGIC ("m_traceDequeue (p)");
+  m_traceDequeue (item);
 }
 
 template <typename Item>
@@ -481,14 +541,7 @@ Queue<Item>::DoDequeue (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
-
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
-
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
+      NotifyDequeue (item);
     }
   return item;
 }
@@ -510,21 +563,50 @@ Queue<Item>::DoRemove (ConstIterator pos)
 
   if (item != 0)
     {
-      NS_ASSERT (m_nBytes.Get () >= item->GetSize ());
-      NS_ASSERT (m_nPackets.Get () > 0);
-
-      m_nBytes -= item->GetSize ();
-      m_nPackets--;
-
       // packets are first dequeued and then dropped
-      NS_LOG_LOGIC ("m_traceDequeue (p)");
-      m_traceDequeue (item);
-
+      NotifyDequeue (item);
       DropAfterDequeue (item);
     }
   return item;
 }
 
+template <typename Item>
+uint32_t
+Queue<Item>::EnqueueMany (const std::vector<Ptr<Item> > &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  uint32_t nEnqueued = 0;
+  for (auto it = items.begin (); it != items.end (); ++it)
+    {
+      if (Enqueue (*it))
+        {
+          nEnqueued++;
+        }
+    }
+  return nEnqueued;
+}
+
+template <typename Item>
+uint32_t
+Queue<Item>::DequeueMany (std::vector<Ptr<Item> > &items, uint32_t maxItems)
+{
+  NS_LOG_FUNCTION (this << maxItems);
+
+  uint32_t nDequeued = 0;
+  while (nDequeued < maxItems && !IsEmpty ())
+    {
+      Ptr<Item> item = Dequeue ();
+      if (item == 0)
+        {
+          break;
+        }
+      items.push_back (item);
+      nDequeued++;
+    }
+  return nDequeued;
+}
+
 template <typename Item>
 void
 Queue<Item>::Flush (void)
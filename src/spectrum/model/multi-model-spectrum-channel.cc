@@ -26,6 +26,7 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -95,6 +96,7 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_linkLosses.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -119,6 +121,23 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("CacheLinkLosses",
+                   "If true, the single-frequency loss (antenna gains and "
+                   "PropagationLossModel) and the propagation delay of each "
+                   "TX-RX pair are computed once and reused for the next "
+                   "signals, as long as the positions of the two nodes and "
+                   "their antennas do not change. This also allows the "
+                   "signals to receivers beyond MaxLossDb to be discarded "
+                   "without copying them. Only to be used with deterministic "
+                   "PropagationLossModel and PropagationDelayModel; the "
+                   "SpectrumPropagationLossModel is still evaluated for "
+                   "each signal. Antennas are compared by instance only: "
+                   "changing the attributes of an AntennaModel (e.g., its "
+                   "orientation or beamwidth) after the first signal is not "
+                   "detected, and the antenna should be replaced instead.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiModelSpectrumChannel::m_cacheLinkLosses),
+                   MakeBooleanChecker ())
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -215,8 +234,33 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 
 }
 
+void
+MultiModelSpectrumChannel::RemoveRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+
+  for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+       rxInfoIterator !=  m_rxSpectrumModelInfoMap.end ();
+       ++rxInfoIterator)
+    {
+      if (rxInfoIterator->second.m_rxPhySet.erase (phy) > 0)
+        {
+          --m_numDevices;
+          break; // there should be at most one entry
+        }
+    }
+
+  // drop the cached losses from and to this phy, which would otherwise
+  // keep it alive until the channel is disposed
+  m_linkLosses.erase (phy);
+  for (LinkLossMap_t::iterator it = m_linkLosses.begin (); it != m_linkLosses.end (); ++it)
+    {
+      it->second.erase (phy);
+    }
+}
+
 
-TxSpectrumModelInfoMap_t::const_iterator
+TxSpectrumModelInfoMap_t::iterator
 MultiModelSpectrumChannel::FindAndEventuallyAddTxSpectrumModel (Ptr<const SpectrumModel> txSpectrumModel)
 {
   NS_LOG_FUNCTION (this << txSpectrumModel);
@@ -317,57 +361,22 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
+              double pathLossDb;
+              Time delay;
+              if (!CalcLinkLoss (txParams, txMobility, *rxPhyIterator, pathLossDb, delay))
+                {
+                  // beyond range
+                  continue;
+                }
+              if (DoHandleRx (txParams, convertedTxPowerSpectrum, txMobility, *rxPhyIterator, pathLossDb, delay))
+                {
+                  continue;
+                }
+
               NS_LOG_LOGIC (" copying signal parameters " << txParams);
               Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
               rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
-
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-
-              if (txMobility && receiverMobility)
-                {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
-                }
+              ApplyPropagation (rxParams, txMobility, *rxPhyIterator, pathLossDb);
 
               Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
               if (netDev)
@@ -390,6 +399,142 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 }
 
+/**
+ * \param a a position
+ * \param b another position
+ * \return true if the two positions are exactly the same
+ */
+static bool
+IsSamePosition (const Vector &a, const Vector &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+bool
+MultiModelSpectrumChannel::CalcLinkLoss (Ptr<const SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                                         Ptr<SpectrumPhy> receiver, double &pathLossDb, Time &delay)
+{
+  NS_LOG_FUNCTION (this << txParams << receiver);
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
+  if (!txMobility || !receiverMobility)
+    {
+      pathLossDb = 0;
+      delay = MicroSeconds (0);
+      return true;
+    }
+
+  Ptr<AntennaModel> rxAntenna = receiver->GetRxAntenna ();
+  if (m_cacheLinkLosses)
+    {
+      Vector txPosition = txMobility->GetPosition ();
+      Vector rxPosition = receiverMobility->GetPosition ();
+      RxLinkLossMap_t &rxLinkLosses = m_linkLosses[txParams->txPhy];
+      RxLinkLossMap_t::iterator it = rxLinkLosses.lower_bound (receiver);
+      if (it == rxLinkLosses.end () || it->first != receiver)
+        {
+          it = rxLinkLosses.insert (it, std::make_pair (receiver, LinkLoss ()));
+          DoCalcLinkLoss (txParams->txAntenna, txMobility, rxAntenna, receiverMobility,
+                          m_propagationLoss, m_propagationDelay,
+                          it->second.pathLossDb, it->second.delay);
+        }
+      else if (!IsSamePosition (it->second.txPosition, txPosition)
+               || !IsSamePosition (it->second.rxPosition, rxPosition)
+               || it->second.txAntenna != txParams->txAntenna || it->second.rxAntenna != rxAntenna)
+        {
+          NS_LOG_LOGIC ("cached loss is outdated");
+          DoCalcLinkLoss (txParams->txAntenna, txMobility, rxAntenna, receiverMobility,
+                          m_propagationLoss, m_propagationDelay,
+                          it->second.pathLossDb, it->second.delay);
+        }
+      it->second.txPosition = txPosition;
+      it->second.rxPosition = rxPosition;
+      it->second.txAntenna = txParams->txAntenna;
+      it->second.rxAntenna = rxAntenna;
+      pathLossDb = it->second.pathLossDb;
+      delay = it->second.delay;
+    }
+  else
+    {
+      DoCalcLinkLoss (txParams->txAntenna, txMobility, rxAntenna, receiverMobility,
+                      m_propagationLoss, m_propagationDelay, pathLossDb, delay);
+    }
+  m_pathLossTrace (txParams->txPhy, receiver, pathLossDb);
+  return pathLossDb <= m_maxLossDb;
+}
+
+void
+MultiModelSpectrumChannel::ApplyPropagation (Ptr<SpectrumSignalParameters> rxParams, Ptr<MobilityModel> txMobility,
+                                             Ptr<SpectrumPhy> receiver, double pathLossDb)
+{
+  NS_LOG_FUNCTION (this << rxParams << receiver << pathLossDb);
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
+
+  if (txMobility && receiverMobility)
+    {
+      DoApplyLinkLoss (rxParams, pathLossDb, m_spectrumPropagationLoss, txMobility, receiverMobility);
+    }
+}
+
+bool
+MultiModelSpectrumChannel::DoHandleRx (Ptr<const SpectrumSignalParameters> txParams, Ptr<const SpectrumValue> rxPsd,
+                                       Ptr<MobilityModel> txMobility, Ptr<SpectrumPhy> receiver,
+                                       double pathLossDb, Time delay)
+{
+  return false;
+}
+
+Ptr<SpectrumSignalParameters>
+MultiModelSpectrumChannel::CalcRxSignalParameters (Ptr<SpectrumSignalParameters> txParams,
+                                                   Ptr<SpectrumPhy> receiver,
+                                                   Time &delay)
+{
+  NS_LOG_FUNCTION (this << txParams << receiver);
+  NS_ASSERT (txParams->txPhy);
+  NS_ASSERT (txParams->psd);
+
+  if (receiver == txParams->txPhy)
+    {
+      return 0;
+    }
+
+  Ptr<const SpectrumModel> txSpectrumModel = txParams->psd->GetSpectrumModel ();
+  Ptr<const SpectrumModel> rxSpectrumModel = receiver->GetRxSpectrumModel ();
+  Ptr<SpectrumValue> convertedTxPowerSpectrum;
+  if (txSpectrumModel->GetUid () == rxSpectrumModel->GetUid ())
+    {
+      NS_LOG_LOGIC ("no spectrum conversion needed");
+      convertedTxPowerSpectrum = txParams->psd;
+    }
+  else
+    {
+      // the receiver needs not be attached to the channel, hence the
+      // converter is created here if it is not known yet
+      TxSpectrumModelInfoMap_t::iterator txInfoIterator = FindAndEventuallyAddTxSpectrumModel (txSpectrumModel);
+      SpectrumConverterMap_t::iterator rxConverterIterator = txInfoIterator->second.m_spectrumConverterMap.find (rxSpectrumModel->GetUid ());
+      if (rxConverterIterator == txInfoIterator->second.m_spectrumConverterMap.end ())
+        {
+          if (txSpectrumModel->IsOrthogonal (*rxSpectrumModel))
+            {
+              return 0;
+            }
+          SpectrumConverter converter (txSpectrumModel, rxSpectrumModel);
+          rxConverterIterator = txInfoIterator->second.m_spectrumConverterMap.insert (std::make_pair (rxSpectrumModel->GetUid (), converter)).first;
+        }
+      convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
+    }
+
+  Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
+  double pathLossDb;
+  if (!CalcLinkLoss (txParams, txMobility, receiver, pathLossDb, delay))
+    {
+      return 0;
+    }
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+  rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+  ApplyPropagation (rxParams, txMobility, receiver, pathLossDb);
+  return rxParams;
+}
+
 void
 MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
 {
@@ -27,6 +27,8 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/vector.h>
 #include <map>
 #include <set>
 
@@ -120,7 +122,11 @@ public:
   virtual void AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss);
   virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
   virtual void AddRx (Ptr<SpectrumPhy> phy);
+  virtual void RemoveRx (Ptr<SpectrumPhy> phy);
   virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+  virtual Ptr<SpectrumSignalParameters> CalcRxSignalParameters (Ptr<SpectrumSignalParameters> txParams,
+                                                                Ptr<SpectrumPhy> receiver,
+                                                                Time &delay);
 
 
   // inherited from Channel
@@ -143,6 +149,41 @@ public:
 protected:
   void DoDispose ();
 
+  /**
+   * Called by StartTx () for each receiver in range of a signal, before
+   * the signal is copied for it. A subclass can override it to handle
+   * the reception itself, e.g., to aggregate the signals that several
+   * transmitters cause at the same receiver; the default implementation
+   * does nothing.
+   *
+   * @param txParams the transmitted signal
+   * @param rxPsd the transmitted PSD, converted to the SpectrumModel of
+   * the receiver
+   * @param txMobility the mobility model of the transmitter
+   * @param receiver the receiver
+   * @param pathLossDb the loss computed by CalcLinkLoss (), in dB
+   * @param delay the propagation delay
+   * @return true if the signal was handled, and is not to be delivered
+   * to the receiver by StartTx ()
+   */
+  virtual bool DoHandleRx (Ptr<const SpectrumSignalParameters> txParams, Ptr<const SpectrumValue> rxPsd,
+                           Ptr<MobilityModel> txMobility, Ptr<SpectrumPhy> receiver,
+                           double pathLossDb, Time delay);
+
+  /**
+   * Apply the single-frequency loss and the SpectrumPropagationLossModel
+   * between the transmitter and a receiver to a received signal.
+   *
+   * @param rxParams the received signal, whose PSD is initially the
+   * transmitted PSD converted to the SpectrumModel of the receiver;
+   * it is modified in place
+   * @param txMobility the mobility model of the transmitter
+   * @param receiver the receiver
+   * @param pathLossDb the loss computed by CalcLinkLoss (), in dB
+   */
+  void ApplyPropagation (Ptr<SpectrumSignalParameters> rxParams, Ptr<MobilityModel> txMobility,
+                         Ptr<SpectrumPhy> receiver, double pathLossDb);
+
 private:
   /**
    * This method checks if m_rxSpectrumModelInfoMap contains an entry
@@ -154,7 +195,25 @@ private:
    *
    * @return An iterator pointing to the corresponding entry in m_txSpectrumModelInfoMap
    */
-  TxSpectrumModelInfoMap_t::const_iterator FindAndEventuallyAddTxSpectrumModel (Ptr<const SpectrumModel> txSpectrumModel);
+  TxSpectrumModelInfoMap_t::iterator FindAndEventuallyAddTxSpectrumModel (Ptr<const SpectrumModel> txSpectrumModel);
+
+  /**
+   * Compute the single-frequency loss (antenna gains and
+   * PropagationLossModel) and the propagation delay between the
+   * transmitter of a signal and a receiver, and fire the PathLoss trace.
+   * If the CacheLinkLosses attribute is set, the values are taken from
+   * the cache as long as the positions of the two nodes and their
+   * antennas did not change.
+   *
+   * @param txParams the transmitted signal
+   * @param txMobility the mobility model of the transmitter
+   * @param receiver the receiver
+   * @param pathLossDb set to the loss, in dB
+   * @param delay set to the propagation delay
+   * @return false if the receiver is out of range
+   */
+  bool CalcLinkLoss (Ptr<const SpectrumSignalParameters> txParams, Ptr<MobilityModel> txMobility,
+                     Ptr<SpectrumPhy> receiver, double &pathLossDb, Time &delay);
 
   /**
    * Used internally to reschedule transmission after the propagation delay.
@@ -217,6 +276,38 @@ private:
    * Traced callback for SpectrumSignalParameters in StartTx requests
    */
   TracedCallback<Ptr<SpectrumSignalParameters> > m_txSigParamsTrace;
+
+  /**
+   * Cached single-frequency loss and propagation delay between a
+   * transmitter and a receiver, together with the state they were
+   * computed for.
+   */
+  struct LinkLoss
+  {
+    Vector txPosition;            //!< position of the transmitter
+    Vector rxPosition;            //!< position of the receiver
+    Ptr<AntennaModel> txAntenna;  //!< antenna of the transmitter
+    Ptr<AntennaModel> rxAntenna;  //!< antenna of the receiver
+    double pathLossDb;            //!< the loss, in dB
+    Time delay;                   //!< the propagation delay
+  };
+
+  /// Container: receiver SpectrumPhy, LinkLoss
+  typedef std::map<Ptr<const SpectrumPhy>, LinkLoss> RxLinkLossMap_t;
+
+  /// Container: transmitter SpectrumPhy, cached losses to its receivers
+  typedef std::map<Ptr<const SpectrumPhy>, RxLinkLossMap_t> LinkLossMap_t;
+
+  /**
+   * Whether the single-frequency losses and the propagation delays are
+   * cached for each pair of nodes.
+   */
+  bool m_cacheLinkLosses;
+
+  /**
+   * The cached single-frequency losses and propagation delays.
+   */
+  LinkLossMap_t m_linkLosses;
 };
 
 
@@ -33,6 +33,7 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <algorithm>
 
 
 #include "single-model-spectrum-channel.h"
@@ -109,6 +110,17 @@ SingleModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
   m_phyList.push_back (phy);
 }
 
+void
+SingleModelSpectrumChannel::RemoveRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  PhyList::iterator it = std::find (m_phyList.begin (), m_phyList.end (), phy);
+  if (it != m_phyList.end ())
+    {
+      m_phyList.erase (it);
+    }
+}
+
 
 void
 SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
@@ -142,56 +154,15 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
         {
           Time delay  = MicroSeconds (0);
 
-          Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
           NS_LOG_LOGIC ("copying signal parameters " << txParams);
           Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
 
-          if (senderMobility && receiverMobility)
+          if (!ApplyPropagation (rxParams, senderMobility, *rxPhyIterator, delay))
             {
-              double pathLossDb = 0;
-              if (rxParams->txAntenna != 0)
-                {
-                  Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-                  double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                  NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                  pathLossDb -= txAntennaGain;
-                }
-              Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-              if (rxAntenna != 0)
-                {
-                  Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-                  double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                  NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                  pathLossDb -= rxAntennaGain;
-                }
-              if (m_propagationLoss)
-                {
-                  double propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
-                  NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                  pathLossDb -= propagationGainDb;
-                }                    
-              NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-              m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-              if ( pathLossDb > m_maxLossDb)
-                {
-                  // beyond range
-                  continue;
-                }
-              double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-              *(rxParams->psd) *= pathGainLinear;              
-
-              if (m_spectrumPropagationLoss)
-                {
-                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, senderMobility, receiverMobility);
-                }
-
-              if (m_propagationDelay)
-                {
-                  delay = m_propagationDelay->GetDelay (senderMobility, receiverMobility);
-                }
+              // beyond range
+              continue;
             }
 
-
           Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
           if (netDev)
             {
@@ -209,6 +180,52 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
     }
 }
 
+bool
+SingleModelSpectrumChannel::ApplyPropagation (Ptr<SpectrumSignalParameters> rxParams, Ptr<MobilityModel> senderMobility,
+                                              Ptr<SpectrumPhy> receiver, Time &delay)
+{
+  NS_LOG_FUNCTION (this << rxParams << receiver);
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
+
+  if (senderMobility && receiverMobility)
+    {
+      double pathLossDb;
+      DoCalcLinkLoss (rxParams->txAntenna, senderMobility, receiver->GetRxAntenna (), receiverMobility,
+                      m_propagationLoss, m_propagationDelay, pathLossDb, delay);
+      m_pathLossTrace (rxParams->txPhy, receiver, pathLossDb);
+      if ( pathLossDb > m_maxLossDb)
+        {
+          return false;
+        }
+      DoApplyLinkLoss (rxParams, pathLossDb, m_spectrumPropagationLoss, senderMobility, receiverMobility);
+    }
+  return true;
+}
+
+Ptr<SpectrumSignalParameters>
+SingleModelSpectrumChannel::CalcRxSignalParameters (Ptr<SpectrumSignalParameters> txParams,
+                                                    Ptr<SpectrumPhy> receiver,
+                                                    Time &delay)
+{
+  NS_LOG_FUNCTION (this << txParams << receiver);
+  NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
+  NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
+  // all SpectrumPhy instances must use the same SpectrumModel
+  NS_ASSERT (*(txParams->psd->GetSpectrumModel ()) == *(receiver->GetRxSpectrumModel ()));
+
+  if (receiver == txParams->txPhy)
+    {
+      return 0;
+    }
+  delay = MicroSeconds (0);
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+  if (!ApplyPropagation (rxParams, txParams->txPhy->GetMobility (), receiver, delay))
+    {
+      return 0;
+    }
+  return rxParams;
+}
+
 void
 SingleModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
 {
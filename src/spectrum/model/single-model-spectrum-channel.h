@@ -28,7 +28,7 @@
 
 namespace ns3 {
 
-
+class MobilityModel;
 
 /**
  * \ingroup spectrum
@@ -54,7 +54,11 @@ public:
   virtual void AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss);
   virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
   virtual void AddRx (Ptr<SpectrumPhy> phy);
+  virtual void RemoveRx (Ptr<SpectrumPhy> phy);
   virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+  virtual Ptr<SpectrumSignalParameters> CalcRxSignalParameters (Ptr<SpectrumSignalParameters> txParams,
+                                                                Ptr<SpectrumPhy> receiver,
+                                                                Time &delay);
 
 
   // inherited from Channel
@@ -81,6 +85,20 @@ private:
    */
   void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Apply the antenna gains, the propagation losses and the propagation
+   * delay between the transmitter and a receiver to a received signal.
+   *
+   * @param rxParams the received signal, whose PSD is initially the
+   * transmitted PSD; it is modified in place
+   * @param senderMobility the mobility model of the transmitter
+   * @param receiver the receiver
+   * @param delay set to the propagation delay
+   * @return false if the receiver is out of range
+   */
+  bool ApplyPropagation (Ptr<SpectrumSignalParameters> rxParams, Ptr<MobilityModel> senderMobility,
+                         Ptr<SpectrumPhy> receiver, Time &delay);
+
   /**
    * List of SpectrumPhy instances attached to the channel.
    */
@@ -18,11 +18,20 @@
  * Author: Nicola Baldo <nbaldo@cttc.es>
  */
 
+#include <ns3/log.h>
+#include <ns3/mobility-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
 #include "spectrum-channel.h"
+#include <cmath>
 
 
 namespace ns3 {
 
+NS_LOG_COMPONENT_DEFINE ("SpectrumChannel");
 
 NS_OBJECT_ENSURE_REGISTERED (SpectrumChannel);
 
@@ -40,4 +49,69 @@ SpectrumChannel::~SpectrumChannel ()
 {
 }
 
+Ptr<SpectrumSignalParameters>
+SpectrumChannel::CalcRxSignalParameters (Ptr<SpectrumSignalParameters> txParams,
+                                         Ptr<SpectrumPhy> receiver,
+                                         Time &delay)
+{
+  NS_FATAL_ERROR (GetInstanceTypeId ().GetName () << " does not implement CalcRxSignalParameters ()");
+  return 0;
+}
+
+void
+SpectrumChannel::RemoveRx (Ptr<SpectrumPhy> phy)
+{
+  NS_FATAL_ERROR (GetInstanceTypeId ().GetName () << " does not implement RemoveRx ()");
+}
+
+void
+SpectrumChannel::DoCalcLinkLoss (Ptr<AntennaModel> txAntenna, Ptr<MobilityModel> txMobility,
+                                 Ptr<AntennaModel> rxAntenna, Ptr<MobilityModel> rxMobility,
+                                 Ptr<PropagationLossModel> propagationLoss,
+                                 Ptr<PropagationDelayModel> propagationDelay,
+                                 double &pathLossDb, Time &delay)
+{
+  pathLossDb = 0;
+  if (txAntenna != 0)
+    {
+      Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+      double txAntennaGain = txAntenna->GetGainDb (txAngles);
+      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+      pathLossDb -= txAntennaGain;
+    }
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (txMobility->GetPosition (), rxMobility->GetPosition ());
+      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+      pathLossDb -= rxAntennaGain;
+    }
+  if (propagationLoss)
+    {
+      double propagationGainDb = propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+      pathLossDb -= propagationGainDb;
+    }
+  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+  delay = MicroSeconds (0);
+  if (propagationDelay)
+    {
+      delay = propagationDelay->GetDelay (txMobility, rxMobility);
+    }
+}
+
+void
+SpectrumChannel::DoApplyLinkLoss (Ptr<SpectrumSignalParameters> rxParams, double pathLossDb,
+                                  Ptr<SpectrumPropagationLossModel> spectrumPropagationLoss,
+                                  Ptr<MobilityModel> txMobility, Ptr<MobilityModel> rxMobility)
+{
+  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+  *(rxParams->psd) *= pathGainLinear;
+
+  if (spectrumPropagationLoss)
+    {
+      rxParams->psd = spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, rxMobility);
+    }
+}
+
 } // namespace
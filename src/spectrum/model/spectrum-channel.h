@@ -36,6 +36,8 @@ class SpectrumPhy;
 class SpectrumPropagationLossModel;
 class PropagationLossModel;
 class PropagationDelayModel;
+class AntennaModel;
+class MobilityModel;
 
 /**
  * \ingroup spectrum
@@ -99,6 +101,44 @@ public:
    */
   virtual void AddRx (Ptr<SpectrumPhy> phy) = 0;
 
+  /**
+   * Remove a SpectrumPhy from the channel, so that it will not receive
+   * any further signal. Any state that the channel keeps about the
+   * SpectrumPhy, e.g., cached link losses, is released as well; this
+   * can be called for a SpectrumPhy that was only ever passed to
+   * CalcRxSignalParameters ().
+   *
+   * The default implementation aborts the simulation: this method is to
+   * be implemented by the classes inheriting from SpectrumChannel which
+   * support it.
+   *
+   * @param phy the SpectrumPhy instance to be removed
+   */
+  virtual void RemoveRx (Ptr<SpectrumPhy> phy);
+
+  /**
+   * Compute the signal that a SpectrumPhy would receive for a given
+   * transmission, without scheduling its reception. The same spectrum
+   * conversion, antenna gains, propagation losses and propagation delay
+   * as for the receivers added with AddRx () are applied, and the PathLoss
+   * trace is fired as well. The receiver does not need to be attached to
+   * the channel.
+   *
+   * The default implementation aborts the simulation: this method is to
+   * be implemented by the classes inheriting from SpectrumChannel which
+   * support it.
+   *
+   * @param txParams the parameters of the transmitted signal, as passed
+   * to StartTx ()
+   * @param receiver the SpectrumPhy instance receiving the signal
+   * @param delay set to the propagation delay of the signal
+   * @return the parameters of the received signal, or 0 if the receiver
+   * would not receive the signal (e.g., if it is out of range)
+   */
+  virtual Ptr<SpectrumSignalParameters> CalcRxSignalParameters (Ptr<SpectrumSignalParameters> txParams,
+                                                                Ptr<SpectrumPhy> receiver,
+                                                                Time &delay);
+
   /**
    * TracedCallback signature for path loss calculation events.
    *
@@ -112,7 +152,41 @@ public:
   typedef void (* LossTracedCallback)
     (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy,
      double lossDb);
-  
+
+protected:
+  /**
+   * Compute the single-frequency loss (antenna gains and
+   * PropagationLossModel) and the propagation delay between two nodes.
+   *
+   * @param txAntenna the antenna of the transmitter, or 0
+   * @param txMobility the mobility model of the transmitter
+   * @param rxAntenna the antenna of the receiver, or 0
+   * @param rxMobility the mobility model of the receiver
+   * @param propagationLoss the PropagationLossModel of the channel, or 0
+   * @param propagationDelay the PropagationDelayModel of the channel, or 0
+   * @param pathLossDb set to the loss, in dB
+   * @param delay set to the propagation delay
+   */
+  static void DoCalcLinkLoss (Ptr<AntennaModel> txAntenna, Ptr<MobilityModel> txMobility,
+                              Ptr<AntennaModel> rxAntenna, Ptr<MobilityModel> rxMobility,
+                              Ptr<PropagationLossModel> propagationLoss,
+                              Ptr<PropagationDelayModel> propagationDelay,
+                              double &pathLossDb, Time &delay);
+
+  /**
+   * Apply the single-frequency loss computed by DoCalcLinkLoss () and the
+   * SpectrumPropagationLossModel between two nodes to a received signal.
+   *
+   * @param rxParams the received signal, whose PSD is modified in place
+   * @param pathLossDb the single-frequency loss, in dB
+   * @param spectrumPropagationLoss the SpectrumPropagationLossModel of
+   * the channel, or 0
+   * @param txMobility the mobility model of the transmitter
+   * @param rxMobility the mobility model of the receiver
+   */
+  static void DoApplyLinkLoss (Ptr<SpectrumSignalParameters> rxParams, double pathLossDb,
+                               Ptr<SpectrumPropagationLossModel> spectrumPropagationLoss,
+                               Ptr<MobilityModel> txMobility, Ptr<MobilityModel> rxMobility);
 };
 
 
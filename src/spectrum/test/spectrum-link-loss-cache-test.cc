@@ -0,0 +1,225 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/core-module.h>
+#include <ns3/test.h>
+#include <ns3/spectrum-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/propagation-module.h>
+#include <ns3/antenna-module.h>
+
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumLinkLossCacheTest");
+
+using namespace ns3;
+
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * \brief Check that a MultiModelSpectrumChannel caching the link losses
+ * computes the same received signals as a channel which does not, also
+ * when the nodes move or their antennas change.
+ */
+class SpectrumLinkLossCacheTestCase : public TestCase
+{
+public:
+  SpectrumLinkLossCacheTestCase ();
+  virtual ~SpectrumLinkLossCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a channel
+   *
+   * \param cache the CacheLinkLosses attribute
+   * \return the channel
+   */
+  Ptr<SpectrumChannel> CreateChannel (bool cache);
+
+  /**
+   * Compare the signals received through the two channels
+   *
+   * \param expectInRange whether the receiver is expected to be in range
+   */
+  void Check (bool expectInRange);
+
+  /**
+   * Count the PathLoss trace calls
+   *
+   * \param count the counter
+   * \param txPhy the transmitter
+   * \param rxPhy the receiver
+   * \param lossDb the loss
+   */
+  static void PathLoss (uint32_t *count, Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb);
+
+  Ptr<SpectrumChannel> m_cachedChannel;   ///< the channel caching the losses
+  Ptr<SpectrumChannel> m_channel;         ///< the channel not caching the losses
+  Ptr<SpectrumSignalParameters> m_txParams; ///< the transmitted signal
+  Ptr<SpectrumAnalyzer> m_receiver;       ///< the receiver
+  uint32_t m_cachedPathLossCount;         ///< PathLoss trace calls of the caching channel
+  uint32_t m_pathLossCount;               ///< PathLoss trace calls of the other channel
+};
+
+SpectrumLinkLossCacheTestCase::SpectrumLinkLossCacheTestCase ()
+  : TestCase ("Cached link losses of the MultiModelSpectrumChannel"),
+    m_cachedPathLossCount (0),
+    m_pathLossCount (0)
+{
+}
+
+SpectrumLinkLossCacheTestCase::~SpectrumLinkLossCacheTestCase ()
+{
+}
+
+void
+SpectrumLinkLossCacheTestCase::PathLoss (uint32_t *count, Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb)
+{
+  (*count)++;
+}
+
+Ptr<SpectrumChannel>
+SpectrumLinkLossCacheTestCase::CreateChannel (bool cache)
+{
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("CacheLinkLosses", BooleanValue (cache));
+  channel->SetAttribute ("MaxLossDb", DoubleValue (90.0));
+  channel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->TraceConnectWithoutContext ("PathLoss", MakeBoundCallback (&SpectrumLinkLossCacheTestCase::PathLoss,
+                                                                      cache ? &m_cachedPathLossCount : &m_pathLossCount));
+  return channel;
+}
+
+void
+SpectrumLinkLossCacheTestCase::Check (bool expectInRange)
+{
+  Time cachedDelay;
+  Time delay;
+  Ptr<SpectrumSignalParameters> cachedRxParams = m_cachedChannel->CalcRxSignalParameters (m_txParams, m_receiver, cachedDelay);
+  Ptr<SpectrumSignalParameters> rxParams = m_channel->CalcRxSignalParameters (m_txParams, m_receiver, delay);
+  NS_TEST_ASSERT_MSG_EQ ((rxParams != 0), expectInRange, "Unexpected range");
+  NS_TEST_ASSERT_MSG_EQ ((cachedRxParams != 0), expectInRange, "Unexpected range with the cache");
+  if (expectInRange)
+    {
+      NS_TEST_ASSERT_MSG_EQ (cachedDelay, delay, "Different propagation delay");
+      for (size_t i = 0; i < rxParams->psd->GetSpectrumModel ()->GetNumBands (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((*cachedRxParams->psd)[i], (*rxParams->psd)[i], "Different received PSD");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_cachedPathLossCount, m_pathLossCount, "Different number of PathLoss trace calls");
+}
+
+void
+SpectrumLinkLossCacheTestCase::DoRun (void)
+{
+  m_cachedChannel = CreateChannel (true);
+  m_channel = CreateChannel (false);
+
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      freqs.push_back (2.4e9 + i * 1e6);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+
+  Ptr<WaveformGenerator> transmitter = CreateObject<WaveformGenerator> ();
+  Ptr<ConstantPositionMobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  txMobility->SetPosition (Vector (0.0, 0.0, 0.0));
+  transmitter->SetMobility (txMobility);
+  m_receiver = CreateObject<SpectrumAnalyzer> ();
+  Ptr<ConstantPositionMobilityModel> rxMobility = CreateObject<ConstantPositionMobilityModel> ();
+  m_receiver->SetMobility (rxMobility);
+  m_receiver->SetRxSpectrumModel (model);
+
+  m_txParams = Create<SpectrumSignalParameters> ();
+  m_txParams->txPhy = transmitter;
+  m_txParams->duration = MilliSeconds (1);
+  m_txParams->psd = Create<SpectrumValue> (model);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      (*m_txParams->psd)[i] = 1e-6 * (i + 1);
+    }
+  Ptr<CosineAntennaModel> txAntenna = CreateObject<CosineAntennaModel> ();
+  txAntenna->SetAttribute ("Orientation", DoubleValue (30.0));
+  m_txParams->txAntenna = txAntenna;
+
+  rxMobility->SetPosition (Vector (10.0, 0.0, 0.0));
+  Check (true);
+  // same positions: the cached loss is used
+  Check (true);
+  // the receiver moves
+  rxMobility->SetPosition (Vector (20.0, 15.0, 0.0));
+  Check (true);
+  // the transmitter moves
+  txMobility->SetPosition (Vector (5.0, 5.0, 0.0));
+  Check (true);
+  // the receiver gets an antenna, pointing to the transmitter
+  Ptr<CosineAntennaModel> rxAntenna = CreateObject<CosineAntennaModel> ();
+  rxAntenna->SetAttribute ("Orientation", DoubleValue (-150.0));
+  m_receiver->SetAntenna (rxAntenna);
+  Check (true);
+  // the transmitter changes antenna
+  m_txParams->txAntenna = CreateObject<IsotropicAntennaModel> ();
+  Check (true);
+  // the receiver moves beyond MaxLossDb, then back
+  rxMobility->SetPosition (Vector (1000.0, 0.0, 0.0));
+  Check (false);
+  Check (false);
+  rxMobility->SetPosition (Vector (10.0, 0.0, 0.0));
+  Check (true);
+
+  // removing the two phys drops the references held by the cache
+  uint32_t rxReferences = m_receiver->GetReferenceCount ();
+  uint32_t txReferences = transmitter->GetReferenceCount ();
+  m_cachedChannel->RemoveRx (m_receiver);
+  NS_TEST_ASSERT_MSG_EQ (m_receiver->GetReferenceCount (), rxReferences - 1, "The receiver was not purged from the cache");
+  m_cachedChannel->RemoveRx (transmitter);
+  NS_TEST_ASSERT_MSG_EQ (transmitter->GetReferenceCount (), txReferences - 1, "The transmitter was not purged from the cache");
+  Check (true);
+
+  m_cachedChannel->Dispose ();
+  m_channel->Dispose ();
+  m_txParams = 0;
+  m_receiver = 0;
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup spectrum
+ * \ingroup tests
+ *
+ * \brief Test suite for the cached link losses of the
+ * MultiModelSpectrumChannel.
+ */
+class SpectrumLinkLossCacheTestSuite : public TestSuite
+{
+public:
+  SpectrumLinkLossCacheTestSuite ();
+};
+
+SpectrumLinkLossCacheTestSuite::SpectrumLinkLossCacheTestSuite ()
+  : TestSuite ("spectrum-link-loss-cache", UNIT)
+{
+  AddTestCase (new SpectrumLinkLossCacheTestCase, TestCase::QUICK);
+}
+
+static SpectrumLinkLossCacheTestSuite g_spectrumLinkLossCacheTestSuite;
@@ -130,6 +130,8 @@ CoDelQueueDisc::CoDelQueueDisc ()
     m_states (0)
 {
   NS_LOG_FUNCTION (this);
+  m_targetExceededDropId = RegisterReason (TARGET_EXCEEDED_DROP);
+  m_overlimitDropId = RegisterReason (OVERLIMIT_DROP);
 }
 
 CoDelQueueDisc::~CoDelQueueDisc ()
@@ -165,7 +167,7 @@ CoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   if (GetCurrentSize () + item > GetMaxSize ())
     {
       NS_LOG_LOGIC ("Queue full -- dropping pkt");
-      DropBeforeEnqueue (item, OVERLIMIT_DROP);
+      DropBeforeEnqueue (item, m_overlimitDropId);
       return false;
     }
 
@@ -266,7 +268,7 @@ CoDelQueueDisc::DoDequeue (void)
               // rates so high that the next drop should happen now,
               // hence the while loop.
               NS_LOG_LOGIC ("Sojourn time is still above target and it's time for next drop; dropping " << item);
-              DropAfterDequeue (item, TARGET_EXCEEDED_DROP);
+              DropAfterDequeue (item, m_targetExceededDropId);
 
               ++m_count;
               NewtonStep ();
@@ -304,7 +306,7 @@ CoDelQueueDisc::DoDequeue (void)
         {
           // Drop the first packet and enter dropping state unless the queue is empty
           NS_LOG_LOGIC ("Sojourn time goes above target, dropping the first packet " << item << " and entering the dropping state");
-          DropAfterDequeue (item, TARGET_EXCEEDED_DROP);
+          DropAfterDequeue (item, m_targetExceededDropId);
 
           item = GetInternalQueue (0)->Dequeue ();
 
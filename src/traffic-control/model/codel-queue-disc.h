@@ -206,6 +206,8 @@ private:
   uint32_t m_state2;                      //!< Number of times we perform next drop while in dropping state
   uint32_t m_state3;                      //!< Number of times we enter drop state and drop the fist packet
   uint32_t m_states;                      //!< Total number of times we are in state 1, state 2, or state 3
+  uint32_t m_targetExceededDropId;        //!< Identifier of the TARGET_EXCEEDED_DROP reason
+  uint32_t m_overlimitDropId;             //!< Identifier of the OVERLIMIT_DROP reason
 };
 
 } // namespace ns3
@@ -50,6 +50,7 @@ FifoQueueDisc::FifoQueueDisc ()
   : QueueDisc (QueueDiscSizePolicy::SINGLE_INTERNAL_QUEUE)
 {
   NS_LOG_FUNCTION (this);
+  m_limitExceededDropId = RegisterReason (LIMIT_EXCEEDED_DROP);
 }
 
 FifoQueueDisc::~FifoQueueDisc ()
@@ -65,7 +66,7 @@ FifoQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   if (GetCurrentSize () + item > GetMaxSize ())
     {
       NS_LOG_LOGIC ("Queue full -- dropping pkt");
-      DropBeforeEnqueue (item, LIMIT_EXCEEDED_DROP);
+      DropBeforeEnqueue (item, m_limitExceededDropId);
       return false;
     }
 
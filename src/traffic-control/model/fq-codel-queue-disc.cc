@@ -44,7 +44,9 @@ TypeId FqCoDelFlow::GetTypeId (void)
 
 FqCoDelFlow::FqCoDelFlow ()
   : m_deficit (0),
-    m_status (INACTIVE)
+    m_status (INACTIVE),
+    m_index (0),
+    m_next (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -90,6 +92,63 @@ FqCoDelFlow::GetStatus (void) const
 }
 
 
+FqCoDelQueueDisc::FlowList::FlowList ()
+  : m_head (0),
+    m_tail (0)
+{
+}
+
+bool
+FqCoDelQueueDisc::FlowList::IsEmpty (void) const
+{
+  return m_head == 0;
+}
+
+FqCoDelFlow*
+FqCoDelQueueDisc::FlowList::Front (void) const
+{
+  NS_ASSERT (m_head != 0);
+  return m_head;
+}
+
+void
+FqCoDelQueueDisc::FlowList::PushBack (FqCoDelFlow *flow)
+{
+  NS_ASSERT (flow->m_next == 0 && flow != m_tail);
+  if (m_tail == 0)
+    {
+      m_head = flow;
+    }
+  else
+    {
+      m_tail->m_next = flow;
+    }
+  m_tail = flow;
+}
+
+void
+FqCoDelQueueDisc::FlowList::PopFront (void)
+{
+  NS_ASSERT (m_head != 0);
+  FqCoDelFlow *flow = m_head;
+  m_head = flow->m_next;
+  flow->m_next = 0;
+  if (m_head == 0)
+    {
+      m_tail = 0;
+    }
+}
+
+void
+FqCoDelQueueDisc::FlowList::Clear (void)
+{
+  while (m_head != 0)
+    {
+      PopFront ();
+    }
+}
+
+
 NS_OBJECT_ENSURE_REGISTERED (FqCoDelQueueDisc);
 
 TypeId FqCoDelQueueDisc::GetTypeId (void)
@@ -138,6 +197,8 @@ FqCoDelQueueDisc::FqCoDelQueueDisc ()
     m_quantum (0)
 {
   NS_LOG_FUNCTION (this);
+  m_unclassifiedDropId = RegisterReason (UNCLASSIFIED_DROP);
+  m_overlimitDropId = RegisterReason (OVERLIMIT_DROP);
 }
 
 FqCoDelQueueDisc::~FqCoDelQueueDisc ()
@@ -158,6 +219,17 @@ FqCoDelQueueDisc::GetQuantum (void) const
   return m_quantum;
 }
 
+void
+FqCoDelQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_newFlows.Clear ();
+  m_oldFlows.Clear ();
+  m_flowsTable.clear ();
+  m_backlogs.clear ();
+  QueueDisc::DoDispose ();
+}
+
 bool
 FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 {
@@ -180,13 +252,13 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       else
         {
           NS_LOG_ERROR ("No filter has been able to classify this packet, drop it.");
-          DropBeforeEnqueue (item, UNCLASSIFIED_DROP);
+          DropBeforeEnqueue (item, m_unclassifiedDropId);
           return false;
         }
     }
 
-  Ptr<FqCoDelFlow> flow;
-  if (m_flowsIndices.find (h) == m_flowsIndices.end ())
+  Ptr<FqCoDelFlow> &flow = m_flowsTable[h];
+  if (flow == 0)
     {
       NS_LOG_DEBUG ("Creating a new flow queue with index " << h);
       flow = m_flowFactory.Create<FqCoDelFlow> ();
@@ -195,23 +267,22 @@ FqCoDelQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       flow->SetQueueDisc (qd);
       AddQueueDiscClass (flow);
 
-      m_flowsIndices[h] = GetNQueueDiscClasses () - 1;
-    }
-  else
-    {
-      flow = StaticCast<FqCoDelFlow> (GetQueueDiscClass (m_flowsIndices[h]));
+      flow->m_index = GetNQueueDiscClasses () - 1;
+      m_backlogs.push_back (0);
     }
 
   if (flow->GetStatus () == FqCoDelFlow::INACTIVE)
     {
       flow->SetStatus (FqCoDelFlow::NEW_FLOW);
       flow->SetDeficit (m_quantum);
-      m_newFlows.push_back (flow);
+      m_newFlows.PushBack (PeekPointer (flow));
     }
 
-  flow->GetQueueDisc ()->Enqueue (item);
+  Ptr<QueueDisc> qd = flow->GetQueueDisc ();
+  qd->Enqueue (item);
+  m_backlogs[flow->m_index] = qd->GetNBytes ();
 
-  NS_LOG_DEBUG ("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h << "; flow index " << flow->m_index);
 
   if (GetCurrentSize () > GetMaxSize ())
     {
@@ -226,23 +297,23 @@ FqCoDelQueueDisc::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<FqCoDelFlow> flow;
+  FqCoDelFlow *flow = 0;
   Ptr<QueueDiscItem> item;
 
   do
     {
       bool found = false;
 
-      while (!found && !m_newFlows.empty ())
+      while (!found && !m_newFlows.IsEmpty ())
         {
-          flow = m_newFlows.front ();
+          flow = m_newFlows.Front ();
 
           if (flow->GetDeficit () <= 0)
             {
               flow->IncreaseDeficit (m_quantum);
               flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              m_newFlows.PopFront ();
+              m_oldFlows.PushBack (flow);
             }
           else
             {
@@ -251,15 +322,15 @@ FqCoDelQueueDisc::DoDequeue (void)
             }
         }
 
-      while (!found && !m_oldFlows.empty ())
+      while (!found && !m_oldFlows.IsEmpty ())
         {
-          flow = m_oldFlows.front ();
+          flow = m_oldFlows.Front ();
 
           if (flow->GetDeficit () <= 0)
             {
               flow->IncreaseDeficit (m_quantum);
-              m_oldFlows.push_back (flow);
-              m_oldFlows.pop_front ();
+              m_oldFlows.PopFront ();
+              m_oldFlows.PushBack (flow);
             }
           else
             {
@@ -274,21 +345,24 @@ FqCoDelQueueDisc::DoDequeue (void)
           return 0;
         }
 
-      item = flow->GetQueueDisc ()->Dequeue ();
+      Ptr<QueueDisc> qd = flow->GetQueueDisc ();
+      item = qd->Dequeue ();
+      // CoDel may have dropped packets as well
+      m_backlogs[flow->m_index] = qd->GetNBytes ();
 
       if (!item)
         {
           NS_LOG_DEBUG ("Could not get a packet from the selected flow queue");
-          if (!m_newFlows.empty ())
+          if (!m_newFlows.IsEmpty ())
             {
               flow->SetStatus (FqCoDelFlow::OLD_FLOW);
-              m_oldFlows.push_back (flow);
-              m_newFlows.pop_front ();
+              m_newFlows.PopFront ();
+              m_oldFlows.PushBack (flow);
             }
           else
             {
               flow->SetStatus (FqCoDelFlow::INACTIVE);
-              m_oldFlows.pop_front ();
+              m_oldFlows.PopFront ();
             }
         }
       else
@@ -342,6 +416,8 @@ FqCoDelQueueDisc::InitializeParams (void)
   m_queueDiscFactory.Set ("MaxSize", QueueSizeValue (GetMaxSize ()));
   m_queueDiscFactory.Set ("Interval", StringValue (m_interval));
   m_queueDiscFactory.Set ("Target", StringValue (m_target));
+
+  m_flowsTable.assign (m_flows, 0);
 }
 
 uint32_t
@@ -350,32 +426,31 @@ FqCoDelQueueDisc::FqCoDelDrop (void)
   NS_LOG_FUNCTION (this);
 
   uint32_t maxBacklog = 0, index = 0;
-  Ptr<QueueDisc> qd;
 
   /* Queue is full! Find the fat flow and drop packet(s) from it */
-  for (uint32_t i = 0; i < GetNQueueDiscClasses (); i++)
+  for (uint32_t i = 0; i < m_backlogs.size (); i++)
     {
-      qd = GetQueueDiscClass (i)->GetQueueDisc ();
-      uint32_t bytes = qd->GetNBytes ();
-      if (bytes > maxBacklog)
+      if (m_backlogs[i] > maxBacklog)
         {
-          maxBacklog = bytes;
+          maxBacklog = m_backlogs[i];
           index = i;
         }
     }
 
   /* Our goal is to drop half of this fat flow backlog */
   uint32_t len = 0, count = 0, threshold = maxBacklog >> 1;
-  qd = GetQueueDiscClass (index)->GetQueueDisc ();
+  Ptr<QueueDisc> qd = GetQueueDiscClass (index)->GetQueueDisc ();
   Ptr<QueueDiscItem> item;
 
   do
     {
       item = qd->GetInternalQueue (0)->Dequeue ();
-      DropAfterDequeue (item, OVERLIMIT_DROP);
+      DropAfterDequeue (item, m_overlimitDropId);
       len += item->GetSize ();
     } while (++count < m_dropBatchSize && len < threshold);
 
+  m_backlogs[index] = qd->GetNBytes ();
+
   return index;
 }
 
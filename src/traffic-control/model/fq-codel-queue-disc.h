@@ -24,8 +24,7 @@
 
 #include "ns3/queue-disc.h"
 #include "ns3/object-factory.h"
-#include <list>
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -33,6 +32,11 @@ namespace ns3 {
  * \ingroup traffic-control
  *
  * \brief A flow queue used by the FqCoDel queue disc
+ *
+ * A flow is linked into the list of new flows or into the list of old
+ * flows of its queue disc through a pointer to the next flow, so that
+ * the flows can be moved from a list to another in constant time and
+ * without allocating memory.
  */
 
 class FqCoDelFlow : public QueueDiscClass {
@@ -87,8 +91,12 @@ public:
   FlowStatus GetStatus (void) const;
 
 private:
+  friend class FqCoDelQueueDisc;
+
   int32_t m_deficit;    //!< the deficit for this flow
   FlowStatus m_status;  //!< the status of this flow
+  uint32_t m_index;     //!< the index of this flow among the classes of the queue disc
+  FqCoDelFlow *m_next;  //!< the next flow in the list of new or old flows
 };
 
 
@@ -96,6 +104,12 @@ private:
  * \ingroup traffic-control
  *
  * \brief A FqCoDel packet queue disc
+ *
+ * The flow queues are created on demand and stored in a table indexed by
+ * the hash of the packets, so that finding the flow queue of a packet
+ * takes constant time. The byte count of each flow queue is mirrored in a
+ * contiguous array, which is scanned to find the fat flow when the queue
+ * disc is full.
  */
 
 class FqCoDelQueueDisc : public QueueDisc {
@@ -131,6 +145,43 @@ public:
   static constexpr const char* OVERLIMIT_DROP = "Overlimit drop";        //!< Overlimit dropped packets
 
 private:
+  /**
+   * \brief A list of flows linked through their pointer to the next flow
+   */
+  class FlowList
+  {
+  public:
+    FlowList ();
+    /**
+     * \brief Check whether the list is empty
+     * \return true if the list is empty
+     */
+    bool IsEmpty (void) const;
+    /**
+     * \brief Get the first flow of the list
+     * \return the first flow of the list
+     */
+    FqCoDelFlow* Front (void) const;
+    /**
+     * \brief Append a flow to the list
+     * \param flow the flow, which must not belong to any list
+     */
+    void PushBack (FqCoDelFlow *flow);
+    /**
+     * \brief Remove the first flow of the list
+     */
+    void PopFront (void);
+    /**
+     * \brief Remove all the flows from the list
+     */
+    void Clear (void);
+
+  private:
+    FqCoDelFlow *m_head;  //!< the first flow of the list
+    FqCoDelFlow *m_tail;  //!< the last flow of the list
+  };
+
+  virtual void DoDispose (void);
   virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
   virtual Ptr<QueueDiscItem> DoDequeue (void);
   virtual bool CheckConfig (void);
@@ -149,13 +200,17 @@ private:
   uint32_t m_dropBatchSize;  //!< Max number of packets dropped from the fat flow
   uint32_t m_perturbation;   //!< hash perturbation value
 
-  std::list<Ptr<FqCoDelFlow> > m_newFlows;    //!< The list of new flows
-  std::list<Ptr<FqCoDelFlow> > m_oldFlows;    //!< The list of old flows
+  FlowList m_newFlows;    //!< The list of new flows
+  FlowList m_oldFlows;    //!< The list of old flows
 
-  std::map<uint32_t, uint32_t> m_flowsIndices;    //!< Map with the index of class for each flow
+  std::vector<Ptr<FqCoDelFlow> > m_flowsTable;    //!< The flow queue for each hash value, if created
+  std::vector<uint32_t> m_backlogs;               //!< The number of bytes in each flow queue, by class index
 
   ObjectFactory m_flowFactory;         //!< Factory to create a new flow
   ObjectFactory m_queueDiscFactory;    //!< Factory to create a new queue
+
+  uint32_t m_unclassifiedDropId;  //!< Identifier of the UNCLASSIFIED_DROP reason
+  uint32_t m_overlimitDropId;     //!< Identifier of the OVERLIMIT_DROP reason
 };
 
 } // namespace ns3
@@ -103,6 +103,8 @@ PieQueueDisc::PieQueueDisc ()
 {
   NS_LOG_FUNCTION (this);
   m_uv = CreateObject<UniformRandomVariable> ();
+  m_unforcedDropId = RegisterReason (UNFORCED_DROP);
+  m_forcedDropId = RegisterReason (FORCED_DROP);
   m_rtrsEvent = Simulator::Schedule (m_sUpdate, &PieQueueDisc::CalculateP, this);
 }
 
@@ -145,13 +147,13 @@ PieQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   if (nQueued + item > GetMaxSize ())
     {
       // Drops due to queue limit: reactive
-      DropBeforeEnqueue (item, FORCED_DROP);
+      DropBeforeEnqueue (item, m_forcedDropId);
       return false;
     }
   else if (DropEarly (item, nQueued.GetValue ()))
     {
       // Early probability drop: proactive
-      DropBeforeEnqueue (item, UNFORCED_DROP);
+      DropBeforeEnqueue (item, m_unforcedDropId);
       return false;
     }
 
@@ -154,6 +154,8 @@ private:
   uint64_t m_dqCount;                           //!< Number of bytes departed since current measurement cycle starts
   EventId m_rtrsEvent;                          //!< Event used to decide the decision of interval of drop probability calculation
   Ptr<UniformRandomVariable> m_uv;              //!< Rng stream
+  uint32_t m_unforcedDropId;                    //!< Identifier of the UNFORCED_DROP reason
+  uint32_t m_forcedDropId;                      //!< Identifier of the FORCED_DROP reason
 };
 
 };   // namespace ns3
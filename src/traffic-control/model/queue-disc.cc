@@ -29,6 +29,7 @@
 #include "queue-disc.h"
 #include <ns3/drop-tail-queue.h>
 #include "ns3/net-device-queue-interface.h"
+#include <cstring>
 
 namespace ns3 {
 
@@ -261,6 +262,16 @@ std::ostream & operator << (std::ostream &os, const QueueDisc::Stats &stats)
   return os;
 }
 
+QueueDisc::ReasonCounters::ReasonCounters ()
+  : nDroppedPacketsBeforeEnqueue (0),
+    nDroppedBytesBeforeEnqueue (0),
+    nDroppedPacketsAfterDequeue (0),
+    nDroppedBytesAfterDequeue (0),
+    nMarkedPackets (0),
+    nMarkedBytes (0)
+{
+}
+
 NS_OBJECT_ENSURE_REGISTERED (QueueDisc);
 
 TypeId QueueDisc::GetTypeId (void)
@@ -333,6 +344,8 @@ QueueDisc::QueueDisc (QueueDiscSizePolicy policy)
 {
   NS_LOG_FUNCTION (this << (uint16_t)policy);
 
+  m_internalQueueDropId = RegisterReason (INTERNAL_QUEUE_DROP);
+
   // These lambdas call the DropBeforeEnqueue or DropAfterDequeue methods of this
   // QueueDisc object. Given that a callback to the operator() of these lambdas
   // is connected to the DropBeforeEnqueue and DropAfterDequeue traces of the
@@ -340,11 +353,11 @@ QueueDisc::QueueDisc (QueueDiscSizePolicy policy)
   // why the packet is dropped.
   m_internalQueueDbeFunctor = [this] (Ptr<const QueueDiscItem> item)
     {
-      return DropBeforeEnqueue (item, INTERNAL_QUEUE_DROP);
+      return DropBeforeEnqueue (item, m_internalQueueDropId, INTERNAL_QUEUE_DROP);
     };
   m_internalQueueDadFunctor = [this] (Ptr<const QueueDiscItem> item)
     {
-      return DropAfterDequeue (item, INTERNAL_QUEUE_DROP);
+      return DropAfterDequeue (item, m_internalQueueDropId, INTERNAL_QUEUE_DROP);
     };
 
   // These lambdas call the DropBeforeEnqueue or DropAfterDequeue methods of this
@@ -352,16 +365,17 @@ QueueDisc::QueueDisc (QueueDiscSizePolicy policy)
   // is connected to the DropBeforeEnqueue and DropAfterDequeue traces of the
   // child queue discs, the concatenation of the CHILD_QUEUE_DISC_DROP constant
   // and the second argument provided by such traces is passed as the reason why
-  // the packet is dropped.
+  // the packet is dropped. The concatenation is only built the first time a
+  // child queue disc drops a packet for a given reason.
   m_childQueueDiscDbeFunctor = [this] (Ptr<const QueueDiscItem> item, const char* r)
     {
-      return DropBeforeEnqueue (item,
-                                m_childQueueDiscDropMsg.assign (CHILD_QUEUE_DISC_DROP).append (r).data ());
+      uint32_t id = GetChildQueueDiscDropReasonId (r);
+      return DropBeforeEnqueue (item, id, m_reasonNames[id].c_str ());
     };
   m_childQueueDiscDadFunctor = [this] (Ptr<const QueueDiscItem> item, const char* r)
     {
-      return DropAfterDequeue (item,
-                               m_childQueueDiscDropMsg.assign (CHILD_QUEUE_DISC_DROP).append (r).data ());
+      uint32_t id = GetChildQueueDiscDropReasonId (r);
+      return DropAfterDequeue (item, id, m_reasonNames[id].c_str ());
     };
 }
 
@@ -433,6 +447,37 @@ QueueDisc::GetStats (void)
   m_stats.nTotalSentBytes = m_stats.nTotalDequeuedBytes - (m_requeued ? m_requeued->GetSize () : 0)
                             - m_stats.nTotalDroppedBytesAfterDequeue;
 
+  // the counters for each reason are only copied here to avoid to update maps
+  // keyed by strings every time a packet is dropped or marked
+  m_stats.nDroppedPacketsBeforeEnqueue.clear ();
+  m_stats.nDroppedBytesBeforeEnqueue.clear ();
+  m_stats.nDroppedPacketsAfterDequeue.clear ();
+  m_stats.nDroppedBytesAfterDequeue.clear ();
+  m_stats.nMarkedPackets.clear ();
+  m_stats.nMarkedBytes.clear ();
+
+  for (uint32_t id = 0; id < m_reasonCounters.size (); id++)
+    {
+      const ReasonCounters &counters = m_reasonCounters[id];
+      const std::string &name = m_reasonNames[id];
+
+      if (counters.nDroppedPacketsBeforeEnqueue > 0)
+        {
+          m_stats.nDroppedPacketsBeforeEnqueue[name] = counters.nDroppedPacketsBeforeEnqueue;
+          m_stats.nDroppedBytesBeforeEnqueue[name] = counters.nDroppedBytesBeforeEnqueue;
+        }
+      if (counters.nDroppedPacketsAfterDequeue > 0)
+        {
+          m_stats.nDroppedPacketsAfterDequeue[name] = counters.nDroppedPacketsAfterDequeue;
+          m_stats.nDroppedBytesAfterDequeue[name] = counters.nDroppedBytesAfterDequeue;
+        }
+      if (counters.nMarkedPackets > 0)
+        {
+          m_stats.nMarkedPackets[name] = counters.nMarkedPackets;
+          m_stats.nMarkedBytes[name] = counters.nMarkedBytes;
+        }
+    }
+
   return m_stats;
 }
 
@@ -708,8 +753,83 @@ QueueDisc::PacketDequeued (Ptr<const QueueDiscItem> item)
     }
 }
 
+uint32_t
+QueueDisc::RegisterReason (const std::string &name)
+{
+  NS_LOG_FUNCTION (this << name);
+
+  for (uint32_t id = 0; id < m_reasonNames.size (); id++)
+    {
+      if (m_reasonNames[id] == name)
+        {
+          return id;
+        }
+    }
+
+  m_reasonNames.push_back (name);
+  m_reasonCounters.push_back (ReasonCounters ());
+  return m_reasonCounters.size () - 1;
+}
+
+uint32_t
+QueueDisc::GetReasonId (const char* reason)
+{
+  // reasons are usually string constants, hence the address of the string
+  // is looked up first; the content is still compared, because a buffer at
+  // the same address may now hold a different reason
+  for (ReasonIdList::iterator it = m_reasonIds.begin (); it != m_reasonIds.end (); it++)
+    {
+      if (it->first == reason)
+        {
+          if (m_reasonNames[it->second] != reason)
+            {
+              it->second = RegisterReason (reason);
+            }
+          return it->second;
+        }
+    }
+
+  uint32_t id = RegisterReason (reason);
+  m_reasonIds.push_back (std::make_pair (reason, id));
+  return id;
+}
+
+uint32_t
+QueueDisc::GetChildQueueDiscDropReasonId (const char* reason)
+{
+  for (ReasonIdList::iterator it = m_childReasonIds.begin (); it != m_childReasonIds.end (); it++)
+    {
+      if (it->first == reason)
+        {
+          if (std::strcmp (m_reasonNames[it->second].c_str () + std::strlen (CHILD_QUEUE_DISC_DROP),
+                           reason) != 0)
+            {
+              it->second = RegisterReason (std::string (CHILD_QUEUE_DISC_DROP).append (reason));
+            }
+          return it->second;
+        }
+    }
+
+  uint32_t id = RegisterReason (std::string (CHILD_QUEUE_DISC_DROP).append (reason));
+  m_childReasonIds.push_back (std::make_pair (reason, id));
+  return id;
+}
+
 void
 QueueDisc::DropBeforeEnqueue (Ptr<const QueueDiscItem> item, const char* reason)
+{
+  DropBeforeEnqueue (item, GetReasonId (reason), reason);
+}
+
+void
+QueueDisc::DropBeforeEnqueue (Ptr<const QueueDiscItem> item, uint32_t reasonId)
+{
+  NS_ASSERT (reasonId < m_reasonNames.size ());
+  DropBeforeEnqueue (item, reasonId, m_reasonNames[reasonId].c_str ());
+}
+
+void
+QueueDisc::DropBeforeEnqueue (Ptr<const QueueDiscItem> item, uint32_t reasonId, const char* reason)
 {
   NS_LOG_FUNCTION (this << item << reason);
 
@@ -718,26 +838,10 @@ QueueDisc::DropBeforeEnqueue (Ptr<const QueueDiscItem> item, const char* reason)
   m_stats.nTotalDroppedPacketsBeforeEnqueue++;
   m_stats.nTotalDroppedBytesBeforeEnqueue += item->GetSize ();
 
-  // update the number of packets dropped for the given reason
-  std::map<std::string, uint32_t>::iterator itp = m_stats.nDroppedPacketsBeforeEnqueue.find (reason);
-  if (itp != m_stats.nDroppedPacketsBeforeEnqueue.end ())
-    {
-      itp->second++;
-    }
-  else
-    {
-      m_stats.nDroppedPacketsBeforeEnqueue[reason] = 1;
-    }
-  // update the amount of bytes dropped for the given reason
-  std::map<std::string, uint64_t>::iterator itb = m_stats.nDroppedBytesBeforeEnqueue.find (reason);
-  if (itb != m_stats.nDroppedBytesBeforeEnqueue.end ())
-    {
-      itb->second += item->GetSize ();
-    }
-  else
-    {
-      m_stats.nDroppedBytesBeforeEnqueue[reason] = item->GetSize ();
-    }
+  // update the number of packets and the amount of bytes dropped for the given reason
+  ReasonCounters &counters = m_reasonCounters[reasonId];
+  counters.nDroppedPacketsBeforeEnqueue++;
+  counters.nDroppedBytesBeforeEnqueue += item->GetSize ();
 
   NS_LOG_DEBUG ("Total packets/bytes dropped before enqueue: "
                 << m_stats.nTotalDroppedPacketsBeforeEnqueue << " / "
@@ -749,6 +853,19 @@ QueueDisc::DropBeforeEnqueue (Ptr<const QueueDiscItem> item, const char* reason)
 
 void
 QueueDisc::DropAfterDequeue (Ptr<const QueueDiscItem> item, const char* reason)
+{
+  DropAfterDequeue (item, GetReasonId (reason), reason);
+}
+
+void
+QueueDisc::DropAfterDequeue (Ptr<const QueueDiscItem> item, uint32_t reasonId)
+{
+  NS_ASSERT (reasonId < m_reasonNames.size ());
+  DropAfterDequeue (item, reasonId, m_reasonNames[reasonId].c_str ());
+}
+
+void
+QueueDisc::DropAfterDequeue (Ptr<const QueueDiscItem> item, uint32_t reasonId, const char* reason)
 {
   NS_LOG_FUNCTION (this << item << reason);
 
@@ -757,26 +874,10 @@ QueueDisc::DropAfterDequeue (Ptr<const QueueDiscItem> item, const char* reason)
   m_stats.nTotalDroppedPacketsAfterDequeue++;
   m_stats.nTotalDroppedBytesAfterDequeue += item->GetSize ();
 
-  // update the number of packets dropped for the given reason
-  std::map<std::string, uint32_t>::iterator itp = m_stats.nDroppedPacketsAfterDequeue.find (reason);
-  if (itp != m_stats.nDroppedPacketsAfterDequeue.end ())
-    {
-      itp->second++;
-    }
-  else
-    {
-      m_stats.nDroppedPacketsAfterDequeue[reason] = 1;
-    }
-  // update the amount of bytes dropped for the given reason
-  std::map<std::string, uint64_t>::iterator itb = m_stats.nDroppedBytesAfterDequeue.find (reason);
-  if (itb != m_stats.nDroppedBytesAfterDequeue.end ())
-    {
-      itb->second += item->GetSize ();
-    }
-  else
-    {
-      m_stats.nDroppedBytesAfterDequeue[reason] = item->GetSize ();
-    }
+  // update the number of packets and the amount of bytes dropped for the given reason
+  ReasonCounters &counters = m_reasonCounters[reasonId];
+  counters.nDroppedPacketsAfterDequeue++;
+  counters.nDroppedBytesAfterDequeue += item->GetSize ();
 
   // if in the context of a peek request a dequeued packet is dropped, we need
   // to update the statistics and fire the dequeue trace before firing the drop
@@ -799,6 +900,19 @@ QueueDisc::DropAfterDequeue (Ptr<const QueueDiscItem> item, const char* reason)
 
 bool
 QueueDisc::Mark (Ptr<QueueDiscItem> item, const char* reason)
+{
+  return Mark (item, GetReasonId (reason), reason);
+}
+
+bool
+QueueDisc::Mark (Ptr<QueueDiscItem> item, uint32_t reasonId)
+{
+  NS_ASSERT (reasonId < m_reasonNames.size ());
+  return Mark (item, reasonId, m_reasonNames[reasonId].c_str ());
+}
+
+bool
+QueueDisc::Mark (Ptr<QueueDiscItem> item, uint32_t reasonId, const char* reason)
 {
   NS_LOG_FUNCTION (this << item << reason);
 
@@ -812,26 +926,10 @@ QueueDisc::Mark (Ptr<QueueDiscItem> item, const char* reason)
   m_stats.nTotalMarkedPackets++;
   m_stats.nTotalMarkedBytes += item->GetSize ();
 
-  // update the number of packets marked for the given reason
-  std::map<std::string, uint32_t>::iterator itp = m_stats.nMarkedPackets.find (reason);
-  if (itp != m_stats.nMarkedPackets.end ())
-    {
-      itp->second++;
-    }
-  else
-    {
-      m_stats.nMarkedPackets[reason] = 1;
-    }
-  // update the amount of bytes marked for the given reason
-  std::map<std::string, uint64_t>::iterator itb = m_stats.nMarkedBytes.find (reason);
-  if (itb != m_stats.nMarkedBytes.end ())
-    {
-      itb->second += item->GetSize ();
-    }
-  else
-    {
-      m_stats.nMarkedBytes[reason] = item->GetSize ();
-    }
+  // update the number of packets and the amount of bytes marked for the given reason
+  ReasonCounters &counters = m_reasonCounters[reasonId];
+  counters.nMarkedPackets++;
+  counters.nMarkedBytes += item->GetSize ();
 
   NS_LOG_DEBUG ("Total packets/bytes marked: "
                 << m_stats.nTotalMarkedPackets << " / "
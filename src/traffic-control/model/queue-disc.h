@@ -27,6 +27,7 @@
 #include "ns3/queue-item.h"
 #include "ns3/queue-size.h"
 #include <vector>
+#include <deque>
 #include <map>
 #include <functional>
 #include <string>
@@ -167,7 +168,10 @@ enum QueueDiscSizePolicy
  * When a packet is dropped by an internal queue, e.g., because the queue is full,
  * the reason is "Dropped by internal queue". When a packet is dropped by a child
  * queue disc, the reason is "(Dropped by child queue disc) " followed by the
- * reason why the child queue disc dropped the packet.
+ * reason why the child queue disc dropped the packet. Each reason is registered
+ * once and identified by an integer, which subclasses can obtain in advance by
+ * calling RegisterReason. The per-reason maps of the statistics are filled in
+ * by GetStats.
  *
  * The QueueDisc base class provides the SojournTime trace source, which provides
  * the sojourn time of every packet dequeued from a queue disc, including packets
@@ -205,21 +209,21 @@ public:
     uint32_t nTotalDroppedPackets;
     /// Total packets dropped before enqueue
     uint32_t nTotalDroppedPacketsBeforeEnqueue;
-    /// Packets dropped before enqueue, for each reason
+    /// Packets dropped before enqueue, for each reason -- this value is not kept up to date, call GetStats first
     std::map<std::string, uint32_t> nDroppedPacketsBeforeEnqueue;
     /// Total packets dropped after dequeue
     uint32_t nTotalDroppedPacketsAfterDequeue;
-    /// Packets dropped after dequeue, for each reason
+    /// Packets dropped after dequeue, for each reason -- this value is not kept up to date, call GetStats first
     std::map<std::string, uint32_t> nDroppedPacketsAfterDequeue;
     /// Total dropped bytes
     uint64_t nTotalDroppedBytes;
     /// Total bytes dropped before enqueue
     uint64_t nTotalDroppedBytesBeforeEnqueue;
-    /// Bytes dropped before enqueue, for each reason
+    /// Bytes dropped before enqueue, for each reason -- this value is not kept up to date, call GetStats first
     std::map<std::string, uint64_t> nDroppedBytesBeforeEnqueue;
     /// Total bytes dropped after dequeue
     uint64_t nTotalDroppedBytesAfterDequeue;
-    /// Bytes dropped after dequeue, for each reason
+    /// Bytes dropped after dequeue, for each reason -- this value is not kept up to date, call GetStats first
     std::map<std::string, uint64_t> nDroppedBytesAfterDequeue;
     /// Total requeued packets
     uint32_t nTotalRequeuedPackets;
@@ -227,11 +231,11 @@ public:
     uint64_t nTotalRequeuedBytes;
     /// Total marked packets
     uint32_t nTotalMarkedPackets;
-    /// Marked packets, for each reason
+    /// Marked packets, for each reason -- this value is not kept up to date, call GetStats first
     std::map<std::string, uint32_t> nMarkedPackets;
     /// Total marked bytes
     uint32_t nTotalMarkedBytes;
-    /// Marked bytes, for each reason
+    /// Marked bytes, for each reason -- this value is not kept up to date, call GetStats first
     std::map<std::string, uint64_t> nMarkedBytes;
 
     /// constructor
@@ -515,20 +519,38 @@ protected:
    *  \param item item that was dropped
    *  \param reason the reason why the item was dropped
    *  This method must be called by subclasses to record that a packet was
-   *  dropped before enqueue for the specified reason
+   *  dropped before enqueue for the specified reason.
    */
   void DropBeforeEnqueue (Ptr<const QueueDiscItem> item, const char* reason);
 
+  /**
+   *  \brief Perform the actions required when the queue disc is notified of
+   *         a packet dropped before enqueue
+   *  \param item item that was dropped
+   *  \param reasonId the identifier returned by RegisterReason for the reason
+   *         why the item was dropped
+   */
+  void DropBeforeEnqueue (Ptr<const QueueDiscItem> item, uint32_t reasonId);
+
   /**
    *  \brief Perform the actions required when the queue disc is notified of
    *         a packet dropped after dequeue
    *  \param item item that was dropped
    *  \param reason the reason why the item was dropped
    *  This method must be called by subclasses to record that a packet was
-   *  dropped after dequeue for the specified reason
+   *  dropped after dequeue for the specified reason.
    */
   void DropAfterDequeue (Ptr<const QueueDiscItem> item, const char* reason);
 
+  /**
+   *  \brief Perform the actions required when the queue disc is notified of
+   *         a packet dropped after dequeue
+   *  \param item item that was dropped
+   *  \param reasonId the identifier returned by RegisterReason for the reason
+   *         why the item was dropped
+   */
+  void DropAfterDequeue (Ptr<const QueueDiscItem> item, uint32_t reasonId);
+
   /**
    *  \brief Marks the given packet and, if successful, updates the counters
    *         associated with the given reason
@@ -538,6 +560,29 @@ protected:
    */
   bool Mark (Ptr<QueueDiscItem> item, const char* reason);
 
+  /**
+   *  \brief Marks the given packet and, if successful, updates the counters
+   *         associated with the given reason
+   *  \param item item that has to be marked
+   *  \param reasonId the identifier returned by RegisterReason for the reason
+   *         why the item has to be marked
+   *  \return true if the item was successfully marked, false otherwise
+   */
+  bool Mark (Ptr<QueueDiscItem> item, uint32_t reasonId);
+
+  /**
+   *  \brief Register a reason to drop or mark packets, unless a reason with
+   *         the same name is already registered
+   *
+   *  Subclasses can register their reasons once, e.g., in their constructor,
+   *  and pass the returned identifier to DropBeforeEnqueue, DropAfterDequeue
+   *  and Mark, so that the reason is not looked up for every packet.
+   *
+   *  \param name the name of the reason
+   *  \return the identifier of the reason
+   */
+  uint32_t RegisterReason (const std::string &name);
+
 private:
   /**
    * \brief Copy constructor
@@ -658,6 +703,63 @@ private:
    */
   void PacketDequeued (Ptr<const QueueDiscItem> item);
 
+  /**
+   *  \brief Perform the actions required when a packet is dropped before enqueue
+   *  \param item item that was dropped
+   *  \param reasonId the identifier of the reason why the item was dropped
+   *  \param reason the reason why the item was dropped
+   */
+  void DropBeforeEnqueue (Ptr<const QueueDiscItem> item, uint32_t reasonId, const char* reason);
+
+  /**
+   *  \brief Perform the actions required when a packet is dropped after dequeue
+   *  \param item item that was dropped
+   *  \param reasonId the identifier of the reason why the item was dropped
+   *  \param reason the reason why the item was dropped
+   */
+  void DropAfterDequeue (Ptr<const QueueDiscItem> item, uint32_t reasonId, const char* reason);
+
+  /**
+   *  \brief Mark a packet and, if successful, update the counters of the reason
+   *  \param item item that has to be marked
+   *  \param reasonId the identifier of the reason why the item has to be marked
+   *  \param reason the reason why the item has to be marked
+   *  \return true if the item was successfully marked, false otherwise
+   */
+  bool Mark (Ptr<QueueDiscItem> item, uint32_t reasonId, const char* reason);
+
+  /**
+   *  \brief Get the identifier of a reason to drop or mark packets
+   *  \param reason the reason
+   *  \return the identifier of the reason, which is registered if needed
+   */
+  uint32_t GetReasonId (const char* reason);
+
+  /**
+   *  \brief Get the identifier of the reason to drop packets used when a
+   *         child queue disc drops a packet
+   *  \param reason the reason why the child queue disc dropped the packet
+   *  \return the identifier of the reason, which is registered if needed
+   */
+  uint32_t GetChildQueueDiscDropReasonId (const char* reason);
+
+  /// \brief Structure that keeps the number of packets/bytes dropped or marked for a reason
+  struct ReasonCounters
+  {
+    /// constructor
+    ReasonCounters ();
+
+    uint32_t nDroppedPacketsBeforeEnqueue;  //!< Packets dropped before enqueue
+    uint64_t nDroppedBytesBeforeEnqueue;    //!< Bytes dropped before enqueue
+    uint32_t nDroppedPacketsAfterDequeue;   //!< Packets dropped after dequeue
+    uint64_t nDroppedBytesAfterDequeue;     //!< Bytes dropped after dequeue
+    uint32_t nMarkedPackets;                //!< Marked packets
+    uint64_t nMarkedBytes;                  //!< Marked bytes
+  };
+
+  /// Type for the lists associating the address of a reason string with the reason identifier
+  typedef std::vector<std::pair<const char*, uint32_t> > ReasonIdList;
+
   static const uint32_t DEFAULT_QUOTA = 64; //!< Default quota (as in /proc/sys/net/core/dev_weight)
 
   std::vector<Ptr<InternalQueue> > m_queues;    //!< Internal queues
@@ -676,7 +778,11 @@ private:
   bool m_running;                   //!< The queue disc is performing multiple dequeue operations
   Ptr<QueueDiscItem> m_requeued;    //!< The last packet that failed to be transmitted
   bool m_peeked;                    //!< A packet was dequeued because Peek was called
-  std::string m_childQueueDiscDropMsg;  //!< Reason why a packet was dropped by a child queue disc
+  std::deque<std::string> m_reasonNames;         //!< The name of each registered reason
+  std::vector<ReasonCounters> m_reasonCounters;  //!< The counters of each registered reason
+  ReasonIdList m_reasonIds;                      //!< The identifier of the reasons passed by this queue disc
+  ReasonIdList m_childReasonIds;                 //!< The identifier of the reasons passed by the child queue discs
+  uint32_t m_internalQueueDropId;                //!< The identifier of the INTERNAL_QUEUE_DROP reason
   QueueDiscSizePolicy m_sizePolicy;     //!< The queue disc size policy
   bool m_prohibitChangeMode;            //!< True if changing mode is prohibited
 
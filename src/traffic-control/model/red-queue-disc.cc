@@ -229,6 +229,10 @@ RedQueueDisc::RedQueueDisc () :
 {
   NS_LOG_FUNCTION (this);
   m_uv = CreateObject<UniformRandomVariable> ();
+  m_unforcedDropId = RegisterReason (UNFORCED_DROP);
+  m_forcedDropId = RegisterReason (FORCED_DROP);
+  m_unforcedMarkId = RegisterReason (UNFORCED_MARK);
+  m_forcedMarkId = RegisterReason (FORCED_MARK);
 }
 
 RedQueueDisc::~RedQueueDisc ()
@@ -409,20 +413,20 @@ RedQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 
   if (dropType == DTYPE_UNFORCED)
     {
-      if (!m_useEcn || !Mark (item, UNFORCED_MARK))
+      if (!m_useEcn || !Mark (item, m_unforcedMarkId))
         {
           NS_LOG_DEBUG ("\t Dropping due to Prob Mark " << m_qAvg);
-          DropBeforeEnqueue (item, UNFORCED_DROP);
+          DropBeforeEnqueue (item, m_unforcedDropId);
           return false;
         }
       NS_LOG_DEBUG ("\t Marking due to Prob Mark " << m_qAvg);
     }
   else if (dropType == DTYPE_FORCED)
     {
-      if (m_useHardDrop || !m_useEcn || !Mark (item, FORCED_MARK))
+      if (m_useHardDrop || !m_useEcn || !Mark (item, m_forcedMarkId))
         {
           NS_LOG_DEBUG ("\t Dropping due to Hard Mark " << m_qAvg);
-          DropBeforeEnqueue (item, FORCED_DROP);
+          DropBeforeEnqueue (item, m_forcedDropId);
           if (m_isNs1Compat)
             {
               m_count = 0;
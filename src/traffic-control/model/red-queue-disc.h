@@ -312,6 +312,11 @@ private:
   Time m_idleTime;          //!< Start of current idle period
 
   Ptr<UniformRandomVariable> m_uv;  //!< rng stream
+
+  uint32_t m_unforcedDropId;  //!< Identifier of the UNFORCED_DROP reason
+  uint32_t m_forcedDropId;    //!< Identifier of the FORCED_DROP reason
+  uint32_t m_unforcedMarkId;  //!< Identifier of the UNFORCED_MARK reason
+  uint32_t m_forcedMarkId;    //!< Identifier of the FORCED_MARK reason
 };
 
 }; // namespace ns3
@@ -24,6 +24,7 @@
 #include "ns3/drop-tail-queue.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include <cstring>
 #include <map>
 
 using namespace ns3;
@@ -146,7 +147,98 @@ TestChildQueueDisc::InitializeParams (void)
  * \ingroup traffic-control-test
  * \ingroup tests
  *
- * \brief Test Parent Queue Disc having a child of type TestChildQueueDisc
+ * \brief Test Queue Disc that drops every packet before enqueue for a reason
+ * stored in a buffer whose content can be changed, and every packet after
+ * dequeue for a reason registered in advance
+ */
+class TestReasonQueueDisc : public QueueDisc
+{
+public:
+  /**
+   * Constructor
+   */
+  TestReasonQueueDisc ();
+  virtual ~TestReasonQueueDisc ();
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * Set the reason why the next packets are dropped before enqueue
+   * \param reason the reason, which is copied into the same buffer every time
+   */
+  void SetReason (const char* reason);
+  /**
+   * Drop a packet after dequeue
+   * \param item the packet
+   */
+  void DropAfterDequeue (Ptr<const QueueDiscItem> item);
+
+  // Reasons for dropping packets
+  static constexpr const char* AFTER_DEQUEUE = "Registered after dequeue";  //!< Drop after dequeue
+
+private:
+  char m_reason[32];          //!< The reason why packets are dropped before enqueue
+  uint32_t m_afterDequeueId;  //!< Identifier of the AFTER_DEQUEUE reason
+};
+
+TestReasonQueueDisc::TestReasonQueueDisc ()
+  : QueueDisc (QueueDiscSizePolicy::SINGLE_INTERNAL_QUEUE)
+{
+  m_reason[0] = '\0';
+  m_afterDequeueId = RegisterReason (AFTER_DEQUEUE);
+}
+
+TestReasonQueueDisc::~TestReasonQueueDisc ()
+{
+}
+
+void
+TestReasonQueueDisc::SetReason (const char* reason)
+{
+  std::strncpy (m_reason, reason, sizeof (m_reason) - 1);
+  m_reason[sizeof (m_reason) - 1] = '\0';
+}
+
+void
+TestReasonQueueDisc::DropAfterDequeue (Ptr<const QueueDiscItem> item)
+{
+  QueueDisc::DropAfterDequeue (item, m_afterDequeueId);
+}
+
+bool
+TestReasonQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  DropBeforeEnqueue (item, m_reason);
+  return false;
+}
+
+Ptr<QueueDiscItem>
+TestReasonQueueDisc::DoDequeue (void)
+{
+  return GetInternalQueue (0)->Dequeue ();
+}
+
+bool
+TestReasonQueueDisc::CheckConfig (void)
+{
+  AddInternalQueue (CreateObject<DropTailQueue<QueueDiscItem> > ());
+  return true;
+}
+
+void
+TestReasonQueueDisc::InitializeParams (void)
+{
+}
+
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Test Parent Queue Disc having a child of type TestChildQueueDisc,
+ * unless a child queue disc is added before initialization
  */
 class TestParentQueueDisc : public QueueDisc
 {
@@ -186,9 +278,13 @@ TestParentQueueDisc::DoDequeue (void)
 bool
 TestParentQueueDisc::CheckConfig (void)
 {
-  Ptr<QueueDiscClass> c = CreateObject<QueueDiscClass> ();
-  c->SetQueueDisc (CreateObject<TestChildQueueDisc> ());
-  AddQueueDiscClass (c);
+  // a child queue disc may have been added before initialization
+  if (GetNQueueDiscClasses () == 0)
+    {
+      Ptr<QueueDiscClass> c = CreateObject<QueueDiscClass> ();
+      c->SetQueueDisc (CreateObject<TestChildQueueDisc> ());
+      AddQueueDiscClass (c);
+    }
   return true;
 }
 
@@ -555,6 +651,109 @@ QueueDiscTracesTestCase::DoRun (void)
   CheckDroppedBeforeEnqueue (child, 1, pktSizeUnit * 5);
   CheckDroppedAfterDequeue (child, 2, pktSizeUnit * 3);
 
+  // Check the packets/bytes dropped for each reason
+  QueueDisc::Stats stats = child->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.nDroppedPacketsBeforeEnqueue.size (), 1, "Unexpected number of reasons");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (TestChildQueueDisc::BEFORE_ENQUEUE), 1,
+                         "Verify that the number of packets dropped for a reason is computed correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedBytes (TestChildQueueDisc::BEFORE_ENQUEUE), pktSizeUnit * 5,
+                         "Verify that the number of bytes dropped for a reason is computed correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.nDroppedPacketsAfterDequeue.size (), 1, "Unexpected number of reasons");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (TestChildQueueDisc::AFTER_DEQUEUE), 2,
+                         "Verify that the number of packets dropped for a reason is computed correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedBytes (TestChildQueueDisc::AFTER_DEQUEUE), pktSizeUnit * 3,
+                         "Verify that the number of bytes dropped for a reason is computed correctly");
+
+  stats = root->GetStats ();
+  std::string childDbe = std::string (QueueDisc::CHILD_QUEUE_DISC_DROP) + TestChildQueueDisc::BEFORE_ENQUEUE;
+  std::string childDad = std::string (QueueDisc::CHILD_QUEUE_DISC_DROP) + TestChildQueueDisc::AFTER_DEQUEUE;
+  NS_TEST_EXPECT_MSG_EQ (stats.nDroppedPacketsBeforeEnqueue.size (), 1, "Unexpected number of reasons");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (childDbe), 1,
+                         "Verify that the number of packets dropped by the child is computed correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedBytes (childDbe), pktSizeUnit * 5,
+                         "Verify that the number of bytes dropped by the child is computed correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.nDroppedPacketsAfterDequeue.size (), 1, "Unexpected number of reasons");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (childDad), 2,
+                         "Verify that the number of packets dropped by the child is computed correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedBytes (childDad), pktSizeUnit * 3,
+                         "Verify that the number of bytes dropped by the child is computed correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.nMarkedPackets.size (), 0, "No packet should have been marked");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the per-reason statistics when the reasons are passed by
+ * identifier or in a buffer whose content changes
+ *
+ * The child queue disc drops packets before enqueue for a reason that is
+ * always stored at the same address. Every time the content of the buffer
+ * changes, the packets must be counted for the new reason, both by the child
+ * and by the parent queue disc. Packets dropped by passing the identifier of a
+ * reason registered in advance must be counted for that reason.
+ */
+class QueueDiscReasonsTestCase : public TestCase
+{
+public:
+  QueueDiscReasonsTestCase ();
+  virtual void DoRun (void);
+};
+
+QueueDiscReasonsTestCase::QueueDiscReasonsTestCase ()
+  : TestCase ("Check the per-reason statistics of the queue discs")
+{
+}
+
+void
+QueueDiscReasonsTestCase::DoRun (void)
+{
+  Address dest;
+  uint32_t pktSize = 100;
+
+  Ptr<QueueDisc> root = CreateObject<TestParentQueueDisc> ();
+  Ptr<TestReasonQueueDisc> child = CreateObject<TestReasonQueueDisc> ();
+  Ptr<QueueDiscClass> c = CreateObject<QueueDiscClass> ();
+  c->SetQueueDisc (child);
+  root->AddQueueDiscClass (c);
+  root->Initialize ();
+
+  child->SetReason ("First reason");
+  root->Enqueue (Create<qdTestItem> (Create<Packet> (pktSize), dest));
+  root->Enqueue (Create<qdTestItem> (Create<Packet> (pktSize), dest));
+  child->SetReason ("Second reason");
+  root->Enqueue (Create<qdTestItem> (Create<Packet> (pktSize), dest));
+  child->SetReason ("First reason");
+  root->Enqueue (Create<qdTestItem> (Create<Packet> (pktSize), dest));
+  child->DropAfterDequeue (Create<qdTestItem> (Create<Packet> (pktSize), dest));
+
+  QueueDisc::Stats stats = child->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.nDroppedPacketsBeforeEnqueue.size (), 2, "Unexpected number of reasons");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets ("First reason"), 3,
+                         "Packets dropped for a reason whose buffer was reused are not counted correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets ("Second reason"), 1,
+                         "Packets dropped for a reason whose buffer was reused are not counted correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.nDroppedPacketsAfterDequeue.size (), 1, "Unexpected number of reasons");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (TestReasonQueueDisc::AFTER_DEQUEUE), 1,
+                         "Packets dropped for a registered reason are not counted correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedBytes (TestReasonQueueDisc::AFTER_DEQUEUE), pktSize,
+                         "Bytes dropped for a registered reason are not counted correctly");
+
+  stats = root->GetStats ();
+  std::string childFirst = std::string (QueueDisc::CHILD_QUEUE_DISC_DROP) + "First reason";
+  std::string childSecond = std::string (QueueDisc::CHILD_QUEUE_DISC_DROP) + "Second reason";
+  std::string childAfter = std::string (QueueDisc::CHILD_QUEUE_DISC_DROP) + TestReasonQueueDisc::AFTER_DEQUEUE;
+  NS_TEST_EXPECT_MSG_EQ (stats.nDroppedPacketsBeforeEnqueue.size (), 2, "Unexpected number of reasons");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (childFirst), 3,
+                         "Packets dropped by the child for a reused buffer are not counted correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (childSecond), 1,
+                         "Packets dropped by the child for a reused buffer are not counted correctly");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetNDroppedPackets (childAfter), 1,
+                         "Packets dropped by the child for a registered reason are not counted correctly");
+
   Simulator::Destroy ();
 }
 
@@ -572,5 +771,6 @@ public:
     : TestSuite ("queue-disc-traces", UNIT)
   {
     AddTestCase (new QueueDiscTracesTestCase (), TestCase::QUICK);
+    AddTestCase (new QueueDiscReasonsTestCase (), TestCase::QUICK);
   }
 } g_queueDiscTracesTestSuite; ///< the test suite
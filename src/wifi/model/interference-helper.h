@@ -23,7 +23,7 @@
 
 #include "ns3/nstime.h"
 #include "wifi-tx-vector.h"
-#include <map>
+#include <deque>
 
 namespace ns3 {
 
@@ -244,9 +244,12 @@ private:
   };
 
   /**
-   * typedef for a multimap of NiChanges
+   * typedef for a time-ordered sequence of NiChanges. Changes occurring
+   * at the same time are kept in insertion order. A deque is used so that
+   * expired changes can be pruned cheaply from the front while new changes
+   * are mostly inserted close to the back.
    */
-  typedef std::multimap<Time, NiChange> NiChanges;
+  typedef std::deque<std::pair<Time, NiChange> > NiChanges;
 
   /**
    * Append the given Event.
@@ -255,14 +258,16 @@ private:
    */
   void AppendEvent (Ptr<Event> event);
   /**
-   * Calculate noise and interference power in W.
+   * Calculate noise and interference power in W and locate the NI changes
+   * overlapping with the given event.
    *
    * \param event
-   * \param ni
+   * \param first set to the NI change corresponding to the start of the event
+   * \param last set to one past the NI change corresponding to the end of the event
    *
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges::const_iterator *first, NiChanges::const_iterator *last) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    * (Mode is not currently used)
@@ -291,21 +296,23 @@ private:
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param first the NI change corresponding to the start of the event
+   * \param last one past the NI change corresponding to the end of the event
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges::const_iterator first, NiChanges::const_iterator last) const;
   /**
    * Calculate the error rate of the plcp header. The plcp header can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param first the NI change corresponding to the start of the event
+   * \param last one past the NI change corresponding to the end of the event
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges::const_iterator first, NiChanges::const_iterator last) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel; ///< error rate model
@@ -315,6 +322,13 @@ private:
   double m_firstPower; ///< first power
   bool m_rxing; ///< flag whether it is in receiving state
 
+  /**
+   * Returns an iterator to the first nichange that is not earlier than moment
+   *
+   * \param moment time to check from
+   * \returns an iterator to the list of NiChanges
+   */
+  NiChanges::const_iterator GetFirstPosition (Time moment) const;
   /**
    * Returns an iterator to the first nichange that is later than moment
    *
@@ -339,13 +353,13 @@ private:
 
   /**
    * Add NiChange to the list at the appropriate position and
-   * return the iterator of the new event.
+   * return the index of the new event.
    *
    * \param moment
    * \param change
-   * \returns the iterator of the new event
+   * \returns the index of the new event in the list of NiChanges
    */
-  NiChanges::iterator AddNiChangeEvent (Time moment, NiChange change);
+  std::size_t AddNiChangeEvent (Time moment, NiChange change);
 };
 
 } //namespace ns3
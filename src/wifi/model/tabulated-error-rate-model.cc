@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <limits>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "tabulated-error-rate-model.h"
+#include "nist-error-rate-model.h"
+#include "wifi-tx-vector.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TabulatedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TabulatedErrorRateModel);
+
+TypeId
+TabulatedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TabulatedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<TabulatedErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model used to compute the tabulated values. "
+                   "A NistErrorRateModel is used if none is provided.",
+                   PointerValue (),
+                   MakePointerAccessor (&TabulatedErrorRateModel::SetErrorRateModel,
+                                        &TabulatedErrorRateModel::GetErrorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The smallest tabulated SNR (dB). Smaller SNR values are "
+                   "forwarded to the reference error rate model.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::SetMinSnr,
+                                       &TabulatedErrorRateModel::GetMinSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The largest tabulated SNR (dB). Larger SNR values are "
+                   "forwarded to the reference error rate model.",
+                   DoubleValue (60.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::SetMaxSnr,
+                                       &TabulatedErrorRateModel::GetMaxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SnrResolution",
+                   "The distance between two tabulated SNR values (dB).",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::SetSnrResolution,
+                                       &TabulatedErrorRateModel::GetSnrResolution),
+                   MakeDoubleChecker<double> (0.001))
+  ;
+  return tid;
+}
+
+TabulatedErrorRateModel::TabulatedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TabulatedErrorRateModel::~TabulatedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TabulatedErrorRateModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_errorRateModel = 0;
+  m_tables.clear ();
+  ErrorRateModel::DoDispose ();
+}
+
+void
+TabulatedErrorRateModel::SetErrorRateModel (const Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_errorRateModel = model;
+  m_tables.clear ();
+}
+
+Ptr<ErrorRateModel>
+TabulatedErrorRateModel::GetErrorRateModel (void) const
+{
+  return m_errorRateModel;
+}
+
+void
+TabulatedErrorRateModel::SetMinSnr (double snrDb)
+{
+  NS_LOG_FUNCTION (this << snrDb);
+  m_minSnrDb = snrDb;
+  m_tables.clear ();
+}
+
+double
+TabulatedErrorRateModel::GetMinSnr (void) const
+{
+  return m_minSnrDb;
+}
+
+void
+TabulatedErrorRateModel::SetMaxSnr (double snrDb)
+{
+  NS_LOG_FUNCTION (this << snrDb);
+  m_maxSnrDb = snrDb;
+  m_tables.clear ();
+}
+
+double
+TabulatedErrorRateModel::GetMaxSnr (void) const
+{
+  return m_maxSnrDb;
+}
+
+void
+TabulatedErrorRateModel::SetSnrResolution (double resolutionDb)
+{
+  NS_LOG_FUNCTION (this << resolutionDb);
+  m_snrResolutionDb = resolutionDb;
+  m_tables.clear ();
+}
+
+double
+TabulatedErrorRateModel::GetSnrResolution (void) const
+{
+  return m_snrResolutionDb;
+}
+
+const TabulatedErrorRateModel::Table &
+TabulatedErrorRateModel::GetTable (WifiMode mode, WifiTxVector txVector) const
+{
+  //The reference models only depend on the TXVECTOR through the PHY rate
+  //and the channel width, hence the parameters used to build the key
+  uint64_t key = (static_cast<uint64_t> (mode.GetUid ()) << 32)
+    | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 16)
+    | (static_cast<uint64_t> (txVector.GetGuardInterval () & 0x0fff) << 4)
+    | (txVector.GetNss () & 0x0f);
+  auto it = m_tables.find (key);
+  if (it != m_tables.end ())
+    {
+      return it->second;
+    }
+
+  if (m_errorRateModel == 0)
+    {
+      m_errorRateModel = CreateObject<NistErrorRateModel> ();
+    }
+  NS_ABORT_MSG_IF (m_maxSnrDb <= m_minSnrDb, "MaxSnr must be larger than MinSnr");
+  uint32_t nSamples = static_cast<uint32_t> (std::ceil ((m_maxSnrDb - m_minSnrDb) / m_snrResolutionDb)) + 1;
+  NS_LOG_DEBUG ("Computing " << nSamples << " samples for mode " << mode << " and TXVECTOR " << txVector);
+  Table table (nSamples);
+  for (uint32_t i = 0; i < nSamples; i++)
+    {
+      double snr = std::pow (10.0, (m_minSnrDb + i * m_snrResolutionDb) / 10.0);
+      double csr = m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, 1);
+      //-ln(csr) is the per-bit error exponent; its logarithm varies smoothly with the SNR in dB.
+      //This is -infinity when bits are always received and +infinity when they never are.
+      double errorExponent = -std::log (csr);
+      table[i] = (errorExponent > 0) ? std::log (errorExponent) : -std::numeric_limits<double>::infinity ();
+    }
+  return m_tables.insert (std::make_pair (key, table)).first->second;
+}
+
+double
+TabulatedErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
+  if (nbits == 0)
+    {
+      return 1.0;
+    }
+  const Table &table = GetTable (mode, txVector);
+  double position = (10.0 * std::log10 (snr) - m_minSnrDb) / m_snrResolutionDb;
+  if (!(position >= 0) || position >= table.size () - 1)
+    {
+      NS_LOG_DEBUG ("SNR outside of the tabulated range");
+      return m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, nbits);
+    }
+  uint32_t index = static_cast<uint32_t> (position);
+  double low = table[index];
+  double high = table[index + 1];
+  double exponent;
+  if (std::isinf (low) || std::isinf (high))
+    {
+      //interpolation is not possible at the edges of the range where
+      //bits are either always or never received
+      if (low == high)
+        {
+          exponent = low;
+        }
+      else
+        {
+          return m_errorRateModel->GetChunkSuccessRate (mode, txVector, snr, nbits);
+        }
+    }
+  else
+    {
+      exponent = low + (high - low) * (position - index);
+    }
+  double csr = std::exp (-std::exp (exponent) * nbits);
+  NS_LOG_DEBUG ("csr=" << csr);
+  return csr;
+}
+
+} //namespace ns3
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TABULATED_ERROR_RATE_MODEL_H
+#define TABULATED_ERROR_RATE_MODEL_H
+
+#include <map>
+#include <vector>
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * \brief an error rate model that interpolates precomputed success rates
+ *
+ * This model wraps another error rate model (the reference model, which is
+ * a NistErrorRateModel by default) and avoids evaluating its erfc, pow and
+ * coding-gain polynomials for every chunk of every frame.
+ *
+ * All the error rate models provided by the wifi module compute the success
+ * rate of a chunk of \f$n\f$ bits as \f$p(snr)^n\f$, where \f$p(snr)\f$ is
+ * the success rate of a single bit. The first time a given combination of
+ * WifiMode, channel width, guard interval and number of spatial streams is
+ * seen, this model samples \f$\ln p(snr)\f$ from the reference model on a
+ * regular grid of SNR values (expressed in dB) spanning [MinSnr, MaxSnr]
+ * with a step of SnrResolution. Chunk success rates are then obtained by
+ * interpolating \f$\ln(-\ln p(snr))\f$ linearly between the two closest
+ * samples, which makes the result exact in the number of bits. SNR values
+ * outside of the tabulated range are forwarded to the reference model.
+ *
+ * With the default resolution of 0.05 dB, the absolute difference between
+ * the chunk success rates returned by this model and by the Nist or Yans
+ * reference models is below 1e-3 for all OFDM, HT, VHT and HE modes and
+ * chunks from 14 bytes (an ACK) up to the maximum A-MPDU size. Shorter
+ * chunks are within 1e-2, the largest differences being observed where the
+ * coded BER of the reference models saturates (see the wifi-error-rate-models
+ * test suite).
+ */
+class TabulatedErrorRateModel : public ErrorRateModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TabulatedErrorRateModel ();
+  virtual ~TabulatedErrorRateModel ();
+
+  /**
+   * Set the error rate model used to compute the tabulated values.
+   * Tables that have already been computed are discarded.
+   *
+   * \param model the reference error rate model
+   */
+  void SetErrorRateModel (const Ptr<ErrorRateModel> model);
+  /**
+   * Return the error rate model used to compute the tabulated values.
+   *
+   * \return the reference error rate model
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+  /**
+   * Set the smallest tabulated SNR.
+   * Tables that have already been computed are discarded.
+   *
+   * \param snrDb the smallest tabulated SNR (dB)
+   */
+  void SetMinSnr (double snrDb);
+  /**
+   * Return the smallest tabulated SNR.
+   *
+   * \return the smallest tabulated SNR (dB)
+   */
+  double GetMinSnr (void) const;
+  /**
+   * Set the largest tabulated SNR.
+   * Tables that have already been computed are discarded.
+   *
+   * \param snrDb the largest tabulated SNR (dB)
+   */
+  void SetMaxSnr (double snrDb);
+  /**
+   * Return the largest tabulated SNR.
+   *
+   * \return the largest tabulated SNR (dB)
+   */
+  double GetMaxSnr (void) const;
+  /**
+   * Set the distance between two tabulated SNR values.
+   * Tables that have already been computed are discarded.
+   *
+   * \param resolutionDb the distance between two tabulated SNR values (dB)
+   */
+  void SetSnrResolution (double resolutionDb);
+  /**
+   * Return the distance between two tabulated SNR values.
+   *
+   * \return the distance between two tabulated SNR values (dB)
+   */
+  double GetSnrResolution (void) const;
+
+  double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * A table of per-bit success rates, sampled on the SNR grid.
+   * Each sample holds ln(-ln p(snr)), where p(snr) is the success
+   * rate of a single bit.
+   */
+  typedef std::vector<double> Table;
+
+  /**
+   * Return the table for the given mode, computing it if needed.
+   *
+   * \param mode the Wi-Fi mode applicable to the chunk
+   * \param txVector TXVECTOR of the overall transmission
+   *
+   * \return the table for the given mode and TXVECTOR parameters
+   */
+  const Table & GetTable (WifiMode mode, WifiTxVector txVector) const;
+
+  mutable Ptr<ErrorRateModel> m_errorRateModel; ///< the reference error rate model
+  double m_minSnrDb;                    ///< smallest tabulated SNR (dB)
+  double m_maxSnrDb;                    ///< largest tabulated SNR (dB)
+  double m_snrResolutionDb;             ///< distance between two tabulated SNR values (dB)
+  mutable std::map<uint64_t, Table> m_tables; ///< tables indexed by mode and TXVECTOR parameters
+};
+
+} //namespace ns3
+
+#endif /* TABULATED_ERROR_RATE_MODEL_H */
@@ -82,6 +82,15 @@ public:
   uint32_t GetSize (void) const;
 
 private:
+  /// Allow WifiMacQueue to link the item into its per-flow lists
+  friend class WifiMacQueue;
+
+  /**
+   * A list of the positions in a WifiMacQueue of the items belonging to
+   * the same (TID, destination) flow, in queue order
+   */
+  typedef std::list<std::list<Ptr<WifiMacQueueItem> >::const_iterator> FlowItems;
+
   /**
    * \brief Default constructor
    *
@@ -105,6 +114,9 @@ private:
   Ptr<const Packet> m_packet;  //!< The packet contained in this queue item
   WifiMacHeader m_header;      //!< Wifi MAC header associated with the packet
   Time m_tstamp;               //!< timestamp when the packet arrived at the queue
+  FlowItems *m_flow;           //!< the per-flow list of the queue the item is linked into, if any
+  FlowItems::iterator m_flowIt; //!< position of the item in m_flow
+  uint64_t m_flowKey;          //!< key of m_flow in the per-flow lists of the queue
 };
 
 
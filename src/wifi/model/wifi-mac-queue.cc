@@ -90,6 +90,101 @@ WifiMacQueue::TtlExceeded (ConstIterator &it)
   return false;
 }
 
+uint64_t
+WifiMacQueue::GetFlowKey (uint8_t tid, Mac48Address dest)
+{
+  uint8_t buffer[6];
+  dest.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return (key << 8) | tid;
+}
+
+bool
+WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+  NS_ASSERT (pos == Head () || pos == Tail ());
+  bool atHead = (pos == Head ());
+  if (!Queue<WifiMacQueueItem>::DoEnqueue (pos, item))
+    {
+      return false;
+    }
+  if (item->GetHeader ().IsQosData ())
+    {
+      uint64_t key = GetFlowKey (item->GetHeader ().GetQosTid (), item->GetDestinationAddress ());
+      WifiMacQueueItem::FlowItems &flow = m_flows[key];
+      ConstIterator it = atHead ? Head () : std::prev (Tail ());
+      item->m_flow = &flow;
+      item->m_flowKey = key;
+      item->m_flowIt = flow.insert (atHead ? flow.begin () : flow.end (), it);
+    }
+  return true;
+}
+
+void
+WifiMacQueue::Unlink (ConstIterator pos)
+{
+  Ptr<WifiMacQueueItem> item = *pos;
+  if (item->m_flow != 0)
+    {
+      item->m_flow->erase (item->m_flowIt);
+      if (item->m_flow->empty ())
+        {
+          // do not let the map grow with the flows that are no longer active
+          m_flows.erase (item->m_flowKey);
+        }
+      item->m_flow = 0;
+    }
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoDequeue (ConstIterator pos)
+{
+  NS_LOG_FUNCTION (this);
+  if (pos != Tail ())
+    {
+      Unlink (pos);
+    }
+  return Queue<WifiMacQueueItem>::DoDequeue (pos);
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoRemove (ConstIterator pos)
+{
+  NS_LOG_FUNCTION (this);
+  if (pos != Tail ())
+    {
+      Unlink (pos);
+    }
+  return Queue<WifiMacQueueItem>::DoRemove (pos);
+}
+
+bool
+WifiMacQueue::GetFlowHead (uint8_t tid, Mac48Address dest, ConstIterator &it)
+{
+  NS_LOG_FUNCTION (this << +tid << dest);
+  uint64_t key = GetFlowKey (tid, dest);
+  while (true)
+    {
+      // removing the last frame of the flow also removes the flow, hence
+      // the flow is looked up again after each removal
+      auto flow = m_flows.find (key);
+      if (flow == m_flows.end ())
+        {
+          return false;
+        }
+      it = flow->second.front ();
+      if (!TtlExceeded (it))
+        {
+          return true;
+        }
+    }
+}
+
 bool
 WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
 {
@@ -185,18 +280,10 @@ WifiMacQueue::DequeueByTidAndAddress (uint8_t tid,
                                       WifiMacHeader::AddressType type, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  ConstIterator it;
+  if (GetFlowHead (tid, dest, it))
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoDequeue (it);
-            }
-
-          it++;
-        }
+      return DoDequeue (it);
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -245,18 +332,10 @@ WifiMacQueue::PeekByTidAndAddress (uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  for (auto it = Head (); it != Tail (); )
+  ConstIterator it;
+  if (GetFlowHead (tid, dest, it))
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return DoPeek (it);
-            }
-
-          it++;
-        }
+      return DoPeek (it);
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -348,17 +427,21 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
   uint32_t nPackets = 0;
-  for (auto it = Head (); it != Tail (); )
+  auto flow = m_flows.find (GetFlowKey (tid, dest));
+  if (flow != m_flows.end ())
     {
-      if (!TtlExceeded (it))
+      WifiMacQueueItem::FlowItems &items = flow->second;
+      bool last = false;
+      for (auto flowIt = items.begin (); !last; )
         {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
+          // move to the next frame of the flow before the current one is possibly
+          // removed; removing the last frame also removes the flow
+          ConstIterator it = *flowIt++;
+          last = (flowIt == items.end ());
+          if (!TtlExceeded (it))
             {
               nPackets++;
             }
-
-          it++;
         }
     }
   NS_LOG_DEBUG ("returns " << nPackets);
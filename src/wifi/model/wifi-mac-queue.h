@@ -25,6 +25,7 @@
 #define WIFI_MAC_QUEUE_H
 
 #include "wifi-mac-queue-item.h"
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -44,6 +45,12 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * In addition to the FIFO order, QoS data frames are linked into one list
+ * per (TID, destination) flow, so that the methods operating on a given
+ * TID and destination (e.g. DequeueByTidAndAddress) do not need to scan
+ * the frames addressed to other stations. These methods only check the
+ * lifetime of, and possibly drop, the frames of the requested flow.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -235,8 +242,62 @@ private:
    */
   bool TtlExceeded (ConstIterator &it);
 
+  /**
+   * Insert the given item before the given position, as Queue::DoEnqueue,
+   * and link it into the list of its flow if it is a QoS data frame.
+   * Only insertions at the head or at the tail of the queue are supported.
+   *
+   * \param pos the position before which the item is inserted
+   * \param item the item to enqueue
+   * \return true if success, false if the packet has been dropped
+   */
+  bool DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item);
+  /**
+   * Unlink the item at the given position from its flow and dequeue it,
+   * as Queue::DoDequeue.
+   *
+   * \param pos the position of the item to dequeue
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoDequeue (ConstIterator pos);
+  /**
+   * Unlink the item at the given position from its flow and drop it,
+   * as Queue::DoRemove.
+   *
+   * \param pos the position of the item to remove
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoRemove (ConstIterator pos);
+  /**
+   * Unlink the item at the given position from the list of its flow, if any.
+   *
+   * \param pos the position of the item
+   */
+  void Unlink (ConstIterator pos);
+  /**
+   * Remove the frames of the given flow that stayed in the queue for too
+   * long, starting from the oldest one, until a frame that can still be
+   * transmitted is found.
+   *
+   * \param tid the given TID
+   * \param dest the given destination
+   * \param it set to the position of the first frame of the flow that can
+   *           be transmitted, if any
+   * \return true if such a frame has been found, false otherwise
+   */
+  bool GetFlowHead (uint8_t tid, Mac48Address dest, ConstIterator &it);
+  /**
+   * \param tid the given TID
+   * \param dest the given destination
+   * \return the key of the (TID, destination) flow
+   */
+  static uint64_t GetFlowKey (uint8_t tid, Mac48Address dest);
+
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
+  /// positions of the QoS data frames of each (TID, destination) flow;
+  /// a flow is removed as soon as it has no frames left in the queue
+  std::unordered_map<uint64_t, WifiMacQueueItem::FlowItems> m_flows;
 
   NS_LOG_TEMPLATE_DECLARE;                  //!< redefinition of the log component
 };
@@ -304,6 +304,14 @@ WifiPhy::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&WifiPhy::m_frameCaptureModel),
                    MakePointerChecker <FrameCaptureModel> ())
+    .AddAttribute ("TxDurationCacheSize",
+                   "The maximum number of frame durations kept in the cache used by "
+                   "CalculateTxDuration and GetPayloadDuration. The cache is flushed when "
+                   "it is full. Setting this value to 0 disables the cache.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&WifiPhy::SetTxDurationCacheSize,
+                                         &WifiPhy::GetTxDurationCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddTraceSource ("PhyTxBegin",
                      "Trace source indicating a packet "
                      "has begun transmitting over the channel medium",
@@ -372,6 +380,7 @@ WifiPhy::WifiPhy ()
     m_initialChannelNumber (0),
     m_totalAmpduSize (0),
     m_totalAmpduNumSymbols (0),
+    m_txDurationCacheSize (0),
     m_currentEvent (0),
     m_wifiRadioEnergyModel (0)
 {
@@ -395,6 +404,7 @@ WifiPhy::DoDispose (void)
   m_wifiRadioEnergyModel = 0;
   m_deviceRateSet.clear ();
   m_deviceMcsSet.clear ();
+  m_txDurationCache.clear ();
 }
 
 void
@@ -1940,6 +1950,24 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
 
 Time
 WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag)
+{
+  if (!IsTxDurationCacheable (mpdutype, incFlag))
+    {
+      return ComputePayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+    }
+  TxDurationKey key = GetTxDurationKey (size, txVector, frequency, mpdutype, true);
+  TxDurationCache::const_iterator it = m_txDurationCache.find (key);
+  if (it != m_txDurationCache.end ())
+    {
+      return it->second;
+    }
+  Time duration = ComputePayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+  AddTxDuration (key, duration);
+  return duration;
+}
+
+Time
+WifiPhy::ComputePayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag)
 {
   WifiMode payloadMode = txVector.GetMode ();
   WifiPreamble preamble = txVector.GetPreambleType ();
@@ -2225,8 +2253,20 @@ WifiPhy::CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector)
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag)
 {
+  if (!IsTxDurationCacheable (mpdutype, incFlag))
+    {
+      return CalculatePlcpPreambleAndHeaderDuration (txVector)
+             + ComputePayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+    }
+  TxDurationKey key = GetTxDurationKey (size, txVector, frequency, mpdutype, false);
+  TxDurationCache::const_iterator it = m_txDurationCache.find (key);
+  if (it != m_txDurationCache.end ())
+    {
+      return it->second;
+    }
   Time duration = CalculatePlcpPreambleAndHeaderDuration (txVector)
-    + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+    + ComputePayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+  AddTxDuration (key, duration);
   return duration;
 }
 
@@ -2236,6 +2276,77 @@ WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t fre
   return CalculateTxDuration (size, txVector, frequency, NORMAL_MPDU, 0);
 }
 
+bool
+WifiPhy::IsTxDurationCacheable (MpduType mpdutype, uint8_t incFlag) const
+{
+  //the duration of the last MPDU in an A-MPDU depends on the MPDUs that have
+  //been accounted for before it, and incFlag requests these to be updated
+  return m_txDurationCacheSize > 0
+         && (mpdutype == NORMAL_MPDU || (mpdutype == MPDU_IN_AGGREGATE && incFlag == 0));
+}
+
+WifiPhy::TxDurationKey
+WifiPhy::GetTxDurationKey (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, bool payloadOnly)
+{
+  TxDurationKey key;
+  key.txVector = GetTxVectorKey (txVector);
+  key.size = size;
+  key.frequency = frequency;
+  key.type = static_cast<uint16_t> ((mpdutype << 1) | (payloadOnly ? 1 : 0));
+  return key;
+}
+
+uint64_t
+WifiPhy::GetTxVectorKey (WifiTxVector txVector)
+{
+  //Only the TXVECTOR parameters the frame duration depends on are packed
+  //(TX power level, number of TX antennas and aggregation flag are not)
+  return (static_cast<uint64_t> (txVector.GetMode ().GetUid () & 0xffff) << 48)
+         | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 32)
+         | (static_cast<uint64_t> (txVector.GetGuardInterval () & 0x0fff) << 20)
+         | (static_cast<uint64_t> (txVector.GetPreambleType () & 0x0f) << 16)
+         | (static_cast<uint64_t> (txVector.GetNss () & 0x0f) << 12)
+         | (static_cast<uint64_t> (txVector.GetNess () & 0x0f) << 8)
+         | (txVector.IsStbc () ? 1 : 0);
+}
+
+std::size_t
+WifiPhy::TxDurationKeyHash::operator() (const TxDurationKey &key) const
+{
+  uint64_t h = key.txVector;
+  h ^= (static_cast<uint64_t> (key.size) << 24) ^ (static_cast<uint64_t> (key.frequency) << 4) ^ key.type;
+  //mix the bits (finalizer of MurmurHash3)
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<std::size_t> (h);
+}
+
+void
+WifiPhy::AddTxDuration (const TxDurationKey &key, Time duration)
+{
+  if (m_txDurationCache.size () >= m_txDurationCacheSize)
+    {
+      NS_LOG_DEBUG ("TX duration cache full, flushing " << m_txDurationCache.size () << " entries");
+      m_txDurationCache.clear ();
+    }
+  m_txDurationCache.insert (std::make_pair (key, duration));
+}
+
+void
+WifiPhy::SetTxDurationCacheSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_txDurationCacheSize = size;
+  m_txDurationCache.clear ();
+}
+
+uint32_t
+WifiPhy::GetTxDurationCacheSize (void) const
+{
+  return m_txDurationCacheSize;
+}
+
 void
 WifiPhy::NotifyTxBegin (Ptr<const Packet> packet)
 {
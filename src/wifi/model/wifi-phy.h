@@ -27,6 +27,8 @@
 #include "wifi-phy-standard.h"
 #include "interference-helper.h"
 #include "wifi-phy-state-helper.h"
+#include <map>
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -322,6 +324,18 @@ public:
    * \return the duration of the payload
    */
   Time GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag);
+  /**
+   * Set the maximum number of entries of the frame duration cache
+   * used by CalculateTxDuration and GetPayloadDuration. The cache
+   * is flushed. A size of zero disables the cache.
+   *
+   * \param size the maximum number of cached frame durations
+   */
+  void SetTxDurationCacheSize (uint32_t size);
+  /**
+   * \return the maximum number of entries of the frame duration cache
+   */
+  uint32_t GetTxDurationCacheSize (void) const;
 
   /**
    * The WifiPhy::GetNModes() and WifiPhy::GetMode() methods are used
@@ -1508,6 +1522,79 @@ protected:
   EventId m_endPlcpRxEvent;            //!< the end PLCP receive event
 
 private:
+  /**
+   * Key of the frame duration cache
+   */
+  struct TxDurationKey
+  {
+    uint64_t txVector;  //!< packed TXVECTOR parameters (see GetTxVectorKey)
+    uint32_t size;      //!< number of bytes
+    uint16_t frequency; //!< channel center frequency (MHz)
+    uint16_t type;      //!< MPDU type, and whether the key refers to the payload duration only (LSB)
+
+    /**
+     * \param o the key to compare with
+     * \return true if both keys are equal
+     */
+    bool operator== (const TxDurationKey &o) const
+    {
+      return txVector == o.txVector && size == o.size && frequency == o.frequency && type == o.type;
+    }
+  };
+  /**
+   * Hash function for TxDurationKey
+   */
+  struct TxDurationKeyHash
+  {
+    /**
+     * \param key the key to hash
+     * \return the hash of the key
+     */
+    std::size_t operator() (const TxDurationKey &key) const;
+  };
+  typedef std::unordered_map<TxDurationKey, Time, TxDurationKeyHash> TxDurationCache; //!< frame duration cache typedef
+
+  /**
+   * \param size the number of bytes in the packet to send
+   * \param txVector the TXVECTOR used for the transmission of this packet
+   * \param frequency the channel center frequency (MHz)
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::MpduType.
+   * \param incFlag this flag is used to indicate that the static variables need to be update or not
+   *
+   * \return the duration of the payload, bypassing the frame duration cache
+   */
+  Time ComputePayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag);
+  /**
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::MpduType.
+   * \param incFlag this flag is used to indicate that the static variables need to be update or not
+   *
+   * \return true if the duration of such a frame only depends on its arguments and can be cached
+   */
+  bool IsTxDurationCacheable (MpduType mpdutype, uint8_t incFlag) const;
+  /**
+   * \param size the number of bytes in the packet to send
+   * \param txVector the TXVECTOR used for the transmission of this packet
+   * \param frequency the channel center frequency (MHz)
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::MpduType.
+   * \param payloadOnly whether the key refers to the payload duration only
+   *
+   * \return the frame duration cache key
+   */
+  static TxDurationKey GetTxDurationKey (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, bool payloadOnly);
+  /**
+   * \param txVector the TXVECTOR
+   *
+   * \return the TXVECTOR parameters the frame duration depends on, packed in 64 bits
+   */
+  static uint64_t GetTxVectorKey (WifiTxVector txVector);
+  /**
+   * Insert a duration in the frame duration cache, flushing it if it is full.
+   *
+   * \param key the frame duration cache key
+   * \param duration the duration
+   */
+  void AddTxDuration (const TxDurationKey &key, Time duration);
+
   /**
    * \brief post-construction setting of frequency and/or channel number
    *
@@ -1784,6 +1871,9 @@ private:
   uint32_t m_totalAmpduSize;     //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   double m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
 
+  TxDurationCache m_txDurationCache; //!< durations returned by CalculateTxDuration and GetPayloadDuration
+  uint32_t m_txDurationCacheSize;    //!< maximum number of entries in the frame duration cache
+
   Ptr<NetDevice>     m_device;   //!< Pointer to the device
   Ptr<MobilityModel> m_mobility; //!< Pointer to the mobility model
 
@@ -1637,17 +1637,14 @@ WifiRemoteStationManager::GetInfo (Mac48Address address)
   return state->m_info;
 }
 
-WifiRemoteStationState *
-WifiRemoteStationManager::LookupState (Mac48Address address) const
+WifiRemoteStationManager::StationEntry &
+WifiRemoteStationManager::LookupEntry (Mac48Address address) const
 {
-  NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  StationTable::iterator it = m_stationTable.find (address);
+  if (it != m_stationTable.end ())
     {
-      if ((*i)->m_address == address)
-        {
-          NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
-        }
+      NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+      return it->second;
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
   state->m_state = WifiRemoteStationState::BRAND_NEW;
@@ -1667,9 +1664,17 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_htSupported = false;
   state->m_vhtSupported = false;
   state->m_heSupported = false;
-  const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  StationEntry entry;
+  entry.state = state;
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
-  return state;
+  return m_stationTable.insert (std::make_pair (address, entry)).first->second;
+}
+
+WifiRemoteStationState *
+WifiRemoteStationManager::LookupState (Mac48Address address) const
+{
+  NS_LOG_FUNCTION (this << address);
+  return LookupEntry (address).state;
 }
 
 WifiRemoteStation *
@@ -1691,22 +1696,22 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << +tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  StationEntry &entry = LookupEntry (address);
+  if (tid < entry.stations.size () && entry.stations[tid] != 0)
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
-        {
-          return (*i);
-        }
+      return entry.stations[tid];
     }
-  WifiRemoteStationState *state = LookupState (address);
 
   WifiRemoteStation *station = DoCreateStation ();
-  station->m_state = state;
+  station->m_state = entry.state;
   station->m_tid = tid;
   station->m_ssrc = 0;
   station->m_slrc = 0;
-  const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  if (tid >= entry.stations.size ())
+    {
+      entry.stations.resize (tid + 1, 0);
+    }
+  entry.stations[tid] = station;
   return station;
 }
 
@@ -1867,16 +1872,15 @@ void
 WifiRemoteStationManager::Reset (void)
 {
   NS_LOG_FUNCTION (this);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
-    {
-      delete (*i);
-    }
-  m_states.clear ();
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  for (StationTable::const_iterator i = m_stationTable.begin (); i != m_stationTable.end (); i++)
     {
-      delete (*i);
+      delete i->second.state;
+      for (WifiRemoteStation *station : i->second.stations)
+        {
+          delete station;
+        }
     }
-  m_stations.clear ();
+  m_stationTable.clear ();
   m_bssBasicRateSet.clear ();
   m_bssBasicMcsSet.clear ();
 }
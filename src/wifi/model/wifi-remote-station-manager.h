@@ -28,6 +28,7 @@
 #include "ns3/mac48-address.h"
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
+#include <unordered_map>
 
 namespace ns3 {
 
@@ -1387,13 +1388,27 @@ private:
   uint32_t GetNFragments (const WifiMacHeader *header, Ptr<const Packet> packet);
 
   /**
-   * A vector of WifiRemoteStations
+   * The state of a known station, together with the WifiRemoteStation
+   * created for each of its TIDs (indexed by TID, null if not created yet)
    */
-  typedef std::vector <WifiRemoteStation *> Stations;
+  struct StationEntry
+  {
+    WifiRemoteStationState *state;              //!< state of the station
+    std::vector<WifiRemoteStation *> stations;  //!< per-TID information of the station
+  };
   /**
-   * A vector of WifiRemoteStationStates
+   * Known stations, indexed by their address
+   */
+  typedef std::unordered_map <Mac48Address, StationEntry, Mac48AddressHash> StationTable;
+
+  /**
+   * Return the entry of the station associated with the given address,
+   * creating the station state if needed.
+   *
+   * \param address the address of the station
+   * \return the StationEntry corresponding to the address
    */
-  typedef std::vector <WifiRemoteStationState *> StationStates;
+  StationEntry & LookupEntry (Mac48Address address) const;
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -1424,8 +1439,7 @@ private:
   WifiModeList m_bssBasicRateSet; //!< basic rate set
   WifiModeList m_bssBasicMcsSet; //!< basic MCS set
 
-  StationStates m_states;  //!< States of known stations
-  Stations m_stations;     //!< Information for each known stations
+  mutable StationTable m_stationTable; //!< States and per-TID information of known stations
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
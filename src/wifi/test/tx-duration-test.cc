@@ -75,6 +75,17 @@ private:
    */
   bool CheckTxDuration (uint32_t size, WifiMode payloadMode, uint16_t channelWidth, uint16_t guardInterval, WifiPreamble preamble, Time knownDuration);
 
+  /**
+   * Check that the durations retrieved from the frame duration cache of
+   * the PHY are the same as the ones computed by a PHY without cache
+   *
+   * @param cacheSize the maximum number of entries of the frame duration cache
+   *
+   * @return true if values correspond, false otherwise
+   */
+  bool CheckTxDurationCache (uint32_t cacheSize);
+
+  Ptr<YansWifiPhy> m_phy; ///< PHY shared by the checks, so that durations are also retrieved from its cache
 };
 
 TxDurationTest::TxDurationTest ()
@@ -98,7 +109,7 @@ TxDurationTest::CheckPayloadDuration (uint32_t size, WifiMode payloadMode, uint1
   txVector.SetStbc (0);
   txVector.SetNess (0);
   uint16_t testedFrequency = CHANNEL_1_MHZ;
-  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<YansWifiPhy> phy = m_phy;
   if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
       || payloadMode.GetModulationClass () == WIFI_MOD_CLASS_HT
       || payloadMode.GetModulationClass () == WIFI_MOD_CLASS_VHT
@@ -153,7 +164,7 @@ TxDurationTest::CheckTxDuration (uint32_t size, WifiMode payloadMode, uint16_t c
   txVector.SetStbc (0);
   txVector.SetNess (0);
   uint16_t testedFrequency = CHANNEL_1_MHZ;
-  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<YansWifiPhy> phy = m_phy;
   if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
       || payloadMode.GetModulationClass () == WIFI_MOD_CLASS_HT
       || payloadMode.GetModulationClass () == WIFI_MOD_CLASS_VHT
@@ -198,10 +209,56 @@ TxDurationTest::CheckTxDuration (uint32_t size, WifiMode payloadMode, uint16_t c
   return true;
 }
 
+bool
+TxDurationTest::CheckTxDurationCache (uint32_t cacheSize)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetTxDurationCacheSize (cacheSize);
+  Ptr<YansWifiPhy> refPhy = CreateObject<YansWifiPhy> ();
+  refPhy->SetTxDurationCacheSize (0);
+  WifiMode modes[] = {WifiPhy::GetDsssRate11Mbps (), WifiPhy::GetOfdmRate54Mbps (), WifiPhy::GetErpOfdmRate6Mbps (),
+                      WifiPhy::GetHtMcs7 (), WifiPhy::GetVhtMcs8 (), WifiPhy::GetHeMcs11 ()};
+  uint16_t frequencies[] = {CHANNEL_1_MHZ, CHANNEL_36_MHZ};
+  for (unsigned int pass = 0; pass < 2; pass++)
+    {
+      for (WifiMode mode : modes)
+        {
+          for (uint16_t frequency : frequencies)
+            {
+              for (uint32_t size = 14; size < 1600; size += 97)
+                {
+                  WifiTxVector txVector;
+                  txVector.SetMode (mode);
+                  txVector.SetNss (1);
+                  txVector.SetNess (0);
+                  txVector.SetStbc (0);
+                  txVector.SetChannelWidth (mode.GetModulationClass () == WIFI_MOD_CLASS_DSSS ? 22 : 20);
+                  txVector.SetGuardInterval (mode.GetModulationClass () == WIFI_MOD_CLASS_HE ? 800 : 400);
+                  txVector.SetPreambleType (mode.GetModulationClass () == WIFI_MOD_CLASS_HE ? WIFI_PREAMBLE_HE_SU : WIFI_PREAMBLE_LONG);
+                  if (phy->CalculateTxDuration (size, txVector, frequency) != refPhy->CalculateTxDuration (size, txVector, frequency)
+                      || phy->GetPayloadDuration (size, txVector, frequency) != refPhy->GetPayloadDuration (size, txVector, frequency)
+                      || phy->CalculateTxDuration (size, txVector, frequency, MPDU_IN_AGGREGATE, 0)
+                      != refPhy->CalculateTxDuration (size, txVector, frequency, MPDU_IN_AGGREGATE, 0))
+                    {
+                      std::cerr << "size=" << size
+                                << " mode=" << mode
+                                << " frequency=" << frequency
+                                << " cacheSize=" << cacheSize
+                                << std::endl;
+                      return false;
+                    }
+                }
+            }
+        }
+    }
+  return true;
+}
+
 void
 TxDurationTest::DoRun (void)
 {
   bool retval = true;
+  m_phy = CreateObject<YansWifiPhy> ();
 
   //IEEE Std 802.11-2007 Table 18-2 "Example of LENGTH calculations for CCK"
   retval = retval
@@ -424,6 +481,11 @@ TxDurationTest::DoRun (void)
     && CheckTxDuration (14, WifiPhy::GetHeMcs11 (), 160, 3200, WIFI_PREAMBLE_HE_SU, MicroSeconds (60));
 
   NS_TEST_EXPECT_MSG_EQ (retval, true, "an 802.11ax duration failed");
+
+  retval = CheckTxDurationCache (1024)
+    && CheckTxDurationCache (7);
+  NS_TEST_EXPECT_MSG_EQ (retval, true, "a cached duration failed");
+  m_phy = 0;
 }
 
 /**
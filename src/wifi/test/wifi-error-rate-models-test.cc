@@ -22,7 +22,11 @@
 #include "ns3/test.h"
 #include "ns3/nist-error-rate-model.h"
 #include "ns3/dsss-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/tabulated-error-rate-model.h"
 #include "ns3/wifi-tx-vector.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/double.h"
 
 using namespace ns3;
 
@@ -291,6 +295,112 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Tabulated
+ *
+ * Check that the chunk success rates interpolated by the
+ * TabulatedErrorRateModel match those of the reference models.
+ */
+class WifiErrorRateModelsTestCaseTabulated : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTabulated ();
+  virtual ~WifiErrorRateModelsTestCaseTabulated ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the tabulated model against its reference model for the given
+   * mode and channel width, over a range of SNR values and chunk sizes.
+   *
+   * \param tabulated the tabulated error rate model
+   * \param reference the reference error rate model
+   * \param mode the Wi-Fi mode
+   * \param channelWidth the channel width in MHz
+   */
+  void CheckMode (Ptr<TabulatedErrorRateModel> tabulated, Ptr<ErrorRateModel> reference,
+                  WifiMode mode, uint16_t channelWidth);
+};
+
+WifiErrorRateModelsTestCaseTabulated::WifiErrorRateModelsTestCaseTabulated ()
+  : TestCase ("WifiErrorRateModel test case Tabulated")
+{
+}
+
+WifiErrorRateModelsTestCaseTabulated::~WifiErrorRateModelsTestCaseTabulated ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTabulated::CheckMode (Ptr<TabulatedErrorRateModel> tabulated, Ptr<ErrorRateModel> reference,
+                                                 WifiMode mode, uint16_t channelWidth)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (mode);
+  txVector.SetChannelWidth (channelWidth);
+  txVector.SetGuardInterval (mode.GetModulationClass () == WIFI_MOD_CLASS_HE ? 800 : 400);
+  txVector.SetNss (1);
+  // chunk sizes range from a single bit to the largest VHT A-MPDU
+  uint64_t sizes[] = {1, 7, 8 * 14, 8 * 1500, 8 * 65535, 8 * 1048575};
+  // SNR values are deliberately not aligned on the tabulated grid
+  for (double snr = -12.0; snr < 65.0; snr += 0.37)
+    {
+      for (uint64_t nbits : sizes)
+        {
+          double expected = reference->GetChunkSuccessRate (mode, txVector, std::pow (10.0, snr / 10.0), nbits);
+          double actual = tabulated->GetChunkSuccessRate (mode, txVector, std::pow (10.0, snr / 10.0), nbits);
+          // chunks shorter than an ACK are less accurate where the coded BER saturates
+          double tolerance = (nbits < 8 * 14) ? 1e-2 : 1e-3;
+          NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, tolerance, "Mode " << mode << " SNR " << snr << " dB nbits " << nbits);
+        }
+    }
+}
+
+void
+WifiErrorRateModelsTestCaseTabulated::DoRun (void)
+{
+  WifiMode modes[] = {WifiPhy::GetOfdmRate6Mbps (), WifiPhy::GetOfdmRate12Mbps (), WifiPhy::GetOfdmRate54Mbps (),
+                      WifiPhy::GetHtMcs0 (), WifiPhy::GetHtMcs4 (), WifiPhy::GetHtMcs7 (),
+                      WifiPhy::GetVhtMcs5 (), WifiPhy::GetVhtMcs8 (), WifiPhy::GetVhtMcs9 (),
+                      WifiPhy::GetHeMcs2 (), WifiPhy::GetHeMcs10 (), WifiPhy::GetHeMcs11 ()};
+
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<TabulatedErrorRateModel> tabulatedNist = CreateObject<TabulatedErrorRateModel> ();
+  tabulatedNist->SetErrorRateModel (nist);
+  Ptr<YansErrorRateModel> yans = CreateObject<YansErrorRateModel> ();
+  Ptr<TabulatedErrorRateModel> tabulatedYans = CreateObject<TabulatedErrorRateModel> ();
+  tabulatedYans->SetErrorRateModel (yans);
+
+  for (WifiMode mode : modes)
+    {
+      if (mode.GetModulationClass () != WIFI_MOD_CLASS_VHT || mode.IsAllowed (20, 1))
+        {
+          CheckMode (tabulatedNist, nist, mode, 20);
+          CheckMode (tabulatedYans, yans, mode, 20);
+        }
+      if (mode.GetModulationClass () == WIFI_MOD_CLASS_VHT || mode.GetModulationClass () == WIFI_MOD_CLASS_HE)
+        {
+          CheckMode (tabulatedNist, nist, mode, 80);
+          CheckMode (tabulatedYans, yans, mode, 80);
+        }
+    }
+
+  // the default reference model is the NistErrorRateModel
+  Ptr<TabulatedErrorRateModel> tabulated = CreateObject<TabulatedErrorRateModel> ();
+  WifiTxVector txVector;
+  double ps = tabulated->GetChunkSuccessRate (WifiPhy::GetOfdmRate6Mbps (), txVector, std::pow (10.0, 4.0 / 10.0), 2000 * 8);
+  NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.885, 0.001, "Not equal within tolerance");
+
+  // changing the tabulated range after the tables are built discards them
+  CheckMode (tabulated, nist, WifiPhy::GetOfdmRate6Mbps (), 20);
+  tabulated->SetAttribute ("MinSnr", DoubleValue (-5.0));
+  tabulated->SetAttribute ("SnrResolution", DoubleValue (0.02));
+  CheckMode (tabulated, nist, WifiPhy::GetOfdmRate6Mbps (), 20);
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -308,6 +418,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTabulated, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
@@ -43,6 +43,8 @@
 #include "ns3/wifi-phy-tag.h"
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/mgt-headers.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/enum.h"
 
 using namespace ns3;
 
@@ -237,6 +239,133 @@ public:
 };
 
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that the per-(TID, destination) operations of the WifiMacQueue
+ * return the frames of the requested flow in FIFO order and drop the frames
+ * that stayed in the queue for too long
+ */
+class WifiMacQueueFlowTest : public TestCase
+{
+public:
+  WifiMacQueueFlowTest ();
+  virtual void DoRun (void);
+
+
+private:
+  /**
+   * Enqueue a QoS data frame
+   *
+   * \param tid the TID of the frame
+   * \param dest the destination of the frame
+   * \param size the size of the packet, used to identify it
+   */
+  void Enqueue (uint8_t tid, Mac48Address dest, uint32_t size);
+  /**
+   * Check the frames of the queue, after the lifetime of the first frames has elapsed
+   */
+  void CheckExpiry (void);
+
+  Ptr<WifiMacQueue> m_queue; ///< the queue
+  Mac48Address m_sta1;       ///< first destination
+  Mac48Address m_sta2;       ///< second destination
+};
+
+WifiMacQueueFlowTest::WifiMacQueueFlowTest ()
+  : TestCase ("Check the per-flow operations of the WifiMacQueue")
+{
+}
+
+void
+WifiMacQueueFlowTest::Enqueue (uint8_t tid, Mac48Address dest, uint32_t size)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (tid);
+  hdr.SetAddr1 (dest);
+  m_queue->Enqueue (Create<WifiMacQueueItem> (Create<Packet> (size), hdr));
+}
+
+void
+WifiMacQueueFlowTest::CheckExpiry (void)
+{
+  //the frames enqueued at time 0 have expired
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_sta1), 1, "Expired frames must not be counted");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, WifiMacHeader::ADDR1, m_sta1)->GetPacket ()->GetSize (), 30,
+                         "Expired frames must not be returned");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (3, WifiMacHeader::ADDR1, m_sta2), 0,
+                         "Expired frames must not be returned");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (), 2, "Unexpected number of frames in the queue");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetTotalDroppedPackets (), 3, "Expired frames must be dropped");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (0, WifiMacHeader::ADDR1, m_sta1)->GetPacket ()->GetSize (), 30,
+                         "Unexpected frame");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue ()->GetPacket ()->GetSize (), 31, "Unexpected frame");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), true, "The queue should be empty");
+}
+
+void
+WifiMacQueueFlowTest::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxSize (QueueSize ("4p"));
+  m_queue->SetAttribute ("DropPolicy", EnumValue (WifiMacQueue::DROP_OLDEST));
+  m_sta1 = Mac48Address ("00:00:00:00:00:01");
+  m_sta2 = Mac48Address ("00:00:00:00:00:02");
+
+  Enqueue (0, m_sta1, 10);
+  Enqueue (3, m_sta2, 11);
+  Enqueue (0, m_sta1, 12);
+  Enqueue (3, m_sta1, 13);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_sta1), 2, "Unexpected number of frames");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (3, m_sta1), 1, "Unexpected number of frames");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_sta2), 0, "Unexpected number of frames");
+
+  //the queue is full: the oldest frame is dropped, and the flow is updated accordingly
+  Enqueue (0, m_sta1, 14);
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetTotalDroppedPackets (), 1, "The oldest frame should have been dropped");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_sta1), 2, "Unexpected number of frames");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (0, WifiMacHeader::ADDR1, m_sta1)->GetPacket ()->GetSize (), 12,
+                         "Unexpected frame");
+
+  //a frame pushed at the front of the queue is also the first frame of its flow
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  hdr.SetAddr1 (m_sta1);
+  Ptr<Packet> pushed = Create<Packet> (15);
+  m_queue->Remove ();
+  m_queue->PushFront (Create<WifiMacQueueItem> (pushed, hdr));
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (0, WifiMacHeader::ADDR1, m_sta1)->GetPacket (), pushed,
+                         "Unexpected frame");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (0, m_sta1), 2, "Unexpected number of frames");
+
+  //frames removed by the other methods are also removed from their flow
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Dequeue ()->GetPacket ()->GetSize (), 12, "Unexpected frame");
+  Ptr<const Packet> packet = m_queue->PeekByTidAndAddress (3, WifiMacHeader::ADDR1, m_sta1)->GetPacket ();
+  NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (packet), true, "The frame should have been removed");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->PeekByTidAndAddress (3, WifiMacHeader::ADDR1, m_sta1), 0, "The flow should be empty");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (0, WifiMacHeader::ADDR1, m_sta1)->GetPacket ()->GetSize (), 14,
+                         "Unexpected frame");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->DequeueByTidAndAddress (0, WifiMacHeader::ADDR1, m_sta1), 0, "The flow should be empty");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), true, "The queue should be empty");
+
+  //frames that stayed in the queue for too long are dropped
+  m_queue->SetMaxDelay (MilliSeconds (10));
+  m_queue->ResetStatistics ();
+  Enqueue (0, m_sta1, 20);
+  Enqueue (3, m_sta2, 21);
+  Enqueue (0, m_sta1, 22);
+  Simulator::Schedule (MilliSeconds (5), &WifiMacQueueFlowTest::Enqueue, this, 0, m_sta1, 30);
+  Simulator::Schedule (MilliSeconds (5), &WifiMacQueueFlowTest::Enqueue, this, 1, m_sta2, 31);
+  Simulator::Schedule (MilliSeconds (12), &WifiMacQueueFlowTest::CheckExpiry, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_queue = 0;
+}
+
+
 /**
  * See \bugid{991}
  */
@@ -1707,6 +1836,7 @@ WifiTestSuite::WifiTestSuite ()
 {
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueFlowTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new DcfImmediateAccessBroadcastTestCase, TestCase::QUICK);
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
@@ -0,0 +1,300 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the downlink data plane of the
+// EpcSgwPgwApplication: the lookup of the UE, the classification of the
+// packets against the TFTs of its bearers and the GTP-U encapsulation.
+// The application is installed on a node whose S1-U interface is a
+// SimpleNetDevice, and the S11 interface is driven directly, without
+// MME and eNBs. Each UE has a default bearer and a number of dedicated
+// bearers, each matching a range of remote ports, and receives packets
+// from a number of flows with different remote ports. The packets are
+// handed to the application as if they came from its TUN device, and
+// the wall clock time spent by the application is measured.
+// Sample usage:
+//   ./waf --run 'bench-epc-sgw-pgw --ues=10000 --bearers=4 --flows=8'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/virtual-net-device.h"
+#include "ns3/epc-sgw-pgw-application.h"
+#include "ns3/epc-gtpu-header.h"
+#include "ns3/epc-s11-sap.h"
+#include "ns3/epc-tft.h"
+#include "ns3/eps-bearer.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/// Port range of the remote hosts matched by each dedicated bearer
+static const uint16_t g_portsPerBearer = 1000;
+
+/**
+ * MME side of the S11 SAP, which ignores all the messages of the SGW
+ */
+class BenchMme : public EpcS11SapMme
+{
+public:
+  virtual void CreateSessionResponse (CreateSessionResponseMessage msg)
+  {
+  }
+  virtual void DeleteBearerRequest (DeleteBearerRequestMessage msg)
+  {
+  }
+  virtual void ModifyBearerResponse (ModifyBearerResponseMessage msg)
+  {
+  }
+};
+
+/**
+ * Feeds downlink packets to the SGW/PGW and measures its processing time
+ */
+class SgwPgwBench
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param app the SGW/PGW application
+   * \param ueAddresses the addresses of the UEs
+   * \param nFlows the number of flows of each UE
+   * \param nBearers the number of bearers of each UE
+   * \param packetSize the size of the UDP payload of the packets
+   */
+  SgwPgwBench (Ptr<EpcSgwPgwApplication> app, std::vector<Ipv4Address> ueAddresses,
+               uint32_t nFlows, uint32_t nBearers, uint32_t packetSize);
+
+  /**
+   * Send a packet to the SGW/PGW every nanosecond
+   *
+   * \param nPackets the number of packets
+   */
+  void Run (uint32_t nPackets);
+
+  /// \return the total time spent by the SGW/PGW, in ns
+  double GetTotalNs () const;
+
+private:
+  /// Send the next packet
+  void SendPacket ();
+
+  Ptr<EpcSgwPgwApplication> m_app;        ///< the SGW/PGW
+  std::vector<Ipv4Address> m_ueAddresses; ///< the UE addresses
+  uint32_t m_nFlows;                      ///< number of flows of each UE
+  uint32_t m_nBearers;                    ///< number of bearers of each UE
+  uint32_t m_packetSize;                  ///< UDP payload size
+  uint32_t m_remainingPackets;            ///< number of packets still to be sent
+  Ptr<UniformRandomVariable> m_random;    ///< selects the UE and flow of each packet
+  std::chrono::steady_clock::duration m_total; ///< time spent by the SGW/PGW
+};
+
+SgwPgwBench::SgwPgwBench (Ptr<EpcSgwPgwApplication> app, std::vector<Ipv4Address> ueAddresses,
+                          uint32_t nFlows, uint32_t nBearers, uint32_t packetSize)
+  : m_app (app),
+    m_ueAddresses (ueAddresses),
+    m_nFlows (nFlows),
+    m_nBearers (nBearers),
+    m_packetSize (packetSize),
+    m_remainingPackets (0),
+    m_total (std::chrono::steady_clock::duration::zero ())
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+}
+
+void
+SgwPgwBench::Run (uint32_t nPackets)
+{
+  m_remainingPackets = nPackets;
+  Simulator::ScheduleNow (&SgwPgwBench::SendPacket, this);
+  Simulator::Run ();
+}
+
+double
+SgwPgwBench::GetTotalNs () const
+{
+  return std::chrono::duration<double, std::nano> (m_total).count ();
+}
+
+void
+SgwPgwBench::SendPacket ()
+{
+  uint32_t ue = m_random->GetInteger (0, m_ueAddresses.size () - 1);
+  uint32_t flow = m_random->GetInteger (0, m_nFlows - 1);
+  // spread the flows over the bearers (including the default one)
+  uint16_t remotePort = 1 + (flow % m_nBearers) * g_portsPerBearer + flow / m_nBearers;
+
+  Ptr<Packet> packet = Create<Packet> (m_packetSize);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (remotePort);
+  udpHeader.SetDestinationPort (1234);
+  packet->AddHeader (udpHeader);
+  Ipv4Header ipv4Header;
+  ipv4Header.SetSource (Ipv4Address ("1.0.0.2"));
+  ipv4Header.SetDestination (m_ueAddresses[ue]);
+  ipv4Header.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  ipv4Header.SetPayloadSize (packet->GetSize ());
+  ipv4Header.SetTtl (63);
+  packet->AddHeader (ipv4Header);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  m_app->RecvFromTunDevice (packet, Address (), Address (), Ipv4L3Protocol::PROT_NUMBER);
+  m_total += std::chrono::steady_clock::now () - start;
+
+  if (--m_remainingPackets > 0)
+    {
+      Simulator::Schedule (NanoSeconds (1), &SgwPgwBench::SendPacket, this);
+    }
+}
+
+/**
+ * Count the GTP-U packets received by the eNBs, by bearer. The TEIDs are
+ * allocated in sequence to the bearers of the UEs, so that the bearer of
+ * a packet can be told from its TEID.
+ *
+ * \param packetsPerBearer the counters
+ * \param device the receiving device
+ * \param packet the packet received on the S1-U interface
+ * \param protocol the protocol number
+ * \param from the sender
+ * \return true
+ */
+static bool
+CountTeid (std::vector<uint32_t> *packetsPerBearer, Ptr<NetDevice> device,
+           Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  Ptr<Packet> p = packet->Copy ();
+  Ipv4Header ipv4Header;
+  p->RemoveHeader (ipv4Header);
+  UdpHeader udpHeader;
+  p->RemoveHeader (udpHeader);
+  GtpuHeader gtpu;
+  p->RemoveHeader (gtpu);
+  (*packetsPerBearer)[(gtpu.GetTeid () - 1) % packetsPerBearer->size ()]++;
+  return true;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nUes = 10000;
+  uint32_t nBearers = 4;
+  uint32_t nFlows = 8;
+  uint32_t nEnbs = 100;
+  uint32_t nPackets = 500000;
+  uint32_t packetSize = 1000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the downlink data plane of the EpcSgwPgwApplication.");
+  cmd.AddValue ("ues", "number of UEs", nUes);
+  cmd.AddValue ("bearers", "number of bearers of each UE, including the default bearer (at most 16)", nBearers);
+  cmd.AddValue ("flows", "number of flows to each UE", nFlows);
+  cmd.AddValue ("enbs", "number of eNBs", nEnbs);
+  cmd.AddValue ("packets", "number of packets", nPackets);
+  cmd.AddValue ("packetSize", "size of the UDP payload of the packets", packetSize);
+  cmd.Parse (argc, argv);
+  NS_ABORT_MSG_IF (nBearers < 1 || nBearers > 16, "the number of bearers must be between 1 and 16");
+
+  // the SGW/PGW node, with its S1-U interface; a bare device on the
+  // other side of the S1-U link stands for all the eNBs
+  Ptr<Node> pgw = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (pgw);
+  Ptr<SimpleChannel> s1uChannel = CreateObject<SimpleChannel> ();
+  Ptr<SimpleNetDevice> s1uDevice = CreateObject<SimpleNetDevice> ();
+  s1uDevice->SetAttribute ("PointToPointMode", BooleanValue (true));
+  s1uDevice->SetAddress (Mac48Address::Allocate ());
+  s1uDevice->SetChannel (s1uChannel);
+  pgw->AddDevice (s1uDevice);
+  Ipv4AddressHelper s1uAddresses ("10.0.0.0", "255.0.0.0");
+  Ipv4Address sgwAddress = s1uAddresses.Assign (NetDeviceContainer (s1uDevice)).GetAddress (0);
+  Ptr<SimpleNetDevice> enbDevice = CreateObject<SimpleNetDevice> ();
+  enbDevice->SetAttribute ("PointToPointMode", BooleanValue (true));
+  enbDevice->SetAddress (Mac48Address::Allocate ());
+  enbDevice->SetChannel (s1uChannel);
+  CreateObject<Node> ()->AddDevice (enbDevice);
+  std::vector<uint32_t> packetsPerBearer (nBearers, 0);
+  enbDevice->SetReceiveCallback (MakeBoundCallback (&CountTeid, &packetsPerBearer));
+
+  Ptr<Socket> s1uSocket = Socket::CreateSocket (pgw, UdpSocketFactory::GetTypeId ());
+  s1uSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 2152));
+  Ptr<VirtualNetDevice> tunDevice = CreateObject<VirtualNetDevice> ();
+  Ptr<EpcSgwPgwApplication> app = CreateObject<EpcSgwPgwApplication> (tunDevice, s1uSocket);
+  pgw->AddApplication (app);
+  BenchMme mme;
+  app->SetS11SapMme (&mme);
+
+  for (uint16_t cellId = 1; cellId <= nEnbs; cellId++)
+    {
+      app->AddEnb (cellId, Ipv4Address (sgwAddress.Get () + cellId), sgwAddress);
+    }
+
+  // the UEs and their bearers
+  std::vector<Ipv4Address> ueAddresses;
+  Ipv4AddressHelper ueAddressHelper ("7.0.0.0", "255.0.0.0", "0.0.0.2");
+  for (uint64_t imsi = 1; imsi <= nUes; imsi++)
+    {
+      Ipv4Address ueAddress = ueAddressHelper.NewAddress ();
+      ueAddresses.push_back (ueAddress);
+      app->AddUe (imsi);
+      app->SetUeAddress (imsi, ueAddress);
+
+      EpcS11SapSgw::CreateSessionRequestMessage msg;
+      msg.imsi = imsi;
+      msg.uli.gci = 1 + imsi % nEnbs;
+      for (uint8_t bearerId = 1; bearerId <= nBearers; bearerId++)
+        {
+          EpcS11SapSgw::BearerContextToBeCreated bearerContext;
+          bearerContext.epsBearerId = bearerId;
+          if (bearerId == 1)
+            {
+              bearerContext.bearerLevelQos = EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT);
+              bearerContext.tft = EpcTft::Default ();
+            }
+          else
+            {
+              bearerContext.bearerLevelQos = EpsBearer (EpsBearer::NGBR_VIDEO_TCP_PREMIUM);
+              bearerContext.tft = Create<EpcTft> ();
+              EpcTft::PacketFilter filter;
+              filter.remotePortStart = 1 + (bearerId - 1) * g_portsPerBearer;
+              filter.remotePortEnd = bearerId * g_portsPerBearer;
+              bearerContext.tft->Add (filter);
+            }
+          msg.bearerContextsToBeCreated.push_back (bearerContext);
+        }
+      app->GetS11SapSgw ()->CreateSessionRequest (msg);
+    }
+
+  std::cout << nUes << " UEs, " << nBearers << " bearers and " << nFlows << " flows per UE, "
+            << nPackets << " packets of " << packetSize << " bytes" << std::endl;
+  SgwPgwBench bench (app, ueAddresses, nFlows, nBearers, packetSize);
+  bench.Run (nPackets);
+  double totalNs = bench.GetTotalNs ();
+  std::cout << std::fixed << std::setprecision (1)
+            << "mean time per packet " << totalNs / nPackets << " ns, "
+            << nPackets / totalNs * 1e6 << " kpacket/s" << std::endl;
+  std::cout << "packets per bearer:";
+  for (uint32_t i = 0; i < nBearers; i++)
+    {
+      std::cout << " " << packetsPerBearer[i];
+    }
+  std::cout << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the FqCoDel queue disc with a
+// large number of concurrent flows.  At every tick, packets of randomly
+// chosen flows are enqueued and a smaller number of packets is dequeued,
+// so that the queue disc fills up and both the CoDel and the overlimit
+// drops are exercised.  The wall-clock time and the statistics of the
+// queue disc are printed.
+// Sample usage:
+//   ./waf --run 'bench-fq-codel --flows=10000 --time=1'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/traffic-control-module.h"
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Enqueue and dequeue a batch of packets, then reschedule itself
+ *
+ * \param queueDisc the queue disc
+ * \param flows the flow chosen for each packet
+ * \param arrivals the number of packets to enqueue
+ * \param departures the number of packets to dequeue
+ * \param tick the time between two batches
+ */
+static void
+Tick (Ptr<FqCoDelQueueDisc> queueDisc, Ptr<UniformRandomVariable> flows,
+      uint32_t arrivals, uint32_t departures, Time tick)
+{
+  for (uint32_t i = 0; i < arrivals; i++)
+    {
+      uint32_t flow = flows->GetInteger ();
+      Ipv4Header hdr;
+      hdr.SetPayloadSize (1000);
+      hdr.SetSource (Ipv4Address (0x0a000000 + flow));
+      hdr.SetDestination (Ipv4Address ("192.168.0.1"));
+      hdr.SetProtocol (17);
+      queueDisc->Enqueue (Create<Ipv4QueueDiscItem> (Create<Packet> (1000), Address (), 0, hdr));
+    }
+  for (uint32_t i = 0; i < departures; i++)
+    {
+      queueDisc->Dequeue ();
+    }
+  Simulator::Schedule (tick, &Tick, queueDisc, flows, arrivals, departures, tick);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nFlows = 10000;
+  uint32_t nQueues = 16384;
+  uint32_t arrivals = 12;
+  uint32_t departures = 10;
+  double time = 0.5;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the FqCoDel queue disc with many concurrent flows.");
+  cmd.AddValue ("flows", "number of concurrent flows", nFlows);
+  cmd.AddValue ("queues", "number of flow queues of the queue disc", nQueues);
+  cmd.AddValue ("arrivals", "packets enqueued every 10 us", arrivals);
+  cmd.AddValue ("departures", "packets dequeued every 10 us", departures);
+  cmd.AddValue ("time", "simulated time, in seconds", time);
+  cmd.Parse (argc, argv);
+
+  Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc> ("Flows", UintegerValue (nQueues));
+  queueDisc->SetQuantum (1500);
+  queueDisc->Initialize ();
+
+  Ptr<UniformRandomVariable> flows = CreateObject<UniformRandomVariable> ();
+  flows->SetAttribute ("Min", DoubleValue (0));
+  flows->SetAttribute ("Max", DoubleValue (nFlows - 1));
+  flows->SetStream (1);
+
+  std::cout << nFlows << " flows, " << nQueues << " flow queues, " << time << " s" << std::endl;
+  Simulator::Schedule (Seconds (0), &Tick, queueDisc, flows, arrivals, departures, MicroSeconds (10));
+  Simulator::Stop (Seconds (time));
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  double s = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  std::cout << queueDisc->GetStats () << std::endl;
+  std::cout << queueDisc->GetNQueueDiscClasses () << " flow queues in use, "
+            << queueDisc->GetNPackets () << " packets queued, "
+            << s << " s of wall-clock time" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
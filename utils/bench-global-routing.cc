@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the computation of the global
+// routes.  The routers form a square grid of point-to-point links, and
+// each router has a number of hosts.  The time to populate the routing
+// tables is measured, and then the time to recompute them, fully or
+// incrementally, after a link of the grid goes down and up.
+// Sample usage:
+//   ./waf --run 'bench-global-routing --rows=20 --hosts=2'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Get the number of global routes of the nodes
+ *
+ * \param nodes the nodes
+ * \return the total number of routes
+ */
+static uint32_t
+CountRoutes (NodeContainer nodes)
+{
+  uint32_t nRoutes = 0;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      nRoutes += nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ()->GetNRoutes ();
+    }
+  return nRoutes;
+}
+
+/**
+ * Time a function
+ *
+ * \param name the name of the benchmark
+ * \param f the function
+ * \param nodes the nodes, to count their routes
+ */
+static void
+Bench (std::string name, void (*f)(void), NodeContainer nodes)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  f ();
+  double ms = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+  std::cout << name << ": " << ms << " ms, " << CountRoutes (nodes) << " routes" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t rows = 10;
+  uint32_t nHosts = 2;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the computation of the global routes on a grid.");
+  cmd.AddValue ("rows", "number of rows (and columns) of routers", rows);
+  cmd.AddValue ("hosts", "number of hosts per router", nHosts);
+  cmd.Parse (argc, argv);
+
+  NodeContainer routers;
+  routers.Create (rows * rows);
+  NodeContainer hosts;
+  hosts.Create (rows * rows * nHosts);
+  NodeContainer nodes (routers, hosts);
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4 ("10.0.0.0", "255.255.255.252");
+  Ipv4InterfaceContainer firstLink;
+  for (uint32_t r = 0; r < rows; r++)
+    {
+      for (uint32_t c = 0; c < rows; c++)
+        {
+          Ptr<Node> router = routers.Get (r * rows + c);
+          if (c + 1 < rows)
+            {
+              Ipv4InterfaceContainer link = ipv4.Assign (devHelper.Install (NodeContainer (router, routers.Get (r * rows + c + 1))));
+              ipv4.NewNetwork ();
+              if (firstLink.GetN () == 0)
+                {
+                  firstLink = link;
+                }
+            }
+          if (r + 1 < rows)
+            {
+              ipv4.Assign (devHelper.Install (NodeContainer (router, routers.Get ((r + 1) * rows + c))));
+              ipv4.NewNetwork ();
+            }
+          for (uint32_t h = 0; h < nHosts; h++)
+            {
+              ipv4.Assign (devHelper.Install (NodeContainer (router, hosts.Get ((r * rows + c) * nHosts + h))));
+              ipv4.NewNetwork ();
+            }
+        }
+    }
+
+  std::cout << routers.GetN () << " routers, " << hosts.GetN () << " hosts" << std::endl;
+  Bench ("PopulateRoutingTables", &Ipv4GlobalRoutingHelper::PopulateRoutingTables, nodes);
+  Ptr<Ipv4> linkIpv4 = firstLink.Get (0).first;
+  uint32_t linkInterface = firstLink.Get (0).second;
+  linkIpv4->SetDown (linkInterface);
+  Bench ("RecomputeRoutingTables (link down)", &Ipv4GlobalRoutingHelper::RecomputeRoutingTables, nodes);
+  linkIpv4->SetUp (linkInterface);
+  Bench ("RecomputeRoutingTables (link up)", &Ipv4GlobalRoutingHelper::RecomputeRoutingTables, nodes);
+  linkIpv4->SetDown (linkInterface);
+  Bench ("UpdateRoutingTables (link down)", &Ipv4GlobalRoutingHelper::UpdateRoutingTables, nodes);
+  linkIpv4->SetUp (linkInterface);
+  Bench ("UpdateRoutingTables (link up)", &Ipv4GlobalRoutingHelper::UpdateRoutingTables, nodes);
+
+  Simulator::Destroy ();
+  return 0;
+}
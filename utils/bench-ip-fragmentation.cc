@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the fragmentation and the
+// reassembly of IPv4 and IPv6 packets.  Large UDP datagrams, whose
+// payload is made of actual bytes, are sent over a link with a small
+// MTU.  The wall-clock time of the simulation, the datagrams received
+// and a checksum of their content are printed.
+// Sample usage:
+//   ./waf --run 'bench-ip-fragmentation --size=60000 --mtu=68'
+//   ./waf --run 'bench-ip-fragmentation --size=60000 --mtu=1280 --ipv6=1'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+static uint32_t g_received = 0; //!< Number of datagrams received
+static uint64_t g_sum = 0;      //!< Sum of the bytes received
+
+/**
+ * Receive the datagrams and add up their bytes
+ *
+ * \param socket the receiving socket
+ */
+static void
+Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  std::vector<uint8_t> data;
+  while ((packet = socket->Recv ()))
+    {
+      data.resize (packet->GetSize ());
+      packet->CopyData (&data[0], data.size ());
+      for (uint32_t i = 0; i < data.size (); i++)
+        {
+          g_sum += data[i];
+        }
+      g_received++;
+    }
+}
+
+/**
+ * Send a datagram
+ *
+ * \param socket the sending socket
+ * \param data the payload of the datagram
+ */
+static void
+Send (Ptr<Socket> socket, const std::vector<uint8_t> *data)
+{
+  socket->Send (Create<Packet> (&(*data)[0], data->size ()));
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t size = 60000;
+  uint32_t mtu = 128;
+  uint32_t datagrams = 100;
+  bool ipv6 = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the fragmentation and reassembly of large IP datagrams.");
+  cmd.AddValue ("size", "size of the UDP payload", size);
+  cmd.AddValue ("mtu", "MTU of the link, at least 1280 for IPv6", mtu);
+  cmd.AddValue ("datagrams", "number of datagrams to send", datagrams);
+  cmd.AddValue ("ipv6", "use IPv6 instead of IPv4", ipv6);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  devHelper.SetQueue ("ns3::DropTailQueue<Packet>", "MaxSize", StringValue ("1000000p"));
+  NetDeviceContainer devices = devHelper.Install (nodes);
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      devices.Get (i)->SetMtu (mtu);
+    }
+
+  Address local;
+  Address remote;
+  uint16_t port = 9;
+  if (ipv6)
+    {
+      Ipv6AddressHelper ipv6Helper;
+      ipv6Helper.SetBase (Ipv6Address ("2001:db8::"), Ipv6Prefix (64));
+      Ipv6InterfaceContainer interfaces = ipv6Helper.Assign (devices);
+      local = Inet6SocketAddress (Ipv6Address::GetAny (), port);
+      remote = Inet6SocketAddress (interfaces.GetAddress (1, 1), port);
+    }
+  else
+    {
+      Ipv4AddressHelper ipv4Helper ("10.0.0.0", "255.255.255.0");
+      Ipv4InterfaceContainer interfaces = ipv4Helper.Assign (devices);
+      local = InetSocketAddress (Ipv4Address::GetAny (), port);
+      remote = InetSocketAddress (interfaces.GetAddress (1), port);
+    }
+
+  TypeId tid = UdpSocketFactory::GetTypeId ();
+  Ptr<Socket> sink = Socket::CreateSocket (nodes.Get (1), tid);
+  sink->SetAttribute ("RcvBufSize", UintegerValue (1 << 30));
+  sink->Bind (local);
+  sink->SetRecvCallback (MakeCallback (&Receive));
+  Ptr<Socket> source = Socket::CreateSocket (nodes.Get (0), tid);
+  source->Connect (remote);
+
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data[i] = static_cast<uint8_t> (i * 7 + 1);
+    }
+  for (uint32_t i = 0; i < datagrams; i++)
+    {
+      Simulator::Schedule (MilliSeconds (10 + i), &Send, source, &data);
+    }
+
+  std::cout << datagrams << " datagrams of " << size << " bytes, MTU " << mtu
+            << (ipv6 ? ", IPv6" : ", IPv4") << std::endl;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  double s = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  std::cout << "Received " << g_received << " datagrams (byte sum " << g_sum << ") in "
+            << s << " s of wall-clock time" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the route lookups of the
+// Ipv4StaticRouting, Ipv4GlobalRouting and Ipv6StaticRouting protocols
+// with large routing tables. A node with a few interfaces gets a number
+// of random routes, with prefix lengths between 8 and 32 bits (16 and 64
+// bits for IPv6) and equal-cost duplicates, and the time of RouteOutput
+// for random destinations is measured. A digest of the routes found is
+// printed, so that different implementations can be compared.
+// Sample usage:
+//   ./waf --run 'bench-ip-routing-lookup --routes=10000 --lookups=100000'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Update a digest with a value
+ *
+ * \param digest the FNV-1a digest
+ * \param value the value
+ */
+static void
+Digest (uint64_t &digest, uint64_t value)
+{
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      digest ^= (value >> (i * 8)) & 0xff;
+      digest *= 0x100000001b3ULL;
+    }
+}
+
+/**
+ * Print the results of a benchmark
+ *
+ * \param name the name of the benchmark
+ * \param ns the total time, in ns
+ * \param nLookups the number of lookups
+ * \param found the number of routes found
+ * \param digest the digest of the routes found
+ */
+static void
+Report (std::string name, double ns, uint32_t nLookups, uint32_t found, uint64_t digest)
+{
+  std::cout << std::left << std::setw (24) << name << std::right
+            << std::fixed << std::setprecision (1) << std::setw (10) << ns / nLookups << " ns/lookup"
+            << std::setw (10) << found << " found  digest " << std::hex << digest << std::dec << std::endl;
+}
+
+/**
+ * Benchmark an IPv4 routing protocol
+ *
+ * \param name the name of the benchmark
+ * \param routing the routing protocol
+ * \param nLookups the number of lookups
+ * \param random the random variable choosing the destinations
+ */
+static void
+BenchIpv4 (std::string name, Ptr<Ipv4RoutingProtocol> routing, uint32_t nLookups,
+           Ptr<UniformRandomVariable> random)
+{
+  std::vector<Ipv4Header> headers (nLookups);
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      headers[i].SetDestination (Ipv4Address (0x0a000000 | random->GetInteger (0, 0xffffff)));
+    }
+  Ptr<Packet> packet = Create<Packet> ();
+  uint32_t found = 0;
+  uint64_t digest = 0xcbf29ce484222325ULL;
+  Socket::SocketErrno err;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      Ptr<Ipv4Route> route = routing->RouteOutput (packet, headers[i], 0, err);
+      if (route != 0)
+        {
+          found++;
+          Digest (digest, route->GetGateway ().Get ());
+        }
+    }
+  double ns = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count ();
+  Report (name, ns, nLookups, found, digest);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nRoutes = 10000;
+  uint32_t nLookups = 100000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the route lookups of the static and global routing protocols.");
+  cmd.AddValue ("routes", "number of routes", nRoutes);
+  cmd.AddValue ("lookups", "number of lookups", nLookups);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (1);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  SimpleNetDeviceHelper simpleHelper;
+  Ipv4AddressHelper ipv4Helper ("172.16.0.0", "255.255.255.0");
+  Ipv6AddressHelper ipv6Helper (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NetDeviceContainer device = simpleHelper.Install (nodes);
+      ipv4Helper.Assign (device);
+      ipv4Helper.NewNetwork ();
+      ipv6Helper.Assign (device);
+      ipv6Helper.NewNetwork ();
+    }
+
+  Ptr<Ipv4StaticRouting> ipv4Static = CreateObject<Ipv4StaticRouting> ();
+  ipv4Static->SetIpv4 (nodes.Get (0)->GetObject<Ipv4> ());
+  Ptr<Ipv4GlobalRouting> ipv4Global = CreateObject<Ipv4GlobalRouting> ();
+  ipv4Global->SetIpv4 (nodes.Get (0)->GetObject<Ipv4> ());
+  Ptr<Ipv6StaticRouting> ipv6Static = CreateObject<Ipv6StaticRouting> ();
+  ipv6Static->SetIpv6 (nodes.Get (0)->GetObject<Ipv6> ());
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+  for (uint32_t i = 0; i < nRoutes; i++)
+    {
+      uint32_t interface = random->GetInteger (1, 4);
+      Ipv4Address gateway (0xac100000 | ((interface - 1) << 8) | random->GetInteger (2, 254));
+      uint8_t prefixLength = random->GetInteger (8, 32);
+      Ipv4Mask mask (0xffffffff << (32 - prefixLength));
+      Ipv4Address network (0x0a000000 | random->GetInteger (0, 0xffffff));
+      ipv4Static->AddNetworkRouteTo (network.CombineMask (mask), mask, gateway, interface);
+      ipv4Global->AddNetworkRouteTo (network.CombineMask (mask), mask, gateway, interface);
+
+      uint8_t bytes[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+      uint32_t bits = random->GetInteger (0, 0xffffffff);
+      bytes[4] = bits >> 24;
+      bytes[5] = bits >> 16;
+      bytes[6] = bits >> 8;
+      bytes[7] = bits;
+      Ipv6Prefix prefix (random->GetInteger (16, 64));
+      ipv6Static->AddNetworkRouteTo (Ipv6Address (bytes).CombinePrefix (prefix), prefix, interface);
+    }
+  ipv4Static->SetDefaultRoute (Ipv4Address ("172.16.0.1"), 1);
+
+  std::cout << nRoutes << " routes, " << nLookups << " lookups" << std::endl;
+  BenchIpv4 ("Ipv4StaticRouting", ipv4Static, nLookups, random);
+  BenchIpv4 ("Ipv4GlobalRouting", ipv4Global, nLookups, random);
+
+  std::vector<Ipv6Header> headers (nLookups);
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      uint8_t bytes[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+      uint32_t bits = random->GetInteger (0, 0xffffffff);
+      bytes[4] = bits >> 24;
+      bytes[5] = bits >> 16;
+      bytes[6] = bits >> 8;
+      bytes[7] = bits;
+      bytes[15] = 1;
+      headers[i].SetDestinationAddress (Ipv6Address (bytes));
+    }
+  Ptr<Packet> packet = Create<Packet> ();
+  uint32_t found = 0;
+  uint64_t digest = 0xcbf29ce484222325ULL;
+  Socket::SocketErrno err;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      Ptr<Ipv6Route> route = ipv6Static->RouteOutput (packet, headers[i], 0, err);
+      if (route != 0)
+        {
+          found++;
+          uint8_t bytes[16];
+          route->GetDestination ().GetBytes (bytes);
+          Digest (digest, ((uint64_t) bytes[4] << 24) | (bytes[5] << 16) | (bytes[6] << 8) | bytes[7]);
+          Digest (digest, route->GetOutputDevice ()->GetIfIndex ());
+        }
+    }
+  double ns = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count ();
+  Report ("Ipv6StaticRouting", ns, nLookups, found, digest);
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the forwarding of IPv4 packets.
+// A number of UDP flows cross a chain of routers connected by simple net
+// devices, which need ARP unless the point-to-point mode is requested.
+// The wall-clock time of the simulation and the packets received are
+// printed.
+// Sample usage:
+//   ./waf --run 'bench-ipv4-forwarding --hops=10 --flows=10 --packets=10000'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t nHops = 10;
+  uint32_t nFlows = 10;
+  uint32_t nPackets = 10000;
+  uint32_t packetSize = 1000;
+  bool pointToPoint = false;
+  bool checksum = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the forwarding of IPv4 packets along a chain of routers.");
+  cmd.AddValue ("hops", "number of routers between the sender and the receiver", nHops);
+  cmd.AddValue ("flows", "number of UDP flows", nFlows);
+  cmd.AddValue ("packets", "number of packets sent by each flow", nPackets);
+  cmd.AddValue ("packetSize", "size of the UDP payload", packetSize);
+  cmd.AddValue ("pointToPoint", "use point-to-point links, which do not need ARP", pointToPoint);
+  cmd.AddValue ("checksum", "enable the computation of the checksums", checksum);
+  cmd.Parse (argc, argv);
+
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (checksum));
+  // Resolve the addresses at once, so that the ARP requests do not drop
+  // the packets which arrive while the resolution is pending
+  Config::SetDefault ("ns3::ArpL3Protocol::RequestJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+
+  NodeContainer nodes;
+  nodes.Create (nHops + 2);
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (pointToPoint);
+  devHelper.SetQueue ("ns3::DropTailQueue<Packet>", "MaxSize", StringValue ("100000p"));
+  Ipv4AddressHelper ipv4 ("10.0.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer lastLink;
+  for (uint32_t i = 0; i <= nHops; i++)
+    {
+      lastLink = ipv4.Assign (devHelper.Install (NodeContainer (nodes.Get (i), nodes.Get (i + 1))));
+      ipv4.NewNetwork ();
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  ApplicationContainer servers;
+  for (uint32_t f = 0; f < nFlows; f++)
+    {
+      uint16_t port = 1000 + f;
+      UdpServerHelper server (port);
+      servers.Add (server.Install (nodes.Get (nHops + 1)));
+      UdpClientHelper client (lastLink.GetAddress (1), port);
+      client.SetAttribute ("MaxPackets", UintegerValue (nPackets));
+      client.SetAttribute ("Interval", TimeValue (MicroSeconds (10)));
+      client.SetAttribute ("PacketSize", UintegerValue (packetSize));
+      client.Install (nodes.Get (0)).Start (MicroSeconds (f));
+    }
+
+  std::cout << nHops << " routers, " << nFlows << " flows of " << nPackets << " packets" << std::endl;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  double s = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  uint64_t received = 0;
+  for (uint32_t f = 0; f < nFlows; f++)
+    {
+      received += DynamicCast<UdpServer> (servers.Get (f))->GetReceived ();
+    }
+  std::cout << "Received " << received << " packets in " << s << " s of wall-clock time ("
+            << s * 1e9 / (received * (nHops + 1)) << " ns per packet per hop)" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
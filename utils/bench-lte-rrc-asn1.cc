@@ -0,0 +1,323 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the ASN.1 encoding and decoding
+// of the main LTE RRC messages, as done by the LteUeRrcProtocolReal and
+// LteEnbRrcProtocolReal: each message is set in its header, which is
+// added to a packet (encoding) and then removed from it (decoding).
+// For each message type, the size of the encoded message, the mean
+// wall clock time of the encoding and of the decoding, and a digest of
+// the encoded bytes are reported. The digest allows to check that a
+// change of the encoder does not change its output.
+// Sample usage:
+//   ./waf --run 'bench-lte-rrc-asn1 --iterations=100000'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/lte-rrc-sap.h"
+#include "ns3/lte-rrc-header.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \return the dedicated radio resource configuration of a UE with a
+ * signalling and a data radio bearer, as set up by the LteEnbRrc
+ */
+static LteRrcSap::RadioResourceConfigDedicated
+CreateRadioResourceConfigDedicated ()
+{
+  LteRrcSap::RadioResourceConfigDedicated rrcd;
+
+  LteRrcSap::SrbToAddMod srbToAddMod;
+  srbToAddMod.srbIdentity = 1;
+  srbToAddMod.logicalChannelConfig.priority = 1;
+  srbToAddMod.logicalChannelConfig.prioritizedBitRateKbps = 100;
+  srbToAddMod.logicalChannelConfig.bucketSizeDurationMs = 100;
+  srbToAddMod.logicalChannelConfig.logicalChannelGroup = 0;
+  rrcd.srbToAddModList.push_back (srbToAddMod);
+
+  LteRrcSap::DrbToAddMod drbToAddMod;
+  drbToAddMod.epsBearerIdentity = 1;
+  drbToAddMod.drbIdentity = 1;
+  drbToAddMod.logicalChannelIdentity = 3;
+  drbToAddMod.rlcConfig.choice = LteRrcSap::RlcConfig::AM;
+  drbToAddMod.logicalChannelConfig.priority = 9;
+  drbToAddMod.logicalChannelConfig.prioritizedBitRateKbps = 128;
+  drbToAddMod.logicalChannelConfig.bucketSizeDurationMs = 100;
+  drbToAddMod.logicalChannelConfig.logicalChannelGroup = 1;
+  rrcd.drbToAddModList.push_back (drbToAddMod);
+
+  rrcd.havePhysicalConfigDedicated = true;
+  rrcd.physicalConfigDedicated.haveSoundingRsUlConfigDedicated = true;
+  rrcd.physicalConfigDedicated.soundingRsUlConfigDedicated.type = LteRrcSap::SoundingRsUlConfigDedicated::SETUP;
+  rrcd.physicalConfigDedicated.soundingRsUlConfigDedicated.srsBandwidth = 0;
+  rrcd.physicalConfigDedicated.soundingRsUlConfigDedicated.srsConfigIndex = 17;
+  rrcd.physicalConfigDedicated.haveAntennaInfoDedicated = true;
+  rrcd.physicalConfigDedicated.antennaInfo.transmissionMode = 1;
+  rrcd.physicalConfigDedicated.havePdschConfigDedicated = true;
+  rrcd.physicalConfigDedicated.pdschConfigDedicated.pa = LteRrcSap::PdschConfigDedicated::dB0;
+
+  return rrcd;
+}
+
+/**
+ * \return a measurement configuration with an A3 and an A2 event, as
+ * configured by the handover and ANR algorithms
+ */
+static LteRrcSap::MeasConfig
+CreateMeasConfig ()
+{
+  LteRrcSap::MeasConfig measConfig;
+  measConfig.haveQuantityConfig = true;
+  measConfig.quantityConfig.filterCoefficientRSRP = 4;
+  measConfig.quantityConfig.filterCoefficientRSRQ = 4;
+  measConfig.haveMeasGapConfig = false;
+  measConfig.haveSmeasure = false;
+  measConfig.haveSpeedStatePars = false;
+
+  LteRrcSap::MeasObjectToAddMod measObject;
+  measObject.measObjectId = 1;
+  measObject.measObjectEutra.carrierFreq = 100;
+  measObject.measObjectEutra.allowedMeasBandwidth = 50;
+  measObject.measObjectEutra.presenceAntennaPort1 = false;
+  measObject.measObjectEutra.neighCellConfig = 0;
+  measObject.measObjectEutra.offsetFreq = 0;
+  measObject.measObjectEutra.haveCellForWhichToReportCGI = false;
+  measConfig.measObjectToAddModList.push_back (measObject);
+
+  LteRrcSap::ReportConfigToAddMod reportConfig;
+  reportConfig.reportConfigId = 1;
+  reportConfig.reportConfigEutra.triggerType = LteRrcSap::ReportConfigEutra::EVENT;
+  reportConfig.reportConfigEutra.eventId = LteRrcSap::ReportConfigEutra::EVENT_A3;
+  reportConfig.reportConfigEutra.threshold1.choice = LteRrcSap::ThresholdEutra::THRESHOLD_RSRP;
+  reportConfig.reportConfigEutra.threshold1.range = 0;
+  reportConfig.reportConfigEutra.threshold2.choice = LteRrcSap::ThresholdEutra::THRESHOLD_RSRP;
+  reportConfig.reportConfigEutra.threshold2.range = 0;
+  reportConfig.reportConfigEutra.reportOnLeave = false;
+  reportConfig.reportConfigEutra.a3Offset = 0;
+  reportConfig.reportConfigEutra.hysteresis = 6;
+  reportConfig.reportConfigEutra.timeToTrigger = 256;
+  reportConfig.reportConfigEutra.purpose = LteRrcSap::ReportConfigEutra::REPORT_STRONGEST_CELLS;
+  reportConfig.reportConfigEutra.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRP;
+  reportConfig.reportConfigEutra.reportQuantity = LteRrcSap::ReportConfigEutra::BOTH;
+  reportConfig.reportConfigEutra.maxReportCells = 8;
+  reportConfig.reportConfigEutra.reportInterval = LteRrcSap::ReportConfigEutra::MS480;
+  reportConfig.reportConfigEutra.reportAmount = 255;
+  measConfig.reportConfigToAddModList.push_back (reportConfig);
+  reportConfig.reportConfigId = 2;
+  reportConfig.reportConfigEutra.eventId = LteRrcSap::ReportConfigEutra::EVENT_A2;
+  reportConfig.reportConfigEutra.threshold1.choice = LteRrcSap::ThresholdEutra::THRESHOLD_RSRQ;
+  reportConfig.reportConfigEutra.threshold1.range = 30;
+  reportConfig.reportConfigEutra.hysteresis = 0;
+  reportConfig.reportConfigEutra.timeToTrigger = 0;
+  reportConfig.reportConfigEutra.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRQ;
+  measConfig.reportConfigToAddModList.push_back (reportConfig);
+
+  for (uint8_t measId = 1; measId <= 2; measId++)
+    {
+      LteRrcSap::MeasIdToAddMod measIdToAddMod;
+      measIdToAddMod.measId = measId;
+      measIdToAddMod.measObjectId = 1;
+      measIdToAddMod.reportConfigId = measId;
+      measConfig.measIdToAddModList.push_back (measIdToAddMod);
+    }
+  return measConfig;
+}
+
+/// Accumulated results of a message type
+struct BenchResult
+{
+  uint32_t size;          ///< size of the encoded message, in bytes
+  uint64_t digest;        ///< FNV-1a hash of the encoded message
+  double encodeNs;        ///< mean encoding time, in ns
+  double decodeNs;        ///< mean decoding time, in ns
+};
+
+/**
+ * Encode and decode a message the given number of times
+ *
+ * \param msg the message
+ * \param iterations the number of iterations
+ * \return the results
+ */
+template <class HEADER, class MSG>
+static BenchResult
+BenchMessage (const MSG &msg, uint32_t iterations)
+{
+  typedef std::chrono::steady_clock Clock;
+  BenchResult result;
+  Clock::duration encode = Clock::duration::zero ();
+  Clock::duration decode = Clock::duration::zero ();
+  std::vector<uint8_t> bytes;
+  for (uint32_t i = 0; i < iterations; i++)
+    {
+      Ptr<Packet> packet = Create<Packet> ();
+      Clock::time_point start = Clock::now ();
+      HEADER source;
+      source.SetMessage (msg);
+      packet->AddHeader (source);
+      Clock::time_point encoded = Clock::now ();
+      HEADER destination;
+      packet->RemoveHeader (destination);
+      MSG decodedMsg = destination.GetMessage ();
+      Clock::time_point decoded = Clock::now ();
+      encode += encoded - start;
+      decode += decoded - encoded;
+      if (i == 0)
+        {
+          packet->AddHeader (source);
+          bytes.resize (packet->GetSize ());
+          packet->CopyData (bytes.data (), bytes.size ());
+          // the decoded message must encode to the same bytes
+          HEADER reencoded;
+          reencoded.SetMessage (decodedMsg);
+          Ptr<Packet> check = Create<Packet> ();
+          check->AddHeader (reencoded);
+          std::vector<uint8_t> checkBytes (check->GetSize ());
+          check->CopyData (checkBytes.data (), checkBytes.size ());
+          NS_ABORT_MSG_IF (checkBytes != bytes, "decoded message does not encode to the original bytes");
+        }
+    }
+  result.size = bytes.size ();
+  result.digest = 14695981039346656037ULL;
+  for (std::vector<uint8_t>::const_iterator it = bytes.begin (); it != bytes.end (); ++it)
+    {
+      result.digest = (result.digest ^ *it) * 1099511628211ULL;
+    }
+  result.encodeNs = std::chrono::duration<double, std::nano> (encode).count () / iterations;
+  result.decodeNs = std::chrono::duration<double, std::nano> (decode).count () / iterations;
+  return result;
+}
+
+/**
+ * Print the results of a message type
+ *
+ * \param name the name of the message type
+ * \param result the results
+ */
+static void
+PrintResult (std::string name, BenchResult result)
+{
+  std::cout << std::left << std::setw (40) << name << std::right
+            << std::setw (5) << result.size << " bytes, encode " << std::setw (8) << result.encodeNs
+            << " ns, decode " << std::setw (8) << result.decodeNs << " ns, digest "
+            << std::hex << std::setw (16) << std::setfill ('0') << result.digest
+            << std::dec << std::setfill (' ') << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t iterations = 20000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the ASN.1 encoding and decoding of the main LTE RRC messages.");
+  cmd.AddValue ("iterations", "number of encodings and decodings of each message", iterations);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::fixed << std::setprecision (1);
+
+  LteRrcSap::RrcConnectionRequest request;
+  request.ueIdentity = 0x83fecafecaULL;
+  PrintResult ("RrcConnectionRequest", BenchMessage<RrcConnectionRequestHeader> (request, iterations));
+
+  LteRrcSap::RrcConnectionSetup setup;
+  setup.rrcTransactionIdentifier = 1;
+  setup.radioResourceConfigDedicated = CreateRadioResourceConfigDedicated ();
+  PrintResult ("RrcConnectionSetup", BenchMessage<RrcConnectionSetupHeader> (setup, iterations));
+
+  LteRrcSap::RrcConnectionSetupCompleted setupCompleted;
+  setupCompleted.rrcTransactionIdentifier = 1;
+  PrintResult ("RrcConnectionSetupCompleted", BenchMessage<RrcConnectionSetupCompleteHeader> (setupCompleted, iterations));
+
+  // measurement configuration after the connection setup
+  LteRrcSap::RrcConnectionReconfiguration reconfiguration;
+  reconfiguration.rrcTransactionIdentifier = 2;
+  reconfiguration.haveMeasConfig = true;
+  reconfiguration.measConfig = CreateMeasConfig ();
+  reconfiguration.haveMobilityControlInfo = false;
+  reconfiguration.haveRadioResourceConfigDedicated = true;
+  reconfiguration.radioResourceConfigDedicated = CreateRadioResourceConfigDedicated ();
+  reconfiguration.haveNonCriticalExtension = false;
+  PrintResult ("RrcConnectionReconfiguration", BenchMessage<RrcConnectionReconfigurationHeader> (reconfiguration, iterations));
+
+  // handover command
+  LteRrcSap::RrcConnectionReconfiguration handoverCommand = reconfiguration;
+  handoverCommand.haveMeasConfig = false;
+  handoverCommand.haveMobilityControlInfo = true;
+  handoverCommand.mobilityControlInfo.targetPhysCellId = 4;
+  handoverCommand.mobilityControlInfo.haveCarrierFreq = true;
+  handoverCommand.mobilityControlInfo.carrierFreq.dlCarrierFreq = 100;
+  handoverCommand.mobilityControlInfo.carrierFreq.ulCarrierFreq = 18100;
+  handoverCommand.mobilityControlInfo.haveCarrierBandwidth = true;
+  handoverCommand.mobilityControlInfo.carrierBandwidth.dlBandwidth = 50;
+  handoverCommand.mobilityControlInfo.carrierBandwidth.ulBandwidth = 50;
+  handoverCommand.mobilityControlInfo.newUeIdentity = 11;
+  handoverCommand.mobilityControlInfo.haveRachConfigDedicated = true;
+  handoverCommand.mobilityControlInfo.rachConfigDedicated.raPreambleIndex = 52;
+  handoverCommand.mobilityControlInfo.rachConfigDedicated.raPrachMaskIndex = 0;
+  handoverCommand.mobilityControlInfo.radioResourceConfigCommon.rachConfigCommon.preambleInfo.numberOfRaPreambles = 52;
+  handoverCommand.mobilityControlInfo.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.preambleTransMax = 50;
+  handoverCommand.mobilityControlInfo.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.raResponseWindowSize = 3;
+  PrintResult ("RrcConnectionReconfiguration (HO)", BenchMessage<RrcConnectionReconfigurationHeader> (handoverCommand, iterations));
+
+  LteRrcSap::RrcConnectionReconfigurationCompleted reconfigurationCompleted;
+  reconfigurationCompleted.rrcTransactionIdentifier = 2;
+  PrintResult ("RrcConnectionReconfigurationCompleted", BenchMessage<RrcConnectionReconfigurationCompleteHeader> (reconfigurationCompleted, iterations));
+
+  LteRrcSap::MeasurementReport report;
+  report.measResults.measId = 1;
+  report.measResults.rsrpResult = 60;
+  report.measResults.rsrqResult = 20;
+  report.measResults.haveMeasResultNeighCells = true;
+  for (uint16_t cellId = 2; cellId < 6; cellId++)
+    {
+      LteRrcSap::MeasResultEutra measResultEutra;
+      measResultEutra.physCellId = cellId;
+      measResultEutra.haveCgiInfo = false;
+      measResultEutra.haveRsrpResult = true;
+      measResultEutra.rsrpResult = 50 - cellId;
+      measResultEutra.haveRsrqResult = true;
+      measResultEutra.rsrqResult = 18 - cellId;
+      report.measResults.measResultListEutra.push_back (measResultEutra);
+    }
+  report.measResults.haveScellsMeas = false;
+  PrintResult ("MeasurementReport", BenchMessage<MeasurementReportHeader> (report, iterations));
+
+  LteRrcSap::HandoverPreparationInfo preparationInfo;
+  preparationInfo.asConfig.sourceDlCarrierFreq = 100;
+  preparationInfo.asConfig.sourceUeIdentity = 11;
+  preparationInfo.asConfig.sourceRadioResourceConfig = CreateRadioResourceConfigDedicated ();
+  preparationInfo.asConfig.sourceMeasConfig = CreateMeasConfig ();
+  preparationInfo.asConfig.sourceMasterInformationBlock.dlBandwidth = 50;
+  preparationInfo.asConfig.sourceMasterInformationBlock.systemFrameNumber = 1;
+  preparationInfo.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.csgIndication = false;
+  preparationInfo.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.cellIdentity = 1;
+  preparationInfo.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.csgIdentity = 0;
+  preparationInfo.asConfig.sourceSystemInformationBlockType1.cellAccessRelatedInfo.plmnIdentityInfo.plmnIdentity = 123;
+  preparationInfo.asConfig.sourceSystemInformationBlockType2.freqInfo.ulBandwidth = 50;
+  preparationInfo.asConfig.sourceSystemInformationBlockType2.freqInfo.ulCarrierFreq = 18100;
+  preparationInfo.asConfig.sourceSystemInformationBlockType2.radioResourceConfigCommon.rachConfigCommon.preambleInfo.numberOfRaPreambles = 52;
+  preparationInfo.asConfig.sourceSystemInformationBlockType2.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.preambleTransMax = 50;
+  preparationInfo.asConfig.sourceSystemInformationBlockType2.radioResourceConfigCommon.rachConfigCommon.raSupervisionInfo.raResponseWindowSize = 3;
+  PrintResult ("HandoverPreparationInfo", BenchMessage<HandoverPreparationInfoHeader> (preparationInfo, iterations));
+
+  return 0;
+}
@@ -0,0 +1,609 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the per-TTI cost of an LTE MAC
+// scheduler (any subclass of FfMacScheduler) without the PHY, channel and
+// RLC models. The scheduler is driven directly through its CSCHED and
+// SCHED SAPs, as the LteEnbMac would do, with synthetic DL CQI reports
+// (alternating wideband P10 and subband A30 reports, as the LteUePhy),
+// UL SRS reports, RLC buffer status reports, BSRs and DL HARQ feedback
+// for a given number of UEs.
+// For each number of UEs, the wall clock time spent in the scheduler
+// during each TTI is measured, and its percentiles are reported.
+// Sample usage:
+//   ./waf --run 'bench-lte-scheduler --scheduler=ns3::PfFfMacScheduler --maxUes=320'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ff-mac-scheduler.h"
+#include "ns3/ff-mac-csched-sap.h"
+#include "ns3/ff-mac-sched-sap.h"
+#include "ns3/lte-fr-no-op-algorithm.h"
+#include "ns3/lte-common.h"
+#include "ns3/lte-vendor-specific-parameters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/// Logical channel identity of the data radio bearer of each UE
+static const uint8_t g_lcId = 3;
+/// Logical channel group of the data radio bearer of each UE
+static const uint8_t g_lcGroup = 1;
+/// Number of TTIs between a DL transmission and its HARQ feedback
+static const uint32_t g_dlHarqFeedbackDelay = 4;
+/// Size of the RLC queues of the UEs in full buffer mode
+static const uint32_t g_fullBufferSize = 1000000;
+
+/**
+ * \param bandwidth the DL bandwidth, in RBs
+ * \return the RBG size (see table 7.1.6.1-1 of 36.213)
+ */
+static int
+GetRbgSize (int bandwidth)
+{
+  static const int type0AllocationRbg[4] = { 10, 26, 63, 110 };
+  for (int i = 0; i < 4; i++)
+    {
+      if (bandwidth < type0AllocationRbg[i])
+        {
+          return i + 1;
+        }
+    }
+  return 4;
+}
+
+/// Configuration of a benchmark run
+struct BenchConfig
+{
+  std::string schedulerType;  ///< TypeId name of the scheduler
+  uint8_t bandwidth;          ///< DL and UL bandwidth, in RBs
+  uint8_t txMode;             ///< transmission mode of the UEs
+  uint32_t nTtis;             ///< number of measured TTIs
+  uint32_t warmupTtis;        ///< number of TTIs run before measuring
+  uint32_t cqiPeriod;         ///< period of the DL CQI reports of a UE, in TTIs
+  uint32_t srsPeriod;         ///< period of the SRS reports of a UE, in TTIs
+  bool fullBuffer;            ///< whether the RLC queues are always full
+  uint64_t dlRate;            ///< DL offered load per UE (bit/s), if not in full buffer mode
+  uint64_t ulRate;            ///< UL offered load per UE (bit/s), if not in full buffer mode
+  uint64_t bitRate;           ///< MBR and GBR of the bearer of each UE (bit/s)
+  double bler;                ///< probability of a NACK for each DL TB
+};
+
+/// Synthetic state of a UE
+struct BenchUe
+{
+  uint16_t rnti;          ///< the RNTI
+  uint8_t meanCqi;        ///< mean DL CQI
+  double meanUlSinrDb;    ///< mean UL SINR (dB)
+  uint32_t dlQueue;       ///< size of the DL RLC queue (bytes)
+  uint32_t ulQueue;       ///< size of the UL RLC queue (bytes)
+  bool dlQueueChanged;    ///< whether the DL queue must be reported
+  bool ulQueueChanged;    ///< whether the UL queue must be reported
+};
+
+/**
+ * Drive an FfMacScheduler through its SAPs, acting as the LteEnbMac and
+ * as the UEs of the cell.
+ */
+class SchedulerBench : public FfMacCschedSapUser,
+                       public FfMacSchedSapUser
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param config the configuration of the run
+   * \param nUes the number of UEs
+   */
+  SchedulerBench (const BenchConfig &config, uint32_t nUes);
+  virtual ~SchedulerBench ();
+
+  /// Run the benchmark and print the results
+  void Run (void);
+
+  // inherited from FfMacCschedSapUser
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params);
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params);
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params);
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params);
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params);
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params);
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params);
+
+  // inherited from FfMacSchedSapUser
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params);
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params);
+
+private:
+  /// Configure the cell, the UEs and their bearers
+  void Setup (void);
+  /// Generate the reports of the current TTI and trigger the scheduler
+  void Tti (void);
+  /**
+   * Generate a DL CQI report
+   *
+   * \param ue the reporting UE
+   * \param subband whether an A30 (subband) or a P10 (wideband) report is generated
+   * \return the report
+   */
+  CqiListElement_s CreateDlCqi (const BenchUe &ue, bool subband);
+  /**
+   * Generate an UL SRS report
+   *
+   * \param ue the reporting UE
+   * \param sfnSf the frame and subframe number of the report
+   * \return the report
+   */
+  FfMacSchedSapProvider::SchedUlCqiInfoReqParameters CreateSrs (const BenchUe &ue, uint16_t sfnSf);
+  /**
+   * \param tti the TTI number
+   * \return the frame and subframe number of the TTI
+   */
+  static uint16_t GetSfnSf (uint32_t tti);
+  /**
+   * \param rnti the RNTI
+   * \return the UE with the given RNTI
+   */
+  BenchUe & GetUe (uint16_t rnti);
+
+  BenchConfig m_config;                               ///< the configuration
+  Ptr<FfMacScheduler> m_scheduler;                    ///< the scheduler
+  Ptr<LteFfrAlgorithm> m_ffrAlgorithm;                ///< the FFR algorithm
+  FfMacCschedSapProvider *m_cschedSapProvider;        ///< CSCHED SAP of the scheduler
+  FfMacSchedSapProvider *m_schedSapProvider;          ///< SCHED SAP of the scheduler
+  std::vector<BenchUe> m_ues;                         ///< the UEs, indexed by RNTI - 1
+  uint32_t m_rbgNum;                                  ///< number of DL RBGs
+  uint8_t m_nLayers;                                  ///< number of layers of the UEs
+  uint32_t m_tti;                                     ///< current TTI number
+  /// DL HARQ feedbacks to be reported, for each of the next TTIs
+  std::deque<std::vector<DlInfoListElement_s> > m_dlHarqFeedback;
+  std::vector<int64_t> m_ttiDurations;                ///< duration of each measured TTI (ns)
+  uint64_t m_dlBytes;                                 ///< bytes of new DL RLC PDUs during the measure
+  uint64_t m_ulBytes;                                 ///< bytes of new UL TBs during the measure
+  Ptr<UniformRandomVariable> m_uniform;               ///< random variable for the synthetic reports
+};
+
+SchedulerBench::SchedulerBench (const BenchConfig &config, uint32_t nUes)
+  : m_config (config),
+    m_tti (0),
+    m_dlBytes (0),
+    m_ulBytes (0)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (config.schedulerType);
+  m_scheduler = factory.Create<FfMacScheduler> ();
+  m_ffrAlgorithm = CreateObject<LteFrNoOpAlgorithm> ();
+  m_ffrAlgorithm->SetDlBandwidth (config.bandwidth);
+  m_ffrAlgorithm->SetUlBandwidth (config.bandwidth);
+  m_scheduler->SetLteFfrSapProvider (m_ffrAlgorithm->GetLteFfrSapProvider ());
+  m_ffrAlgorithm->SetLteFfrSapUser (m_scheduler->GetLteFfrSapUser ());
+  m_scheduler->SetFfMacCschedSapUser (this);
+  m_scheduler->SetFfMacSchedSapUser (this);
+  m_cschedSapProvider = m_scheduler->GetFfMacCschedSapProvider ();
+  m_schedSapProvider = m_scheduler->GetFfMacSchedSapProvider ();
+  m_scheduler->Initialize ();
+  m_ffrAlgorithm->Initialize ();
+
+  m_rbgNum = config.bandwidth / GetRbgSize (config.bandwidth);
+  m_nLayers = TransmissionModesLayers::TxMode2LayerNum (config.txMode);
+  m_uniform = CreateObject<UniformRandomVariable> ();
+  m_uniform->SetStream (1);
+  for (uint32_t i = 0; i < nUes; i++)
+    {
+      BenchUe ue;
+      ue.rnti = i + 1;
+      ue.meanCqi = m_uniform->GetInteger (2, 15);
+      ue.meanUlSinrDb = m_uniform->GetValue (-5.0, 25.0);
+      ue.dlQueue = config.fullBuffer ? g_fullBufferSize : 0;
+      ue.ulQueue = config.fullBuffer ? g_fullBufferSize : 0;
+      ue.dlQueueChanged = config.fullBuffer;
+      ue.ulQueueChanged = config.fullBuffer;
+      m_ues.push_back (ue);
+    }
+  m_dlHarqFeedback.resize (g_dlHarqFeedbackDelay);
+}
+
+SchedulerBench::~SchedulerBench ()
+{
+  m_scheduler->Dispose ();
+  m_ffrAlgorithm->Dispose ();
+}
+
+void
+SchedulerBench::Setup (void)
+{
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cellParams;
+  cellParams.m_dlBandwidth = m_config.bandwidth;
+  cellParams.m_ulBandwidth = m_config.bandwidth;
+  m_cschedSapProvider->CschedCellConfigReq (cellParams);
+
+  for (std::vector<BenchUe>::const_iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ueParams;
+      ueParams.m_rnti = it->rnti;
+      ueParams.m_reconfigureFlag = false;
+      ueParams.m_transmissionMode = m_config.txMode;
+      m_cschedSapProvider->CschedUeConfigReq (ueParams);
+
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lcParams;
+      lcParams.m_rnti = it->rnti;
+      lcParams.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lccle;
+      lccle.m_logicalChannelIdentity = g_lcId;
+      lccle.m_logicalChannelGroup = g_lcGroup;
+      lccle.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lccle.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lccle.m_qci = 9;
+      lccle.m_eRabMaximulBitrateUl = m_config.bitRate;
+      lccle.m_eRabMaximulBitrateDl = m_config.bitRate;
+      lccle.m_eRabGuaranteedBitrateUl = m_config.bitRate;
+      lccle.m_eRabGuaranteedBitrateDl = m_config.bitRate;
+      lcParams.m_logicalChannelConfigList.push_back (lccle);
+      m_cschedSapProvider->CschedLcConfigReq (lcParams);
+    }
+}
+
+uint16_t
+SchedulerBench::GetSfnSf (uint32_t tti)
+{
+  // frames are numbered from 1 and subframes from 1 to 10, as in the LteEnbPhy
+  uint32_t frameNo = 1 + tti / 10;
+  uint32_t subframeNo = 1 + tti % 10;
+  return ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
+}
+
+BenchUe &
+SchedulerBench::GetUe (uint16_t rnti)
+{
+  NS_ASSERT (rnti >= 1 && rnti <= m_ues.size ());
+  return m_ues[rnti - 1];
+}
+
+CqiListElement_s
+SchedulerBench::CreateDlCqi (const BenchUe &ue, bool subband)
+{
+  CqiListElement_s cqi;
+  cqi.m_rnti = ue.rnti;
+  cqi.m_ri = 1;
+  cqi.m_cqiType = subband ? CqiListElement_s::A30 : CqiListElement_s::P10;
+  cqi.m_wbPmi = 0;
+  if (!subband)
+    {
+      for (uint8_t layer = 0; layer < m_nLayers; layer++)
+        {
+          cqi.m_wbCqi.push_back (ue.meanCqi);
+        }
+      return cqi;
+    }
+  for (uint32_t rbg = 0; rbg < m_rbgNum; rbg++)
+    {
+      HigherLayerSelected_s hlCqi;
+      hlCqi.m_sbPmi = 0;
+      for (uint8_t layer = 0; layer < m_nLayers; layer++)
+        {
+          int sbCqi = ue.meanCqi + (int) m_uniform->GetInteger (0, 4) - 2;
+          hlCqi.m_sbCqi.push_back (std::max (1, std::min (15, sbCqi)));
+        }
+      cqi.m_sbMeasResult.m_higherLayerSelected.push_back (hlCqi);
+    }
+  return cqi;
+}
+
+FfMacSchedSapProvider::SchedUlCqiInfoReqParameters
+SchedulerBench::CreateSrs (const BenchUe &ue, uint16_t sfnSf)
+{
+  FfMacSchedSapProvider::SchedUlCqiInfoReqParameters params;
+  params.m_sfnSf = sfnSf;
+  params.m_ulCqi.m_type = UlCqi_s::SRS;
+  for (uint32_t rb = 0; rb < m_config.bandwidth; rb++)
+    {
+      double sinrDb = ue.meanUlSinrDb + m_uniform->GetValue (-3.0, 3.0);
+      params.m_ulCqi.m_sinr.push_back (LteFfConverter::double2fpS11dot3 (sinrDb));
+    }
+  VendorSpecificListElement_s vsp;
+  vsp.m_type = SRS_CQI_RNTI_VSP;
+  vsp.m_length = 4;
+  vsp.m_value = Create<SrsCqiRntiVsp> (ue.rnti);
+  params.m_vendorSpecificList.push_back (vsp);
+  return params;
+}
+
+void
+SchedulerBench::Tti (void)
+{
+  uint16_t sfnSf = GetSfnSf (m_tti);
+  bool measured = (m_tti >= m_config.warmupTtis);
+
+  // the reports of the UEs are generated before starting the clock, so
+  // that only the time spent in the scheduler is measured
+  FfMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqiParams;
+  dlCqiParams.m_sfnSf = sfnSf;
+  std::vector<FfMacSchedSapProvider::SchedUlCqiInfoReqParameters> srsParams;
+  std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> rlcParams;
+  FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrParams;
+  bsrParams.m_sfnSf = sfnSf;
+  uint32_t dlArrival = m_config.dlRate / 8000;
+  uint32_t ulArrival = m_config.ulRate / 8000;
+  for (std::vector<BenchUe>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      if ((m_tti + it->rnti) % m_config.cqiPeriod == 0)
+        {
+          bool subband = ((m_tti + it->rnti) / m_config.cqiPeriod) % 2;
+          dlCqiParams.m_cqiList.push_back (CreateDlCqi (*it, subband));
+        }
+      if ((m_tti + it->rnti) % m_config.srsPeriod == 0)
+        {
+          srsParams.push_back (CreateSrs (*it, sfnSf));
+        }
+      if (m_config.fullBuffer)
+        {
+          it->dlQueue = g_fullBufferSize;
+          it->ulQueue = g_fullBufferSize;
+        }
+      else
+        {
+          it->dlQueue += dlArrival;
+          it->ulQueue += ulArrival;
+          it->dlQueueChanged |= (dlArrival > 0);
+          it->ulQueueChanged |= (ulArrival > 0);
+        }
+      if (it->dlQueueChanged)
+        {
+          FfMacSchedSapProvider::SchedDlRlcBufferReqParameters params;
+          params.m_rnti = it->rnti;
+          params.m_logicalChannelIdentity = g_lcId;
+          params.m_rlcTransmissionQueueSize = it->dlQueue;
+          params.m_rlcTransmissionQueueHolDelay = 0;
+          params.m_rlcRetransmissionQueueSize = 0;
+          params.m_rlcRetransmissionHolDelay = 0;
+          params.m_rlcStatusPduSize = 0;
+          rlcParams.push_back (params);
+          it->dlQueueChanged = false;
+        }
+      if (it->ulQueueChanged)
+        {
+          MacCeListElement_s bsr;
+          bsr.m_rnti = it->rnti;
+          bsr.m_macCeType = MacCeListElement_s::BSR;
+          for (uint8_t lcg = 0; lcg < 4; lcg++)
+            {
+              uint32_t queue = (lcg == g_lcGroup) ? it->ulQueue : 0;
+              bsr.m_macCeValue.m_bufferStatus.push_back (BufferSizeLevelBsr::BufferSize2BsrId (queue));
+            }
+          bsrParams.m_macCeList.push_back (bsr);
+          it->ulQueueChanged = false;
+        }
+    }
+  FfMacSchedSapProvider::SchedDlTriggerReqParameters dlParams;
+  dlParams.m_sfnSf = sfnSf;
+  dlParams.m_dlInfoList = m_dlHarqFeedback.front ();
+  m_dlHarqFeedback.pop_front ();
+  m_dlHarqFeedback.push_back (std::vector<DlInfoListElement_s> ());
+  FfMacSchedSapProvider::SchedUlTriggerReqParameters ulParams;
+  ulParams.m_sfnSf = GetSfnSf (m_tti + UL_PUSCH_TTIS_DELAY);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  for (std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::const_iterator it = rlcParams.begin ();
+       it != rlcParams.end (); ++it)
+    {
+      m_schedSapProvider->SchedDlRlcBufferReq (*it);
+    }
+  if (!dlCqiParams.m_cqiList.empty ())
+    {
+      m_schedSapProvider->SchedDlCqiInfoReq (dlCqiParams);
+    }
+  m_schedSapProvider->SchedDlTriggerReq (dlParams);
+  for (std::vector<FfMacSchedSapProvider::SchedUlCqiInfoReqParameters>::const_iterator it = srsParams.begin ();
+       it != srsParams.end (); ++it)
+    {
+      m_schedSapProvider->SchedUlCqiInfoReq (*it);
+    }
+  if (!bsrParams.m_macCeList.empty ())
+    {
+      m_schedSapProvider->SchedUlMacCtrlInfoReq (bsrParams);
+    }
+  m_schedSapProvider->SchedUlTriggerReq (ulParams);
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now ();
+
+  if (measured)
+    {
+      m_ttiDurations.push_back (std::chrono::duration_cast<std::chrono::nanoseconds> (end - start).count ());
+    }
+  m_tti++;
+  if (m_tti < m_config.warmupTtis + m_config.nTtis)
+    {
+      Simulator::Schedule (MilliSeconds (1), &SchedulerBench::Tti, this);
+    }
+}
+
+void
+SchedulerBench::Run (void)
+{
+  Setup ();
+  Simulator::Schedule (MilliSeconds (1), &SchedulerBench::Tti, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::sort (m_ttiDurations.begin (), m_ttiDurations.end ());
+  double sum = 0.0;
+  for (std::vector<int64_t>::const_iterator it = m_ttiDurations.begin (); it != m_ttiDurations.end (); ++it)
+    {
+      sum += *it;
+    }
+  uint32_t n = m_ttiDurations.size ();
+  double p[] = { 0.5, 0.9, 0.99 };
+  const char *pName[] = { "p50", "p90", "p99" };
+  std::cout << std::setw (5) << m_ues.size () << " UEs: mean " << std::setw (9) << sum / n / 1000.0 << " us";
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      uint32_t rank = std::max<uint32_t> (1, std::ceil (p[i] * n));
+      std::cout << ", " << pName[i] << " " << std::setw (9) << m_ttiDurations[rank - 1] / 1000.0 << " us";
+    }
+  std::cout << ", max " << std::setw (9) << m_ttiDurations.back () / 1000.0 << " us"
+            << ", DL RLC PDUs " << m_dlBytes * 8.0 / (n * 1000.0) << " Mbit/s"
+            << ", UL allocated TB size " << m_ulBytes * 8.0 / (n * 1000.0) << " Mbit/s" << std::endl;
+}
+
+void
+SchedulerBench::SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+{
+  for (std::vector<BuildDataListElement_s>::const_iterator it = params.m_buildDataList.begin ();
+       it != params.m_buildDataList.end (); ++it)
+    {
+      DlInfoListElement_s harqFeedback;
+      harqFeedback.m_rnti = it->m_rnti;
+      harqFeedback.m_harqProcessId = it->m_dci.m_harqProcess;
+      for (uint32_t layer = 0; layer < it->m_dci.m_ndi.size (); layer++)
+        {
+          bool ack = (m_config.bler == 0.0) || (m_uniform->GetValue () >= m_config.bler);
+          harqFeedback.m_harqStatus.push_back (ack ? DlInfoListElement_s::ACK : DlInfoListElement_s::NACK);
+          if (it->m_dci.m_ndi.at (layer) == 1 && layer < it->m_rlcPduList.size ())
+            {
+              // new data: remove it from the RLC queue
+              BenchUe &ue = GetUe (it->m_rnti);
+              for (std::vector<RlcPduListElement_s>::const_iterator pdu = it->m_rlcPduList.at (layer).begin ();
+                   pdu != it->m_rlcPduList.at (layer).end (); ++pdu)
+                {
+                  ue.dlQueue -= std::min (ue.dlQueue, (uint32_t) pdu->m_size);
+                  ue.dlQueueChanged = true;
+                  if (m_tti >= m_config.warmupTtis)
+                    {
+                      // the RLC PDUs, without the padding of the TB
+                      m_dlBytes += pdu->m_size;
+                    }
+                }
+            }
+        }
+      m_dlHarqFeedback.back ().push_back (harqFeedback);
+    }
+}
+
+void
+SchedulerBench::SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+{
+  for (std::vector<UlDciListElement_s>::const_iterator it = params.m_dciList.begin ();
+       it != params.m_dciList.end (); ++it)
+    {
+      if (it->m_ndi == 1)
+        {
+          // new data: remove it from the RLC queue
+          BenchUe &ue = GetUe (it->m_rnti);
+          ue.ulQueue -= std::min (ue.ulQueue, (uint32_t) it->m_tbSize);
+          ue.ulQueueChanged = true;
+          if (m_tti >= m_config.warmupTtis)
+            {
+              m_ulBytes += it->m_tbSize;
+            }
+        }
+    }
+}
+
+void
+SchedulerBench::CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+{
+}
+
+void
+SchedulerBench::CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+{
+}
+
+void
+SchedulerBench::CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+{
+}
+
+void
+SchedulerBench::CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+{
+}
+
+void
+SchedulerBench::CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+{
+}
+
+void
+SchedulerBench::CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+{
+}
+
+void
+SchedulerBench::CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+{
+}
+
+int main (int argc, char *argv[])
+{
+  BenchConfig config;
+  config.schedulerType = "ns3::PfFfMacScheduler";
+  config.txMode = 0;
+  config.nTtis = 1000;
+  config.warmupTtis = 100;
+  config.cqiPeriod = 1;
+  config.srsPeriod = 20;
+  config.fullBuffer = true;
+  config.dlRate = 1000000;
+  config.ulRate = 500000;
+  config.bitRate = 1000000;
+  config.bler = 0.1;
+  uint32_t bandwidth = 100;
+  uint32_t txMode = 0;
+  uint32_t minUes = 10;
+  uint32_t maxUes = 320;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the per-TTI cost of an LTE MAC scheduler for a growing number of UEs.");
+  cmd.AddValue ("scheduler", "TypeId of the FfMacScheduler", config.schedulerType);
+  cmd.AddValue ("bandwidth", "DL and UL bandwidth, in RBs", bandwidth);
+  cmd.AddValue ("txMode", "transmission mode of the UEs", txMode);
+  cmd.AddValue ("ttis", "number of measured TTIs for each number of UEs", config.nTtis);
+  cmd.AddValue ("warmup", "number of TTIs run before measuring", config.warmupTtis);
+  cmd.AddValue ("cqiPeriod", "period of the DL CQI reports of each UE, in TTIs", config.cqiPeriod);
+  cmd.AddValue ("srsPeriod", "period of the SRS reports of each UE, in TTIs", config.srsPeriod);
+  cmd.AddValue ("fullBuffer", "whether the DL and UL queues of the UEs are always full", config.fullBuffer);
+  cmd.AddValue ("dlRate", "DL offered load per UE (bit/s), if fullBuffer is false", config.dlRate);
+  cmd.AddValue ("ulRate", "UL offered load per UE (bit/s), if fullBuffer is false", config.ulRate);
+  cmd.AddValue ("bitRate", "MBR and GBR of the bearer of each UE (bit/s)", config.bitRate);
+  cmd.AddValue ("bler", "probability of a NACK for each DL transport block", config.bler);
+  cmd.AddValue ("minUes", "smallest number of UEs", minUes);
+  cmd.AddValue ("maxUes", "largest number of UEs (the number of UEs is doubled from minUes)", maxUes);
+  cmd.Parse (argc, argv);
+  NS_ABORT_MSG_IF (minUes == 0, "minUes must be at least 1");
+  NS_ABORT_MSG_IF (config.nTtis == 0, "ttis must be at least 1");
+  config.bandwidth = bandwidth;
+  config.txMode = txMode;
+
+  std::cout << config.schedulerType << ", " << bandwidth << " RBs, " << config.nTtis << " TTIs, "
+            << (config.fullBuffer ? "full buffer" : "constant bit rate") << std::endl;
+  std::cout << std::fixed << std::setprecision (1);
+  for (uint32_t nUes = minUes; nUes <= maxUes; nUes *= 2)
+    {
+      SchedulerBench bench (config, nUes);
+      bench.Run ();
+    }
+  return 0;
+}
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the TCP implementation with a
+// high bandwidth-delay product. A BulkSendApplication sends to a
+// PacketSink over a point-to-point link, with send and receive buffers
+// of twice the bandwidth-delay product, and random losses on the link
+// (plus the losses of the sender's queue) keep SACK recovery busy.
+// The wall-clock time of the simulation and the bytes received are
+// printed.
+// Sample usage:
+//   ./waf --run 'bench-tcp-bulk-send --rate=10Gbps --delay=10ms --time=0.5'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string rate = "10Gbps";
+  std::string delay = "10ms";
+  double time = 0.5;
+  double errorRate = 1e-5;
+  uint32_t segmentSize = 1448;
+  bool sack = true;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark a TCP bulk transfer over a high bandwidth-delay product link.");
+  cmd.AddValue ("rate", "rate of the link", rate);
+  cmd.AddValue ("delay", "one-way delay of the link", delay);
+  cmd.AddValue ("time", "simulated time, in seconds", time);
+  cmd.AddValue ("errorRate", "packet error rate of the link", errorRate);
+  cmd.AddValue ("segmentSize", "TCP segment size", segmentSize);
+  cmd.AddValue ("sack", "enable SACK", sack);
+  cmd.Parse (argc, argv);
+
+  double bdp = DataRate (rate).GetBitRate () / 8.0 * Time (delay).GetSeconds () * 2;
+  uint32_t bufSize = static_cast<uint32_t> (std::min (2 * bdp, 1e9));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (segmentSize));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (bufSize));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (bufSize));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (sack));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue (rate));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue (delay));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+  Ptr<RateErrorModel> errorModel = CreateObject<RateErrorModel> ();
+  errorModel->SetUnit (RateErrorModel::ERROR_UNIT_PACKET);
+  errorModel->SetRate (errorRate);
+  errorModel->AssignStreams (1);
+  devices.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (errorModel));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4 ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+
+  uint16_t port = 9;
+  BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("SendSize", UintegerValue (segmentSize));
+  source.Install (nodes.Get (0)).Start (Seconds (0));
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+
+  std::cout << rate << ", " << delay << ", " << bufSize << " bytes of buffers, "
+            << time << " s" << std::endl;
+  Simulator::Stop (Seconds (time));
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  double s = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  uint64_t rx = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  std::cout << "Received " << rx << " bytes (" << rx * 8 / time / 1e6 << " Mbps) in "
+            << s << " s of wall-clock time" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
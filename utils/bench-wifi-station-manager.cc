@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the per-frame cost of the
+// WifiRemoteStationManager (station lookup and rate control) when the
+// number of remote stations grows, e.g. at an AP with many associated
+// stations. For each number of stations, 'frames' data frames are sent
+// to the stations in a round-robin fashion, each of them being followed
+// by a received frame from the same station.
+// Sample usage:  ./waf --run 'bench-wifi-station-manager --frames=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/adhoc-wifi-mac.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/ht-capabilities.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Send the given number of frames to the given number of stations
+ *
+ * \param managerType the TypeId name of the WifiRemoteStationManager
+ * \param ht whether HT rates are used
+ * \param nStations the number of remote stations
+ * \param nFrames the number of frames
+ * \return the elapsed time (ms)
+ */
+static uint64_t
+runBench (std::string managerType, bool ht, uint32_t nStations, uint32_t nFrames)
+{
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+  Ptr<AdhocWifiMac> mac = CreateObject<AdhocWifiMac> ();
+  WifiPhyStandard standard = ht ? WIFI_PHY_STANDARD_80211n_5GHZ : WIFI_PHY_STANDARD_80211a;
+  mac->ConfigureStandard (standard);
+  mac->SetAddress (Mac48Address::Allocate ());
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetDevice (dev);
+  phy->SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  phy->ConfigureStandard (standard);
+  ObjectFactory factory;
+  factory.SetTypeId (managerType);
+  Ptr<WifiRemoteStationManager> manager = factory.Create<WifiRemoteStationManager> ();
+  manager->SetHtSupported (ht);
+  Ptr<Node> node = CreateObject<Node> ();
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+  dev->Initialize ();
+
+  std::vector<Mac48Address> stations;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      stations.push_back (Mac48Address::Allocate ());
+    }
+  for (Mac48Address address : stations)
+    {
+      manager->AddAllSupportedModes (address);
+      if (ht)
+        {
+          manager->AddAllSupportedMcs (address);
+          manager->AddStationHtCapabilities (address, mac->GetHtCapabilities ());
+        }
+      manager->RecordGotAssocTxOk (address);
+    }
+
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  Ptr<Packet> packet = Create<Packet> (1000);
+  WifiMode ackMode = phy->GetMode (0);
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      Mac48Address address = stations[i % nStations];
+      hdr.SetAddr1 (address);
+      WifiTxVector txVector = manager->GetDataTxVector (address, &hdr, packet);
+      manager->ReportDataOk (address, &hdr, 30.0, ackMode, 30.0, packet->GetSize ());
+      manager->ReportRxOk (address, &hdr, 30.0, txVector.GetMode ());
+    }
+  uint64_t deltaMs = time.End ();
+  node->Dispose ();
+  return deltaMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nFrames = 100000;
+  uint32_t maxStations = 1024;
+  std::string managerType = "ns3::IdealWifiManager";
+  bool ht = true;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the WifiRemoteStationManager for a growing number of stations.");
+  cmd.AddValue ("frames", "number of frames for each number of stations", nFrames);
+  cmd.AddValue ("maxStations", "largest number of stations (the number of stations is doubled from 1)", maxStations);
+  cmd.AddValue ("manager", "TypeId of the WifiRemoteStationManager", managerType);
+  cmd.AddValue ("ht", "use 802.11n (HT) rates, otherwise 802.11a rates are used", ht);
+  cmd.Parse (argc, argv);
+
+  std::cout << managerType << ", " << nFrames << " frames" << std::endl;
+  for (uint32_t nStations = 1; nStations <= maxStations; nStations *= 2)
+    {
+      uint64_t deltaMs = runBench (managerType, ht, nStations, nFrames);
+      std::cout << nStations << " stations: " << deltaMs << " ms, "
+                << (deltaMs * 1e6 / nFrames) << " ns/frame" << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,52 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program converts an ASCII fading trace, as generated by the
+// fading_trace_generator.m script, to the binary format that the
+// TraceFadingLossModel memory-maps.
+// Sample usage:
+//   ./waf --run 'lte-fading-trace-converter --input=fading_trace_EPA_3kmph.fad
+//                --output=fading_trace_EPA_3kmph.fadb'
+
+#include "ns3/command-line.h"
+#include "ns3/abort.h"
+#include "ns3/trace-fading-loss-model.h"
+#include <iostream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  uint32_t rbNum = 100;
+  uint32_t samplesNum = 10000;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert an ASCII fading trace to the binary format of the TraceFadingLossModel.");
+  cmd.AddValue ("input", "name of the ASCII trace file", input);
+  cmd.AddValue ("output", "name of the binary trace file", output);
+  cmd.AddValue ("rbNum", "number of RBs of the trace", rbNum);
+  cmd.AddValue ("samplesNum", "number of samples per RB of the trace", samplesNum);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (input.empty () || output.empty (), "the input and output file names are required");
+  NS_ABORT_MSG_IF (rbNum == 0 || rbNum > 255, "the number of RBs must be between 1 and 255");
+  TraceFadingLossModel::ConvertTrace (input, output, rbNum, samplesNum);
+  std::cout << "converted " << rbNum << " x " << samplesNum << " samples from "
+            << input << " to " << output << std::endl;
+  return 0;
+}